@@ -0,0 +1,309 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: bandencoder.cpp
+ *
+ * 模块描述:
+ *   该模块实现了按条带转换和编码的 JPEG 编码器。
+ *
+ * 主要功能:
+ *   1. 逐条带把原始帧转换为 RGB 并送入 JPEG 编码器
+ *   2. 压缩结果直接写入可增长的字节数组
+ *
+ * 函数列表:
+ *   1. bandEncoder               - 构造函数
+ *   2. isAvailable               - 是否编译了 libjpeg 支持
+ *   3. encodeJpeg                - 按条带把一帧编码为 JPEG
+ *   4. compressBands             - 逐条带转换并压缩一帧
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#include "bandencoder.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include "colorconvert.h"
+#include "pipelinestats.h"
+#include "tracelogger.h"
+
+#ifdef HAVE_LIBJPEG
+#include <csetjmp>
+#include <cstdio>
+extern "C"
+{
+#include <jpeglib.h>
+}
+
+namespace
+{
+    const int OUTPUT_CHUNK = 256 * 1024; // 压缩结果的初始容量和最小增长量(字节)
+    const int DEFAULT_QUALITY = 75;      // 未指定质量时的 JPEG 质量，与 Qt 默认值一致
+
+#ifdef JCS_EXTENSIONS
+    // libjpeg-turbo 可直接接受 RGB32 的内存布局，不需要逐行重排
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    const J_COLOR_SPACE RGB32_COLOR_SPACE = JCS_EXT_BGRX;
+#else
+    const J_COLOR_SPACE RGB32_COLOR_SPACE = JCS_EXT_XRGB;
+#endif
+#endif
+
+    // 出错时跳回 compressBands，避免 libjpeg 默认的 exit()
+    struct errorManager
+    {
+        jpeg_error_mgr base;
+        jmp_buf jump;
+    };
+
+    // 把压缩结果写入 QByteArray 的目标管理器
+    struct byteArrayDestination
+    {
+        jpeg_destination_mgr base;
+        QByteArray *output;
+    };
+
+    void onError(j_common_ptr info)
+    {
+        errorManager *manager = reinterpret_cast<errorManager *>(info->err);
+        char message[JMSG_LENGTH_MAX];
+        (*info->err->format_message)(info, message);
+        qDebug() << "JPEG encode failed:" << message;
+        longjmp(manager->jump, 1);
+    }
+
+    void initDestination(j_compress_ptr info)
+    {
+        byteArrayDestination *destination = reinterpret_cast<byteArrayDestination *>(info->dest);
+        destination->output->resize(OUTPUT_CHUNK);
+        destination->base.next_output_byte = reinterpret_cast<JOCTET *>(destination->output->data());
+        destination->base.free_in_buffer = static_cast<size_t>(destination->output->size());
+    }
+
+    boolean emptyOutputBuffer(j_compress_ptr info)
+    {
+        // 调用时缓冲区已全部写满，按当前大小的一半增长
+        byteArrayDestination *destination = reinterpret_cast<byteArrayDestination *>(info->dest);
+        const int used = destination->output->size();
+        destination->output->resize(used + qMax(OUTPUT_CHUNK, used / 2));
+        destination->base.next_output_byte = reinterpret_cast<JOCTET *>(destination->output->data() + used);
+        destination->base.free_in_buffer = static_cast<size_t>(destination->output->size() - used);
+        return TRUE;
+    }
+
+    void termDestination(j_compress_ptr info)
+    {
+        byteArrayDestination *destination = reinterpret_cast<byteArrayDestination *>(info->dest);
+        destination->output->resize(destination->output->size() -
+                                    static_cast<int>(destination->base.free_in_buffer));
+    }
+}
+
+/***********************************************************
+ * 函数名称: compressBands
+ * 函数功能: 逐条带转换并压缩一帧
+ * 参数说明:
+ *   frame      - 源帧视图
+ *   quality    - JPEG 质量，-1 为默认
+ *   encoded    - 返回压缩结果
+ *   bandBuffer - 条带缓冲区
+ *   rowBuffer  - RGB24 行缓冲区，仅不支持 RGB32 输入的 libjpeg 使用
+ *   convertNs  - 累加颜色转换耗时(纳秒)
+ * 返回值: 成功返回 true
+ * 备注: 含 setjmp，函数内不创建带析构函数的局部对象；
+ *       RGB32 源帧直接把各行指针交给编码器，不经过条带缓冲区
+ ***********************************************************/
+static bool compressBands(const frameView &frame, int quality, QByteArray &encoded,
+                          QByteArray &bandBuffer, QByteArray &rowBuffer, qint64 *convertNs)
+{
+    jpeg_compress_struct info;
+    errorManager error;
+    byteArrayDestination destination;
+
+    info.err = jpeg_std_error(&error.base);
+    error.base.error_exit = onError;
+    if (setjmp(error.jump))
+    {
+        jpeg_destroy_compress(&info);
+        encoded.clear();
+        return false;
+    }
+    jpeg_create_compress(&info);
+
+    destination.base.init_destination = initDestination;
+    destination.base.empty_output_buffer = emptyOutputBuffer;
+    destination.base.term_destination = termDestination;
+    destination.output = &encoded;
+    info.dest = &destination.base;
+
+    info.image_width = static_cast<JDIMENSION>(frame.width);
+    info.image_height = static_cast<JDIMENSION>(frame.height);
+#ifdef JCS_EXTENSIONS
+    info.input_components = 4;
+    info.in_color_space = RGB32_COLOR_SPACE;
+#else
+    info.input_components = 3;
+    info.in_color_space = JCS_RGB;
+#endif
+    jpeg_set_defaults(&info);
+    jpeg_set_quality(&info, quality < 0 ? DEFAULT_QUALITY : qBound(0, quality, 100), TRUE);
+    jpeg_start_compress(&info, TRUE);
+
+    const bool direct = frame.format == frameView::FORMAT_RGB32;
+    const int bandStride = frame.width * 4;
+    if (!direct && bandBuffer.size() < bandStride * bandEncoder::BAND_ROWS)
+    {
+        bandBuffer.resize(bandStride * bandEncoder::BAND_ROWS);
+    }
+#ifndef JCS_EXTENSIONS
+    if (rowBuffer.size() < frame.width * 3)
+    {
+        rowBuffer.resize(frame.width * 3);
+    }
+#else
+    Q_UNUSED(rowBuffer);
+#endif
+
+    JSAMPROW rows[bandEncoder::BAND_ROWS];
+    QElapsedTimer timer;
+    while (info.next_scanline < info.image_height)
+    {
+        const int firstRow = static_cast<int>(info.next_scanline);
+        const int rowCount = qMin(bandEncoder::BAND_ROWS, frame.height - firstRow);
+        if (direct)
+        {
+            for (int i = 0; i < rowCount; ++i)
+            {
+                rows[i] = const_cast<JSAMPROW>(frame.planes[0] + static_cast<qint64>(firstRow + i) * frame.strides[0]);
+            }
+        }
+        else
+        {
+            timer.start();
+            uchar *band = reinterpret_cast<uchar *>(bandBuffer.data());
+            convertRowsToRgb32(frame, firstRow, rowCount, band, bandStride);
+            *convertNs += timer.nsecsElapsed();
+            for (int i = 0; i < rowCount; ++i)
+            {
+                rows[i] = band + static_cast<qint64>(i) * bandStride;
+            }
+        }
+
+#ifdef JCS_EXTENSIONS
+        jpeg_write_scanlines(&info, rows, static_cast<JDIMENSION>(rowCount));
+#else
+        for (int i = 0; i < rowCount; ++i)
+        {
+            timer.start();
+            const QRgb *source = reinterpret_cast<const QRgb *>(rows[i]);
+            JSAMPROW packed = reinterpret_cast<JSAMPROW>(rowBuffer.data());
+            for (int x = 0; x < frame.width; ++x)
+            {
+                packed[3 * x] = static_cast<JSAMPLE>(qRed(source[x]));
+                packed[3 * x + 1] = static_cast<JSAMPLE>(qGreen(source[x]));
+                packed[3 * x + 2] = static_cast<JSAMPLE>(qBlue(source[x]));
+            }
+            *convertNs += timer.nsecsElapsed();
+            jpeg_write_scanlines(&info, &packed, 1);
+        }
+#endif
+    }
+
+    jpeg_finish_compress(&info);
+    jpeg_destroy_compress(&info);
+    return true;
+}
+#endif
+
+/***********************************************************
+ * 函数名称: bandEncoder
+ * 函数功能: 条带编码器的构造函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 条带缓冲区在第一次编码时按帧宽分配
+ ***********************************************************/
+bandEncoder::bandEncoder()
+{
+}
+
+/***********************************************************
+ * 函数名称: isAvailable
+ * 函数功能: 是否编译了 libjpeg 支持
+ * 参数说明: 无
+ * 返回值: 以 CONFIG+=libjpeg 编译时返回 true
+ * 备注: 无
+ ***********************************************************/
+bool bandEncoder::isAvailable()
+{
+#ifdef HAVE_LIBJPEG
+    return true;
+#else
+    return false;
+#endif
+}
+
+/***********************************************************
+ * 函数名称: encodeJpeg
+ * 函数功能: 按条带把一帧编码为 JPEG
+ * 参数说明:
+ *   frame       - 源帧视图
+ *   quality     - JPEG 质量，-1 为默认
+ *   encoded     - 返回压缩结果
+ *   stats       - 阶段统计对象，可为空
+ *   frameNumber - 帧号，用于阶段统计
+ * 返回值: 成功返回 true，未编译 libjpeg 支持时返回 false
+ * 备注: 转换和编码交替进行，逐条带的转换耗时合计后记一次转换阶段，
+ *       其余耗时记一次编码阶段，与整帧路径的统计口径一致
+ ***********************************************************/
+bool bandEncoder::encodeJpeg(const frameView &frame, int quality, QByteArray &encoded,
+                             pipelineStats *stats, qint64 frameNumber)
+{
+#ifdef HAVE_LIBJPEG
+    if (!frame.isValid())
+    {
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    traceLogger *tracer = stats != nullptr ? stats->activeTracer() : nullptr;
+    const qint64 traceBeginNs = tracer != nullptr ? traceLogger::nowNs() : -1;
+    qint64 convertNs = 0;
+    const bool encodedOk = compressBands(frame, quality, encoded, bandBuffer, rowBuffer, &convertNs);
+    const qint64 elapsed = timer.nsecsElapsed();
+    if (stats != nullptr)
+    {
+        stats->recordLatency(pipelineStats::STAGE_CONVERT, convertNs);
+        stats->recordLatency(pipelineStats::STAGE_ENCODE, elapsed - convertNs);
+    }
+    if (tracer != nullptr)
+    {
+        tracer->record(pipelineStats::stageKey(pipelineStats::STAGE_ENCODE), traceBeginNs, elapsed, frameNumber);
+    }
+    if (!encodedOk)
+    {
+        qDebug() << "Band encode failed, frame:" << frameNumber;
+    }
+    return encodedOk;
+#else
+    Q_UNUSED(frame);
+    Q_UNUSED(quality);
+    Q_UNUSED(encoded);
+    Q_UNUSED(stats);
+    Q_UNUSED(frameNumber);
+    return false;
+#endif
+}
@@ -0,0 +1,62 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: bandencoder.h
+ *
+ * 模块描述:
+ *   该模块定义了按条带转换和编码的 JPEG 编码器，用于 4K/8K 大分辨率帧。
+ *   整帧 RGB32 图像在 8K 下约 130MB，该编码器每次只把 16 行原始帧转换到
+ *   可复用的条带缓冲区，随即按扫描行送入 libjpeg，每帧的峰值内存只有
+ *   一个条带加上压缩结果。仅在 qmake CONFIG+=libjpeg 时可用。
+ *
+ * 主要功能:
+ *   1. 逐条带把原始帧转换为 RGB 并送入 JPEG 编码器
+ *   2. 压缩结果直接写入可增长的字节数组
+ *
+ * 函数列表:
+ *   1. bandEncoder               - 构造函数
+ *   2. isAvailable               - 是否编译了 libjpeg 支持
+ *   3. encodeJpeg                - 按条带把一帧编码为 JPEG
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#ifndef BANDENCODER_H
+#define BANDENCODER_H
+
+#include <QByteArray>
+#include "frameview.h"
+
+class pipelineStats;
+
+class bandEncoder
+{
+public:
+    static const int BAND_ROWS = 16; // 每个条带的行数，与 4:2:0 JPEG 的 MCU 行高一致
+
+    bandEncoder();
+
+    static bool isAvailable(); // 是否编译了 libjpeg 支持
+    bool encodeJpeg(const frameView &frame, int quality, QByteArray &encoded,
+                    pipelineStats *stats, qint64 frameNumber); // 按条带把一帧编码为 JPEG
+
+private:
+    QByteArray bandBuffer; // 条带缓冲区，在各帧之间复用
+    QByteArray rowBuffer;  // 不支持 RGB32 输入的 libjpeg 所需的 RGB24 行缓冲区
+};
+
+#endif // BANDENCODER_H
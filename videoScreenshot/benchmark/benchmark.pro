@@ -0,0 +1,25 @@
+#-------------------------------------------------
+#
+# 导出流水线基准测试程序
+# 与 GUI 程序分开构建: qmake benchmark.pro && make
+#
+#-------------------------------------------------
+
+QT       += core gui multimedia
+
+TARGET = videoScreenshotBench
+TEMPLATE = app
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SOURCES += \
+    main.cpp \
+    syntheticclip.cpp
+
+HEADERS += \
+    syntheticclip.h
+
+include(../exportcore.pri)
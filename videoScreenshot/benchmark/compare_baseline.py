@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+比较两次基准测试结果，发现吞吐或内存回退时返回非零退出码。
+基准中有而本次结果中没有的用例同样算作回退，只跑部分用例(--filter)时
+用 --allow-missing 跳过。
+
+用法:
+    python3 compare_baseline.py baseline.json bench_results.json [--fps-tolerance 0.10] [--allow-missing]
+"""
+
+import argparse
+import json
+import sys
+
+
+def load_results(path):
+    with open(path, encoding="utf-8") as f:
+        document = json.load(f)
+    return {r["case"]: r for r in document.get("results", [])}, document.get("host", {})
+
+
+def relative_change(current, baseline):
+    if not baseline:
+        return 0.0
+    return (current - baseline) / baseline
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare benchmark results against a baseline.")
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--fps-tolerance", type=float, default=0.10,
+                        help="allowed relative drop of export fps (default 0.10)")
+    parser.add_argument("--latency-tolerance", type=float, default=0.25,
+                        help="allowed relative growth of per-stage p99 latency (default 0.25)")
+    parser.add_argument("--memory-tolerance", type=float, default=0.15,
+                        help="allowed relative growth of peak RSS (default 0.15)")
+    parser.add_argument("--allow-missing", action="store_true",
+                        help="do not fail on baseline cases absent from the current run (filtered runs)")
+    args = parser.parse_args()
+
+    baseline, baseline_host = load_results(args.baseline)
+    current, current_host = load_results(args.current)
+
+    if baseline_host.get("hostName") != current_host.get("hostName"):
+        print("warning: results come from different hosts (%s vs %s)"
+              % (baseline_host.get("hostName"), current_host.get("hostName")))
+
+    regressions = []
+    print("%-58s %10s %10s %8s %8s" % ("case", "base fps", "fps", "fps %", "rss %"))
+    for case in sorted(current):
+        now = current[case]
+        before = baseline.get(case)
+        if before is None:
+            print("%-58s %10s %10.1f %8s %8s" % (case, "new", now.get("exportFps", 0.0), "", ""))
+            continue
+        if "error" in now:
+            if "error" not in before:
+                regressions.append("%s: failed (%s)" % (case, now["error"]))
+            continue
+        if "error" in before:
+            continue
+
+        fps_change = relative_change(now["exportFps"], before["exportFps"])
+        rss_change = relative_change(now["peakRssBytes"], before["peakRssBytes"])
+        print("%-58s %10.1f %10.1f %+7.1f%% %+7.1f%%"
+              % (case, before["exportFps"], now["exportFps"], fps_change * 100, rss_change * 100))
+
+        if fps_change < -args.fps_tolerance:
+            regressions.append("%s: export fps %.1f -> %.1f" % (case, before["exportFps"], now["exportFps"]))
+        if rss_change > args.memory_tolerance:
+            regressions.append("%s: peak RSS %.0f MB -> %.0f MB"
+                               % (case, before["peakRssBytes"] / 1048576.0, now["peakRssBytes"] / 1048576.0))
+
+        for stage, stats in now.get("stages", {}).items():
+            old = before.get("stages", {}).get(stage)
+            if not old or not old.get("frames") or not stats.get("frames"):
+                continue
+            p99_change = relative_change(stats["p99Us"], old["p99Us"])
+            if p99_change > args.latency_tolerance:
+                regressions.append("%s: %s p99 %.0f us -> %.0f us"
+                                   % (case, stage, old["p99Us"], stats["p99Us"]))
+
+    missing = sorted(set(baseline) - set(current))
+    for case in missing:
+        print("%-58s %10s" % (case, "missing"))
+        if not args.allow_missing:
+            regressions.append("%s: missing from current results" % case)
+
+    if regressions:
+        print("\n%d regression(s):" % len(regressions))
+        for line in regressions:
+            print("  " + line)
+        return 1
+
+    print("\nno regressions")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,752 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: main.cpp
+ *
+ * 模块描述:
+ *   该模块是导出流水线基准测试程序的入口。主进程负责生成合成片段并按
+ *   片段 x 导出模式 x 输出格式的组合逐个启动子进程执行导出，子进程独立
+ *   运行保证峰值内存互不干扰，结果汇总为 JSON 文件，可用
+ *   compare_baseline.py 与基线比较。
+ *
+ * 主要功能:
+ *   1. 生成或复用确定性的合成片段
+ *   2. 在子进程中执行单个导出用例并采集运行报告
+ *   3. 汇总结果写出 JSON
+ *
+ * 函数列表:
+ *   1. runCase                   - 子进程: 执行单个导出用例
+ *   2. runSuite                  - 主进程: 执行全部用例并汇总
+ *   3. countExported             - 统计导出的图像数量
+ *   4. main                      - 程序入口
+ *   5. loadMemorySource          - 将 Y4M 片段整体载入内存帧源
+ *   6. runQueueCheck             - 子进程: 慢速消费 Qt 帧源并检查帧队列上限
+ *   7. runChild                  - 主进程: 启动子进程并合并其输出的结果
+ *   8. exportedFrames            - 从导出的文件名中读取帧号
+ *   9. runSelection              - 用合成内存帧执行一次导出并返回导出的帧号
+ *   10. runSelectionCheck        - 子进程: 检查等间隔相位、随机种子确定性和关键帧间隔
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 增加 --backend 选项，可选 memory 后端排除读取和解码的影响
+ *     * 增加关键帧导出用例
+ *     * 正交分布用例改为多样性导出用例
+ *     * 增加慢速消费用例，检查 Qt 帧源的帧队列不随视频长度增长
+ *     * 导出吞吐按读过的视频帧数计算，另行记录实际解码帧数
+ *     * 增加选帧检查用例，用合成内存帧验证各导出模式选出的帧号
+ ***********************************************************/
+
+#include <QCoreApplication>
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QSysInfo>
+#include <QThread>
+#include <QTextStream>
+#include <algorithm>
+
+#include "exportthread.h"
+#include "syntheticclip.h"
+#include "memoryframesource.h"
+#include "pipelinestats.h"
+#include "qtframesource.h"
+#include "y4msource.h"
+
+// 导出模式用例
+struct modeCase
+{
+    const char *name;
+    int mode;
+    int interval;
+};
+
+static const modeCase MODE_CASES[] = {
+    {"interval30", 0, 30},
+    {"interval1", 0, 1},
+    {"random", 1, 30},
+    {"diversity", 2, 30},
+    {"keyframes", 3, 30},
+};
+
+// 慢速消费用例每读一帧的停顿(毫秒)，远慢于片段的实时帧率
+static const int SLOW_CONSUMER_DELAY_MS = 100;
+
+// 慢速消费用例允许的帧队列最大长度: 高水位加上暂停生效前已投递的帧
+static const int SLOW_CONSUMER_QUEUE_LIMIT = frameGrabSurface::MAX_QUEUED_FRAMES * 2;
+
+// 选帧检查: 合成帧数、尺寸、关键帧间隔和帧率；关键帧间隔 0.4 秒，小于关键帧导出的最小间隔
+static const int SELECTION_FRAMES = 200;
+static const int SELECTION_SIZE = 64;
+static const int SELECTION_GOP = 10;
+static const double SELECTION_FPS = 25.0;
+static const int SELECTION_INTERVAL = 30;
+static const int SELECTION_RANDOM_COUNT = 10;
+static const int SELECTION_KEYFRAME_GAP_MS = 1000;
+
+/***********************************************************
+ * 函数名称: countExported
+ * 函数功能: 统计导出的图像数量
+ * 参数说明:
+ *   dirPath - 导出目录
+ *   format  - 图像格式后缀
+ * 返回值: 图像文件数量
+ * 备注: 无
+ ***********************************************************/
+static int countExported(const QString &dirPath, const QString &format)
+{
+    return QDir(dirPath).entryList(QStringList() << ("*." + format), QDir::Files).size();
+}
+
+/***********************************************************
+ * 函数名称: loadMemorySource
+ * 函数功能: 将 Y4M 片段整体载入内存帧源
+ * 参数说明:
+ *   path - Y4M 片段路径
+ * 返回值: 载入完成的内存帧源，失败返回 nullptr
+ * 备注: 载入在计时开始前完成，用例只测量转换、编码和写入
+ ***********************************************************/
+static memoryFrameSource *loadMemorySource(const QString &path)
+{
+    y4mSource reader;
+    if (!reader.open(path))
+    {
+        QTextStream(stderr) << "cannot load " << path << ": " << reader.errorString() << "\n";
+        return nullptr;
+    }
+
+    memoryFrameSource *source = new memoryFrameSource();
+    source->setFrameRate(reader.frameRate());
+    const qint64 frameBytes = frameView::bufferSize(reader.pixelFormat(), reader.width(), reader.height());
+    frameView frame;
+    while (reader.readFrame(frame))
+    {
+        source->addFrame(QByteArray(reinterpret_cast<const char *>(frame.planes[0]), static_cast<int>(frameBytes)),
+                         frame.format, frame.width, frame.height, frame.keyframe);
+    }
+    return source;
+}
+
+/***********************************************************
+ * 函数名称: runCase
+ * 函数功能: 子进程: 执行单个导出用例
+ * 参数说明:
+ *   app    - 应用程序对象
+ *   parser - 已解析的命令行
+ * 返回值: 进程退出码
+ * 备注: 结果以单行 JSON 输出到标准输出
+ ***********************************************************/
+static int runCase(QCoreApplication &app, const QCommandLineParser &parser)
+{
+    const QString input = parser.value("input");
+    const QString workDir = parser.value("work-dir");
+    const QString format = parser.value("format");
+    const int mode = parser.value("mode").toInt();
+    const int interval = parser.value("interval").toInt();
+    const QString caseName = "case";
+
+    QDir(workDir).removeRecursively();
+    QDir().mkpath(workDir);
+
+    exportThread worker;
+    worker.setVideoFile(input);
+    worker.setExportPath(workDir);
+    worker.setExportName(caseName);
+    worker.setExportMode(mode);
+    worker.setInterval(interval);
+    worker.setRandomCount(10);
+    worker.setDiversityCount(10);
+    worker.setImageFormat(format, parser.value("quality").toInt());
+
+    const QString backend = parser.value("backend");
+    if (backend == "memory")
+    {
+        memoryFrameSource *source = loadMemorySource(input);
+        if (source == nullptr)
+        {
+            return 2;
+        }
+        worker.setFrameSource(source);
+    }
+    else
+    {
+        worker.setDecoder(backend, 0, frameSourceOptions::THREAD_AUTO);
+    }
+
+    QObject::connect(&worker, &QThread::finished, &app, &QCoreApplication::quit);
+
+    QElapsedTimer wallClock;
+    wallClock.start();
+    worker.start();
+    app.exec();
+    worker.wait();
+    const qint64 wallMs = wallClock.elapsed();
+
+    const QString outputDir = QDir(workDir).filePath(caseName);
+    QFile reportFile(QDir(outputDir).filePath("export_report.json"));
+    if (!reportFile.open(QIODevice::ReadOnly))
+    {
+        QTextStream(stderr) << "missing export report in " << outputDir << "\n";
+        return 2;
+    }
+    const QJsonObject report = QJsonDocument::fromJson(reportFile.readAll()).object();
+    const QJsonObject job = report["job"].toObject();
+    const QJsonObject stats = report["stats"].toObject();
+
+    QJsonObject stageLatency;
+    for (const QJsonValue &value : stats["stages"].toArray())
+    {
+        const QJsonObject stage = value.toObject();
+        QJsonObject entry;
+        entry["frames"] = stage["frames"];
+        entry["p50Us"] = stage["p50Us"];
+        entry["p99Us"] = stage["p99Us"];
+        stageLatency[stage["name"].toString()] = entry;
+    }
+
+    // 吞吐按读过的视频帧数计算: 帧源在解码前跳帧时实际解码的帧更少，
+    // 但处理的仍是同样长的视频，各后端和跳帧与否的结果可以直接比较
+    const double framesCovered = job["framesCovered"].toDouble();
+    QJsonObject result;
+    result["framesDecoded"] = job["framesDecoded"];
+    result["framesCovered"] = framesCovered;
+    result["framesExported"] = countExported(outputDir, format);
+    result["wallMs"] = static_cast<double>(wallMs);
+    result["exportFps"] = wallMs > 0 ? framesCovered * 1000.0 / wallMs : 0.0;
+    result["bytesWritten"] = stats["bytesWritten"];
+    result["peakRssBytes"] = stats["peakRssBytes"];
+    result["bottleneck"] = stats["bottleneck"];
+    result["stages"] = stageLatency;
+
+    QTextStream(stdout) << QJsonDocument(result).toJson(QJsonDocument::Compact) << "\n";
+    return 0;
+}
+
+/***********************************************************
+ * 函数名称: runQueueCheck
+ * 函数功能: 子进程: 慢速消费 Qt 帧源并检查帧队列上限
+ * 参数说明:
+ *   parser - 已解析的命令行
+ * 返回值: 进程退出码，帧队列超过 SLOW_CONSUMER_QUEUE_LIMIT 时返回 1
+ * 备注: 播放器按实时速度推送帧，消费者每帧停顿 --consumer-delay-ms，
+ *       帧队列不受约束时会增长到接近整段视频的帧数
+ ***********************************************************/
+static int runQueueCheck(const QCommandLineParser &parser)
+{
+    const QString input = parser.value("input");
+    const int delayMs = parser.value("consumer-delay-ms").toInt();
+
+    qtFrameSource source;
+    if (!source.open(input))
+    {
+        QTextStream(stderr) << "cannot open " << input << ": " << source.errorString() << "\n";
+        return 2;
+    }
+
+    QElapsedTimer wallClock;
+    wallClock.start();
+    qint64 framesDecoded = 0;
+    frameView frame;
+    while (source.readFrame(frame))
+    {
+        framesDecoded++;
+        QThread::msleep(static_cast<unsigned long>(delayMs));
+    }
+    const qint64 wallMs = wallClock.elapsed();
+    const QString error = source.errorString();
+    const int peakQueued = source.peakQueuedFrames();
+    source.close();
+
+    QJsonObject result;
+    result["framesDecoded"] = static_cast<double>(framesDecoded);
+    result["wallMs"] = static_cast<double>(wallMs);
+    result["exportFps"] = wallMs > 0 ? framesDecoded * 1000.0 / wallMs : 0.0;
+    result["peakRssBytes"] = static_cast<double>(pipelineStats::peakRssBytes());
+    result["peakQueuedFrames"] = peakQueued;
+    result["queueLimit"] = SLOW_CONSUMER_QUEUE_LIMIT;
+    QTextStream(stdout) << QJsonDocument(result).toJson(QJsonDocument::Compact) << "\n";
+
+    if (!error.isEmpty())
+    {
+        QTextStream(stderr) << "frame source error: " << error << "\n";
+        return 1;
+    }
+    if (framesDecoded == 0)
+    {
+        QTextStream(stderr) << "no frames decoded from " << input << "\n";
+        return 1;
+    }
+    if (peakQueued > SLOW_CONSUMER_QUEUE_LIMIT)
+    {
+        QTextStream(stderr) << "frame queue reached " << peakQueued << " frames, limit "
+                            << SLOW_CONSUMER_QUEUE_LIMIT << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+/***********************************************************
+ * 函数名称: exportedFrames
+ * 函数功能: 从导出的文件名中读取帧号
+ * 参数说明:
+ *   dirPath - 导出目录
+ * 返回值: 升序排列的帧号
+ * 备注: 文件名形如 <时间>_<帧号>.bmp
+ ***********************************************************/
+static QVector<qint64> exportedFrames(const QString &dirPath)
+{
+    static const QRegularExpression pattern("_(\\d+)\\.bmp$");
+    QVector<qint64> frames;
+    for (const QString &name : QDir(dirPath).entryList(QStringList() << "*.bmp", QDir::Files))
+    {
+        const QRegularExpressionMatch match = pattern.match(name);
+        if (match.hasMatch())
+        {
+            frames.append(match.captured(1).toLongLong());
+        }
+    }
+    std::sort(frames.begin(), frames.end());
+    return frames;
+}
+
+/***********************************************************
+ * 函数名称: runSelection
+ * 函数功能: 用合成内存帧执行一次导出并返回导出的帧号
+ * 参数说明:
+ *   workDir - 导出根目录
+ *   name    - 导出名称，每次运行使用不同的名称
+ *   mode    - 导出模式
+ *   seed    - 随机导出的种子
+ * 返回值: 升序排列的导出帧号
+ * 备注: 帧内容只由帧号决定，BMP 输出不经有损编码，结果只取决于选帧逻辑
+ ***********************************************************/
+static QVector<qint64> runSelection(const QString &workDir, const QString &name, int mode, quint64 seed)
+{
+    memoryFrameSource *source = new memoryFrameSource();
+    source->addSyntheticFrames(SELECTION_FRAMES, SELECTION_SIZE, SELECTION_SIZE, SELECTION_GOP, SELECTION_FPS);
+
+    exportThread worker;
+    worker.setVideoFile("memory");
+    worker.setExportPath(workDir);
+    worker.setExportName(name);
+    worker.setExportMode(mode);
+    worker.setInterval(SELECTION_INTERVAL);
+    worker.setRandomCount(SELECTION_RANDOM_COUNT);
+    worker.setRandomSeed(seed);
+    worker.setKeyframeGap(SELECTION_KEYFRAME_GAP_MS);
+    worker.setImageFormat("bmp", -1);
+    worker.setFrameSource(source);
+    worker.start();
+    worker.wait();
+    return exportedFrames(QDir(workDir).filePath(name));
+}
+
+/***********************************************************
+ * 函数名称: runSelectionCheck
+ * 函数功能: 子进程: 检查等间隔相位、随机种子确定性和关键帧间隔
+ * 参数说明:
+ *   parser - 已解析的命令行
+ * 返回值: 进程退出码，任一检查不通过时返回 1
+ * 备注: 通过 memoryFrameSource 驱动 exportThread，不依赖片段和解码器。
+ *       等间隔导出每 N 帧的最后一帧；关键帧导出只取与上次选中相隔
+ *       不少于最小间隔的关键帧；随机导出相同种子结果相同、不同种子结果不同
+ ***********************************************************/
+static int runSelectionCheck(const QCommandLineParser &parser)
+{
+    const QString workDir = parser.value("work-dir");
+    QDir(workDir).removeRecursively();
+    QDir().mkpath(workDir);
+    QStringList failures;
+
+    QElapsedTimer wallClock;
+    wallClock.start();
+
+    // 等间隔: 帧号 (从 1 开始) 为间隔的整数倍
+    QVector<qint64> expected;
+    for (qint64 number = SELECTION_INTERVAL; number <= SELECTION_FRAMES; number += SELECTION_INTERVAL)
+    {
+        expected.append(number);
+    }
+    const QVector<qint64> interval = runSelection(workDir, "interval", 0, 0);
+    if (interval != expected)
+    {
+        failures << "interval phase";
+    }
+
+    // 关键帧: 第一帧必选，之后取首个与上次选中相隔不少于最小间隔的关键帧
+    expected.clear();
+    qint64 lastPtsUs = -1;
+    for (int index = 0; index < SELECTION_FRAMES; index += SELECTION_GOP)
+    {
+        const qint64 ptsUs = static_cast<qint64>(index * 1000000 / SELECTION_FPS);
+        if (lastPtsUs < 0 || ptsUs - lastPtsUs >= SELECTION_KEYFRAME_GAP_MS * 1000LL)
+        {
+            expected.append(index + 1);
+            lastPtsUs = ptsUs;
+        }
+    }
+    const QVector<qint64> keyframes = runSelection(workDir, "keyframes", 3, 0);
+    if (keyframes != expected)
+    {
+        failures << "keyframe gap";
+    }
+
+    // 随机: 同一种子两次结果相同，换种子结果不同
+    const QVector<qint64> randomA = runSelection(workDir, "random_a", 1, 42);
+    const QVector<qint64> randomB = runSelection(workDir, "random_b", 1, 42);
+    const QVector<qint64> randomC = runSelection(workDir, "random_c", 1, 43);
+    if (randomA.size() != SELECTION_RANDOM_COUNT ||
+        std::adjacent_find(randomA.begin(), randomA.end()) != randomA.end() ||
+        randomA.first() < 1 || randomA.last() > SELECTION_FRAMES)
+    {
+        failures << "random count";
+    }
+    if (randomA != randomB)
+    {
+        failures << "random seed determinism";
+    }
+    if (randomA == randomC)
+    {
+        failures << "random seed ignored";
+    }
+    const qint64 wallMs = wallClock.elapsed();
+
+    auto toArray = [](const QVector<qint64> &frames) {
+        QJsonArray array;
+        for (qint64 number : frames)
+        {
+            array.append(static_cast<double>(number));
+        }
+        return array;
+    };
+    QJsonObject result;
+    result["intervalFrames"] = toArray(interval);
+    result["keyframeFrames"] = toArray(keyframes);
+    result["randomFrames"] = toArray(randomA);
+    result["wallMs"] = static_cast<double>(wallMs);
+    result["exportFps"] = wallMs > 0 ? SELECTION_FRAMES * 5 * 1000.0 / wallMs : 0.0;
+    result["peakRssBytes"] = static_cast<double>(pipelineStats::peakRssBytes());
+    QTextStream(stdout) << QJsonDocument(result).toJson(QJsonDocument::Compact) << "\n";
+
+    if (!parser.isSet("keep-output"))
+    {
+        QDir(workDir).removeRecursively();
+    }
+    if (!failures.isEmpty())
+    {
+        QTextStream(stderr) << "selection check failed: " << failures.join(", ") << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+/***********************************************************
+ * 函数名称: runChild
+ * 函数功能: 主进程: 启动子进程并合并其输出的结果
+ * 参数说明:
+ *   arguments - 子进程命令行参数
+ *   timeoutMs - 超时时间(毫秒)
+ *   result    - 用例结果，成功时合并子进程输出的 JSON，失败时写入 error
+ * 返回值: 无
+ * 备注: 子进程标准错误直接转发
+ ***********************************************************/
+static void runChild(const QStringList &arguments, int timeoutMs, QJsonObject &result)
+{
+    QProcess child;
+    child.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    child.start(QCoreApplication::applicationFilePath(), arguments);
+
+    if (!child.waitForFinished(timeoutMs))
+    {
+        child.kill();
+        child.waitForFinished();
+        result["error"] = "timeout";
+    }
+    else if (child.exitStatus() != QProcess::NormalExit || child.exitCode() != 0)
+    {
+        result["error"] = QString("exit code %1").arg(child.exitCode());
+    }
+    else
+    {
+        const QList<QByteArray> lines = child.readAllStandardOutput().trimmed().split('\n');
+        const QJsonObject measured = QJsonDocument::fromJson(lines.last()).object();
+        for (auto it = measured.constBegin(); it != measured.constEnd(); ++it)
+        {
+            result[it.key()] = it.value();
+        }
+    }
+}
+
+/***********************************************************
+ * 函数名称: runSuite
+ * 函数功能: 主进程: 执行全部用例并汇总
+ * 参数说明:
+ *   parser - 已解析的命令行
+ * 返回值: 进程退出码
+ * 备注: 单个用例失败时记录错误并继续
+ ***********************************************************/
+static int runSuite(const QCommandLineParser &parser)
+{
+    QTextStream out(stdout);
+    const bool quick = parser.isSet("quick");
+    const QString backend = parser.value("backend");
+    const bool rawOnly = parser.isSet("raw") || backend == "memory";
+    const QString clipDir = parser.value("clips-dir");
+    const QString workRoot = parser.value("work-dir");
+    const int timeoutMs = parser.value("timeout").toInt() * 1000;
+    const QRegularExpression filter(parser.value("filter"));
+
+    QStringList formats;
+    formats << "jpg";
+    if (!quick)
+    {
+        formats << "png";
+    }
+
+    QJsonArray results;
+    int failures = 0;
+
+    // 选帧检查: 不依赖片段，用合成内存帧验证各导出模式选出的帧号
+    const QString selectionCaseId = "selection/memory";
+    if (filter.match(selectionCaseId).hasMatch())
+    {
+        const QString workDir = QDir(workRoot).filePath("selection");
+        QStringList arguments;
+        arguments << "--run-case" << "--check-selection" << "--work-dir" << workDir;
+        if (parser.isSet("keep-output"))
+        {
+            arguments << "--keep-output";
+        }
+
+        QJsonObject result;
+        result["case"] = selectionCaseId;
+        result["mode"] = "selection";
+        result["backend"] = "memory";
+        runChild(arguments, timeoutMs, result);
+
+        if (result.contains("error"))
+        {
+            failures++;
+            out << selectionCaseId << ": " << result["error"].toString() << "\n";
+        }
+        else
+        {
+            out << selectionCaseId << ": ok\n";
+        }
+        out.flush();
+        results.append(result);
+    }
+
+    for (const clipSpec &spec : defaultClipSpecs(quick))
+    {
+        QString error;
+        const QString clipPath = prepareClip(spec, clipDir, rawOnly, &error);
+        if (clipPath.isEmpty())
+        {
+            out << "skip " << spec.name() << ": " << error << "\n";
+            out.flush();
+            continue;
+        }
+
+        for (const modeCase &modeEntry : MODE_CASES)
+        {
+            for (const QString &format : formats)
+            {
+                const QString caseId = QString("%1/%2/%3").arg(spec.name()).arg(modeEntry.name).arg(format);
+                if (!filter.match(caseId).hasMatch())
+                {
+                    continue;
+                }
+
+                const QString workDir = QDir(workRoot).filePath(QString(caseId).replace('/', '_'));
+                QStringList arguments;
+                arguments << "--run-case"
+                          << "--input" << clipPath
+                          << "--work-dir" << workDir
+                          << "--mode" << QString::number(modeEntry.mode)
+                          << "--interval" << QString::number(modeEntry.interval)
+                          << "--format" << format
+                          << "--quality" << parser.value("quality")
+                          << "--backend" << backend;
+
+                QJsonObject result;
+                result["case"] = caseId;
+                result["clip"] = spec.name();
+                result["width"] = spec.width;
+                result["height"] = spec.height;
+                result["fps"] = static_cast<double>(spec.fpsNum) / spec.fpsDen;
+                result["gop"] = spec.gop;
+                result["pixelFormat"] = spec.pixelFormat;
+                result["container"] = rawOnly ? "y4m" : "mp4";
+                result["mode"] = modeEntry.name;
+                result["format"] = format;
+                result["backend"] = backend.isEmpty() ? QString("auto") : backend;
+                runChild(arguments, timeoutMs, result);
+
+                if (result.contains("error"))
+                {
+                    failures++;
+                    out << caseId << ": " << result["error"].toString() << "\n";
+                }
+                else
+                {
+                    out << caseId << ": " << QString::number(result["exportFps"].toDouble(), 'f', 1) << " fps, peak "
+                        << QString::number(result["peakRssBytes"].toDouble() / 1048576.0, 'f', 0) << " MB\n";
+                }
+                out.flush();
+                results.append(result);
+
+                if (!parser.isSet("keep-output"))
+                {
+                    QDir(workDir).removeRecursively();
+                }
+            }
+        }
+
+        // 慢速消费: 只适用于 Qt 多媒体后端读取 MP4 片段
+        const QString queueCaseId = QString("%1/slowconsumer/qt").arg(spec.name());
+        if (rawOnly || !(backend.isEmpty() || backend == "qt") || !filter.match(queueCaseId).hasMatch())
+        {
+            continue;
+        }
+
+        QStringList arguments;
+        arguments << "--run-case" << "--check-queue"
+                  << "--input" << clipPath
+                  << "--consumer-delay-ms" << QString::number(SLOW_CONSUMER_DELAY_MS);
+
+        QJsonObject result;
+        result["case"] = queueCaseId;
+        result["clip"] = spec.name();
+        result["width"] = spec.width;
+        result["height"] = spec.height;
+        result["fps"] = static_cast<double>(spec.fpsNum) / spec.fpsDen;
+        result["gop"] = spec.gop;
+        result["pixelFormat"] = spec.pixelFormat;
+        result["container"] = "mp4";
+        result["mode"] = "slowconsumer";
+        result["backend"] = "qt";
+        runChild(arguments, timeoutMs, result);
+
+        if (result.contains("error"))
+        {
+            failures++;
+            out << queueCaseId << ": " << result["error"].toString() << "\n";
+        }
+        else
+        {
+            out << queueCaseId << ": peak queue " << result["peakQueuedFrames"].toInt()
+                << " frames (limit " << result["queueLimit"].toInt() << ")\n";
+        }
+        out.flush();
+        results.append(result);
+    }
+
+    QJsonObject host;
+    host["cpuArchitecture"] = QSysInfo::currentCpuArchitecture();
+    host["kernel"] = QSysInfo::kernelType() + " " + QSysInfo::kernelVersion();
+    host["product"] = QSysInfo::prettyProductName();
+    host["hostName"] = QSysInfo::machineHostName();
+    host["logicalCores"] = QThread::idealThreadCount();
+
+    QJsonObject document;
+    document["schema"] = 1;
+    document["generatedAt"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    document["host"] = host;
+    document["results"] = results;
+
+    QFile file(parser.value("output"));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        out << "cannot write " << file.fileName() << "\n";
+        return 2;
+    }
+    file.write(QJsonDocument(document).toJson(QJsonDocument::Indented));
+    out << "results written to " << file.fileName() << "\n";
+    return failures == 0 ? 0 : 1;
+}
+
+/***********************************************************
+ * 函数名称: main
+ * 函数功能: 程序入口
+ * 参数说明:
+ *   argc, argv - 命令行参数
+ * 返回值: 进程退出码
+ * 备注: 带 --run-case 时作为子进程执行单个用例
+ ***********************************************************/
+int main(int argc, char *argv[])
+{
+    bool childMode = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (qstrcmp(argv[i], "--run-case") == 0)
+        {
+            childMode = true;
+        }
+    }
+
+    // 子进程需要多媒体后端，无显示环境时使用 offscreen 平台
+    if (childMode && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QScopedPointer<QCoreApplication> app(childMode ? new QGuiApplication(argc, argv)
+                                                   : new QCoreApplication(argc, argv));
+    QCoreApplication::setApplicationName("videoScreenshotBench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Export pipeline benchmark for videoScreenshot");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"quick", "Run the small smoke-test matrix only."},
+        {"raw", "Feed the generated Y4M clips directly instead of encoding them to MP4."},
+        {"clips-dir", "Directory for cached synthetic clips.", "dir", "bench_clips"},
+        {"work-dir", "Scratch directory for exported frames.", "dir", "bench_work"},
+        {"output", "Result file.", "file", "bench_results.json"},
+        {"filter", "Only run cases whose id matches this regular expression.", "regex", "."},
+        {"timeout", "Per-case timeout in seconds.", "seconds", "600"},
+        {"quality", "Image quality passed to the encoder (-1 = default).", "quality", "-1"},
+        {"keep-output", "Keep exported frames after each case."},
+        {"backend", "Frame source: qt, libav, or memory (Y4M clips preloaded, no I/O or decode).", "name"},
+        {"run-case", "Internal: run a single case in this process."},
+        {"input", "Internal: clip path.", "file"},
+        {"mode", "Internal: export mode.", "mode", "0"},
+        {"interval", "Internal: interval frames.", "frames", "30"},
+        {"format", "Internal: image format.", "format", "jpg"},
+        {"check-queue", "Internal: read the clip through the Qt backend with a slow consumer and check the frame queue bound."},
+        {"consumer-delay-ms", "Internal: pause after each frame in --check-queue.", "ms", "100"},
+        {"check-selection", "Internal: export synthetic in-memory frames and check interval phase, random seed determinism and keyframe gap."},
+    });
+    parser.process(*app);
+
+    if (!childMode)
+    {
+        return runSuite(parser);
+    }
+    if (parser.isSet("check-selection"))
+    {
+        return runSelectionCheck(parser);
+    }
+    return parser.isSet("check-queue") ? runQueueCheck(parser) : runCase(*app, parser);
+}
@@ -0,0 +1,300 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: syntheticclip.cpp
+ *
+ * 模块描述:
+ *   该模块实现了基准测试使用的合成视频片段生成器。画面由渐变背景、
+ *   移动方块、整数哈希噪声和每秒一次的场景切换组成，只使用整数运算，
+ *   保证跨编译器和跨平台的确定性。
+ *
+ * 主要功能:
+ *   1. 生成 Y4M 原始片段
+ *   2. 调用本地 ffmpeg 按指定 GOP 压缩为 H.264 片段
+ *
+ * 函数列表:
+ *   1. clipSpec::name            - 生成片段规格名称
+ *   2. defaultClipSpecs          - 获取默认片段规格列表
+ *   3. generateY4M               - 生成 Y4M 原始片段
+ *   4. encodeClip                - 将 Y4M 片段压缩为 MP4
+ *   5. prepareClip               - 准备片段(已存在则直接复用)
+ *   6. pixelHash                 - 像素坐标和帧号的整数哈希
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 场景切换改为每秒一次，4 秒的片段内也有场景切换
+ *     * 缓存文件名带生成器版本，画面算法变化后旧缓存不再复用
+ ***********************************************************/
+
+#include "syntheticclip.h"
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QStandardPaths>
+
+// 片段画面算法的版本，修改画面生成方式时加一，旧的缓存片段随之失效
+static const int CLIP_GENERATOR_VERSION = 2;
+
+/***********************************************************
+ * 函数名称: pixelHash
+ * 函数功能: 像素坐标和帧号的整数哈希
+ * 参数说明:
+ *   x, y  - 像素坐标
+ *   frame - 帧号
+ * 返回值: 32位哈希值
+ * 备注: 用于生成确定性的噪声
+ ***********************************************************/
+static quint32 pixelHash(quint32 x, quint32 y, quint32 frame)
+{
+    quint32 h = x * 73856093u ^ y * 19349663u ^ frame * 83492791u;
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    h ^= h >> 15;
+    return h;
+}
+
+/***********************************************************
+ * 函数名称: clipSpec::name
+ * 函数功能: 生成片段规格名称
+ * 参数说明: 无
+ * 返回值: 形如 1920x1080_30fps_gop30_yuv420p_4s 的名称
+ * 备注: 名称同时作为缓存文件名
+ ***********************************************************/
+QString clipSpec::name() const
+{
+    const QString fps = fpsDen == 1 ? QString::number(fpsNum)
+                                    : QString::number(static_cast<double>(fpsNum) / fpsDen, 'f', 2);
+    return QString("%1x%2_%3fps_gop%4_%5_%6s")
+        .arg(width)
+        .arg(height)
+        .arg(fps)
+        .arg(gop)
+        .arg(pixelFormat)
+        .arg(seconds);
+}
+
+/***********************************************************
+ * 函数名称: defaultClipSpecs
+ * 函数功能: 获取默认片段规格列表
+ * 参数说明:
+ *   quick - 为 true 时只返回两个小规格，用于快速冒烟测试
+ * 返回值: 片段规格列表
+ * 备注: 覆盖多种分辨率、帧率、GOP 和像素格式
+ ***********************************************************/
+QList<clipSpec> defaultClipSpecs(bool quick)
+{
+    QList<clipSpec> specs;
+    specs << clipSpec{640, 360, 25, 1, 25, "yuv420p", 4}
+          << clipSpec{1280, 720, 30, 1, 30, "yuv420p", 4};
+    if (quick)
+    {
+        return specs;
+    }
+
+    specs << clipSpec{1920, 1080, 30, 1, 250, "yuv420p", 4}
+          << clipSpec{1920, 1080, 60, 1, 1, "yuv420p", 4}
+          << clipSpec{1920, 1080, 30000, 1001, 30, "yuv422p", 4}
+          << clipSpec{1920, 1080, 30, 1, 30, "yuv444p", 4}
+          << clipSpec{3840, 2160, 30, 1, 60, "yuv420p", 4};
+    return specs;
+}
+
+/***********************************************************
+ * 函数名称: generateY4M
+ * 函数功能: 生成 Y4M 原始片段
+ * 参数说明:
+ *   spec - 片段规格
+ *   path - 输出文件路径
+ * 返回值: 生成成功返回 true
+ * 备注: 逐帧生成，内存占用只有一帧
+ ***********************************************************/
+bool generateY4M(const clipSpec &spec, const QString &path)
+{
+    int chromaWidth = spec.width;
+    int chromaHeight = spec.height;
+    QString colorspace = "444";
+    if (spec.pixelFormat == "yuv420p")
+    {
+        chromaWidth = (spec.width + 1) / 2;
+        chromaHeight = (spec.height + 1) / 2;
+        colorspace = "420jpeg";
+    }
+    else if (spec.pixelFormat == "yuv422p")
+    {
+        chromaWidth = (spec.width + 1) / 2;
+        colorspace = "422";
+    }
+    else if (spec.pixelFormat != "yuv444p")
+    {
+        return false;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+
+    const QByteArray header = QString("YUV4MPEG2 W%1 H%2 F%3:%4 Ip A1:1 C%5\n")
+                                  .arg(spec.width)
+                                  .arg(spec.height)
+                                  .arg(spec.fpsNum)
+                                  .arg(spec.fpsDen)
+                                  .arg(colorspace)
+                                  .toLatin1();
+    file.write(header);
+
+    const int frameTotal = spec.seconds * spec.fpsNum / spec.fpsDen;
+    // 场景每秒切换一次，短片段内也能测到场景变化过滤
+    const int sceneLength = qMax(1, spec.fpsNum / spec.fpsDen);
+    const int boxSize = qMax(8, spec.width / 10);
+
+    QByteArray lumaPlane(spec.width * spec.height, 0);
+    QByteArray chromaPlane(chromaWidth * chromaHeight * 2, 0);
+
+    for (int frame = 0; frame < frameTotal; ++frame)
+    {
+        const int scene = frame / sceneLength;
+        const int boxX = (frame * 7 + scene * 131) % qMax(1, spec.width - boxSize);
+        const int boxY = (frame * 3 + scene * 71) % qMax(1, spec.height - boxSize);
+
+        uchar *luma = reinterpret_cast<uchar *>(lumaPlane.data());
+        for (int y = 0; y < spec.height; ++y)
+        {
+            uchar *row = luma + y * spec.width;
+            const bool boxRow = y >= boxY && y < boxY + boxSize;
+            for (int x = 0; x < spec.width; ++x)
+            {
+                int value = ((x * 255 / spec.width + y * 255 / spec.height) / 2 + frame * 2 + scene * 64) & 255;
+                if (boxRow && x >= boxX && x < boxX + boxSize)
+                {
+                    value = 235;
+                }
+                value += static_cast<int>(pixelHash(x, y, frame) & 15) - 8;
+                row[x] = static_cast<uchar>(qBound(16, value, 235));
+            }
+        }
+
+        uchar *cb = reinterpret_cast<uchar *>(chromaPlane.data());
+        uchar *cr = cb + chromaWidth * chromaHeight;
+        for (int y = 0; y < chromaHeight; ++y)
+        {
+            for (int x = 0; x < chromaWidth; ++x)
+            {
+                const int u = ((x * 255 / chromaWidth) + scene * 50 + frame) & 255;
+                const int v = ((y * 255 / chromaHeight) + scene * 90) & 255;
+                cb[y * chromaWidth + x] = static_cast<uchar>(qBound(16, u, 240));
+                cr[y * chromaWidth + x] = static_cast<uchar>(qBound(16, v, 240));
+            }
+        }
+
+        file.write("FRAME\n", 6);
+        file.write(lumaPlane);
+        file.write(chromaPlane);
+    }
+
+    return file.error() == QFileDevice::NoError;
+}
+
+/***********************************************************
+ * 函数名称: encodeClip
+ * 函数功能: 将 Y4M 片段压缩为 MP4
+ * 参数说明:
+ *   spec    - 片段规格
+ *   y4mPath - 输入 Y4M 文件
+ *   mp4Path - 输出 MP4 文件
+ *   error   - 失败时返回错误描述
+ * 返回值: 压缩成功返回 true
+ * 备注: 使用单线程 x264 并关闭场景切换检测，保证 GOP 固定且结果可复现
+ ***********************************************************/
+bool encodeClip(const clipSpec &spec, const QString &y4mPath, const QString &mp4Path, QString *error)
+{
+    const QString ffmpeg = QStandardPaths::findExecutable("ffmpeg");
+    if (ffmpeg.isEmpty())
+    {
+        if (error != nullptr)
+        {
+            *error = "ffmpeg not found in PATH";
+        }
+        return false;
+    }
+
+    QStringList arguments;
+    arguments << "-y" << "-loglevel" << "error"
+              << "-i" << y4mPath
+              << "-c:v" << "libx264" << "-preset" << "veryfast" << "-threads" << "1"
+              << "-g" << QString::number(spec.gop)
+              << "-keyint_min" << QString::number(spec.gop)
+              << "-sc_threshold" << "0"
+              << "-pix_fmt" << spec.pixelFormat
+              << mp4Path;
+
+    QProcess process;
+    process.start(ffmpeg, arguments);
+    if (!process.waitForFinished(-1) || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0)
+    {
+        if (error != nullptr)
+        {
+            *error = QString::fromLocal8Bit(process.readAllStandardError()).trimmed();
+        }
+        QFile::remove(mp4Path);
+        return false;
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: prepareClip
+ * 函数功能: 准备片段(已存在则直接复用)
+ * 参数说明:
+ *   spec    - 片段规格
+ *   clipDir - 片段缓存目录
+ *   rawOnly - 为 true 时只生成 Y4M，不压缩
+ *   error   - 失败时返回错误描述
+ * 返回值: 可用于导出的片段路径，失败返回空字符串
+ * 备注: 缓存文件名带生成器版本，用例名称仍为规格名称
+ ***********************************************************/
+QString prepareClip(const clipSpec &spec, const QString &clipDir, bool rawOnly, QString *error)
+{
+    QDir().mkpath(clipDir);
+    const QString cacheName = QString("%1_v%2").arg(spec.name()).arg(CLIP_GENERATOR_VERSION);
+    const QString y4mPath = QDir(clipDir).filePath(cacheName + ".y4m");
+    const QString mp4Path = QDir(clipDir).filePath(cacheName + ".mp4");
+
+    if (!rawOnly && QFileInfo::exists(mp4Path))
+    {
+        return mp4Path;
+    }
+
+    if (!QFileInfo::exists(y4mPath) && !generateY4M(spec, y4mPath))
+    {
+        if (error != nullptr)
+        {
+            *error = "failed to generate " + y4mPath;
+        }
+        QFile::remove(y4mPath);
+        return QString();
+    }
+
+    if (rawOnly)
+    {
+        return y4mPath;
+    }
+    return encodeClip(spec, y4mPath, mp4Path, error) ? mp4Path : QString();
+}
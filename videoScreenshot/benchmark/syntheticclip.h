@@ -0,0 +1,65 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: syntheticclip.h
+ *
+ * 模块描述:
+ *   该模块定义了基准测试使用的合成视频片段生成器。画面完全由分辨率、帧号
+ *   和固定种子决定，同一规格在任何机器上生成的原始帧逐字节一致。
+ *
+ * 主要功能:
+ *   1. 描述片段规格(分辨率、帧率、GOP、像素格式、时长)
+ *   2. 生成 Y4M 原始片段
+ *   3. 调用本地 ffmpeg 按指定 GOP 压缩为 H.264 片段
+ *
+ * 函数列表:
+ *   1. clipSpec::name            - 生成片段规格名称
+ *   2. defaultClipSpecs          - 获取默认片段规格列表
+ *   3. generateY4M               - 生成 Y4M 原始片段
+ *   4. encodeClip                - 将 Y4M 片段压缩为 MP4
+ *   5. prepareClip               - 准备片段(已存在则直接复用)
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#ifndef SYNTHETICCLIP_H
+#define SYNTHETICCLIP_H
+
+#include <QString>
+#include <QList>
+
+struct clipSpec
+{
+    int width;           // 宽度
+    int height;          // 高度
+    int fpsNum;          // 帧率分子
+    int fpsDen;          // 帧率分母
+    int gop;             // 关键帧间隔
+    QString pixelFormat; // 像素格式(yuv420p/yuv422p/yuv444p)
+    int seconds;         // 时长(秒)
+
+    QString name() const; // 生成片段规格名称
+};
+
+QList<clipSpec> defaultClipSpecs(bool quick);                 // 获取默认片段规格列表
+bool generateY4M(const clipSpec &spec, const QString &path);  // 生成 Y4M 原始片段
+bool encodeClip(const clipSpec &spec, const QString &y4mPath,
+                const QString &mp4Path, QString *error);      // 将 Y4M 片段压缩为 MP4
+QString prepareClip(const clipSpec &spec, const QString &clipDir,
+                    bool rawOnly, QString *error);            // 准备片段(已存在则直接复用)
+
+#endif // SYNTHETICCLIP_H
@@ -0,0 +1,530 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: colorconvert.cpp
+ *
+ * 模块描述:
+ *   该模块实现了原始帧到 RGB32 图像的颜色转换。输入按有限范围(16~235)
+ *   处理，720p 及以上使用 BT.709 系数，以下使用 BT.601 系数，
+ *   全部使用 8 位定点整数运算。
+ *   10bit 输入在同一遍内完成矩阵变换、传递函数、色调映射和 8bit 编码：
+ *   矩阵变换得到 12 位精度的非线性 R'G'B' 下标，再查一张按
+ *   (传递特性, 色调映射) 预先计算的 4096 项表直接得到 8bit 输出。
+ *   HDR 帧使用 BT.2020 系数，色调映射按通道进行，不做色域映射。
+ *
+ * 主要功能:
+ *   1. YUV(420/422/444/NV12)/灰度 到 RGB32 的转换
+ *   2. 按行区间转换到调用方提供的缓冲区
+ *   3. P010/YUV420P10 的 HDR 色调映射，支持 AVX2 时每次处理 8 个像素
+ *
+ * 函数列表:
+ *   1. convertFrameToImage       - 整帧转换为 QImage
+ *   2. convertRowsToRgb32        - 转换指定行区间到缓冲区
+ *   3. clampByte                 - 限制到 0~255
+ *   4. hasAvx2                   - 运行时是否支持 AVX2
+ *   5. toneMapTable              - 获取色调映射查找表
+ *   6. convertRow10              - 转换一行 10bit 像素
+ *   7. convertRow10Avx2          - 用 AVX2 转换一行 10bit 像素
+ *   8. convertFrameToThumbnail   - 按最近邻缩小并转换为 QImage
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 增加 P010/YUV420P10 到 RGB32 的单遍转换和 HDR 色调映射
+ *     * 增加缩小转换，只转换采样到的行，用于多画面预览
+ ***********************************************************/
+
+#include "colorconvert.h"
+#include <QVector>
+#include <cmath>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define COLORCONVERT_AVX2
+#define AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && defined(__AVX2__)
+#include <immintrin.h>
+#define COLORCONVERT_AVX2
+#define AVX2_TARGET
+#endif
+
+namespace
+{
+    // 定点系数(乘以256)
+    struct yuvCoefficients
+    {
+        int y;
+        int rv;
+        int gu;
+        int gv;
+        int bu;
+    };
+
+    const yuvCoefficients BT601 = {298, 409, -100, -208, 516};
+    const yuvCoefficients BT709 = {298, 459, -55, -136, 541};
+
+    // 10bit 输入的定点系数(乘以4096)，把有限范围样本换算为 0~4095 的查表下标
+    struct wideCoefficients
+    {
+        int y;
+        int rv;
+        int gu;
+        int gv;
+        int bu;
+    };
+
+    const int TONE_LUT_BITS = 12;
+    const int TONE_LUT_SIZE = 1 << TONE_LUT_BITS;
+    const double SDR_WHITE_NITS = 203.0;  // SDR 参考白(BT.2408)
+    const double HDR_PEAK_NITS = 1000.0;  // 假定的母版峰值亮度，映射到 8bit 的 255
+    const double OUTPUT_GAMMA = 2.2;      // 输出按 sRGB 显示近似编码
+    const double HABLE_EXPOSURE = 2.0;    // Hable 曲线的曝光补偿
+
+    /***********************************************************
+     * 函数名称: makeWideCoefficients
+     * 函数功能: 由浮点矩阵系数生成 10bit 定点系数
+     * 参数说明:
+     *   rv, gu, gv, bu - 色差到 R'G'B' 的矩阵系数
+     * 返回值: 定点系数
+     * 备注: 亮度 64~940、色差 64~960 的有限范围映射到 0~4095
+     ***********************************************************/
+    wideCoefficients makeWideCoefficients(double rv, double gu, double gv, double bu)
+    {
+        const double lumaScale = (TONE_LUT_SIZE - 1) / 876.0 * 4096.0;
+        const double chromaScale = (TONE_LUT_SIZE - 1) / 896.0 * 4096.0;
+        wideCoefficients k;
+        k.y = static_cast<int>(std::lround(lumaScale));
+        k.rv = static_cast<int>(std::lround(rv * chromaScale));
+        k.gu = static_cast<int>(std::lround(gu * chromaScale));
+        k.gv = static_cast<int>(std::lround(gv * chromaScale));
+        k.bu = static_cast<int>(std::lround(bu * chromaScale));
+        return k;
+    }
+
+    const wideCoefficients WIDE_BT601 = makeWideCoefficients(1.402, -0.344136, -0.714136, 1.772);
+    const wideCoefficients WIDE_BT709 = makeWideCoefficients(1.5748, -0.187324, -0.468124, 1.8556);
+    const wideCoefficients WIDE_BT2020 = makeWideCoefficients(1.4746, -0.164553, -0.571353, 1.8814);
+
+    // SMPTE ST 2084 EOTF，返回绝对亮度(尼特)
+    double pqToNits(double signal)
+    {
+        const double m1 = 0.1593017578125;
+        const double m2 = 78.84375;
+        const double c1 = 0.8359375;
+        const double c2 = 18.8515625;
+        const double c3 = 18.6875;
+        const double p = std::pow(signal, 1.0 / m2);
+        return 10000.0 * std::pow(qMax(p - c1, 0.0) / (c2 - c3 * p), 1.0 / m1);
+    }
+
+    // ARIB STD-B67 反向 OETF 加系统伽马 1.2 的 OOTF(按通道近似)，返回显示亮度(尼特)
+    double hlgToNits(double signal)
+    {
+        const double a = 0.17883277;
+        const double b = 0.28466892;
+        const double c = 0.55991073;
+        const double scene = signal <= 0.5 ? signal * signal / 3.0 : (std::exp((signal - c) / a) + b) / 12.0;
+        return HDR_PEAK_NITS * std::pow(scene, 1.2);
+    }
+
+    double hableCurve(double x)
+    {
+        const double a = 0.15, b = 0.50, c = 0.10, d = 0.20, e = 0.02, f = 0.30;
+        return (x * (a * x + c * b) + d * e) / (x * (a * x + b) + d * f) - e / f;
+    }
+
+    // 以 SDR 参考白为 1 的线性亮度映射到 0~1
+    double toneMapLinear(double relative, frameView::ToneMap toneMap)
+    {
+        const double peak = HDR_PEAK_NITS / SDR_WHITE_NITS;
+        switch (toneMap)
+        {
+        case frameView::TONEMAP_CLIP:
+            return qMin(relative, 1.0);
+        case frameView::TONEMAP_REINHARD:
+            return relative * (1.0 + relative / (peak * peak)) / (1.0 + relative);
+        default:
+            return hableCurve(HABLE_EXPOSURE * relative) / hableCurve(HABLE_EXPOSURE * peak);
+        }
+    }
+
+    // 各 (传递特性, 色调映射) 组合的查找表：非线性 R'G'B' 下标 -> 8bit 输出
+    struct toneMapTables
+    {
+        qint32 entries[3][3][TONE_LUT_SIZE];
+
+        toneMapTables()
+        {
+            for (int transfer = 0; transfer < 3; ++transfer)
+            {
+                for (int toneMap = 0; toneMap < 3; ++toneMap)
+                {
+                    for (int i = 0; i < TONE_LUT_SIZE; ++i)
+                    {
+                        const double signal = static_cast<double>(i) / (TONE_LUT_SIZE - 1);
+                        double output = signal;
+                        if (transfer != frameView::TRANSFER_SDR)
+                        {
+                            const double nits = transfer == frameView::TRANSFER_PQ ? pqToNits(signal) : hlgToNits(signal);
+                            const double mapped = toneMapLinear(nits / SDR_WHITE_NITS, static_cast<frameView::ToneMap>(toneMap));
+                            output = std::pow(qBound(0.0, mapped, 1.0), 1.0 / OUTPUT_GAMMA);
+                        }
+                        entries[transfer][toneMap][i] = static_cast<qint32>(std::lround(output * 255.0));
+                    }
+                }
+            }
+        }
+    };
+}
+
+/***********************************************************
+ * 函数名称: clampByte
+ * 函数功能: 限制到 0~255
+ * 参数说明:
+ *   value - 输入值
+ * 返回值: 限制后的值
+ * 备注: 无
+ ***********************************************************/
+static inline uint clampByte(int value)
+{
+    return static_cast<uint>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+/***********************************************************
+ * 函数名称: hasAvx2
+ * 函数功能: 运行时是否支持 AVX2
+ * 参数说明: 无
+ * 返回值: 支持返回 true
+ * 备注: GCC/Clang 按 CPU 特性运行时选择；MSVC 仅在以 /arch:AVX2 编译时启用
+ ***********************************************************/
+static bool hasAvx2()
+{
+#if defined(COLORCONVERT_AVX2) && defined(__GNUC__)
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#elif defined(COLORCONVERT_AVX2)
+    return true;
+#else
+    return false;
+#endif
+}
+
+/***********************************************************
+ * 函数名称: toneMapTable
+ * 函数功能: 获取色调映射查找表
+ * 参数说明:
+ *   transfer - 传递特性
+ *   toneMap  - 色调映射方式，SDR 时忽略
+ * 返回值: 4096 项查找表
+ * 备注: 第一次调用时构造全部表(约 150KB)，局部静态变量保证线程安全
+ ***********************************************************/
+static const qint32 *toneMapTable(frameView::Transfer transfer, frameView::ToneMap toneMap)
+{
+    static const toneMapTables tables;
+    return tables.entries[qBound(0, static_cast<int>(transfer), 2)][qBound(0, static_cast<int>(toneMap), 2)];
+}
+
+#ifdef COLORCONVERT_AVX2
+/***********************************************************
+ * 函数名称: convertRow10Avx2
+ * 函数功能: 用 AVX2 转换一行 10bit 像素
+ * 参数说明:
+ *   luma  - 亮度行
+ *   cb    - Cb 行，P010 时为 UV 交错行
+ *   cr    - Cr 行，P010 时不使用
+ *   p010  - 是否为 P010 布局
+ *   width - 行宽(像素)
+ *   out   - 输出行
+ *   lut   - 色调映射查找表
+ *   k     - 定点系数
+ * 返回值: 已转换的像素数(8 的倍数)，余下的像素由调用方处理
+ * 备注: 每次 8 个像素，色度样本复制为两份后与亮度一起扩展到 32 位，
+ *       三个通道的下标用 gather 指令查表
+ ***********************************************************/
+AVX2_TARGET static int convertRow10Avx2(const quint16 *luma, const quint16 *cb, const quint16 *cr, bool p010,
+                                        int width, QRgb *out, const qint32 *lut, const wideCoefficients &k)
+{
+    const __m256i ky = _mm256_set1_epi32(k.y);
+    const __m256i krv = _mm256_set1_epi32(k.rv);
+    const __m256i kgu = _mm256_set1_epi32(k.gu);
+    const __m256i kgv = _mm256_set1_epi32(k.gv);
+    const __m256i kbu = _mm256_set1_epi32(k.bu);
+    const __m256i lumaOffset = _mm256_set1_epi32(64);
+    const __m256i chromaOffset = _mm256_set1_epi32(512);
+    const __m256i rounding = _mm256_set1_epi32(2048);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i maxIndex = _mm256_set1_epi32(TONE_LUT_SIZE - 1);
+    const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xff000000u));
+    const __m128i mask10 = _mm_set1_epi16(0x3ff);
+    const __m128i pickU = _mm_setr_epi8(0, 1, 0, 1, 4, 5, 4, 5, 8, 9, 8, 9, 12, 13, 12, 13);
+    const __m128i pickV = _mm_setr_epi8(2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15);
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        __m128i y16 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(luma + x));
+        __m128i u16;
+        __m128i v16;
+        if (p010)
+        {
+            // 第 x/2 个 UV 对从 x 开始，8 个样本正好是 4 对
+            const __m128i uv = _mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(cb + x)), 6);
+            y16 = _mm_srli_epi16(y16, 6);
+            u16 = _mm_shuffle_epi8(uv, pickU);
+            v16 = _mm_shuffle_epi8(uv, pickV);
+        }
+        else
+        {
+            const __m128i u4 = _mm_and_si128(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(cb + x / 2)), mask10);
+            const __m128i v4 = _mm_and_si128(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(cr + x / 2)), mask10);
+            y16 = _mm_and_si128(y16, mask10);
+            u16 = _mm_unpacklo_epi16(u4, u4);
+            v16 = _mm_unpacklo_epi16(v4, v4);
+        }
+
+        const __m256i c = _mm256_add_epi32(
+            _mm256_mullo_epi32(_mm256_sub_epi32(_mm256_cvtepu16_epi32(y16), lumaOffset), ky), rounding);
+        const __m256i d = _mm256_sub_epi32(_mm256_cvtepu16_epi32(u16), chromaOffset);
+        const __m256i e = _mm256_sub_epi32(_mm256_cvtepu16_epi32(v16), chromaOffset);
+
+        __m256i r = _mm256_srai_epi32(_mm256_add_epi32(c, _mm256_mullo_epi32(krv, e)), 12);
+        __m256i g = _mm256_srai_epi32(_mm256_add_epi32(c, _mm256_add_epi32(_mm256_mullo_epi32(kgu, d),
+                                                                           _mm256_mullo_epi32(kgv, e))), 12);
+        __m256i b = _mm256_srai_epi32(_mm256_add_epi32(c, _mm256_mullo_epi32(kbu, d)), 12);
+        r = _mm256_i32gather_epi32(lut, _mm256_min_epi32(_mm256_max_epi32(r, zero), maxIndex), 4);
+        g = _mm256_i32gather_epi32(lut, _mm256_min_epi32(_mm256_max_epi32(g, zero), maxIndex), 4);
+        b = _mm256_i32gather_epi32(lut, _mm256_min_epi32(_mm256_max_epi32(b, zero), maxIndex), 4);
+
+        const __m256i pixel = _mm256_or_si256(_mm256_or_si256(alpha, _mm256_slli_epi32(r, 16)),
+                                              _mm256_or_si256(_mm256_slli_epi32(g, 8), b));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + x), pixel);
+    }
+    return x;
+}
+#endif
+
+/***********************************************************
+ * 函数名称: convertRow10
+ * 函数功能: 转换一行 10bit 像素
+ * 参数说明:
+ *   frame - 源帧视图，P010 或 YUV420P10
+ *   y     - 行号
+ *   out   - 输出行
+ *   lut   - 色调映射查找表
+ *   k     - 定点系数
+ * 返回值: 无
+ * 备注: 样本按小端读取；支持 AVX2 时先按 8 像素一组处理，余下的像素逐个处理
+ ***********************************************************/
+static void convertRow10(const frameView &frame, int y, QRgb *out, const qint32 *lut, const wideCoefficients &k)
+{
+    const bool p010 = frame.format == frameView::FORMAT_P010;
+    const int chromaRow = y / 2;
+    const quint16 *luma = reinterpret_cast<const quint16 *>(frame.planes[0] + static_cast<qint64>(y) * frame.strides[0]);
+    const quint16 *cb = reinterpret_cast<const quint16 *>(frame.planes[1] + static_cast<qint64>(chromaRow) * frame.strides[1]);
+    const quint16 *cr = p010 ? cb + 1
+                             : reinterpret_cast<const quint16 *>(frame.planes[2] + static_cast<qint64>(chromaRow) * frame.strides[2]);
+    const int shift = p010 ? 6 : 0;
+    const int chromaStep = p010 ? 2 : 1;
+
+    int x = 0;
+#ifdef COLORCONVERT_AVX2
+    if (hasAvx2())
+    {
+        x = convertRow10Avx2(luma, cb, cr, p010, frame.width, out, lut, k);
+    }
+#endif
+    for (; x < frame.width; ++x)
+    {
+        const int cx = (x >> 1) * chromaStep;
+        const int c = (((luma[x] >> shift) & 0x3ff) - 64) * k.y + 2048;
+        const int d = ((cb[cx] >> shift) & 0x3ff) - 512;
+        const int e = ((cr[cx] >> shift) & 0x3ff) - 512;
+        const uint r = static_cast<uint>(lut[qBound(0, (c + k.rv * e) >> 12, TONE_LUT_SIZE - 1)]);
+        const uint g = static_cast<uint>(lut[qBound(0, (c + k.gu * d + k.gv * e) >> 12, TONE_LUT_SIZE - 1)]);
+        const uint b = static_cast<uint>(lut[qBound(0, (c + k.bu * d) >> 12, TONE_LUT_SIZE - 1)]);
+        out[x] = 0xff000000u | (r << 16) | (g << 8) | b;
+    }
+}
+
+/***********************************************************
+ * 函数名称: convertRowsToRgb32
+ * 函数功能: 转换指定行区间到缓冲区
+ * 参数说明:
+ *   frame             - 源帧视图
+ *   firstRow          - 起始行
+ *   rowCount          - 行数
+ *   destination       - 目标缓冲区，第 firstRow 行写到 destination 开头
+ *   destinationStride - 目标行跨度(字节)
+ * 返回值: 格式不支持时返回 false
+ * 备注: 输出为 QImage::Format_RGB32 的内存布局(0xffRRGGBB)；
+ *       10bit 帧按 frame.transfer 和 frame.toneMap 选择查找表
+ ***********************************************************/
+bool convertRowsToRgb32(const frameView &frame, int firstRow, int rowCount,
+                        uchar *destination, int destinationStride)
+{
+    if (!frame.isValid() || firstRow < 0 || rowCount <= 0 || firstRow + rowCount > frame.height)
+    {
+        return false;
+    }
+
+    if (frameView::isHighBitDepth(frame.format))
+    {
+        const wideCoefficients &wide = frame.transfer != frameView::TRANSFER_SDR
+                                           ? WIDE_BT2020
+                                           : (frame.height >= 720 ? WIDE_BT709 : WIDE_BT601);
+        const qint32 *lut = toneMapTable(frame.transfer, frame.toneMap);
+        for (int row = 0; row < rowCount; ++row)
+        {
+            QRgb *out = reinterpret_cast<QRgb *>(destination + static_cast<qint64>(row) * destinationStride);
+            convertRow10(frame, firstRow + row, out, lut, wide);
+        }
+        return true;
+    }
+
+    const yuvCoefficients &k = frame.height >= 720 ? BT709 : BT601;
+
+    for (int row = 0; row < rowCount; ++row)
+    {
+        const int y = firstRow + row;
+        QRgb *out = reinterpret_cast<QRgb *>(destination + static_cast<qint64>(row) * destinationStride);
+        const uchar *luma = frame.planes[0] + static_cast<qint64>(y) * frame.strides[0];
+
+        switch (frame.format)
+        {
+        case frameView::FORMAT_RGB32:
+            memcpy(out, luma, static_cast<size_t>(frame.width) * 4);
+            break;
+
+        case frameView::FORMAT_GRAY8:
+            for (int x = 0; x < frame.width; ++x)
+            {
+                const uint v = clampByte(((luma[x] - 16) * k.y + 128) >> 8);
+                out[x] = 0xff000000u | (v << 16) | (v << 8) | v;
+            }
+            break;
+
+        case frameView::FORMAT_YUV420P:
+        case frameView::FORMAT_YUV422P:
+        case frameView::FORMAT_YUV444P:
+        case frameView::FORMAT_NV12:
+        {
+            const bool verticalSubsample = frame.format == frameView::FORMAT_YUV420P ||
+                                           frame.format == frameView::FORMAT_NV12;
+            const int chromaShift = frame.format == frameView::FORMAT_YUV444P ? 0 : 1;
+            const int chromaRow = verticalSubsample ? y / 2 : y;
+            const uchar *cb = frame.planes[1] + static_cast<qint64>(chromaRow) * frame.strides[1];
+            const uchar *cr = frame.format == frameView::FORMAT_NV12
+                                  ? cb + 1
+                                  : frame.planes[2] + static_cast<qint64>(chromaRow) * frame.strides[2];
+            const int chromaStep = frame.format == frameView::FORMAT_NV12 ? 2 : 1;
+
+            for (int x = 0; x < frame.width; ++x)
+            {
+                const int cx = (x >> chromaShift) * chromaStep;
+                const int c = (luma[x] - 16) * k.y + 128;
+                const int d = cb[cx] - 128;
+                const int e = cr[cx] - 128;
+                const uint r = clampByte((c + k.rv * e) >> 8);
+                const uint g = clampByte((c + k.gu * d + k.gv * e) >> 8);
+                const uint b = clampByte((c + k.bu * d) >> 8);
+                out[x] = 0xff000000u | (r << 16) | (g << 8) | b;
+            }
+            break;
+        }
+
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: convertFrameToImage
+ * 函数功能: 整帧转换为 QImage
+ * 参数说明:
+ *   frame - 源帧视图
+ * 返回值: RGB32 图像，格式不支持时返回空图像
+ * 备注: 返回的图像拥有独立内存，与源帧生命周期无关
+ ***********************************************************/
+QImage convertFrameToImage(const frameView &frame)
+{
+    if (!frame.isValid())
+    {
+        return QImage();
+    }
+
+    QImage image(frame.width, frame.height, QImage::Format_RGB32);
+    if (image.isNull() ||
+        !convertRowsToRgb32(frame, 0, frame.height, image.bits(), image.bytesPerLine()))
+    {
+        return QImage();
+    }
+    return image;
+}
+
+/***********************************************************
+ * 函数名称: convertFrameToThumbnail
+ * 函数功能: 按最近邻缩小并转换为 QImage
+ * 参数说明:
+ *   frame     - 源帧视图
+ *   maxWidth  - 最大宽度
+ *   maxHeight - 最大高度
+ * 返回值: 保持宽高比、不超过给定尺寸的 RGB32 图像，格式不支持时返回空图像
+ * 备注: 只转换被采样到的源行，再在行内按列抽取，缩小到 1/3 时转换量约为整帧的 1/3；
+ *       不放大，目标尺寸不小于源帧时等同于 convertFrameToImage
+ ***********************************************************/
+QImage convertFrameToThumbnail(const frameView &frame, int maxWidth, int maxHeight)
+{
+    if (!frame.isValid() || maxWidth <= 0 || maxHeight <= 0)
+    {
+        return QImage();
+    }
+    if (maxWidth >= frame.width && maxHeight >= frame.height)
+    {
+        return convertFrameToImage(frame);
+    }
+
+    const QSize size = QSize(frame.width, frame.height).scaled(maxWidth, maxHeight, Qt::KeepAspectRatio);
+    const int width = qMax(1, size.width());
+    const int height = qMax(1, size.height());
+    QImage image(width, height, QImage::Format_RGB32);
+    if (image.isNull())
+    {
+        return QImage();
+    }
+
+    // 列下标按 16.16 定点步进，每个输出像素取对应源像素的中心
+    QVector<QRgb> sourceRow(frame.width);
+    const qint64 stepX = (static_cast<qint64>(frame.width) << 16) / width;
+    for (int y = 0; y < height; ++y)
+    {
+        const int sourceY = static_cast<int>((static_cast<qint64>(y) * 2 + 1) * frame.height / (2 * height));
+        if (!convertRowsToRgb32(frame, sourceY, 1, reinterpret_cast<uchar *>(sourceRow.data()), frame.width * 4))
+        {
+            return QImage();
+        }
+        QRgb *out = reinterpret_cast<QRgb *>(image.scanLine(y));
+        qint64 position = stepX / 2;
+        for (int x = 0; x < width; ++x)
+        {
+            out[x] = sourceRow[static_cast<int>(position >> 16)];
+            position += stepX;
+        }
+    }
+    return image;
+}
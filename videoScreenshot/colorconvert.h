@@ -0,0 +1,52 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: colorconvert.h
+ *
+ * 模块描述:
+ *   该模块定义了原始帧到 RGB32 图像的颜色转换接口，支持整帧转换和
+ *   按行区间转换。
+ *
+ * 主要功能:
+ *   1. YUV(420/422/444/NV12)/灰度 到 RGB32 的转换
+ *   2. 按行区间转换到调用方提供的缓冲区
+ *   3. P010/YUV420P10 的 HDR 色调映射，与颜色转换在同一遍内完成
+ *
+ * 函数列表:
+ *   1. convertFrameToImage       - 整帧转换为 QImage
+ *   2. convertRowsToRgb32        - 转换指定行区间到缓冲区
+ *   3. convertFrameToThumbnail   - 按最近邻缩小并转换为 QImage
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 增加 10bit 格式的转换和色调映射
+ *     * 增加缩小转换，只转换采样到的行，用于多画面预览
+ ***********************************************************/
+
+#ifndef COLORCONVERT_H
+#define COLORCONVERT_H
+
+#include <QImage>
+#include "frameview.h"
+
+QImage convertFrameToImage(const frameView &frame);           // 整帧转换为 QImage(RGB32)
+bool convertRowsToRgb32(const frameView &frame, int firstRow, int rowCount,
+                        uchar *destination, int destinationStride); // 转换指定行区间到缓冲区
+QImage convertFrameToThumbnail(const frameView &frame, int maxWidth,
+                               int maxHeight);                      // 按最近邻缩小并转换为 QImage
+
+#endif // COLORCONVERT_H
@@ -0,0 +1,590 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: dedupindex.cpp
+ *
+ * 模块描述:
+ *   该模块实现了持久化的近重复索引。
+ *   主索引文件格式(本机字节序):
+ *     文件头 32 字节: "VSDEDUP1" | 版本 | 段数 | 哈希数 | 已合并的增量字节数
+ *     4 x 65538 个 quint32: 每段的桶起始位置(65537 个有效，1 个对齐填充)
+ *     4 x N 个 quint64: 每段一份按该段段值分桶排列的完整哈希
+ *   每条约 32 字节，1000 万条约 320MB，按需分页载入。同一桶内的哈希
+ *   连续存放，查询时顺序比较，不产生随机访存。
+ *   增量文件为 "<索引>.delta"，每条 8 字节，多个进程可同时追加。
+ *   增量文件只追加不删除(1000 万条约 80MB)：其他进程可能一直以追加方式打开，
+ *   删除后它们的追加会写进已删除的文件。整理只把读到的位置记入新主索引的
+ *   文件头，之后追加的记录仍从增量文件读取。旧版主索引该字段为 0。
+ *
+ * 主要功能:
+ *   1. 内存映射打开主索引，读取增量文件
+ *   2. 按汉明距离查询近重复
+ *   3. 追加新哈希，扫描目录为已有图像建立哈希
+ *   4. 合并增量并重写主索引
+ *
+ * 函数列表:
+ *   1. dedupIndex                - 构造函数
+ *   2. ~dedupIndex               - 析构函数
+ *   3. open                      - 打开索引
+ *   4. close                     - 关闭索引
+ *   5. contains                  - 查询是否存在近重复
+ *   6. add                       - 追加哈希
+ *   7. addDirectory              - 为目录下的图像建立哈希
+ *   8. compact                   - 合并增量并重写主索引
+ *   9. syncDelta                 - 读取其他进程追加的增量
+ *   10. insertDelta              - 将哈希加入内存中的增量桶
+ *   11. scanBucket               - 检查一个桶内的哈希
+ *   12. mapBase                  - 内存映射主索引
+ *   13. unmapBase                - 解除主索引映射
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 查询增量桶时按引用遍历，不再逐桶复制
+ *     * 扫描目录时不再输出进度，新增数量由调用方报告
+ *     * 整理不再删除增量文件，主索引文件头记录已合并的增量字节数，
+ *       以追加方式打开增量文件的其他进程和整理期间的追加都不会丢失
+ *     * 整理经 "<索引>.lock" 锁文件串行执行；查询时发现主索引被其他进程替换则重新映射
+ ***********************************************************/
+
+#include "dedupindex.h"
+#include <QDebug>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QLockFile>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+#include "phash.h"
+
+namespace
+{
+    const char INDEX_MAGIC[8] = {'V', 'S', 'D', 'E', 'D', 'U', 'P', '1'};
+    const quint32 INDEX_VERSION = 1;
+    const int CHUNK_COUNT = 4;           // 段数
+    const int CHUNK_BITS = 16;           // 每段位数
+    const int BUCKET_COUNT = 1 << CHUNK_BITS;
+    const int OFFSET_SLOTS = BUCKET_COUNT + 2; // 每段的起始位置表长度，保持 8 字节对齐
+    const qint64 DELTA_SYNC_INTERVAL_MS = 1000; // 查询时检查增量文件的最小间隔
+    const int THUMB_DECODE_SIZE = 64;           // 建立索引时图像解码的目标尺寸
+    const int COMPACT_LOCK_TIMEOUT_MS = 60000;  // 等待其他进程整理完成的最长时间
+
+    struct indexHeader
+    {
+        char magic[8];
+        quint32 version;
+        quint32 chunks;
+        quint64 count;
+        quint64 deltaOffset; // 已合并到主索引的增量字节数
+    };
+
+    inline quint32 chunkValue(quint64 hash, int chunk)
+    {
+        return static_cast<quint32>(hash >> (chunk * CHUNK_BITS)) & (BUCKET_COUNT - 1);
+    }
+}
+
+/***********************************************************
+ * 函数名称: dedupIndex
+ * 函数功能: 近重复索引的构造函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 无
+ ***********************************************************/
+dedupIndex::dedupIndex() : mapped(nullptr),
+                           baseCount(0),
+                           offsets(nullptr),
+                           tables(nullptr),
+                           deltaStart(0),
+                           baseModifiedMs(-1),
+                           baseSize(-1),
+                           deltaPosition(0)
+{
+}
+
+/***********************************************************
+ * 函数名称: ~dedupIndex
+ * 函数功能: 近重复索引的析构函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 解除映射并关闭文件
+ ***********************************************************/
+dedupIndex::~dedupIndex()
+{
+    close();
+}
+
+/***********************************************************
+ * 函数名称: open
+ * 函数功能: 打开索引
+ * 参数说明:
+ *   fileName - 主索引文件路径
+ *   error    - 返回错误描述，可为空
+ * 返回值: 成功返回 true
+ * 备注: 主索引只做内存映射，打开耗时与索引大小无关；
+ *       主索引不存在时从空索引开始，首次整理时创建
+ ***********************************************************/
+bool dedupIndex::open(const QString &fileName, QString *error)
+{
+    close();
+    if (!mapBase(fileName, error))
+    {
+        close();
+        return false;
+    }
+
+    deltaWriter.setFileName(fileName + ".delta");
+    if (!deltaWriter.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered))
+    {
+        if (error)
+        {
+            *error = deltaWriter.errorString();
+        }
+        close();
+        return false;
+    }
+    indexFileName = fileName;
+    deltaPosition = deltaStart;
+    syncDelta();
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: mapBase
+ * 函数功能: 内存映射主索引
+ * 参数说明:
+ *   fileName - 主索引文件路径
+ *   error    - 返回错误描述，可为空
+ * 返回值: 映射成功或文件不存在返回 true
+ * 备注: 记录映射时的修改时间和大小，syncDelta 据此发现主索引被替换；
+ *       文件不存在时为空索引，增量从头读起
+ ***********************************************************/
+bool dedupIndex::mapBase(const QString &fileName, QString *error)
+{
+    const QFileInfo info(fileName);
+    baseModifiedMs = info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+    baseSize = info.exists() ? info.size() : -1;
+    baseFile.setFileName(fileName);
+    if (!info.exists())
+    {
+        return true;
+    }
+
+    if (!baseFile.open(QIODevice::ReadOnly))
+    {
+        if (error)
+        {
+            *error = baseFile.errorString();
+        }
+        return false;
+    }
+    const qint64 fileSize = baseFile.size();
+    mapped = fileSize >= static_cast<qint64>(sizeof(indexHeader)) ? baseFile.map(0, fileSize) : nullptr;
+    indexHeader header;
+    if (mapped != nullptr)
+    {
+        memcpy(&header, mapped, sizeof(header));
+    }
+    const qint64 tableOffset = static_cast<qint64>(sizeof(indexHeader)) +
+                               static_cast<qint64>(CHUNK_COUNT) * OFFSET_SLOTS * sizeof(quint32);
+    if (mapped == nullptr || memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 ||
+        header.version != INDEX_VERSION || header.chunks != CHUNK_COUNT ||
+        fileSize != tableOffset + static_cast<qint64>(header.count * CHUNK_COUNT * sizeof(quint64)))
+    {
+        if (error)
+        {
+            *error = "Not a dedup index: " + fileName;
+        }
+        unmapBase();
+        return false;
+    }
+    baseCount = static_cast<qint64>(header.count);
+    offsets = reinterpret_cast<const quint32 *>(mapped + sizeof(indexHeader));
+    tables = reinterpret_cast<const quint64 *>(mapped + tableOffset);
+    deltaStart = static_cast<qint64>(header.deltaOffset);
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: unmapBase
+ * 函数功能: 解除主索引映射
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 无
+ ***********************************************************/
+void dedupIndex::unmapBase()
+{
+    if (mapped != nullptr)
+    {
+        baseFile.unmap(mapped);
+        mapped = nullptr;
+    }
+    baseFile.close();
+    baseCount = 0;
+    offsets = nullptr;
+    tables = nullptr;
+    deltaStart = 0;
+}
+
+/***********************************************************
+ * 函数名称: close
+ * 函数功能: 关闭索引
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 新增的哈希已在增量文件中，关闭不会丢失
+ ***********************************************************/
+void dedupIndex::close()
+{
+    unmapBase();
+    baseModifiedMs = -1;
+    baseSize = -1;
+    deltaWriter.close();
+    indexFileName.clear();
+    deltaPosition = 0;
+    deltaHashes.clear();
+    deltaBuckets.clear();
+    syncTimer.invalidate();
+}
+
+/***********************************************************
+ * 函数名称: contains
+ * 函数功能: 查询是否存在近重复
+ * 参数说明:
+ *   hash        - 候选哈希
+ *   maxDistance - 最大汉明距离，超过 MAX_DISTANCE 时按 MAX_DISTANCE 处理
+ * 返回值: 存在距离不超过 maxDistance 的哈希时返回 true
+ * 备注: 每段探查段值距离不超过 maxDistance/4 的桶，距离 6 时共 68 个桶；
+ *       1000 万条时每桶约 150 条，一次查询比较约一万次，耗时为微秒级。
+ *       每秒最多检查一次增量文件和主索引，看到其他进程新追加的哈希和整理结果
+ ***********************************************************/
+bool dedupIndex::contains(quint64 hash, int maxDistance)
+{
+    if (!isOpen())
+    {
+        return false;
+    }
+    if (!syncTimer.isValid() || syncTimer.elapsed() >= DELTA_SYNC_INTERVAL_MS)
+    {
+        syncDelta();
+    }
+
+    const int distance = qBound(0, maxDistance, MAX_DISTANCE);
+    const int radius = distance / CHUNK_COUNT;
+    for (int chunk = 0; chunk < CHUNK_COUNT; ++chunk)
+    {
+        const quint32 value = chunkValue(hash, chunk);
+        if (scanBucket(chunk, value, hash, distance))
+        {
+            return true;
+        }
+        for (int i = 0; radius >= 1 && i < CHUNK_BITS; ++i)
+        {
+            const quint32 first = value ^ (1u << i);
+            if (scanBucket(chunk, first, hash, distance))
+            {
+                return true;
+            }
+            for (int j = i + 1; radius >= 2 && j < CHUNK_BITS; ++j)
+            {
+                if (scanBucket(chunk, first ^ (1u << j), hash, distance))
+                {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/***********************************************************
+ * 函数名称: scanBucket
+ * 函数功能: 检查一个桶内的哈希
+ * 参数说明:
+ *   chunk       - 段号
+ *   value       - 段值，即桶号
+ *   hash        - 候选哈希
+ *   maxDistance - 最大汉明距离
+ * 返回值: 桶内存在足够接近的哈希时返回 true
+ * 备注: 依次检查主索引和增量中的同一个桶
+ ***********************************************************/
+bool dedupIndex::scanBucket(int chunk, quint32 value, quint64 hash, int maxDistance) const
+{
+    if (tables != nullptr)
+    {
+        const quint32 *chunkOffsets = offsets + static_cast<qint64>(chunk) * OFFSET_SLOTS;
+        const quint64 *table = tables + static_cast<qint64>(chunk) * baseCount;
+        for (quint32 i = chunkOffsets[value]; i < chunkOffsets[value + 1]; ++i)
+        {
+            if (hammingDistance(table[i], hash) <= maxDistance)
+            {
+                return true;
+            }
+        }
+    }
+
+    const QHash<quint32, QVector<quint64> >::const_iterator bucket =
+        deltaBuckets.constFind((static_cast<quint32>(chunk) << CHUNK_BITS) | value);
+    if (bucket == deltaBuckets.constEnd())
+    {
+        return false;
+    }
+    const QVector<quint64> &stored = bucket.value();
+    for (int i = 0; i < stored.size(); ++i)
+    {
+        if (hammingDistance(stored[i], hash) <= maxDistance)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/***********************************************************
+ * 函数名称: add
+ * 函数功能: 追加哈希
+ * 参数说明:
+ *   hash - 哈希
+ * 返回值: 写入增量文件成功返回 true
+ * 备注: 每条记录一次 8 字节的追加写，多个进程同时追加不会交错
+ ***********************************************************/
+bool dedupIndex::add(quint64 hash)
+{
+    if (!isOpen())
+    {
+        return false;
+    }
+    if (deltaWriter.write(reinterpret_cast<const char *>(&hash), sizeof(hash)) != sizeof(hash))
+    {
+        qDebug() << "Dedup index append failed:" << deltaWriter.errorString();
+        return false;
+    }
+    insertDelta(hash);
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: insertDelta
+ * 函数功能: 将哈希加入内存中的增量桶
+ * 参数说明:
+ *   hash - 哈希
+ * 返回值: 无
+ * 备注: 已存在的哈希跳过，本进程追加的记录在同步时再次读到也只保留一份
+ ***********************************************************/
+void dedupIndex::insertDelta(quint64 hash)
+{
+    const quint32 firstKey = chunkValue(hash, 0);
+    QVector<quint64> &firstBucket = deltaBuckets[firstKey];
+    if (firstBucket.contains(hash))
+    {
+        return;
+    }
+    firstBucket.append(hash);
+    for (int chunk = 1; chunk < CHUNK_COUNT; ++chunk)
+    {
+        deltaBuckets[(static_cast<quint32>(chunk) << CHUNK_BITS) | chunkValue(hash, chunk)].append(hash);
+    }
+    deltaHashes.append(hash);
+}
+
+/***********************************************************
+ * 函数名称: syncDelta
+ * 函数功能: 读取增量文件中新追加的记录
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 主索引的修改时间或大小变化说明其他进程已整理并替换了主索引，
+ *       此时重新映射，丢弃内存中的增量，从新主索引记录的位置重新读取；
+ *       增量文件比该位置还短说明被手工删除后重建，从头读取。
+ *       只读取完整的 8 字节记录
+ ***********************************************************/
+void dedupIndex::syncDelta()
+{
+    syncTimer.start();
+    const QFileInfo info(indexFileName);
+    const qint64 modifiedMs = info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+    const qint64 size = info.exists() ? info.size() : -1;
+    if (modifiedMs != baseModifiedMs || size != baseSize)
+    {
+        unmapBase();
+        QString error;
+        if (!mapBase(indexFileName, &error))
+        {
+            qDebug() << "Dedup index remap failed:" << error;
+        }
+        deltaPosition = deltaStart;
+        deltaHashes.clear();
+        deltaBuckets.clear();
+    }
+
+    QFile reader(indexFileName + ".delta");
+    const qint64 fileSize = reader.size();
+    if (fileSize < deltaPosition)
+    {
+        deltaPosition = 0;
+        deltaHashes.clear();
+        deltaBuckets.clear();
+    }
+    const qint64 available = (fileSize - deltaPosition) / static_cast<qint64>(sizeof(quint64));
+    if (available <= 0 || !reader.open(QIODevice::ReadOnly) || !reader.seek(deltaPosition))
+    {
+        return;
+    }
+    const QByteArray data = reader.read(available * static_cast<qint64>(sizeof(quint64)));
+    const int records = data.size() / static_cast<int>(sizeof(quint64));
+    for (int i = 0; i < records; ++i)
+    {
+        quint64 hash;
+        memcpy(&hash, data.constData() + i * sizeof(quint64), sizeof(hash));
+        insertDelta(hash);
+    }
+    deltaPosition += static_cast<qint64>(records) * static_cast<qint64>(sizeof(quint64));
+}
+
+/***********************************************************
+ * 函数名称: addDirectory
+ * 函数功能: 为目录下的图像建立哈希
+ * 参数说明:
+ *   directory - 数据集目录，递归扫描
+ * 返回值: 新增的哈希数
+ * 备注: 图像按缩小尺寸解码(JPEG 可在解码器内缩小)，只为计算哈希；
+ *       与索引中已有哈希完全相同的图像不重复加入
+ ***********************************************************/
+int dedupIndex::addDirectory(const QString &directory)
+{
+    int added = 0;
+    QDirIterator it(directory, QStringList() << "*.jpg" << "*.jpeg" << "*.png" << "*.bmp" << "*.webp",
+                    QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        const QString path = it.next();
+        QImageReader reader(path);
+        reader.setScaledSize(QSize(THUMB_DECODE_SIZE, THUMB_DECODE_SIZE));
+        const QImage image = reader.read();
+        if (image.isNull())
+        {
+            qDebug() << "Skip unreadable image:" << path;
+            continue;
+        }
+        const quint64 hash = perceptualHash(image);
+        if (!contains(hash, 0) && add(hash))
+        {
+            added++;
+        }
+    }
+    return added;
+}
+
+/***********************************************************
+ * 函数名称: compact
+ * 函数功能: 合并增量并重写主索引
+ * 参数说明:
+ *   error - 返回错误描述，可为空
+ * 返回值: 成功返回 true
+ * 备注: 去重后对每段做计数排序，经 QSaveFile 原子替换主索引。
+ *       持有 "<索引>.lock" 锁文件期间执行，多个整理进程依次进行；
+ *       增量文件不删除也不截短，新主索引的文件头记录本次读到的增量位置，
+ *       整理期间其他进程追加的记录在该位置之后，之后仍从增量文件读到
+ ***********************************************************/
+bool dedupIndex::compact(QString *error)
+{
+    if (!isOpen())
+    {
+        if (error)
+        {
+            *error = "Dedup index is not open";
+        }
+        return false;
+    }
+
+    QLockFile lock(indexFileName + ".lock");
+    lock.setStaleLockTime(0); // 大索引整理可能很久，只在持有者进程已退出时视为失效
+    if (!lock.tryLock(COMPACT_LOCK_TIMEOUT_MS))
+    {
+        if (error)
+        {
+            *error = "Dedup index is being compacted by another process";
+        }
+        return false;
+    }
+    syncDelta(); // 其他进程刚整理过时先重新映射
+    const qint64 foldedBytes = deltaPosition;
+
+    QVector<quint64> hashes;
+    hashes.reserve(static_cast<int>(baseCount + deltaHashes.size()));
+    for (qint64 i = 0; i < baseCount; ++i)
+    {
+        hashes.append(tables[i]);
+    }
+    hashes += deltaHashes;
+    std::sort(hashes.begin(), hashes.end());
+    hashes.resize(static_cast<int>(std::unique(hashes.begin(), hashes.end()) - hashes.begin()));
+
+    const QString fileName = indexFileName;
+    close();
+
+    QVector<quint32> chunkOffsets(CHUNK_COUNT * OFFSET_SLOTS, 0);
+    for (int chunk = 0; chunk < CHUNK_COUNT; ++chunk)
+    {
+        quint32 *counts = chunkOffsets.data() + chunk * OFFSET_SLOTS;
+        for (quint64 hash : hashes)
+        {
+            counts[chunkValue(hash, chunk) + 1]++;
+        }
+        for (int bucket = 0; bucket < BUCKET_COUNT; ++bucket)
+        {
+            counts[bucket + 1] += counts[bucket];
+        }
+        counts[BUCKET_COUNT + 1] = counts[BUCKET_COUNT];
+    }
+
+    indexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.version = INDEX_VERSION;
+    header.chunks = CHUNK_COUNT;
+    header.count = static_cast<quint64>(hashes.size());
+    header.deltaOffset = static_cast<quint64>(foldedBytes);
+
+    QSaveFile out(fileName);
+    bool written = out.open(QIODevice::WriteOnly) &&
+                   out.write(reinterpret_cast<const char *>(&header), sizeof(header)) == sizeof(header);
+    const qint64 offsetBytes = static_cast<qint64>(chunkOffsets.size()) * sizeof(quint32);
+    written = written && out.write(reinterpret_cast<const char *>(chunkOffsets.constData()), offsetBytes) == offsetBytes;
+
+    QVector<quint64> table(hashes.size());
+    for (int chunk = 0; written && chunk < CHUNK_COUNT; ++chunk)
+    {
+        QVector<quint32> next(BUCKET_COUNT);
+        memcpy(next.data(), chunkOffsets.constData() + chunk * OFFSET_SLOTS, BUCKET_COUNT * sizeof(quint32));
+        for (quint64 hash : hashes)
+        {
+            table[static_cast<int>(next[static_cast<int>(chunkValue(hash, chunk))]++)] = hash;
+        }
+        const qint64 tableBytes = static_cast<qint64>(table.size()) * sizeof(quint64);
+        written = out.write(reinterpret_cast<const char *>(table.constData()), tableBytes) == tableBytes;
+    }
+
+    if (!written || !out.commit())
+    {
+        if (error)
+        {
+            *error = out.errorString();
+        }
+        open(fileName);
+        return false;
+    }
+    return open(fileName, error);
+}
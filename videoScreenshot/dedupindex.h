@@ -0,0 +1,109 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: dedupindex.h
+ *
+ * 模块描述:
+ *   该模块定义了持久化的近重复索引，保存已有数据集图像和历次导出帧的
+ *   64 位感知哈希，导出前查询候选帧是否与其中任一哈希足够接近。
+ *   采用多索引哈希: 哈希分成 4 段 16 位，每段一张按段值分桶的表。
+ *   汉明距离不超过 r 时至少有一段的距离不超过 r/4，只需探查少量桶。
+ *   主索引文件只读内存映射，打开不读取数据；新增哈希追加到增量文件，
+ *   整理时合并重写主索引，主索引文件头记录已合并到的增量位置，
+ *   增量文件只追加不删除，整理期间其他进程的追加不会丢失。
+ *
+ * 主要功能:
+ *   1. 内存映射打开主索引，读取增量文件
+ *   2. 按汉明距离查询近重复
+ *   3. 追加新哈希，扫描目录为已有图像建立哈希
+ *   4. 合并增量并重写主索引
+ *
+ * 函数列表:
+ *   1. dedupIndex                - 构造函数
+ *   2. ~dedupIndex               - 析构函数
+ *   3. open                      - 打开索引
+ *   4. close                     - 关闭索引
+ *   5. contains                  - 查询是否存在近重复
+ *   6. add                       - 追加哈希
+ *   7. addDirectory              - 为目录下的图像建立哈希
+ *   8. compact                   - 合并增量并重写主索引
+ *   9. syncDelta                 - 读取其他进程追加的增量
+ *   10. insertDelta              - 将哈希加入内存中的增量桶
+ *   11. scanBucket               - 检查一个桶内的哈希
+ *   12. mapBase                  - 内存映射主索引
+ *   13. unmapBase                - 解除主索引映射
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 整理不再删除增量文件，改为在主索引文件头记录已合并的增量字节数
+ *     * 整理经锁文件串行执行；查询时发现主索引被替换则重新映射
+ ***********************************************************/
+
+#ifndef DEDUPINDEX_H
+#define DEDUPINDEX_H
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+class dedupIndex
+{
+public:
+    static const int MAX_DISTANCE = 11; // 支持的最大查询距离，每段最多探查距离 2 的邻居
+
+    dedupIndex();
+    ~dedupIndex();
+
+    bool open(const QString &fileName, QString *error = nullptr); // 打开索引，文件不存在时为空索引
+    void close();                                                 // 关闭索引
+    bool contains(quint64 hash, int maxDistance);                 // 查询是否存在距离不超过 maxDistance 的哈希
+    bool add(quint64 hash);                                       // 追加哈希到增量文件
+    int addDirectory(const QString &directory);                   // 为目录下的图像建立哈希，返回新增数
+    bool compact(QString *error = nullptr);                       // 合并增量并重写主索引
+
+    bool isOpen() const { return !indexFileName.isEmpty(); }              // 是否已打开
+    qint64 size() const { return baseCount + deltaHashes.size(); }        // 哈希总数
+    qint64 deltaSize() const { return deltaHashes.size(); }               // 尚未合并的哈希数
+
+private:
+    bool mapBase(const QString &fileName, QString *error); // 内存映射主索引，不存在时为空
+    void unmapBase();                    // 解除主索引映射
+    void syncDelta();                    // 读取增量文件中新追加的记录，主索引被替换时重新映射
+    void insertDelta(quint64 hash);      // 将哈希加入内存中的增量桶
+    bool scanBucket(int chunk, quint32 value, quint64 hash,
+                    int maxDistance) const; // 检查一个桶内的哈希
+
+    QString indexFileName;       // 主索引文件路径，为空表示未打开
+    QFile baseFile;              // 主索引文件
+    uchar *mapped;               // 主索引的内存映射
+    qint64 baseCount;            // 主索引中的哈希数
+    const quint32 *offsets;      // 各段的桶起始位置表
+    const quint64 *tables;       // 各段按桶排列的哈希表，依次存放
+    qint64 deltaStart;           // 主索引已合并的增量字节数，增量从此处读起
+    qint64 baseModifiedMs;       // 映射时主索引的修改时间，不存在为 -1
+    qint64 baseSize;             // 映射时主索引的大小，不存在为 -1
+
+    QFile deltaWriter;                          // 增量文件，追加写入
+    qint64 deltaPosition;                       // 增量文件已读取到的位置
+    QVector<quint64> deltaHashes;               // 增量中的哈希
+    QHash<quint32, QVector<quint64> > deltaBuckets; // 增量桶，键为 段号<<16|段值
+    QElapsedTimer syncTimer;                    // 增量同步节流计时器
+};
+
+#endif // DEDUPINDEX_H
@@ -0,0 +1,238 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: diversitysampler.cpp
+ *
+ * 模块描述:
+ *   该模块实现了多样性采样器。
+ *
+ * 主要功能:
+ *   1. 逐帧判断是否入池以及池中的槽位
+ *   2. 池满时倍增半径并收缩候选池
+ *   3. 结束时贪心选出最分散的 N 帧
+ *
+ * 函数列表:
+ *   1. diversitySampler          - 构造函数
+ *   2. reset                     - 设置选取帧数和池容量并清空
+ *   3. offer                     - 提交下一帧的描述子，返回入池槽位
+ *   4. store                     - 保存入池帧的压缩数据
+ *   5. takeSelected              - 选出最分散的帧并按帧号顺序取出
+ *   6. shrinkPool                - 倍增半径并收缩候选池
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#include "diversitysampler.h"
+#include <algorithm>
+#include <climits>
+
+/***********************************************************
+ * 函数名称: diversitySampler
+ * 函数功能: 多样性采样器的构造函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 默认选取 0 帧，使用前需调用 reset()
+ ***********************************************************/
+diversitySampler::diversitySampler() : count(0),
+                                       capacity(0),
+                                       minDistance(0),
+                                       itemsSeen(0)
+{
+}
+
+/***********************************************************
+ * 函数名称: reset
+ * 函数功能: 设置选取帧数和池容量并清空
+ * 参数说明:
+ *   selectCount  - 选取帧数 N
+ *   poolCapacity - 候选池容量，小于 N 时按 N 处理
+ * 返回值: 无
+ * 备注: 半径从 0 开始，池满之前每个画面不完全相同的帧都入池
+ ***********************************************************/
+void diversitySampler::reset(int selectCount, int poolCapacity)
+{
+    count = qMax(0, selectCount);
+    capacity = qMax(count, poolCapacity);
+    minDistance = 0;
+    itemsSeen = 0;
+    pool.clear();
+    pool.reserve(capacity + 1);
+}
+
+/***********************************************************
+ * 函数名称: offer
+ * 函数功能: 提交下一帧的描述子，返回入池槽位
+ * 参数说明:
+ *   descriptor - 当前帧的描述子
+ * 返回值: 入池时返回要写入的槽位，落选返回 -1
+ * 备注: 与池中某帧的距离不超过半径即落选，落选帧不做转换和编码；
+ *       入池导致池超出容量时先收缩，新帧也可能在收缩中被剔除
+ ***********************************************************/
+int diversitySampler::offer(const frameDescriptor &descriptor)
+{
+    const qint64 sequence = itemsSeen++;
+    if (count <= 0)
+    {
+        return -1;
+    }
+    for (const candidate &item : pool)
+    {
+        if (descriptorDistance(item.descriptor, descriptor) <= minDistance)
+        {
+            return -1;
+        }
+    }
+
+    candidate item;
+    item.descriptor = descriptor;
+    item.sequence = sequence;
+    pool.append(item);
+    if (pool.size() > capacity)
+    {
+        shrinkPool();
+    }
+    return pool.last().sequence == sequence ? pool.size() - 1 : -1;
+}
+
+/***********************************************************
+ * 函数名称: store
+ * 函数功能: 保存入池帧的压缩数据
+ * 参数说明:
+ *   slot        - offer() 返回的槽位
+ *   frameNumber - 帧号
+ *   ptsUs       - 显示时间戳(微秒)
+ *   data        - 已编码的图像数据
+ * 返回值: 无
+ * 备注: 须在下一次 offer() 之前调用，收缩会改变槽位
+ ***********************************************************/
+void diversitySampler::store(int slot, qint64 frameNumber, qint64 ptsUs, const QByteArray &data)
+{
+    if (slot < 0 || slot >= pool.size())
+    {
+        return;
+    }
+    pool[slot].frameNumber = frameNumber;
+    pool[slot].ptsUs = ptsUs;
+    pool[slot].data = data;
+}
+
+/***********************************************************
+ * 函数名称: shrinkPool
+ * 函数功能: 倍增半径并收缩候选池
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 半径取 2 倍原半径与池内最小两两距离中的较大者，按时间顺序
+ *       保留与已保留帧距离都大于半径的帧。最近的一对帧必有一帧被剔除，
+ *       循环必然结束；池容量为 P 时一次收缩比较 O(P^2) 次
+ ***********************************************************/
+void diversitySampler::shrinkPool()
+{
+    while (pool.size() > capacity)
+    {
+        int closest = INT_MAX;
+        for (int i = 0; i < pool.size(); ++i)
+        {
+            for (int j = i + 1; j < pool.size(); ++j)
+            {
+                closest = qMin(closest, descriptorDistance(pool[i].descriptor, pool[j].descriptor));
+            }
+        }
+        minDistance = qMax(qMax(minDistance * 2, closest), 1);
+
+        QVector<candidate> kept;
+        kept.reserve(capacity + 1);
+        for (const candidate &item : pool)
+        {
+            bool farEnough = true;
+            for (const candidate &other : kept)
+            {
+                if (descriptorDistance(item.descriptor, other.descriptor) <= minDistance)
+                {
+                    farEnough = false;
+                    break;
+                }
+            }
+            if (farEnough)
+            {
+                kept.append(item);
+            }
+        }
+        pool = kept;
+    }
+}
+
+/***********************************************************
+ * 函数名称: takeSelected
+ * 函数功能: 选出最分散的帧并按帧号顺序取出
+ * 参数说明: 无
+ * 返回值: 最多 N 帧，按帧号升序排列
+ * 备注: 贪心 k-center: 从最早的候选开始，每次选与已选帧最小距离最大的
+ *       候选。取出后池被清空；编码失败未保存过帧的槽位被略去
+ ***********************************************************/
+QVector<reservoirSampler::entry> diversitySampler::takeSelected()
+{
+    QVector<candidate> stored;
+    stored.reserve(pool.size());
+    for (const candidate &item : pool)
+    {
+        if (item.frameNumber >= 0)
+        {
+            stored.append(item);
+        }
+    }
+    pool.clear();
+
+    QVector<int> picked;
+    if (!stored.isEmpty() && count > 0)
+    {
+        QVector<int> nearest(stored.size(), INT_MAX);
+        int next = 0;
+        while (next >= 0 && picked.size() < count)
+        {
+            picked.append(next);
+            nearest[next] = -1;
+            int farthest = -1;
+            for (int i = 0; i < stored.size(); ++i)
+            {
+                if (nearest[i] < 0)
+                {
+                    continue;
+                }
+                nearest[i] = qMin(nearest[i], descriptorDistance(stored[i].descriptor, stored[next].descriptor));
+                if (farthest < 0 || nearest[i] > nearest[farthest])
+                {
+                    farthest = i;
+                }
+            }
+            next = farthest;
+        }
+    }
+
+    QVector<reservoirSampler::entry> result;
+    result.reserve(picked.size());
+    for (int index : picked)
+    {
+        reservoirSampler::entry item;
+        item.frameNumber = stored[index].frameNumber;
+        item.ptsUs = stored[index].ptsUs;
+        item.data = stored[index].data;
+        result.append(item);
+    }
+    std::sort(result.begin(), result.end(), [](const reservoirSampler::entry &a, const reservoirSampler::entry &b)
+              { return a.frameNumber < b.frameNumber; });
+    return result;
+}
@@ -0,0 +1,88 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: diversitysampler.h
+ *
+ * 模块描述:
+ *   该模块定义了多样性采样器，从帧流中选出画面差异尽量大的 N 帧。
+ *   单遍流式处理: 候选池容量有上限，新帧与池中所有帧的描述子距离都
+ *   大于当前半径时才入池；池满后半径加倍并剔除过近的帧(流式 k-center
+ *   的倍增算法)。结束时在池内做贪心 k-center(最远点)选出 N 帧。
+ *   内存只与池容量有关，与视频长度无关。
+ *
+ * 主要功能:
+ *   1. 逐帧判断是否入池以及池中的槽位
+ *   2. 池满时倍增半径并收缩候选池
+ *   3. 结束时贪心选出最分散的 N 帧
+ *
+ * 函数列表:
+ *   1. diversitySampler          - 构造函数
+ *   2. reset                     - 设置选取帧数和池容量并清空
+ *   3. offer                     - 提交下一帧的描述子，返回入池槽位
+ *   4. store                     - 保存入池帧的压缩数据
+ *   5. takeSelected              - 选出最分散的帧并按帧号顺序取出
+ *   6. shrinkPool                - 倍增半径并收缩候选池
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#ifndef DIVERSITYSAMPLER_H
+#define DIVERSITYSAMPLER_H
+
+#include <QByteArray>
+#include <QVector>
+#include "framedescriptor.h"
+#include "reservoirsampler.h"
+
+class diversitySampler
+{
+public:
+    diversitySampler();
+
+    void reset(int count, int poolCapacity);        // 设置选取帧数和池容量并清空
+    int offer(const frameDescriptor &descriptor);   // 提交下一帧，返回入池槽位，落选返回 -1
+    void store(int slot, qint64 frameNumber, qint64 ptsUs,
+               const QByteArray &data);             // 保存入池帧的压缩数据
+    QVector<reservoirSampler::entry> takeSelected(); // 选出最分散的帧并按帧号顺序取出
+
+    qint64 seen() const { return itemsSeen; }     // 已提交的帧数
+    int poolSize() const { return pool.size(); }  // 当前池中帧数
+    int radius() const { return minDistance; }    // 当前入池半径
+
+private:
+    // 池中的一帧
+    struct candidate
+    {
+        frameDescriptor descriptor; // 外观描述子
+        qint64 sequence;            // 提交序号，用于识别刚入池的帧
+        qint64 frameNumber;         // 帧号，-1 为尚未保存
+        qint64 ptsUs;               // 显示时间戳(微秒)
+        QByteArray data;            // 已编码的图像数据，只做规划时为空
+
+        candidate() : sequence(-1), frameNumber(-1), ptsUs(0) {}
+    };
+
+    void shrinkPool(); // 倍增半径并收缩候选池
+
+    QVector<candidate> pool; // 候选池，按提交顺序排列
+    int count;               // 选取帧数 N
+    int capacity;            // 池容量
+    int minDistance;         // 入池半径，池中任意两帧的距离都大于它
+    qint64 itemsSeen;        // 已提交的帧数
+};
+
+#endif // DIVERSITYSAMPLER_H
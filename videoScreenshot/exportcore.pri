@@ -0,0 +1,96 @@
+#-------------------------------------------------
+#
+# 导出引擎源文件，由 GUI 程序和基准测试程序共用
+#
+#-------------------------------------------------
+
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/bandencoder.cpp \
+    $$PWD/colorconvert.cpp \
+    $$PWD/dedupindex.cpp \
+    $$PWD/diversitysampler.cpp \
+    $$PWD/exportplan.cpp \
+    $$PWD/exportthread.cpp \
+    $$PWD/filterchain.cpp \
+    $$PWD/framedescriptor.cpp \
+    $$PWD/framemanifest.cpp \
+    $$PWD/framesource.cpp \
+    $$PWD/frameview.cpp \
+    $$PWD/lumapyramid.cpp \
+    $$PWD/memoryframesource.cpp \
+    $$PWD/parallelencoder.cpp \
+    $$PWD/phash.cpp \
+    $$PWD/pipelinestats.cpp \
+    $$PWD/qtframesource.cpp \
+    $$PWD/quotasampler.cpp \
+    $$PWD/renditionset.cpp \
+    $$PWD/reservoirsampler.cpp \
+    $$PWD/tileslicer.cpp \
+    $$PWD/timerange.cpp \
+    $$PWD/tracelogger.cpp \
+    $$PWD/y4msource.cpp \
+    $$PWD/yoloannotator.cpp
+
+HEADERS += \
+    $$PWD/bandencoder.h \
+    $$PWD/colorconvert.h \
+    $$PWD/dedupindex.h \
+    $$PWD/diversitysampler.h \
+    $$PWD/exportplan.h \
+    $$PWD/exportthread.h \
+    $$PWD/filterchain.h \
+    $$PWD/framedescriptor.h \
+    $$PWD/framemanifest.h \
+    $$PWD/framesource.h \
+    $$PWD/frameview.h \
+    $$PWD/lumapyramid.h \
+    $$PWD/memoryframesource.h \
+    $$PWD/parallelencoder.h \
+    $$PWD/phash.h \
+    $$PWD/pipelinestats.h \
+    $$PWD/qtframesource.h \
+    $$PWD/quotasampler.h \
+    $$PWD/renditionset.h \
+    $$PWD/reservoirsampler.h \
+    $$PWD/tileslicer.h \
+    $$PWD/timerange.h \
+    $$PWD/tracelogger.h \
+    $$PWD/y4msource.h \
+    $$PWD/yoloannotator.h
+
+# 峰值内存统计在 Windows 上需要 psapi
+win32: LIBS += -lpsapi
+
+# 可选的 libav 解码后端: qmake "CONFIG+=ffmpeg" [FFMPEG_DIR=<ffmpeg 开发包目录>]
+ffmpeg {
+    DEFINES += HAVE_FFMPEG
+    SOURCES += $$PWD/libavframesource.cpp
+    HEADERS += $$PWD/libavframesource.h
+    !isEmpty(FFMPEG_DIR) {
+        INCLUDEPATH += $$FFMPEG_DIR/include
+        LIBS += -L$$FFMPEG_DIR/lib
+    }
+    LIBS += -lavformat -lavcodec -lswscale -lavutil
+}
+
+# 可选的 YOLO 预标注推理: qmake "CONFIG+=onnxruntime" [ONNXRUNTIME_DIR=<onnxruntime 发行包目录>]
+onnxruntime {
+    DEFINES += HAVE_ONNXRUNTIME
+    !isEmpty(ONNXRUNTIME_DIR) {
+        INCLUDEPATH += $$ONNXRUNTIME_DIR/include
+        LIBS += -L$$ONNXRUNTIME_DIR/lib
+    }
+    LIBS += -lonnxruntime
+}
+
+# 可选的 4K/8K 条带 JPEG 编码: qmake "CONFIG+=libjpeg" [LIBJPEG_DIR=<libjpeg-turbo 开发包目录>]
+libjpeg {
+    DEFINES += HAVE_LIBJPEG
+    !isEmpty(LIBJPEG_DIR) {
+        INCLUDEPATH += $$LIBJPEG_DIR/include
+        LIBS += -L$$LIBJPEG_DIR/lib
+    }
+    LIBS += -ljpeg
+}
@@ -0,0 +1,390 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: exportplan.cpp
+ *
+ * 模块描述:
+ *   该模块实现了导出计划文件的读写和分片认领。
+ *
+ * 主要功能:
+ *   1. 追加写入计划条目
+ *   2. 读取计划文件并按视频分片
+ *   3. 原子认领分片、回收超时认领、标记分片完成
+ *
+ * 函数列表:
+ *   1. appendEntries             - 追加写入计划条目
+ *   2. load                      - 读取计划文件并按视频分片
+ *   3. shardId                   - 根据视频路径计算分片标识
+ *   4. isDone                    - 判断分片是否已完成
+ *   5. claim                     - 认领分片
+ *   6. markDone                  - 标记分片完成并释放认领
+ *   7. release                   - 放弃认领
+ *   8. workerName                - 获取当前执行者名称(主机名-进程号)
+ *   9. workerId                  - 获取当前执行者标识(主机名:进程号:随机数)
+ *   10. refresh                  - 刷新认领时间并确认仍由本执行者持有
+ *   11. claimOwner               - 读取认领文件中的执行者标识
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 认领文件写入执行者标识，执行中定期刷新修改时间
+ *     * 回收失效认领改名到本执行者唯一的文件名，核对改走的确是失效认领；认领后回读确认归属
+ *     * 放弃认领时只删除本执行者持有的认领文件
+ ***********************************************************/
+
+#include "exportplan.h"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QSaveFile>
+#include <QSysInfo>
+#include <algorithm>
+
+/***********************************************************
+ * 函数名称: appendEntries
+ * 函数功能: 追加写入计划条目
+ * 参数说明:
+ *   fileName - 计划文件路径，不存在时创建
+ *   entries  - 条目
+ *   error    - 返回错误描述，可为空
+ * 返回值: 成功返回 true
+ * 备注: 全部条目拼接后一次写入，多个规划进程追加同一文件时
+ *       各自的条目在文件中保持连续
+ ***********************************************************/
+bool exportPlan::appendEntries(const QString &fileName, const QVector<entry> &entries, QString *error)
+{
+    QByteArray lines;
+    for (const entry &item : entries)
+    {
+        QJsonObject object;
+        object["video"] = item.video;
+        object["pts_us"] = static_cast<double>(item.ptsUs);
+        object["frame"] = static_cast<double>(item.frameNumber);
+        object["output"] = item.output;
+        lines += QJsonDocument(object).toJson(QJsonDocument::Compact);
+        lines += '\n';
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append) || file.write(lines) != lines.size())
+    {
+        if (error != nullptr)
+        {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: load
+ * 函数功能: 读取计划文件并按视频分片
+ * 参数说明:
+ *   fileName - 计划文件路径
+ *   shards   - 返回分片，按视频首次出现的顺序排列
+ *   error    - 返回错误描述，可为空
+ * 返回值: 成功返回 true，任一行格式错误时返回 false
+ * 备注: 空行被忽略；分片内条目按时间戳升序排列，同一时间戳只保留一条
+ ***********************************************************/
+bool exportPlan::load(const QString &fileName, QVector<shard> &shards, QString *error)
+{
+    shards.clear();
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        if (error != nullptr)
+        {
+            *error = file.errorString();
+        }
+        return false;
+    }
+
+    QHash<QString, int> shardOfVideo;
+    int lineNumber = 0;
+    while (!file.atEnd())
+    {
+        const QByteArray line = file.readLine().trimmed();
+        lineNumber++;
+        if (line.isEmpty())
+        {
+            continue;
+        }
+        const QJsonObject object = QJsonDocument::fromJson(line).object();
+        if (object.isEmpty() || !object.contains("video") || !object.contains("pts_us") || !object.contains("output"))
+        {
+            if (error != nullptr)
+            {
+                *error = QString("%1:%2: malformed entry").arg(fileName).arg(lineNumber);
+            }
+            return false;
+        }
+
+        entry item;
+        item.video = object["video"].toString();
+        item.ptsUs = static_cast<qint64>(object["pts_us"].toDouble());
+        item.frameNumber = static_cast<qint64>(object["frame"].toDouble());
+        item.output = object["output"].toString();
+
+        int index = shardOfVideo.value(item.video, -1);
+        if (index < 0)
+        {
+            shard created;
+            created.id = shardId(item.video);
+            created.video = item.video;
+            shards.append(created);
+            index = shards.size() - 1;
+            shardOfVideo.insert(item.video, index);
+        }
+        shards[index].entries.append(item);
+    }
+
+    for (shard &part : shards)
+    {
+        std::sort(part.entries.begin(), part.entries.end(), [](const entry &a, const entry &b)
+                  { return a.ptsUs < b.ptsUs; });
+        const auto last = std::unique(part.entries.begin(), part.entries.end(), [](const entry &a, const entry &b)
+                                      { return a.ptsUs == b.ptsUs; });
+        part.entries.resize(static_cast<int>(last - part.entries.begin()));
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: shardId
+ * 函数功能: 根据视频路径计算分片标识
+ * 参数说明:
+ *   video - 视频文件路径
+ * 返回值: 16 位十六进制字符串
+ * 备注: 取路径 SHA-1 的前 8 字节，只依赖计划中的路径文本，各主机结果一致
+ ***********************************************************/
+QString exportPlan::shardId(const QString &video)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(video.toUtf8(), QCryptographicHash::Sha1).toHex().left(16));
+}
+
+/***********************************************************
+ * 函数名称: isDone
+ * 函数功能: 判断分片是否已完成
+ * 参数说明:
+ *   claimDir - 认领目录
+ *   id       - 分片标识
+ * 返回值: 已存在完成标记时返回 true
+ * 备注: 无
+ ***********************************************************/
+bool exportPlan::isDone(const QString &claimDir, const QString &id)
+{
+    return QFile::exists(QString("%1/%2.done").arg(claimDir).arg(id));
+}
+
+/***********************************************************
+ * 函数名称: claim
+ * 函数功能: 认领分片
+ * 参数说明:
+ *   claimDir     - 认领目录，位于各执行者共享的存储上
+ *   id           - 分片标识
+ *   staleSeconds - 认领超过该秒数未刷新时视为执行者已失效，0 为永不回收
+ * 返回值: 认领成功返回 true
+ * 备注: 以独占创建(O_EXCL)方式创建认领文件，同一时刻只有一个执行者能成功。
+ *       回收失效认领时，多个执行者可能先后看到同一个失效认领，后到者的改名
+ *       可能改走先到者刚创建的新认领；因此改名目标带本执行者标识，改名后核对
+ *       改走的文件仍是看到的那个失效认领，否则放回原处并放弃。
+ *       认领文件写入执行者标识，写完回读，只有内容仍是本执行者时才算认领成功
+ ***********************************************************/
+bool exportPlan::claim(const QString &claimDir, const QString &id, int staleSeconds)
+{
+    if (isDone(claimDir, id))
+    {
+        return false;
+    }
+
+    const QString claimFile = QString("%1/%2.claim").arg(claimDir).arg(id);
+    QFile file(claimFile);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::NewOnly))
+    {
+        const QFileInfo info(claimFile);
+        if (staleSeconds <= 0 || !info.exists() ||
+            info.lastModified().secsTo(QDateTime::currentDateTime()) < staleSeconds)
+        {
+            return false;
+        }
+        const QString staleOwner = claimOwner(claimFile);
+        const QString staleFile = QString("%1.stale-%2").arg(claimFile).arg(QString(workerId()).replace(':', '-'));
+        if (!QFile::rename(claimFile, staleFile))
+        {
+            return false;
+        }
+        const QFileInfo moved(staleFile);
+        if (claimOwner(staleFile) != staleOwner ||
+            moved.lastModified().secsTo(QDateTime::currentDateTime()) < staleSeconds)
+        {
+            // 改走的是其他执行者刚刚创建或刷新的认领，放回原处
+            if (!QFile::rename(staleFile, claimFile))
+            {
+                QFile::remove(staleFile);
+            }
+            return false;
+        }
+        QFile::remove(staleFile);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::NewOnly))
+        {
+            return false;
+        }
+    }
+
+    file.write(QString("%1 %2\n").arg(workerId()).arg(QDateTime::currentDateTime().toString(Qt::ISODate)).toUtf8());
+    file.close();
+    if (claimOwner(claimFile) != workerId())
+    {
+        return false;
+    }
+
+    // 认领前后分片可能已被其他执行者完成
+    if (isDone(claimDir, id))
+    {
+        release(claimDir, id);
+        return false;
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: refresh
+ * 函数功能: 刷新认领时间并确认仍由本执行者持有
+ * 参数说明:
+ *   claimDir - 认领目录
+ *   id       - 分片标识
+ * 返回值: 认领仍由本执行者持有并已刷新返回 true
+ * 备注: 执行分片期间至少每半个失效时间调用一次，只更新修改时间不改写内容；
+ *       返回 false 说明认领已被回收，应停止执行该分片
+ ***********************************************************/
+bool exportPlan::refresh(const QString &claimDir, const QString &id)
+{
+    const QString claimFile = QString("%1/%2.claim").arg(claimDir).arg(id);
+    if (claimOwner(claimFile) != workerId())
+    {
+        return false;
+    }
+    QFile file(claimFile);
+    if (!file.open(QIODevice::ReadWrite | QIODevice::ExistingOnly))
+    {
+        return false;
+    }
+    return file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+}
+
+/***********************************************************
+ * 函数名称: markDone
+ * 函数功能: 标记分片完成并释放认领
+ * 参数说明:
+ *   claimDir - 认领目录
+ *   id       - 分片标识
+ *   exported - 导出的帧数
+ * 返回值: 成功返回 true
+ * 备注: 完成标记经临时文件改名写入，读者看不到写了一半的标记
+ ***********************************************************/
+bool exportPlan::markDone(const QString &claimDir, const QString &id, int exported)
+{
+    QSaveFile file(QString("%1/%2.done").arg(claimDir).arg(id));
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    file.write(QString("%1 %2 %3\n")
+                   .arg(workerName())
+                   .arg(QDateTime::currentDateTime().toString(Qt::ISODate))
+                   .arg(exported)
+                   .toUtf8());
+    if (!file.commit())
+    {
+        return false;
+    }
+    release(claimDir, id);
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: release
+ * 函数功能: 放弃认领
+ * 参数说明:
+ *   claimDir - 认领目录
+ *   id       - 分片标识
+ * 返回值: 无
+ * 备注: 分片执行失败时调用，其他执行者可以重新认领；
+ *       认领已被其他执行者回收时不删除对方的认领文件
+ ***********************************************************/
+void exportPlan::release(const QString &claimDir, const QString &id)
+{
+    const QString claimFile = QString("%1/%2.claim").arg(claimDir).arg(id);
+    if (claimOwner(claimFile) == workerId())
+    {
+        QFile::remove(claimFile);
+    }
+}
+
+/***********************************************************
+ * 函数名称: claimOwner
+ * 函数功能: 读取认领文件中的执行者标识
+ * 参数说明:
+ *   claimFile - 认领文件路径
+ * 返回值: 执行者标识，文件不存在或为空时返回空字符串
+ * 备注: 认领文件内容为 "执行者标识 认领时间"
+ ***********************************************************/
+QString exportPlan::claimOwner(const QString &claimFile)
+{
+    QFile file(claimFile);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return QString();
+    }
+    return QString::fromUtf8(file.readLine()).section(' ', 0, 0).trimmed();
+}
+
+/***********************************************************
+ * 函数名称: workerName
+ * 函数功能: 获取当前执行者名称
+ * 参数说明: 无
+ * 返回值: "主机名-进程号"
+ * 备注: 写入认领文件和完成标记，便于审计
+ ***********************************************************/
+QString exportPlan::workerName()
+{
+    return QString("%1-%2").arg(QSysInfo::machineHostName()).arg(QCoreApplication::applicationPid());
+}
+
+/***********************************************************
+ * 函数名称: workerId
+ * 函数功能: 获取当前执行者标识
+ * 参数说明: 无
+ * 返回值: "主机名:进程号:随机数"
+ * 备注: 随机数在进程内只生成一次，容器内进程号相同或进程号被复用时
+ *       仍能区分不同执行者；写入认领文件用于确认归属
+ ***********************************************************/
+QString exportPlan::workerId()
+{
+    static const QString id = QString("%1:%2:%3")
+                                  .arg(QSysInfo::machineHostName())
+                                  .arg(QCoreApplication::applicationPid())
+                                  .arg(QRandomGenerator::global()->generate64(), 16, 16, QChar('0'));
+    return id;
+}
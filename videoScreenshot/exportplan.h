@@ -0,0 +1,98 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: exportplan.h
+ *
+ * 模块描述:
+ *   该模块定义了导出计划文件。计划文件是 JSON Lines 文本，每行一个
+ *   (视频, 时间戳, 帧号, 输出文件名) 条目，由任意导出模式的规划步骤追加写入，
+ *   可以审计，也可以由多个进程/多台主机分片执行。
+ *   一个视频的全部条目构成一个分片；执行者以原子方式创建认领文件来领取分片，
+ *   完成后写入完成标记，保证同一帧不会被导出两次。
+ *
+ * 主要功能:
+ *   1. 追加写入计划条目
+ *   2. 读取计划文件并按视频分片
+ *   3. 原子认领分片、回收超时认领、标记分片完成
+ *
+ * 函数列表:
+ *   1. appendEntries             - 追加写入计划条目
+ *   2. load                      - 读取计划文件并按视频分片
+ *   3. shardId                   - 根据视频路径计算分片标识
+ *   4. isDone                    - 判断分片是否已完成
+ *   5. claim                     - 认领分片
+ *   6. markDone                  - 标记分片完成并释放认领
+ *   7. release                   - 放弃认领
+ *   8. workerName                - 获取当前执行者名称(主机名-进程号)
+ *   9. workerId                  - 获取当前执行者标识(主机名:进程号:随机数)
+ *   10. refresh                  - 刷新认领时间并确认仍由本执行者持有
+ *   11. claimOwner               - 读取认领文件中的执行者标识
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 认领文件写入执行者标识，执行中定期刷新修改时间，长分片不再被误判失效
+ *     * 回收失效认领改名到每个执行者唯一的文件名并核对内容，认领后回读确认归属
+ *     * 放弃认领时只删除本执行者持有的认领文件
+ ***********************************************************/
+
+#ifndef EXPORTPLAN_H
+#define EXPORTPLAN_H
+
+#include <QString>
+#include <QVector>
+
+class exportPlan
+{
+public:
+    // 计划中的一帧
+    struct entry
+    {
+        QString video;      // 视频文件路径
+        qint64 ptsUs;       // 显示时间戳(微秒)
+        qint64 frameNumber; // 规划时的帧号
+        QString output;     // 输出文件名，相对于导出根目录
+
+        entry() : ptsUs(0), frameNumber(0) {}
+    };
+
+    // 一个分片: 同一视频的全部条目，按时间戳升序
+    struct shard
+    {
+        QString id;              // 分片标识，用于认领文件名
+        QString video;           // 视频文件路径
+        QVector<entry> entries;  // 条目
+    };
+
+    static bool appendEntries(const QString &fileName, const QVector<entry> &entries,
+                              QString *error = nullptr);  // 追加写入计划条目
+    static bool load(const QString &fileName, QVector<shard> &shards,
+                     QString *error = nullptr);           // 读取计划文件并按视频分片
+    static QString shardId(const QString &video);         // 根据视频路径计算分片标识
+
+    static bool isDone(const QString &claimDir, const QString &id);  // 判断分片是否已完成
+    static bool claim(const QString &claimDir, const QString &id,
+                      int staleSeconds);                            // 认领分片
+    static bool markDone(const QString &claimDir, const QString &id,
+                         int exported);                             // 标记分片完成并释放认领
+    static bool refresh(const QString &claimDir, const QString &id); // 刷新认领时间并确认仍由本执行者持有
+    static void release(const QString &claimDir, const QString &id); // 放弃认领
+    static QString claimOwner(const QString &claimFile);             // 读取认领文件中的执行者标识
+    static QString workerName();                                     // 获取当前执行者名称
+    static QString workerId();                                       // 获取当前执行者标识
+};
+
+#endif // EXPORTPLAN_H
@@ -31,10 +31,22 @@
  *   5. saveSettings              - 保存当前设置
  *   6. onExportModeChanged       - 根据导出模式更新UI
  *   7. onPathSelectClicked       - 选择导出路径
+ *   8. getFrameFilters           - 获取帧分析过滤链的阈值
  *
  * 版本历史:
  *   - 版本 1.0 (2025-02-05) - LiuJiaLe
  *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 增加时间线追踪开关
+ *     * 增加解码后端、解码线程数和并行方式设置
+ *     * 增加关键帧导出模式及最小时间间隔设置
+ *     * 增加随机导出的随机种子设置
+ *     * 正交分布导出改为多样性导出，增加每个视频的时间预算设置
+ *     * 增加 HDR 色调映射方式设置
+ *     * 增加导出预览缩略图开关
+ *     * 增加帧分析过滤设置: 最低清晰度、场景变化阈值和最小运动量
+ *     * 增加逐帧元数据清单及 CSV 清单开关
+ *     * 随机种子按字符串保存，与导出报告一致，读取方可按 64 位无符号数解析
  ***********************************************************/
 
 #include "exportsettings.h"
@@ -45,6 +57,7 @@
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QLineEdit>
+#include "framesource.h"
 
 /***********************************************************
  * 函数名称: exportSettings
@@ -83,13 +96,38 @@ exportSettings::~exportSettings()
     delete spinBoxInterval;
     delete labelRandomCount;
     delete spinBoxRandomCount;
-    delete labelOrthogonalCount;
-    delete spinBoxOrthogonalCount;
+    delete labelRandomSeed;
+    delete spinBoxRandomSeed;
+    delete labelDiversityCount;
+    delete spinBoxDiversityCount;
+    delete labelTimeBudget;
+    delete spinBoxTimeBudget;
+    delete labelKeyframeGap;
+    delete spinBoxKeyframeGap;
     delete pushButtonPath;
+    delete checkBoxTrace;
+    delete checkBoxPreview;
+    delete checkBoxManifest;
+    delete checkBoxManifestCsv;
+    delete labelBackend;
+    delete comboBoxBackend;
+    delete labelDecoderThreads;
+    delete spinBoxDecoderThreads;
+    delete comboBoxThreadType;
+    delete labelToneMap;
+    delete comboBoxToneMap;
+    delete labelSharpness;
+    delete spinBoxSharpness;
+    delete labelSceneChange;
+    delete spinBoxSceneChange;
+    delete labelMotion;
+    delete spinBoxMotion;
 
     // 后删除布局,从内到外
     delete pathLayout;
     delete modeLayout;
+    delete decoderLayout;
+    delete filterLayout;
     delete mainLayout;
 
     delete ui;
@@ -120,9 +158,83 @@ void exportSettings::initUI()
     modeLabel = new QLabel(tr("导出模式:"), this);
     modeLayout->addWidget(modeLabel);
 
+    // 创建解码设置布局
+    decoderLayout = new QHBoxLayout();
+    labelBackend = new QLabel(tr("解码后端:"), this);
+    comboBoxBackend = new QComboBox(this);
+    comboBoxBackend->addItem(tr("自动"), QString());
+    for (const QString &name : frameSource::backendNames())
+    {
+        comboBoxBackend->addItem(name, name);
+    }
+    labelDecoderThreads = new QLabel(tr("解码线程:"), this);
+    spinBoxDecoderThreads = new QSpinBox(this);
+    spinBoxDecoderThreads->setRange(0, 64);
+    spinBoxDecoderThreads->setSpecialValueText(tr("自动"));
+    comboBoxThreadType = new QComboBox(this);
+    comboBoxThreadType->addItem(tr("自动并行"), frameSourceOptions::THREAD_AUTO);
+    comboBoxThreadType->addItem(tr("帧级并行"), frameSourceOptions::THREAD_FRAME);
+    comboBoxThreadType->addItem(tr("片级并行"), frameSourceOptions::THREAD_SLICE);
+    decoderLayout->addWidget(labelBackend);
+    decoderLayout->addWidget(comboBoxBackend);
+    decoderLayout->addWidget(labelDecoderThreads);
+    decoderLayout->addWidget(spinBoxDecoderThreads);
+    decoderLayout->addWidget(comboBoxThreadType);
+    labelToneMap = new QLabel(tr("HDR映射:"), this);
+    comboBoxToneMap = new QComboBox(this);
+    comboBoxToneMap->addItem(tr("Hable"), frameView::TONEMAP_HABLE);
+    comboBoxToneMap->addItem(tr("Reinhard"), frameView::TONEMAP_REINHARD);
+    comboBoxToneMap->addItem(tr("截断"), frameView::TONEMAP_CLIP);
+    decoderLayout->addWidget(labelToneMap);
+    decoderLayout->addWidget(comboBoxToneMap);
+
+    // 创建帧分析过滤设置布局，各项为 0 时不启用
+    filterLayout = new QHBoxLayout();
+    labelSharpness = new QLabel(tr("最低清晰度:"), this);
+    spinBoxSharpness = new QDoubleSpinBox(this);
+    spinBoxSharpness->setRange(0, 255);
+    spinBoxSharpness->setDecimals(1);
+    spinBoxSharpness->setSingleStep(0.5);
+    spinBoxSharpness->setSpecialValueText(tr("关闭"));
+    labelSceneChange = new QLabel(tr("场景变化:"), this);
+    spinBoxSceneChange = new QDoubleSpinBox(this);
+    spinBoxSceneChange->setRange(0, 100);
+    spinBoxSceneChange->setDecimals(1);
+    spinBoxSceneChange->setSuffix(tr(" %"));
+    spinBoxSceneChange->setSpecialValueText(tr("关闭"));
+    labelMotion = new QLabel(tr("最小运动量:"), this);
+    spinBoxMotion = new QDoubleSpinBox(this);
+    spinBoxMotion->setRange(0, 255);
+    spinBoxMotion->setDecimals(1);
+    spinBoxMotion->setSingleStep(0.5);
+    spinBoxMotion->setSpecialValueText(tr("关闭"));
+    filterLayout->addWidget(labelSharpness);
+    filterLayout->addWidget(spinBoxSharpness);
+    filterLayout->addWidget(labelSceneChange);
+    filterLayout->addWidget(spinBoxSceneChange);
+    filterLayout->addWidget(labelMotion);
+    filterLayout->addWidget(spinBoxMotion);
+
+    // 创建时间线追踪开关
+    checkBoxTrace = new QCheckBox(tr("记录时间线追踪(export_trace.json)"), this);
+
+    // 创建导出预览开关
+    checkBoxPreview = new QCheckBox(tr("导出时显示预览缩略图"), this);
+
+    // 创建逐帧元数据清单开关，CSV 清单只在写出清单时可选
+    checkBoxManifest = new QCheckBox(tr("写出逐帧元数据清单(frames.vsm)"), this);
+    checkBoxManifestCsv = new QCheckBox(tr("同时写出 CSV 清单(frames.csv)"), this);
+    connect(checkBoxManifest, &QCheckBox::toggled, checkBoxManifestCsv, &QWidget::setEnabled);
+
     // 添加到主布局
     mainLayout->addLayout(pathLayout);
     mainLayout->addLayout(modeLayout);
+    mainLayout->addLayout(decoderLayout);
+    mainLayout->addLayout(filterLayout);
+    mainLayout->addWidget(checkBoxTrace);
+    mainLayout->addWidget(checkBoxPreview);
+    mainLayout->addWidget(checkBoxManifest);
+    mainLayout->addWidget(checkBoxManifestCsv);
     mainLayout->addStretch();
 
     setLayout(mainLayout);
@@ -130,7 +242,8 @@ void exportSettings::initUI()
     comboBoxMode = new QComboBox(this);
     comboBoxMode->addItem(tr("等间距导出"), EQUAL_INTERVAL);
     comboBoxMode->addItem(tr("随机导出"), RANDOM);
-    comboBoxMode->addItem(tr("正交分布导出"), ORTHOGONAL);
+    comboBoxMode->addItem(tr("多样性导出"), DIVERSITY);
+    comboBoxMode->addItem(tr("关键帧导出"), KEYFRAME_ONLY);
     // 添加到布局中
     modeLayout->addWidget(comboBoxMode);
 
@@ -157,11 +270,36 @@ void exportSettings::initUI()
     modeLayout->addWidget(labelRandomCount);
     modeLayout->addWidget(spinBoxRandomCount);
 
-    labelOrthogonalCount = new QLabel(tr("正交分布数:"), this);
-    spinBoxOrthogonalCount = new QSpinBox(this);
-    spinBoxOrthogonalCount->setRange(1, 9999);
-    modeLayout->addWidget(labelOrthogonalCount);
-    modeLayout->addWidget(spinBoxOrthogonalCount);
+    labelRandomSeed = new QLabel(tr("随机种子:"), this);
+    spinBoxRandomSeed = new QSpinBox(this);
+    spinBoxRandomSeed->setRange(0, 2147483647);
+    modeLayout->addWidget(labelRandomSeed);
+    modeLayout->addWidget(spinBoxRandomSeed);
+
+    labelDiversityCount = new QLabel(tr("导出帧数:"), this);
+    spinBoxDiversityCount = new QSpinBox(this);
+    spinBoxDiversityCount->setRange(1, 9999);
+    modeLayout->addWidget(labelDiversityCount);
+    modeLayout->addWidget(spinBoxDiversityCount);
+
+    labelKeyframeGap = new QLabel(tr("最小间隔:"), this);
+    spinBoxKeyframeGap = new QSpinBox(this);
+    spinBoxKeyframeGap->setRange(0, 3600000);
+    spinBoxKeyframeGap->setSingleStep(1000);
+    spinBoxKeyframeGap->setSuffix(tr(" 毫秒"));
+    spinBoxKeyframeGap->setSpecialValueText(tr("不限"));
+    modeLayout->addWidget(labelKeyframeGap);
+    modeLayout->addWidget(spinBoxKeyframeGap);
+
+    // 时间预算对所有模式生效
+    labelTimeBudget = new QLabel(tr("时间预算:"), this);
+    spinBoxTimeBudget = new QSpinBox(this);
+    spinBoxTimeBudget->setRange(0, 86400);
+    spinBoxTimeBudget->setSingleStep(60);
+    spinBoxTimeBudget->setSuffix(tr(" 秒"));
+    spinBoxTimeBudget->setSpecialValueText(tr("不限"));
+    decoderLayout->addWidget(labelTimeBudget);
+    decoderLayout->addWidget(spinBoxTimeBudget);
 }
 
 /***********************************************************
@@ -178,14 +316,46 @@ void exportSettings::loadSettings()
     int exportMode = settings->value("exportMode", EQUAL_INTERVAL).toInt();
     int interval = settings->value("interval", DEFAULT_INTERVAL).toInt();
     int randomCount = settings->value("randomCount", DEFAULT_RANDOM_COUNT).toInt();
-    int orthogonalCount = settings->value("orthogonalCount", DEFAULT_ORTHOGONAL_COUNT).toInt();
+    // 旧版本保存的正交分布数沿用为多样性导出帧数
+    int diversityCount = settings->value("diversityCount",
+                                         settings->value("orthogonalCount", DEFAULT_DIVERSITY_COUNT)).toInt();
+    int timeBudget = settings->value("timeBudgetSec", 0).toInt();
+    int keyframeGap = settings->value("keyframeGapMs", DEFAULT_KEYFRAME_GAP).toInt();
+    const int randomSeed = static_cast<int>(qMin<quint64>(settings->value("randomSeed", 0).toString().toULongLong(),
+                                                          2147483647));
+    bool traceEnabled = settings->value("traceEnabled", false).toBool();
+    bool previewEnabled = settings->value("livePreview", true).toBool();
+    bool manifestEnabled = settings->value("manifestEnabled", true).toBool();
+    bool manifestCsv = settings->value("manifestCsv", false).toBool();
+    QString decoderBackend = settings->value("decoderBackend", QString()).toString();
+    int decoderThreads = settings->value("decoderThreads", 0).toInt();
+    int decoderThreadType = settings->value("decoderThreadType", frameSourceOptions::THREAD_AUTO).toInt();
+    frameView::ToneMap toneMap = frameView::toneMapFromName(settings->value("toneMap", "hable").toString());
+    double minSharpness = settings->value("filterMinSharpness", 0.0).toDouble();
+    double minSceneChange = settings->value("filterMinSceneChange", 0.0).toDouble();
+    double minMotion = settings->value("filterMinMotion", 0.0).toDouble();
 
     // 应用设置到UI
     lineEditPath->setText(exportPath);
     comboBoxMode->setCurrentIndex(exportMode);
     spinBoxInterval->setValue(interval);
     spinBoxRandomCount->setValue(randomCount);
-    spinBoxOrthogonalCount->setValue(orthogonalCount);
+    spinBoxDiversityCount->setValue(diversityCount);
+    spinBoxTimeBudget->setValue(timeBudget);
+    spinBoxKeyframeGap->setValue(keyframeGap);
+    spinBoxRandomSeed->setValue(randomSeed);
+    checkBoxTrace->setChecked(traceEnabled);
+    checkBoxPreview->setChecked(previewEnabled);
+    checkBoxManifest->setChecked(manifestEnabled);
+    checkBoxManifestCsv->setChecked(manifestCsv);
+    checkBoxManifestCsv->setEnabled(manifestEnabled);
+    comboBoxBackend->setCurrentIndex(qMax(0, comboBoxBackend->findData(decoderBackend)));
+    spinBoxDecoderThreads->setValue(decoderThreads);
+    comboBoxThreadType->setCurrentIndex(decoderThreadType);
+    comboBoxToneMap->setCurrentIndex(qMax(0, comboBoxToneMap->findData(toneMap)));
+    spinBoxSharpness->setValue(minSharpness);
+    spinBoxSceneChange->setValue(minSceneChange);
+    spinBoxMotion->setValue(minMotion);
 
     // 根据当前模式显示/隐藏相关控件
     onExportModeChanged(exportMode);
@@ -205,7 +375,21 @@ void exportSettings::saveSettings()
     settings->setValue("exportMode", comboBoxMode->currentIndex());
     settings->setValue("interval", spinBoxInterval->value());
     settings->setValue("randomCount", spinBoxRandomCount->value());
-    settings->setValue("orthogonalCount", spinBoxOrthogonalCount->value());
+    settings->setValue("diversityCount", spinBoxDiversityCount->value());
+    settings->setValue("timeBudgetSec", spinBoxTimeBudget->value());
+    settings->setValue("keyframeGapMs", spinBoxKeyframeGap->value());
+    settings->setValue("randomSeed", QString::number(spinBoxRandomSeed->value()));
+    settings->setValue("traceEnabled", checkBoxTrace->isChecked());
+    settings->setValue("livePreview", checkBoxPreview->isChecked());
+    settings->setValue("manifestEnabled", checkBoxManifest->isChecked());
+    settings->setValue("manifestCsv", checkBoxManifestCsv->isChecked());
+    settings->setValue("decoderBackend", comboBoxBackend->currentData().toString());
+    settings->setValue("decoderThreads", spinBoxDecoderThreads->value());
+    settings->setValue("decoderThreadType", comboBoxThreadType->currentIndex());
+    settings->setValue("toneMap", frameView::toneMapName(static_cast<frameView::ToneMap>(comboBoxToneMap->currentData().toInt())));
+    settings->setValue("filterMinSharpness", spinBoxSharpness->value());
+    settings->setValue("filterMinSceneChange", spinBoxSceneChange->value());
+    settings->setValue("filterMinMotion", spinBoxMotion->value());
 }
 
 /***********************************************************
@@ -223,9 +407,14 @@ void exportSettings::onExportModeChanged(int index)
 
     spinBoxRandomCount->setVisible(index == RANDOM);
     labelRandomCount->setVisible(index == RANDOM);
+    spinBoxRandomSeed->setVisible(index == RANDOM);
+    labelRandomSeed->setVisible(index == RANDOM);
+
+    spinBoxDiversityCount->setVisible(index == DIVERSITY);
+    labelDiversityCount->setVisible(index == DIVERSITY);
 
-    spinBoxOrthogonalCount->setVisible(index == ORTHOGONAL);
-    labelOrthogonalCount->setVisible(index == ORTHOGONAL);
+    spinBoxKeyframeGap->setVisible(index == KEYFRAME_ONLY);
+    labelKeyframeGap->setVisible(index == KEYFRAME_ONLY);
 }
 
 /***********************************************************
@@ -247,3 +436,19 @@ void exportSettings::onPathSelectClicked()
         lineEditPath->setText(dir);
     }
 }
+
+/***********************************************************
+ * 函数名称: getFrameFilters
+ * 函数功能: 获取帧分析过滤链的阈值
+ * 参数说明: 无
+ * 返回值: 各内置过滤器的阈值，0 表示不启用
+ * 备注: 无
+ ***********************************************************/
+filterChain::options exportSettings::getFrameFilters() const
+{
+    filterChain::options result;
+    result.minSharpness = spinBoxSharpness->value();
+    result.minSceneChange = spinBoxSceneChange->value();
+    result.minMotion = spinBoxMotion->value();
+    return result;
+}
@@ -31,10 +31,21 @@
  *   5. saveSettings              - 保存当前设置
  *   6. onExportModeChanged       - 根据导出模式更新UI
  *   7. onPathSelectClicked       - 选择导出路径
+ *   8. getFrameFilters           - 获取帧分析过滤链的阈值
  *
  * 版本历史:
  *   - 版本 1.0 (2025-02-05) - LiuJiaLe
  *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 增加时间线追踪开关
+ *     * 增加解码后端、解码线程数和并行方式设置
+ *     * 增加关键帧导出模式及最小时间间隔设置
+ *     * 增加随机导出的随机种子设置
+ *     * 正交分布导出改为多样性导出，增加每个视频的时间预算设置
+ *     * 增加 HDR 色调映射方式设置
+ *     * 增加导出预览缩略图开关
+ *     * 增加帧分析过滤设置: 最低清晰度、场景变化阈值和最小运动量
+ *     * 增加逐帧元数据清单及 CSV 清单开关
  ***********************************************************/
 
 #ifndef EXPORTSETTINGS_H
@@ -51,6 +62,9 @@
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QLineEdit>
+#include <QCheckBox>
+#include <QDoubleSpinBox>
+#include "filterchain.h"
 
 namespace Ui
 {
@@ -69,10 +83,27 @@ public:
     {
         EQUAL_INTERVAL = 0,
         RANDOM,
-        ORTHOGONAL
+        DIVERSITY,
+        KEYFRAME_ONLY
     };
 
-    QString getExportPath() { return lineEditPath->text(); } // 获取导出路径
+    QString getExportPath() { return lineEditPath->text(); }               // 获取导出路径
+    int getExportMode() { return comboBoxMode->currentIndex(); }           // 获取导出模式
+    int getInterval() { return spinBoxInterval->value(); }                 // 获取间隔帧数
+    int getRandomCount() { return spinBoxRandomCount->value(); }           // 获取随机截图数
+    int getDiversityCount() { return spinBoxDiversityCount->value(); }     // 获取多样性导出帧数
+    int getTimeBudget() { return spinBoxTimeBudget->value(); }             // 获取每个视频的时间预算(秒)
+    int getKeyframeGap() { return spinBoxKeyframeGap->value(); }           // 获取关键帧最小间隔(毫秒)
+    int getRandomSeed() { return spinBoxRandomSeed->value(); }             // 获取随机种子
+    bool getTraceEnabled() { return checkBoxTrace->isChecked(); }          // 获取是否记录时间线追踪
+    bool getPreviewEnabled() { return checkBoxPreview->isChecked(); }      // 获取导出时是否显示预览缩略图
+    bool getManifestEnabled() { return checkBoxManifest->isChecked(); }    // 获取是否写出逐帧元数据清单
+    bool getManifestCsv() { return checkBoxManifestCsv->isChecked(); }     // 获取是否同时写出 CSV 清单
+    QString getDecoderBackend() { return comboBoxBackend->currentData().toString(); } // 获取解码后端
+    int getDecoderThreads() { return spinBoxDecoderThreads->value(); }     // 获取解码线程数
+    int getDecoderThreadType() { return comboBoxThreadType->currentIndex(); } // 获取解码并行方式
+    int getToneMap() { return comboBoxToneMap->currentData().toInt(); }    // 获取 HDR 色调映射方式
+    filterChain::options getFrameFilters() const;                          // 获取帧分析过滤链的阈值
 
 private:
     void initUI();       // 初始化用户界面
@@ -98,15 +129,41 @@ private:
     QSpinBox *spinBoxInterval;        // 间隔帧数选择框
     QLabel *labelRandomCount;         // 随机截图数标签
     QSpinBox *spinBoxRandomCount;     // 随机截图数选择框
-    QLabel *labelOrthogonalCount;     // 正交分布数标签
-    QSpinBox *spinBoxOrthogonalCount; // 正交分布数选择框
+    QLabel *labelRandomSeed;          // 随机种子标签
+    QSpinBox *spinBoxRandomSeed;      // 随机种子选择框
+    QLabel *labelDiversityCount;      // 多样性导出帧数标签
+    QSpinBox *spinBoxDiversityCount;  // 多样性导出帧数选择框
+    QLabel *labelTimeBudget;          // 时间预算标签
+    QSpinBox *spinBoxTimeBudget;      // 每个视频的时间预算选择框(秒，0 为不限)
+    QLabel *labelKeyframeGap;         // 关键帧最小间隔标签
+    QSpinBox *spinBoxKeyframeGap;     // 关键帧最小间隔选择框(毫秒，0 为不限)
     QPushButton *pushButtonPath;      // 选择路径按钮
+    QCheckBox *checkBoxTrace;         // 时间线追踪开关
+    QCheckBox *checkBoxPreview;       // 导出预览缩略图开关
+    QCheckBox *checkBoxManifest;      // 逐帧元数据清单开关
+    QCheckBox *checkBoxManifestCsv;   // CSV 清单开关
+    QHBoxLayout *decoderLayout;       // 解码设置布局
+    QLabel *labelBackend;             // 解码后端标签
+    QComboBox *comboBoxBackend;       // 解码后端选择框
+    QLabel *labelDecoderThreads;      // 解码线程数标签
+    QSpinBox *spinBoxDecoderThreads;  // 解码线程数选择框(0 为自动)
+    QComboBox *comboBoxThreadType;    // 解码并行方式选择框
+    QLabel *labelToneMap;             // HDR 色调映射标签
+    QComboBox *comboBoxToneMap;       // HDR 色调映射方式选择框
+    QHBoxLayout *filterLayout;        // 帧分析过滤设置布局
+    QLabel *labelSharpness;           // 最低清晰度标签
+    QDoubleSpinBox *spinBoxSharpness; // 最低清晰度选择框(0 为关闭)
+    QLabel *labelSceneChange;         // 场景变化阈值标签
+    QDoubleSpinBox *spinBoxSceneChange; // 场景变化阈值选择框(%，0 为关闭)
+    QLabel *labelMotion;              // 最小运动量标签
+    QDoubleSpinBox *spinBoxMotion;    // 最小运动量选择框(0 为关闭)
 
     // 默认参数
     const QString DEFAULT_EXPORT_PATH = QDir::homePath() + "/Pictures/Screenshots";
     const int DEFAULT_INTERVAL = 30;
     const int DEFAULT_RANDOM_COUNT = 10;
-    const int DEFAULT_ORTHOGONAL_COUNT = 10;
+    const int DEFAULT_DIVERSITY_COUNT = 10;
+    const int DEFAULT_KEYFRAME_GAP = 0;
 };
 
 #endif // EXPORTSETTINGS_H
\ No newline at end of file
@@ -23,6 +23,7 @@
  *   2. 设置导出路径和名称
  *   3. 设置导出模式和参数
  *   4. 处理视频帧并导出
+ *   5. 从帧源(Qt 多媒体/libav/原始 YUV/内存)逐帧拉取并导出
  *
  * 函数列表:
  *   1. exportThread              - 构造函数，初始化线程
@@ -33,20 +34,187 @@
  *   6. setExportMode             - 设置导出模式
  *   7. setInterval               - 设置间隔帧数
  *   8. setRandomCount            - 设置随机截图数
- *   9. setOrthogonalCount        - 设置正交分布数
+ *   9. setDiversityCount         - 设置多样性导出的帧数
  *   10. run                      - 线程运行函数，处理视频导出
- *   11. processVideoFrame        - 处理视频帧
+ *   11. runSource                - 从帧源逐帧拉取并导出
  *   12. saveImage                - 保存图像
+ *   13. publishStats             - 按节流间隔发送统计快照
+ *   14. setTraceEnabled          - 设置是否记录时间线追踪
+ *   15. setImageFormat           - 设置输出图像格式和质量
+ *   16. setRawVideoFormat        - 设置无头 YUV 输入的格式
+ *   17. beginExport              - 导出开始前的公共准备
+ *   18. finishExport             - 导出结束后的公共收尾
+ *   19. selectFrame              - 判断当前帧是否需要导出
+ *   20. setDecoder               - 设置解码后端和解码线程
+ *   21. setFrameSource           - 注入自定义帧源
+ *   22. setKeyframeGap           - 设置关键帧导出的最小时间间隔
+ *   23. setRandomSeed            - 设置随机导出的种子
+ *   24. encodeImage              - 将当前帧编码为图像数据
+ *   25. writeImage               - 将图像数据写入导出目录
+ *   26. flushReservoir           - 写出随机导出蓄水池中的帧
+ *   27. setPlanOutput            - 设置只规划不导出，计划追加到文件
+ *   28. setPlanExecution         - 设置执行计划文件
+ *   29. runPlan                  - 认领并执行计划分片
+ *   30. runShard                 - 执行一个计划分片
+ *   31. planOutputName           - 生成计划条目的输出文件名
+ *   32. writeFile                - 将图像数据写入指定文件
+ *   33. setDedupIndex            - 设置跨数据集近重复索引
+ *   34. isDuplicate              - 判断候选帧是否与索引中的图像近重复
+ *   35. setTimeBudget            - 设置每个视频的处理时间预算
+ *   36. flushDiversity           - 选出并写出多样性导出的帧
+ *   37. writePicked              - 写出或规划采样器选出的帧
+ *   38. setAnnotation            - 设置 YOLO 预标注
+ *   39. setTiling                - 设置切片导出
+ *   40. writeOutputs             - 将一帧的切片和各版本并行编码后写出
+ *   41. imageBaseName            - 生成导出图像不含后缀的路径
+ *   42. setRenditions            - 设置多分辨率输出版本
+ *   43. setTimeRanges            - 设置导出时间段
+ *   44. useBandEncoding          - 判断当前帧是否按条带转换编码
+ *   45. setToneMap               - 设置 HDR 帧的色调映射方式
+ *   46. state                    - 获取当前导出状态
+ *   47. stateName                - 获取导出状态名称
+ *   48. pause                    - 请求暂停导出
+ *   49. resume                   - 继续已暂停的导出
+ *   50. cancel                   - 请求取消导出
+ *   51. setState                 - 切换导出状态并通知界面
+ *   52. checkpoint               - 每帧检查暂停和取消请求
+ *   53. setPreviewEnabled        - 设置是否生成导出预览
+ *   54. takePreview              - 取走最新的导出预览
+ *   55. offerPreview             - 按节流间隔生成导出预览
+ *   56. setFrameFilters          - 设置帧分析过滤链
+ *   57. setManifest              - 设置是否写出逐帧元数据清单
+ *   58. recordFrame              - 暂存选中帧的清单记录
  *
  * 版本历史:
  *   - 版本 1.0 (2025-02-05) - LiuJiaLe
  *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 增加分阶段流水线统计和 JSON 运行报告
+ *     * 增加 Chrome trace-event 时间线追踪，每个导出使用自己的追踪记录器
+ *     * 支持选择输出图像格式，文件名附加帧号避免同一秒内覆盖
+ *     * 支持 Y4M/无头 YUV/标准输入的免解码原始帧输入
+ *     * 改为从帧源接口拉取帧，QMediaPlayer 移入导出线程内创建
+ *     * 增加关键帧导出模式，可按最小时间间隔稀疏化
+ *     * 等间隔导出预先把采样计划交给帧源，按帧号选帧
+ *     * 随机导出改为带种子的单遍蓄水池采样，只缓存 k 帧压缩图像
+ *     * 支持只规划不导出生成计划文件，以及多进程/多主机分片执行计划文件
+ *     * 编码前按持久化感知哈希索引跳过与已有数据集近重复的帧
+ *     * 正交分布导出占位改为多样性导出: 流式 k-center 选出画面差异最大的帧
+ *     * 写出图像后交给 YOLO 预标注器批量推理，在同目录写出标注文件
+ *     * 增加 SAHI 式切片导出: 零拷贝切片视图并行编码，坐标写入切片清单
+ *     * 支持一次解码输出多个分辨率版本，级联缩小后与切片一起并行编码；
+ *       随机/多样性导出时池中帧以 PNG 暂存，避免二次有损压缩
+ *     * 支持每个视频多个导出时间段，帧源跳转越过段外区域
+ *     * 4K 及以上的帧按条带转换并编码为 JPEG，不生成整帧 RGB 图像
+ *     * 支持 10bit HDR 输入，转换为 8bit 时按所选方式做色调映射
+ *     * 导出生命周期改为显式状态: 每帧检查暂停/取消请求，暂停时阻塞在条件变量上，
+ *       取消时唤醒帧源的事件等待；打开失败和读取出错经 stateChanged 通知界面
+ *     * 增加导出预览: 写出成功的帧每 250ms 最多取一张缩小到 240 像素，
+ *       通过无锁的最新值槽交给界面线程，旧预览未被取走时直接替换
+ *     * 增加帧分析过滤链: 候选帧只遍历一次原始帧生成亮度金字塔，清晰度、场景变化、
+ *       运动量过滤器和近重复检查都只读金字塔，任一过滤器拒绝即跳过后面的检查
+ *     * 增加逐帧元数据清单: 选中帧的来源、时间戳、感知哈希、清晰度和亮度取自亮度金字塔，
+ *       每写出一张图像追加一行，按列缓存后整块写出 frames.vsm，可选同时写出 frames.csv
+ *     * 帧源由 QScopedPointer 持有，导出中抛出异常时同样释放
+ *     * 执行计划分片期间由单独的线程每半个认领失效时间刷新一次认领，暂停或阻塞时
+ *       认领也不会失效；认领已被回收时停止该分片
+ *     * 文件名、计划条目和清单帧号改用帧源给出的帧序号，帧源在解码前跳帧时
+ *       仍是视频中的真实帧号，各后端一致；运行报告分别记录实际解码帧数和读到的视频帧数
+ *     * 随机导出的蓄水池入池判断移到过滤链和近重复检查之后，被拒绝的帧不再计入样本总数
+ *     * 近重复索引在选帧时只查询，选中帧的哈希暂存到图像写出成功后再加入索引；
+ *       编码或写出失败、导出取消以及只规划时不加入
  ***********************************************************/
 
 #include "exportthread.h"
 #include <QDir>
 #include <QDateTime>
 #include <QDebug>
+#include <QBuffer>
+#include <QFile>
+#include <QFileInfo>
+#include <QScopedPointer>
+#include <QAbstractEventDispatcher>
+#include <QImageReader>
+#include "tracelogger.h"
+#include "colorconvert.h"
+#include "phash.h"
+#include "framedescriptor.h"
+
+// 统计快照发送间隔(毫秒)
+static const qint64 STATS_PUBLISH_INTERVAL_MS = 500;
+
+// 帧源不提供关键帧标记时，关键帧导出退化为按该间隔(毫秒)取帧
+static const int FALLBACK_KEYFRAME_GAP_MS = 1000;
+
+// 多样性导出每隔该帧数取一个候选，相邻几帧的画面几乎相同
+static const int DIVERSITY_CANDIDATE_STRIDE = 5;
+
+// 多样性导出的候选池容量为选取帧数的倍数，并限制上限以控制缓存的压缩图像
+static const int DIVERSITY_POOL_FACTOR = 4;
+static const int DIVERSITY_POOL_LIMIT = 256;
+
+// 切片或多版本导出时蓄水池/候选池中的帧以 PNG 暂存，结束时解码后只做一次有损编码。
+// 质量 80 对应 zlib 压缩级别 1，1080p 画面每帧约 3~4MB(JPEG 约 0.3MB)，
+// 多样性候选池满 256 帧时约 1GB
+static const int POOL_PNG_QUALITY = 80;
+
+// 像素数不低于该值(4K)的帧按条带转换编码，整帧 RGB32 图像在 8K 下约 130MB
+static const qint64 BAND_ENCODE_MIN_PIXELS = 3840 * 2160;
+
+// 导出预览的最短间隔(毫秒)和最长边(像素)
+static const qint64 PREVIEW_INTERVAL_MS = 250;
+static const int PREVIEW_MAX_SIZE = 240;
+
+// 认领刷新线程: 按固定间隔刷新分片认领，与帧进度无关，导出线程暂停、
+// 等待推理队列或帧源长时间不出帧时认领也不会失效
+class claimRefresher : public QThread
+{
+public:
+  claimRefresher(const QString &directory, const QString &shardId, qint64 intervalMs)
+      : claimDirectory(directory), id(shardId), refreshMs(intervalMs), stopping(false), lost(0) {}
+  ~claimRefresher() override { stop(); }
+
+  // 停止刷新并等待线程退出
+  void stop()
+  {
+    mutex.lock();
+    stopping = true;
+    wake.wakeAll();
+    mutex.unlock();
+    wait();
+  }
+
+  // 认领是否已被其他执行者回收
+  bool isLost() const { return lost.loadAcquire() != 0; }
+
+protected:
+  void run() override
+  {
+    QMutexLocker locker(&mutex);
+    while (!stopping)
+    {
+      wake.wait(&mutex, static_cast<unsigned long>(refreshMs));
+      if (stopping)
+      {
+        break;
+      }
+      if (!exportPlan::refresh(claimDirectory, id))
+      {
+        lost.storeRelease(1);
+        break;
+      }
+    }
+  }
+
+private:
+  QString claimDirectory;
+  QString id;
+  qint64 refreshMs;
+  QMutex mutex;
+  QWaitCondition wake;
+  bool stopping;
+  QAtomicInt lost;
+};
 
 /***********************************************************
  * 函数名称: exportThread
@@ -54,17 +222,45 @@
  * 参数说明:
  *   parent - 父对象指针,默认为nullptr
  * 返回值: 无
- * 备注: 初始化媒体播放器和视频探测器
+ * 备注: 帧源推迟到 run() 中创建，使播放器等对象归属于导出线程
  ***********************************************************/
 exportThread::exportThread(QObject *parent) : QThread(parent),
-                                              mediaPlayer(new QMediaPlayer(this)),
-                                              videoProbe(new QVideoProbe(this))
+                                              exportMode(0),
+                                              interval(30),
+                                              randomCount(10),
+                                              diversityCount(10),
+                                              totalFrames(0),
+                                              frameCount(0),
+                                              isExporting(false),
+                                              traceEnabled(false),
+                                              imageFormat("jpg"),
+                                              imageQuality(-1),
+                                              receivedFrames(0),
+                                              currentFrameNumber(0),
+                                              injectedSource(nullptr),
+                                              keyframeGapMs(0),
+                                              lastSelectedPtsUs(-1),
+                                              keyframeFlagsKnown(true),
+                                              randomSeed(0),
+                                              reservoirSlot(-1),
+                                              staleClaimSeconds(0),
+                                              dedupMaxDistance(6),
+                                              duplicateFrames(0),
+                                              diversitySlot(-1),
+                                              timeBudgetSec(0),
+                                              annotator(nullptr),
+                                              tilesWritten(0),
+                                              tilesSkipped(0),
+                                              currentPtsUs(0),
+                                              activeRange(0),
+                                              currentState(STATE_IDLE),
+                                              pauseRequested(false),
+                                              pausedMs(0),
+                                              previewEnabled(false),
+                                              previewSlot(nullptr),
+                                              manifestEnabled(true),
+                                              manifestCsv(false)
 {
-  // 连接 QVideoProbe 到 QMediaPlayer
-  if (videoProbe->setSource(mediaPlayer))
-  {
-    connect(videoProbe, &QVideoProbe::videoFrameProbed, this, &exportThread::processVideoFrame);
-  }
 }
 
 /***********************************************************
@@ -72,12 +268,13 @@ exportThread::exportThread(QObject *parent) : QThread(parent),
  * 函数功能: 导出线程类的析构函数
  * 参数说明: 无
  * 返回值: 无
- * 备注: 释放媒体播放器和视频探测器资源
+ * 备注: 释放未被使用的注入帧源和未被取走的导出预览
  ***********************************************************/
 exportThread::~exportThread()
 {
-  delete mediaPlayer;
-  delete videoProbe;
+  delete injectedSource;
+  delete annotator;
+  delete previewSlot.fetchAndStoreOrdered(nullptr);
 }
 
 /***********************************************************
@@ -85,55 +282,469 @@ exportThread::~exportThread()
  * 函数功能: 线程运行函数，处理视频导出
  * 参数说明: 无
  * 返回值: 无
- * 备注: 设置视频源并根据导出模式处理视频帧
+ * 备注: 帧源在本线程内创建和销毁，Qt 多媒体后端的事件由本线程处理；
+ *       结束时一定切换到 FINISHED/CANCELLED/FAILED 之一；
+ *       帧源由 QScopedPointer 持有，异常退出时同样释放
  ***********************************************************/
 void exportThread::run()
 {
+  setState(STATE_OPENING);
   try
   {
-    // 设置视频源
-    mediaPlayer->setMedia(QUrl::fromLocalFile(videoFilePath));
+    if (!planInputFile.isEmpty())
+    {
+      runPlan();
+      return;
+    }
+    QScopedPointer<frameSource> source(injectedSource != nullptr ? injectedSource
+                                                                 : frameSource::create(videoFilePath, sourceOptions));
+    injectedSource = nullptr;
+    runSource(source.data());
+  }
+  catch (const std::exception &e)
+  {
+    qDebug() << "Error:" << e.what();
+    setState(STATE_FAILED, QString::fromLocal8Bit(e.what()));
+  }
+}
+
+/***********************************************************
+ * 函数名称: runSource
+ * 函数功能: 从帧源逐帧拉取并导出
+ * 参数说明:
+ *   source - 未打开的帧源
+ * 返回值: 无
+ * 备注: 读取耗时由帧源计入解复用/解码阶段；
+ *       只有被选中的帧才做颜色转换，未选中的帧只付出读取开销；
+ *       大分辨率帧按条带转换编码，不生成整帧 RGB 图像；
+ *       关键帧导出时先请求帧源在解码前丢弃非关键帧，
+ *       等间隔导出时先把采样计划交给帧源，由其跳过不会被导出的帧；
+ *       设置了时间段时先交给帧源跳转，段外的帧在此再筛选一次，
+ *       越过最后一段后停止读取；
+ *       每读一帧前检查暂停和取消请求，取消后不再写出蓄水池和候选池中暂存的帧
+ ***********************************************************/
+void exportThread::runSource(frameSource *source)
+{
+  source->setStats(&stats);
+  if (exportMode == 3)
+  {
+    const bool filtered = source->setKeyframeSampling(true, static_cast<qint64>(keyframeGapMs) * 1000);
+    qDebug() << "关键帧导出:" << (filtered ? "解码前过滤" : "解码后过滤");
+  }
+  else if (exportMode == 0 && interval > 1)
+  {
+    const bool planned = source->setSamplingInterval(interval, interval - 1);
+    qDebug() << "等间隔导出:" << (planned ? "帧源跳过计划外的帧" : "逐帧筛选");
+  }
+  else if (exportMode == 2)
+  {
+    const bool planned = source->setSamplingInterval(DIVERSITY_CANDIDATE_STRIDE, 0);
+    qDebug() << "多样性导出:" << (planned ? "帧源跳过非候选帧" : "逐帧筛选");
+  }
+  if (!timeRanges.isEmpty())
+  {
+    const bool seeking = source->setTimeRanges(timeRanges);
+    qDebug() << "导出时间段:" << timeRanges.size() << "段," << (seeking ? "帧源跳过段外区域" : "逐帧筛选");
+  }
+  keyframeFlagsKnown = source->hasKeyframeFlags();
+  if (exportMode == 3 && !keyframeFlagsKnown)
+  {
+    qDebug() << "帧源" << source->backendName() << "不提供关键帧标记，按时间间隔取帧";
+  }
+
+  if (!source->open(videoFilePath))
+  {
+    qDebug() << "Open source failed:" << videoFilePath << source->errorString();
+    setState(isInterruptionRequested() ? STATE_CANCELLED : STATE_FAILED,
+             QString("%1: %2").arg(videoFilePath).arg(source->errorString()));
+    return;
+  }
+
+  totalFrames = static_cast<int>(qMax<qint64>(source->frameCount(), 0));
+  qDebug() << "帧源:" << source->backendName() << source->width() << "x" << source->height()
+           << source->frameRate() << "fps";
+  qDebug() << "视频总时长:" << source->durationMs() << "ms";
+  qDebug() << "预计总帧数:" << totalFrames;
+
+  const bool tracing = beginExport();
+  if (!dedupIndexFile.isEmpty())
+  {
+    QString error;
+    if (dedup.open(dedupIndexFile, &error))
+    {
+      qDebug() << "近重复索引:" << dedup.size() << "条，距离阈值" << dedupMaxDistance;
+    }
+    else
+    {
+      qDebug() << "Open dedup index failed:" << error;
+    }
+  }
+
+  setState(STATE_RUNNING);
+  frameView frame;
+  while (checkpoint(source) && source->readFrame(frame))
+  {
+    receivedFrames++;
+    currentFrameNumber = frame.index + 1;
+    if (timeBudgetSec > 0 && budgetTimer.elapsed() - pausedMs >= static_cast<qint64>(timeBudgetSec) * 1000)
+    {
+      qDebug() << "超出时间预算" << timeBudgetSec << "秒，在第" << currentFrameNumber << "帧停止读取";
+      break;
+    }
+    if (!timeRanges.isEmpty())
+    {
+      while (activeRange < timeRanges.size() && frame.ptsUs >= timeRanges[activeRange].endUs)
+      {
+        activeRange++;
+      }
+      if (activeRange >= timeRanges.size())
+      {
+        qDebug() << "已越过最后一个导出时间段，停止读取";
+        break;
+      }
+      if (frame.ptsUs < timeRanges[activeRange].beginUs)
+      {
+        continue;
+      }
+    }
+    if (selectFrame(frame))
+    {
+      if (!planOutputFile.isEmpty())
+      {
+        // 只规划: 记录选中帧，不转换不编码
+        if (exportMode == 1)
+        {
+          reservoir.store(reservoirSlot, currentFrameNumber, frame.ptsUs, QByteArray());
+        }
+        else if (exportMode == 2)
+        {
+          diversity.store(diversitySlot, currentFrameNumber, frame.ptsUs, QByteArray());
+        }
+        else
+        {
+          exportPlan::entry item;
+          item.video = videoFilePath;
+          item.ptsUs = frame.ptsUs;
+          item.frameNumber = currentFrameNumber;
+          item.output = planOutputName(currentFrameNumber);
+          plannedEntries.append(item);
+        }
+      }
+      else if (useBandEncoding(frame))
+      {
+        // 大分辨率帧: 逐条带转换并编码，压缩结果的去向与整帧路径相同
+        QByteArray encoded;
+        if (bands.encodeJpeg(frame, imageQuality, encoded, &stats, receivedFrames))
+        {
+          if (exportMode == 1)
+          {
+            reservoir.store(reservoirSlot, currentFrameNumber, frame.ptsUs, encoded);
+          }
+          else if (exportMode == 2)
+          {
+            diversity.store(diversitySlot, currentFrameNumber, frame.ptsUs, encoded);
+          }
+          else
+          {
+            writeImage(encoded, currentFrameNumber);
+          }
+        }
+      }
+      else
+      {
+        {
+          pipelineStats::scopedStage timer(stats, pipelineStats::STAGE_CONVERT, receivedFrames);
+          currentFrame = convertFrameToImage(frame);
+        }
+        currentPtsUs = frame.ptsUs;
+        // 池中的帧结束时还要切片或生成各版本，此时无损暂存
+        const bool losslessPool = tiles.isEnabled() || renditions.isEnabled();
+        const QString poolFormat = losslessPool ? QString("png") : imageFormat;
+        const int poolQuality = losslessPool ? POOL_PNG_QUALITY : imageQuality;
+        if (exportMode == 1)
+        {
+          // 随机导出: 压缩后暂存在蓄水池，可能被后续帧替换，结束时统一写出
+          QByteArray encoded;
+          if (encodeImage(encoded, poolFormat, poolQuality))
+          {
+            reservoir.store(reservoirSlot, currentFrameNumber, frame.ptsUs, encoded);
+          }
+        }
+        else if (exportMode == 2)
+        {
+          // 多样性导出: 候选池中的帧可能在收缩时被剔除，结束时选出后统一写出
+          QByteArray encoded;
+          if (encodeImage(encoded, poolFormat, poolQuality))
+          {
+            diversity.store(diversitySlot, currentFrameNumber, frame.ptsUs, encoded);
+          }
+        }
+        else
+        {
+          saveImage();
+        }
+      }
+    }
+    publishStats(false);
+  }
 
-    // 等待媒体加载完成
-    while (mediaPlayer->mediaStatus() != QMediaPlayer::LoadedMedia)
+  const bool cancelled = isInterruptionRequested();
+  if (cancelled)
+  {
+    qDebug() << "导出已取消，在第" << currentFrameNumber << "帧停止读取";
+  }
+  else
+  {
+    setState(STATE_FINISHING);
+  }
+  if (exportMode == 1 && !cancelled)
+  {
+    flushReservoir();
+  }
+  else if (exportMode == 2 && !cancelled)
+  {
+    flushDiversity();
+  }
+  if (dedup.isOpen())
+  {
+    qDebug() << "近重复跳过:" << duplicateFrames << "帧，索引共" << dedup.size() << "条";
+    dedup.close();
+  }
+  if (filters.isEnabled())
+  {
+    qDebug() << "帧分析过滤:" << filters.report();
+  }
+  if (!planOutputFile.isEmpty() && !cancelled)
+  {
+    QString error;
+    if (!exportPlan::appendEntries(planOutputFile, plannedEntries, &error))
     {
-      QThread::msleep(100);
+      qDebug() << "Failed to write plan:" << planOutputFile << error;
     }
+    qDebug() << "规划完成:" << plannedEntries.size() << "帧写入" << planOutputFile;
+    frameCount = plannedEntries.size();
+  }
+
+  const QString sourceError = source->errorString();
+  if (!sourceError.isEmpty())
+  {
+    qDebug() << "Source stopped:" << sourceError;
+  }
+  isExporting = false;
+
+  const qint64 duration = source->durationMs() >= 0
+                              ? source->durationMs()
+                              : static_cast<qint64>(currentFrameNumber * 1000 / qMax(source->frameRate(), 1.0));
+  source->close();
+  finishExport(duration, tracing);
+  if (cancelled)
+  {
+    setState(STATE_CANCELLED);
+  }
+  else if (!sourceError.isEmpty())
+  {
+    setState(STATE_FAILED, QString("%1: %2").arg(videoFilePath).arg(sourceError));
+  }
+  else
+  {
+    setState(STATE_FINISHED);
+  }
+}
 
-    // 获取视频总时长(毫秒)
-    qint64 duration = mediaPlayer->duration();
+/***********************************************************
+ * 函数名称: beginExport
+ * 函数功能: 导出开始前的公共准备
+ * 参数说明: 无
+ * 返回值: 本次导出是否记录时间线追踪
+ * 备注: 创建导出目录、开启追踪并清空统计和计数器
+ ***********************************************************/
+bool exportThread::beginExport()
+{
+  // 创建导出目录
+  QDir dir(exportPath);
+  if (!dir.exists(exportName))
+  {
+    dir.mkpath(exportName);
+  }
+  reportFileName = QString("%1/%2/export_report.json").arg(exportPath).arg(exportName);
 
-    // 根据视频帧率计算总帧数
-    double frameRate = 25.0; // 默认帧率25fps
-    totalFrames = static_cast<int>(duration / 1000.0 * frameRate);
+  // 开启时间线追踪，环境变量 VIDEOSCREENSHOT_TRACE=1 可强制开启
+  const bool tracing = traceEnabled || qEnvironmentVariableIntValue("VIDEOSCREENSHOT_TRACE") != 0;
+  // 记录器归本线程所有，多个导出同时追踪时互不影响
+  if (tracing)
+  {
+    tracer.start();
+    stats.setTracer(&tracer);
+  }
 
-    qDebug() << "视频总时长:" << duration << "ms";
-    qDebug() << "预计总帧数:" << totalFrames;
+  stats.reset();
+  statsTimer.start();
+  isExporting = true;
+  frameCount = 0;
+  receivedFrames = 0;
+  currentFrameNumber = 0;
+  activeRange = 0;
+  pausedMs = 0;
+  lastSelectedPtsUs = -1;
+  reservoir.reset(randomCount, randomSeed);
+  reservoirSlot = -1;
+  plannedEntries.clear();
+  duplicateFrames = 0;
+  pendingHashes.clear();
+  pendingRecords.clear();
+  filters.reset();
+  diversity.reset(diversityCount, qMax(diversityCount, qMin(diversityCount * DIVERSITY_POOL_FACTOR, DIVERSITY_POOL_LIMIT)));
+  diversitySlot = -1;
+  budgetTimer.start();
 
-    // 创建导出目录
-    QDir dir(exportPath);
-    if (!dir.exists(exportName))
+  // 切片清单追加写入，同一导出目录的多次导出共用一个清单
+  tilesWritten = 0;
+  tilesSkipped = 0;
+  if (tiles.isEnabled() && planOutputFile.isEmpty())
+  {
+    tileManifest.setFileName(QString("%1/%2/tiles.csv").arg(exportPath).arg(exportName));
+    if (!tileManifest.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+      qDebug() << "Open tile manifest failed:" << tileManifest.fileName();
+    }
+    else if (tileManifest.size() == 0)
     {
-      dir.mkdir(exportName);
+      tileManifest.write("tile,video,frame,pts_us,x,y,width,height,frame_width,frame_height\n");
     }
+  }
 
-    // 开始播放视频以触发帧处理
-    isExporting = true;
-    frameCount = 0;
-    mediaPlayer->play();
+  // 逐帧元数据清单同样追加写入；执行计划时各执行者分别写出一个清单，
+  // 避免多台主机经网络文件系统追加同一文件
+  if (manifestEnabled && planOutputFile.isEmpty())
+  {
+    const QString manifestName = planInputFile.isEmpty()
+                                     ? QString("frames.vsm")
+                                     : QString("frames_%1.vsm").arg(exportPlan::workerName());
+    QString error;
+    if (!manifest.create(QString("%1/%2/%3").arg(exportPath).arg(exportName).arg(manifestName), manifestCsv, &error))
+    {
+      qDebug() << "Open frame manifest failed:" << error;
+    }
+  }
 
-    // 等待视频播放完成
-    while (mediaPlayer->state() != QMediaPlayer::StoppedState)
+  // 预标注器在导出线程之外另起推理线程，写出的图像排队等待推理
+  delete annotator;
+  annotator = nullptr;
+  if (!annotation.modelPath.isEmpty() && planOutputFile.isEmpty())
+  {
+    annotator = new yoloAnnotator();
+    QString error;
+    if (annotator->start(annotation, &stats, &error))
+    {
+      qDebug() << "YOLO 预标注:" << annotation.modelPath;
+    }
+    else
     {
-      QThread::msleep(100);
+      qDebug() << "Start YOLO annotator failed:" << error;
+      delete annotator;
+      annotator = nullptr;
     }
+  }
+  return tracing;
+}
+
+/***********************************************************
+ * 函数名称: finishExport
+ * 函数功能: 导出结束后的公共收尾
+ * 参数说明:
+ *   duration - 视频时长(毫秒)
+ *   tracing  - 本次导出是否记录了时间线追踪
+ * 返回值: 无
+ * 备注: 先等预标注处理完已写出的图像，再发送最终统计，
+ *       写出运行报告和追踪文件
+ ***********************************************************/
+void exportThread::finishExport(qint64 duration, bool tracing)
+{
+  qint64 framesAnnotated = 0;
+  qint64 boxesWritten = 0;
+  if (annotator != nullptr)
+  {
+    annotator->finish();
+    framesAnnotated = annotator->annotatedCount();
+    boxesWritten = annotator->boxCount();
+    qDebug() << "YOLO 预标注:" << framesAnnotated << "张图像，" << boxesWritten << "个目标框";
+    delete annotator;
+    annotator = nullptr;
+  }
+
+  if (tileManifest.isOpen())
+  {
+    qDebug() << "切片导出:" << tilesWritten << "个切片，跳过无内容切片" << tilesSkipped << "个";
+    tileManifest.close();
+  }
 
-    // 停止播放
-    mediaPlayer->stop();
+  const QString manifestFile = manifest.fileName();
+  qint64 manifestRows = 0;
+  if (manifest.isWriting())
+  {
+    manifest.close();
+    manifestRows = manifest.rowsWritten();
+    qDebug() << "逐帧元数据清单:" << manifestRows << "行写入" << manifestFile;
   }
-  catch (const std::exception &e)
+
+  publishStats(true);
+  QJsonObject jobInfo;
+  jobInfo["videoFile"] = videoFilePath;
+  jobInfo["exportPath"] = exportPath;
+  jobInfo["exportName"] = exportName;
+  jobInfo["exportMode"] = exportMode;
+  jobInfo["interval"] = interval;
+  jobInfo["keyframeGapMs"] = keyframeGapMs;
+  jobInfo["randomCount"] = randomCount;
+  jobInfo["randomSeed"] = QString::number(randomSeed);
+  jobInfo["diversityCount"] = diversityCount;
+  jobInfo["timeBudgetSec"] = timeBudgetSec;
+  jobInfo["durationMs"] = static_cast<double>(duration);
+  jobInfo["framesProcessed"] = frameCount;
+  jobInfo["framesDecoded"] = static_cast<double>(receivedFrames);
+  jobInfo["framesCovered"] = static_cast<double>(currentFrameNumber);
+  jobInfo["imageFormat"] = imageFormat;
+  jobInfo["imageQuality"] = imageQuality;
+  jobInfo["dedupIndex"] = dedupIndexFile;
+  jobInfo["duplicatesSkipped"] = static_cast<double>(duplicateFrames);
+  jobInfo["frameFilters"] = filters.report();
+  jobInfo["yoloModel"] = annotation.modelPath;
+  jobInfo["framesAnnotated"] = static_cast<double>(framesAnnotated);
+  jobInfo["boxesWritten"] = static_cast<double>(boxesWritten);
+  jobInfo["tileSize"] = tiles.tileSize();
+  jobInfo["tileOverlap"] = tiles.overlap();
+  jobInfo["tilesWritten"] = static_cast<double>(tilesWritten);
+  jobInfo["tilesSkipped"] = static_cast<double>(tilesSkipped);
+  jobInfo["manifest"] = manifestFile;
+  jobInfo["manifestRows"] = static_cast<double>(manifestRows);
+  QStringList renditionNames;
+  for (const renditionSet::rendition &item : renditions.renditions())
   {
-    qDebug() << "Error:" << e.what();
+    renditionNames.append(item.name);
+  }
+  jobInfo["renditions"] = renditionNames.join(',');
+  QStringList rangeTexts;
+  for (const timeRange &range : timeRanges)
+  {
+    rangeTexts.append(formatTimeRange(range));
+  }
+  jobInfo["timeRanges"] = rangeTexts.join(',');
+  jobInfo["toneMap"] = frameView::toneMapName(sourceOptions.toneMap);
+  if (!stats.writeReport(reportFileName, jobInfo))
+  {
+    qDebug() << "Failed to write report:" << reportFileName;
+  }
+
+  if (tracing)
+  {
+    stats.setTracer(nullptr);
+    tracer.stop();
+    QString traceFileName = QString("%1/%2/export_trace.json").arg(exportPath).arg(exportName);
+    if (!tracer.writeChromeTrace(traceFileName))
+    {
+      qDebug() << "Failed to write trace:" << traceFileName;
+    }
+    tracer.clear(); // 释放各线程的事件缓冲区
   }
 }
 
@@ -216,16 +827,120 @@ void exportThread::setRandomCount(int count)
 }
 
 /***********************************************************
- * 函数名称: setOrthogonalCount
- * 函数功能: 设置正交分布数
+ * 函数名称: setDiversityCount
+ * 函数功能: 设置多样性导出的帧数
+ * 参数说明:
+ *   count - 选取帧数
+ * 返回值: 无
+ * 备注: 多样性导出从整个视频中选出画面差异最大的 count 帧
+ ***********************************************************/
+void exportThread::setDiversityCount(int count)
+{
+  diversityCount = count;
+}
+
+/***********************************************************
+ * 函数名称: setTraceEnabled
+ * 函数功能: 设置是否记录时间线追踪
+ * 参数说明:
+ *   enabled - 是否开启
+ * 返回值: 无
+ * 备注: 追踪结果写入导出目录下的 export_trace.json，可用 Perfetto 打开
+ ***********************************************************/
+void exportThread::setTraceEnabled(bool enabled)
+{
+  traceEnabled = enabled;
+}
+
+/***********************************************************
+ * 函数名称: setImageFormat
+ * 函数功能: 设置输出图像格式和质量
+ * 参数说明:
+ *   format  - 图像格式后缀，如 jpg、png、bmp
+ *   quality - 图像质量(0~100)，-1 为编码器默认
+ * 返回值: 无
+ * 备注: 格式名直接传给 QImageWriter
+ ***********************************************************/
+void exportThread::setImageFormat(const QString &format, int quality)
+{
+  imageFormat = format.toLower();
+  imageQuality = quality;
+}
+
+/***********************************************************
+ * 函数名称: setRawVideoFormat
+ * 函数功能: 设置无头 YUV 输入的格式
+ * 参数说明:
+ *   width       - 帧宽度
+ *   height      - 帧高度
+ *   pixelFormat - 像素格式名称，如 yuv420p、nv12
+ *   fps         - 帧率
+ * 返回值: 无
+ * 备注: 仅对 .yuv 文件和无 Y4M 头的标准输入有效
+ ***********************************************************/
+void exportThread::setRawVideoFormat(int width, int height, const QString &pixelFormat, double fps)
+{
+  sourceOptions.rawWidth = width;
+  sourceOptions.rawHeight = height;
+  sourceOptions.rawPixelFormat = pixelFormat;
+  sourceOptions.rawFrameRate = fps > 0 ? fps : 25.0;
+}
+
+/***********************************************************
+ * 函数名称: setDecoder
+ * 函数功能: 设置解码后端和解码线程
+ * 参数说明:
+ *   backend - 后端名称(qt/libav)，为空时自动选择
+ *   threads - 解码线程数，0 为自动
+ *   type    - 解码并行方式(帧级/片级)
+ * 返回值: 无
+ * 备注: 线程参数只对 libav 后端有效
+ ***********************************************************/
+void exportThread::setDecoder(const QString &backend, int threads, frameSourceOptions::ThreadType type)
+{
+  sourceOptions.backend = backend;
+  sourceOptions.decoderThreads = threads;
+  sourceOptions.threadType = type;
+}
+
+/***********************************************************
+ * 函数名称: setFrameSource
+ * 函数功能: 注入自定义帧源
+ * 参数说明:
+ *   source - 未打开的帧源，线程接管其所有权
+ * 返回值: 无
+ * 备注: 用于内存帧源等测试场景，注入后忽略视频文件路径对应的后端
+ ***********************************************************/
+void exportThread::setFrameSource(frameSource *source)
+{
+  delete injectedSource;
+  injectedSource = source;
+}
+
+/***********************************************************
+ * 函数名称: setKeyframeGap
+ * 函数功能: 设置关键帧导出的最小时间间隔
+ * 参数说明:
+ *   gapMs - 最小时间间隔(毫秒)，0 为导出全部关键帧
+ * 返回值: 无
+ * 备注: 仅对关键帧导出模式有效
+ ***********************************************************/
+void exportThread::setKeyframeGap(int gapMs)
+{
+  keyframeGapMs = qMax(0, gapMs);
+}
+
+/***********************************************************
+ * 函数名称: setRandomSeed
+ * 函数功能: 设置随机导出的种子
  * 参数说明:
- *   count - 正交分布数
+ *   seed - 随机种子
  * 返回值: 无
- * 备注: 设置正交分布数
+ * 备注: 相同种子、相同输入和相同随机截图数得到相同的导出帧
  ***********************************************************/
-void exportThread::setOrthogonalCount(int count)
+void exportThread::setRandomSeed(quint64 seed)
 {
-  orthogonalCount = count;
+  randomSeed = seed;
 }
 
 /***********************************************************
@@ -233,64 +948,1062 @@ void exportThread::setOrthogonalCount(int count)
  * 函数功能: 保存图像
  * 参数说明: 无
  * 返回值: 无
- * 备注: 保存图像
+ * 备注: 编码当前帧并立即写出，文件名附加当前帧号
  ***********************************************************/
 void exportThread::saveImage()
 {
-  // 根据导出设置保存图像
-  // 例如：保存到文件
-  QString fileName = QString("%1/%2/%3.jpg")
-                         .arg(exportPath)
-                         .arg(exportName)
-                         .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
-  if (currentFrame.save(fileName))
+  if (tiles.isEnabled() || renditions.isEnabled())
   {
-    qDebug() << "Frame saved to:" << fileName;
+    writeOutputs(currentFrame, imageBaseName(currentFrameNumber), imageFormat, currentFrameNumber, currentPtsUs);
+    return;
+  }
+  QByteArray encoded;
+  if (encodeImage(encoded, imageFormat, imageQuality))
+  {
+    writeImage(encoded, currentFrameNumber, currentFrame);
   }
 }
 
 /***********************************************************
- * 函数名称: processVideoFrame
- * 函数功能: 处理视频帧
+ * 函数名称: encodeImage
+ * 函数功能: 将当前帧编码为图像数据
  * 参数说明:
- *   frame - 视频帧
- * 返回值: 无
- * 备注: 处理视频帧并根据导出设置保存
+ *   encoded - 返回编码后的图像数据
+ *   format  - 图像格式后缀
+ *   quality - 编码质量，-1 为编码器默认
+ * 返回值: 成功返回 true
+ * 备注: 编码与写入分开计时，便于区分 CPU 瓶颈和磁盘瓶颈
  ***********************************************************/
-void exportThread::processVideoFrame(const QVideoFrame &frame)
+bool exportThread::encodeImage(QByteArray &encoded, const QString &format, int quality)
 {
-  QVideoFrame cloneFrame(frame);
-  cloneFrame.map(QAbstractVideoBuffer::ReadOnly);
+  pipelineStats::scopedStage timer(stats, pipelineStats::STAGE_ENCODE, receivedFrames);
+  QBuffer buffer(&encoded);
+  buffer.open(QIODevice::WriteOnly);
+  if (!currentFrame.save(&buffer, format.toLatin1().constData(), quality))
+  {
+    qDebug() << "Frame encode failed, frame:" << currentFrameNumber;
+    return false;
+  }
+  return true;
+}
 
-  QImage image(cloneFrame.bits(),
-               cloneFrame.width(),
-               cloneFrame.height(),
-               QVideoFrame::imageFormatFromPixelFormat(cloneFrame.pixelFormat()));
+/***********************************************************
+ * 函数名称: writeImage
+ * 函数功能: 将图像数据写入导出目录
+ * 参数说明:
+ *   encoded     - 编码后的图像数据
+ *   frameNumber - 帧号，附加在文件名中
+ *   source      - 编码前的图像，供预标注直接使用，可为空
+ * 返回值: 成功返回 true
+ * 备注: 无
+ ***********************************************************/
+bool exportThread::writeImage(const QByteArray &encoded, qint64 frameNumber, const QImage &source)
+{
+  const QString fileName = QString("%1.%2").arg(imageBaseName(frameNumber)).arg(imageFormat);
+  return writeFile(fileName, encoded, frameNumber, source);
+}
 
-  cloneFrame.unmap();
+/***********************************************************
+ * 函数名称: imageBaseName
+ * 函数功能: 生成导出图像不含后缀的路径
+ * 参数说明:
+ *   frameNumber - 帧号，附加在文件名中
+ * 返回值: 导出目录下的 "时间_帧号" 路径
+ * 备注: 无
+ ***********************************************************/
+QString exportThread::imageBaseName(qint64 frameNumber) const
+{
+  return QString("%1/%2/%3_%4")
+      .arg(exportPath)
+      .arg(exportName)
+      .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"))
+      .arg(frameNumber, 6, 10, QChar('0'));
+}
 
-  currentFrame = image.copy();
+/***********************************************************
+ * 函数名称: writeFile
+ * 函数功能: 将图像数据写入指定文件
+ * 参数说明:
+ *   fileName    - 文件路径
+ *   encoded     - 编码后的图像数据
+ *   frameNumber - 帧号，用于阶段统计
+ *   source      - 编码前的图像，供预标注直接使用，可为空
+ * 返回值: 成功返回 true
+ * 备注: 启用预标注时写出成功后提交给预标注器，推理跟不上时在此阻塞；
+ *       source 为空时预标注器自行解码已编码的数据；
+ *       使用近重复索引时，写出成功后该帧暂存的哈希才加入索引
+ ***********************************************************/
+bool exportThread::writeFile(const QString &fileName, const QByteArray &encoded, qint64 frameNumber,
+                             const QImage &source)
+{
+  {
+    pipelineStats::scopedStage timer(stats, pipelineStats::STAGE_WRITE, frameNumber);
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(encoded) != encoded.size())
+    {
+      qDebug() << "Frame save failed:" << fileName;
+      return false;
+    }
+  }
 
-  // 如果正在导出
-  if (isExporting)
+  stats.addBytesWritten(encoded.size());
+  qDebug() << "Frame saved to:" << fileName;
+  offerPreview(fileName, source, encoded);
+  if (annotator != nullptr)
   {
-    if (exportMode == 0)
+    annotator->submit(fileName, source, encoded);
+  }
+  if (dedup.isOpen())
+  {
+    // 图像已落盘才算进入数据集；切片和各版本只在第一个文件写出时加入一次
+    QHash<qint64, quint64>::iterator hash = pendingHashes.find(frameNumber);
+    if (hash != pendingHashes.end())
     {
-      // 平均间隔导出
-      frameCount++;
-      if (frameCount % interval == 0)
-      {
-        // 保存图像
-        saveImage();
-      }
+      dedup.add(hash.value());
+      pendingHashes.erase(hash);
+    }
+  }
+  if (manifest.isWriting())
+  {
+    // 切片和各版本共用同一帧的记录，每个文件一行
+    QHash<qint64, frameManifest::record>::const_iterator found = pendingRecords.constFind(frameNumber);
+    if (found != pendingRecords.constEnd())
+    {
+      frameManifest::record row = found.value();
+      row.file = QDir(QFileInfo(manifest.fileName()).absolutePath()).relativeFilePath(fileName);
+      manifest.append(row);
     }
-    else if (exportMode == 1)
+  }
+  return true;
+}
+
+/***********************************************************
+ * 函数名称: flushReservoir
+ * 函数功能: 写出随机导出蓄水池中的帧
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 按帧号顺序写出，写出后蓄水池清空
+ ***********************************************************/
+void exportThread::flushReservoir()
+{
+  qDebug() << "随机导出: 共" << reservoir.seen() << "帧，选中" << reservoir.size() << "帧";
+  writePicked(reservoir.takeSorted());
+}
+
+/***********************************************************
+ * 函数名称: flushDiversity
+ * 函数功能: 选出并写出多样性导出的帧
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 在候选池内做贪心 k-center 选帧，按帧号顺序写出
+ ***********************************************************/
+void exportThread::flushDiversity()
+{
+  qDebug() << "多样性导出: 共" << diversity.seen() << "个候选，池中" << diversity.poolSize()
+           << "帧，入池半径" << diversity.radius();
+  writePicked(diversity.takeSelected());
+}
+
+/***********************************************************
+ * 函数名称: writePicked
+ * 函数功能: 写出或规划采样器选出的帧
+ * 参数说明:
+ *   picked - 按帧号升序排列的帧
+ * 返回值: 无
+ * 备注: 只做规划时记录为计划条目；使用近重复索引时写出成功的帧由 writeFile 加入索引
+ ***********************************************************/
+void exportThread::writePicked(const QVector<reservoirSampler::entry> &picked)
+{
+  for (const reservoirSampler::entry &item : picked)
+  {
+    if (!planOutputFile.isEmpty())
     {
-      // 随机导出
+      exportPlan::entry planned;
+      planned.video = videoFilePath;
+      planned.ptsUs = item.ptsUs;
+      planned.frameNumber = item.frameNumber;
+      planned.output = planOutputName(item.frameNumber);
+      plannedEntries.append(planned);
     }
-    else if (exportMode == 2)
+    else if (tiles.isEnabled() || renditions.isEnabled())
+    {
+      // 池中为无损 PNG，切片或生成各版本前解码一次，输出只经过一次有损编码
+      QImage frame;
+      {
+        pipelineStats::scopedStage timer(stats, pipelineStats::STAGE_CONVERT, item.frameNumber);
+        frame = QImage::fromData(item.data).convertToFormat(QImage::Format_RGB32);
+      }
+      if (writeOutputs(frame, imageBaseName(item.frameNumber), imageFormat, item.frameNumber, item.ptsUs) > 0)
+      {
+        frameCount++;
+      }
+    }
+    else if (writeImage(item.data, item.frameNumber))
+    {
+      frameCount++;
+    }
+  }
+  pendingHashes.clear();
+  pendingRecords.clear();
+}
+
+/***********************************************************
+ * 函数名称: setPlanOutput
+ * 函数功能: 设置只规划不导出，计划追加到文件
+ * 参数说明:
+ *   planFile - 计划文件路径，为空时恢复直接导出
+ * 返回值: 无
+ * 备注: 按当前导出模式选帧，但只记录选中帧的时间戳和输出文件名，
+ *       不做转换、编码和写入。多个视频可依次追加到同一计划文件
+ ***********************************************************/
+void exportThread::setPlanOutput(const QString &planFile)
+{
+  planOutputFile = planFile;
+}
+
+/***********************************************************
+ * 函数名称: setPlanExecution
+ * 函数功能: 设置执行计划文件
+ * 参数说明:
+ *   planFile       - 计划文件路径
+ *   claimDirectory - 分片认领目录，为空时使用 "<计划文件>.claims"
+ *   staleSeconds   - 认领失效时间(秒)，0 为永不回收
+ * 返回值: 无
+ * 备注: 设置后 run() 不再按视频文件和模式导出，而是认领并执行计划中的分片。
+ *       多个进程(可在不同主机上)指向同一计划文件和认领目录即可并行执行
+ ***********************************************************/
+void exportThread::setPlanExecution(const QString &planFile, const QString &claimDirectory, int staleSeconds)
+{
+  planInputFile = planFile;
+  claimDir = claimDirectory;
+  staleClaimSeconds = qMax(0, staleSeconds);
+}
+
+/***********************************************************
+ * 函数名称: planOutputName
+ * 函数功能: 生成计划条目的输出文件名
+ * 参数说明:
+ *   frameNumber - 帧号
+ * 返回值: 相对于导出根目录的文件名
+ * 备注: 只由导出名称、视频文件名和帧号决定，重复规划得到相同的文件名
+ ***********************************************************/
+QString exportThread::planOutputName(qint64 frameNumber) const
+{
+  return QString("%1/%2_%3.%4")
+      .arg(exportName)
+      .arg(QFileInfo(videoFilePath).completeBaseName())
+      .arg(frameNumber, 6, 10, QChar('0'))
+      .arg(imageFormat);
+}
+
+/***********************************************************
+ * 函数名称: runPlan
+ * 函数功能: 认领并执行计划分片
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 依次尝试认领每个分片(一个视频)，认领成功才执行；执行成功写完成标记，
+ *       读取失败则放弃认领留给其他执行者。运行报告按执行者名称写入认领目录
+ ***********************************************************/
+void exportThread::runPlan()
+{
+  QVector<exportPlan::shard> shards;
+  QString error;
+  if (!exportPlan::load(planInputFile, shards, &error))
+  {
+    qDebug() << "Load plan failed:" << error;
+    setState(STATE_FAILED, error);
+    return;
+  }
+
+  const QString directory = claimDir.isEmpty() ? planInputFile + ".claims" : claimDir;
+  QDir().mkpath(directory);
+
+  const bool tracing = beginExport();
+  reportFileName = QString("%1/report_%2.json").arg(directory).arg(exportPlan::workerName());
+
+  setState(STATE_RUNNING);
+  int executed = 0;
+  for (const exportPlan::shard &part : shards)
+  {
+    if (isInterruptionRequested())
+    {
+      break;
+    }
+    if (exportPlan::isDone(directory, part.id) || !exportPlan::claim(directory, part.id, staleClaimSeconds))
+    {
+      continue;
+    }
+    qDebug() << "认领分片:" << part.id << part.video << part.entries.size() << "帧";
+    const int exported = runShard(part, directory);
+    if (exported < 0)
+    {
+      exportPlan::release(directory, part.id);
+      continue;
+    }
+    exportPlan::markDone(directory, part.id, exported);
+    executed++;
+  }
+
+  const bool cancelled = isInterruptionRequested();
+  qDebug() << (cancelled ? "计划执行已取消:" : "计划执行完成:") << executed << "个分片," << frameCount << "帧";
+  isExporting = false;
+  finishExport(0, tracing);
+  setState(cancelled ? STATE_CANCELLED : STATE_FINISHED);
+}
+
+/***********************************************************
+ * 函数名称: runShard
+ * 函数功能: 执行一个计划分片
+ * 参数说明:
+ *   part           - 分片，条目按时间戳升序
+ *   claimDirectory - 分片认领目录
+ * 返回值: 导出的帧数，帧源打开或读取出错、认领被回收以及被取消时返回 -1
+ * 备注: 顺序读取视频，时间戳与计划条目相差不超过半帧即视为命中；
+ *       最后一个条目命中后立即停止读取。输出格式取自条目文件名后缀。
+ *       设置了认领失效时间时，由单独的线程每半个失效时间刷新一次认领的修改时间，
+ *       执行时间超过失效时间或期间暂停、阻塞的分片不会被其他执行者当作失效认领回收
+ ***********************************************************/
+int exportThread::runShard(const exportPlan::shard &part, const QString &claimDirectory)
+{
+  QScopedPointer<frameSource> source(frameSource::create(part.video, sourceOptions));
+  source->setStats(&stats);
+  if (!source->open(part.video))
+  {
+    qDebug() << "Open source failed:" << part.video << source->errorString();
+    return -1;
+  }
+
+  const qint64 toleranceUs = static_cast<qint64>(500000 / qMax(source->frameRate(), 1.0));
+  int next = 0;
+  int exported = 0;
+  const qint64 refreshMs = static_cast<qint64>(staleClaimSeconds) * 500;
+  QScopedPointer<claimRefresher> refresher;
+  if (refreshMs > 0)
+  {
+    refresher.reset(new claimRefresher(claimDirectory, part.id, refreshMs));
+    refresher->start();
+  }
+  frameView frame;
+  while (next < part.entries.size() && checkpoint(source.data()) && source->readFrame(frame))
+  {
+    if (refresher && refresher->isLost())
+    {
+      qDebug() << "Claim lost:" << part.id << part.video;
+      source->close();
+      return -1;
+    }
+    receivedFrames++;
+    while (next < part.entries.size() && part.entries[next].ptsUs < frame.ptsUs - toleranceUs)
+    {
+      qDebug() << "Planned frame not found:" << part.video << part.entries[next].ptsUs;
+      next++;
+    }
+    if (next < part.entries.size() && qAbs(part.entries[next].ptsUs - frame.ptsUs) <= toleranceUs)
+    {
+      const exportPlan::entry &item = part.entries[next++];
+      if (manifest.isWriting())
+      {
+        pendingRecords.clear();
+        pyramid.build(frame);
+        recordFrame(frame, item.frameNumber, part.video, frameManifest::MODE_PLAN);
+      }
+      {
+        pipelineStats::scopedStage timer(stats, pipelineStats::STAGE_CONVERT, receivedFrames);
+        currentFrame = convertFrameToImage(frame);
+      }
+      const QString fileName = QString("%1/%2").arg(exportPath).arg(item.output);
+      const QFileInfo output(fileName);
+      QDir().mkpath(output.absolutePath());
+      bool written = false;
+      if (tiles.isEnabled() || renditions.isEnabled())
+      {
+        const QString baseName = QString("%1/%2").arg(output.path()).arg(output.completeBaseName());
+        written = writeOutputs(currentFrame, baseName, output.suffix().toLower(), item.frameNumber, frame.ptsUs) > 0;
+      }
+      else
+      {
+        QByteArray encoded;
+        written = encodeImage(encoded, output.suffix().toLower(), imageQuality) &&
+                  writeFile(fileName, encoded, item.frameNumber, currentFrame);
+      }
+      if (written)
+      {
+        exported++;
+        frameCount++;
+      }
+    }
+    publishStats(false);
+  }
+
+  if (next < part.entries.size())
+  {
+    qDebug() << "Planned frames not found:" << part.video << part.entries.size() - next;
+  }
+  const bool failed = !source->errorString().isEmpty() || isInterruptionRequested();
+  if (failed)
+  {
+    qDebug() << "Source stopped:" << part.video << source->errorString();
+  }
+  source->close();
+  return failed ? -1 : exported;
+}
+
+/***********************************************************
+ * 函数名称: publishStats
+ * 函数功能: 按节流间隔发送统计快照
+ * 参数说明:
+ *   force - 为 true 时忽略节流间隔立即发送
+ * 返回值: 无
+ * 备注: 快照生成需要遍历直方图，故限制发送频率
+ ***********************************************************/
+void exportThread::publishStats(bool force)
+{
+  if (!force && statsTimer.isValid() && statsTimer.elapsed() < STATS_PUBLISH_INTERVAL_MS)
+  {
+    return;
+  }
+  statsTimer.restart();
+  emit statsUpdated(stats.snapshot());
+}
+
+/***********************************************************
+ * 函数名称: selectFrame
+ * 函数功能: 判断当前帧是否需要导出
+ * 参数说明:
+ *   frame - 当前帧视图
+ * 返回值: 需要导出返回 true
+ * 备注: 计入过滤阶段耗时，所有帧源共用同一套选帧规则；
+ *       按模式选中的帧先经过帧分析过滤链，再做近重复检查，
+ *       两者共用同一个亮度金字塔，每个候选帧只遍历一次原始帧；
+ *       随机/多样性导出的入池判断在两者之后，被拒绝的帧不占用样本计数
+ ***********************************************************/
+bool exportThread::selectFrame(const frameView &frame)
+{
+  pipelineStats::scopedStage timer(stats, pipelineStats::STAGE_FILTER, receivedFrames);
+  bool selected = false;
+  if (exportMode == 0)
+  {
+    // 平均间隔导出，按帧号判断，帧源跳过计划外的帧后结果不变
+    selected = (frame.index % interval == interval - 1);
+  }
+  else if (exportMode == 1)
+  {
+    // 随机导出，每帧都是候选，入池判断放在近重复检查之后
+    selected = true;
+  }
+  else if (exportMode == 2)
+  {
+    // 多样性导出，先按候选间隔筛选，入池判断放在近重复检查之后
+    selected = (frame.index % DIVERSITY_CANDIDATE_STRIDE == 0);
+  }
+  else if (exportMode == 3)
+  {
+    // 关键帧导出，帧源已在解码前过滤时这里只是兜底检查
+    const int gapMs = keyframeFlagsKnown ? keyframeGapMs : qMax(keyframeGapMs, FALLBACK_KEYFRAME_GAP_MS);
+    selected = (frame.keyframe || !keyframeFlagsKnown) &&
+               (lastSelectedPtsUs < 0 || frame.ptsUs - lastSelectedPtsUs >= static_cast<qint64>(gapMs) * 1000);
+  }
+
+  // 过滤链按开销从低到高短路，近重复检查需要查询索引，放在最后；
+  // 写出清单时选中帧的哈希、清晰度和亮度同样取自金字塔
+  const bool analysed = selected && (filters.isEnabled() || dedup.isOpen() || manifest.isWriting()) &&
+                        pyramid.build(frame);
+  if (selected && filters.isEnabled() && !filters.evaluate(pyramid))
+  {
+    selected = false;
+  }
+
+  // 已在数据集中的画面不再导出
+  quint64 hash = 0;
+  if (selected && dedup.isOpen() && isDuplicate(pyramid, hash))
+  {
+    selected = false;
+  }
+  if (selected && exportMode == 1)
+  {
+    // 蓄水池只统计通过过滤和去重的帧，落选的帧不做转换和编码
+    reservoirSlot = reservoir.offer();
+    selected = reservoirSlot >= 0;
+  }
+  if (selected && exportMode == 2)
+  {
+    frameDescriptor descriptor;
+    diversitySlot = computeDescriptor(frame, descriptor) ? diversity.offer(descriptor) : -1;
+    selected = diversitySlot >= 0;
+  }
+  if (selected && exportMode == 3)
+  {
+    lastSelectedPtsUs = frame.ptsUs;
+  }
+  if (selected && dedup.isOpen() && planOutputFile.isEmpty())
+  {
+    // 哈希暂存到图像写出成功时再加入索引；只规划时不导出图像，不加入。
+    // 随机/多样性导出的入池帧到结束时才写出，其余模式的上一帧此时已写出或已失败
+    if (exportMode != 1 && exportMode != 2)
+    {
+      pendingHashes.clear();
+    }
+    pendingHashes.insert(currentFrameNumber, hash);
+  }
+  if (selected && analysed)
+  {
+    filters.commit(pyramid);
+  }
+  if (selected && manifest.isWriting())
+  {
+    // 随机/多样性导出的入池帧到结束时才写出，其余模式的上一帧此时已写出
+    if (exportMode != 1 && exportMode != 2)
+    {
+      pendingRecords.clear();
+    }
+    recordFrame(frame, currentFrameNumber, videoFilePath, static_cast<quint8>(exportMode));
+  }
+  if (selected && exportMode != 1 && exportMode != 2)
+  {
+    frameCount++;
+  }
+  return selected;
+}
+
+/***********************************************************
+ * 函数名称: setDedupIndex
+ * 函数功能: 设置跨数据集近重复索引
+ * 参数说明:
+ *   indexFile   - 索引文件路径，为空时不去重
+ *   maxDistance - 视为近重复的最大汉明距离(0~11)
+ * 返回值: 无
+ * 备注: 索引在导出开始时打开，写出成功的帧随即加入索引，
+ *       之后的导出(包括其他进程)不会再导出相同画面
+ ***********************************************************/
+void exportThread::setDedupIndex(const QString &indexFile, int maxDistance)
+{
+  dedupIndexFile = indexFile;
+  dedupMaxDistance = qBound(0, maxDistance, static_cast<int>(dedupIndex::MAX_DISTANCE));
+}
+
+/***********************************************************
+ * 函数名称: isDuplicate
+ * 函数功能: 判断候选帧是否与索引中的图像近重复
+ * 参数说明:
+ *   candidate - 候选帧的亮度金字塔
+ *   hash      - 返回候选帧的感知哈希
+ * 返回值: 近重复返回 true
+ * 备注: 哈希取自过滤链已生成的亮度金字塔，在颜色转换和编码之前完成，
+ *       与直接从原始帧计算的哈希相同；
+ *       这里只查询索引，选中帧的哈希由 selectFrame 暂存，图像写出成功后才加入，
+ *       已写出的画面在同一视频内同样会被跳过
+ ***********************************************************/
+bool exportThread::isDuplicate(const lumaPyramid &candidate, quint64 &hash)
+{
+  hash = perceptualHash(candidate);
+  if (dedup.contains(hash, dedupMaxDistance))
+  {
+    duplicateFrames++;
+    return true;
+  }
+  return false;
+}
+
+/***********************************************************
+ * 函数名称: setTimeBudget
+ * 函数功能: 设置每个视频的处理时间预算
+ * 参数说明:
+ *   seconds - 预算(秒)，0 为不限
+ * 返回值: 无
+ * 备注: 从导出开始计时，超出后停止读取，已选中的帧照常写出；
+ *       对所有导出模式生效，用于限制超长视频占用的时间
+ ***********************************************************/
+void exportThread::setTimeBudget(int seconds)
+{
+  timeBudgetSec = qMax(0, seconds);
+}
+
+/***********************************************************
+ * 函数名称: setAnnotation
+ * 函数功能: 设置 YOLO 预标注
+ * 参数说明:
+ *   settings - 预标注参数，模型路径为空表示不标注
+ * 返回值: 无
+ * 备注: 每次导出开始时加载模型，导出结束前等待所有标注写出
+ ***********************************************************/
+void exportThread::setAnnotation(const yoloAnnotator::options &settings)
+{
+  annotation = settings;
+}
+
+/***********************************************************
+ * 函数名称: setTiling
+ * 函数功能: 设置切片导出
+ * 参数说明:
+ *   tileSize  - 切片边长(像素)，0 为导出整帧
+ *   overlap   - 相邻切片重叠(像素)
+ *   minStdDev - 亮度标准差低于此值的切片不导出，0 为全部导出
+ * 返回值: 无
+ * 备注: 对所有导出模式和计划执行生效，只规划时不切片
+ ***********************************************************/
+void exportThread::setTiling(int tileSize, int overlap, double minStdDev)
+{
+  tiles.setTiling(tileSize, overlap, minStdDev);
+}
+
+/***********************************************************
+ * 函数名称: writeOutputs
+ * 函数功能: 将一帧的切片和各版本并行编码后写出
+ * 参数说明:
+ *   frame       - 已转换的整帧图像
+ *   baseName    - 不含后缀的输出路径。切片文件名附加 "_x<列>_y<行>"，
+ *                 版本写到同目录下以版本名称命名的子目录
+ *   format      - 切片的图像格式后缀
+ *   frameNumber - 帧号
+ *   ptsUs       - 显示时间戳(微秒)，写入切片清单
+ * 返回值: 写出的图像数
+ * 备注: 切片是整帧缓冲区上的视图，各版本由整帧级联缩小得到，
+ *       全部图像作为一批在线程池中并行编码，写出和清单在本线程
+ *       按顺序进行。写出的图像不附带原图交给预标注，预标注器从
+ *       编码数据解码，视图不会在整帧释放后被访问
+ ***********************************************************/
+int exportThread::writeOutputs(const QImage &frame, const QString &baseName, const QString &format,
+                               qint64 frameNumber, qint64 ptsUs)
+{
+  if (frame.isNull())
+  {
+    return 0;
+  }
+
+  QVector<parallelEncoder::job> jobs;
+  QStringList fileNames;
+  QVector<tileSlicer::tile> kept;
+  {
+    pipelineStats::scopedStage timer(stats, pipelineStats::STAGE_FILTER, frameNumber);
+    for (const tileSlicer::tile &rect : tiles.layout(frame.width(), frame.height()))
+    {
+      const QImage view = tileSlicer::view(frame, rect);
+      if (tiles.isBlank(view))
+      {
+        tilesSkipped++;
+        continue;
+      }
+      parallelEncoder::job item;
+      item.image = view;
+      item.format = format.toLatin1();
+      item.quality = imageQuality;
+      jobs.append(item);
+      fileNames.append(QString("%1_x%2_y%3.%4").arg(baseName).arg(rect.x).arg(rect.y).arg(format));
+      kept.append(rect);
+    }
+  }
+  if (renditions.isEnabled())
+  {
+    pipelineStats::scopedStage timer(stats, pipelineStats::STAGE_FILTER, frameNumber);
+    const QFileInfo base(baseName);
+    const QVector<QImage> images = renditions.build(frame);
+    for (int i = 0; i < images.size(); ++i)
+    {
+      const renditionSet::rendition &target = renditions.renditions()[i];
+      const QString directory = QString("%1/%2").arg(base.path()).arg(target.name);
+      QDir().mkpath(directory);
+      parallelEncoder::job item;
+      item.image = images[i];
+      item.format = target.format;
+      item.quality = target.quality;
+      jobs.append(item);
+      fileNames.append(QString("%1/%2.%3").arg(directory).arg(base.fileName()).arg(QString::fromLatin1(target.format)));
+    }
+  }
+
+  const QVector<QByteArray> encoded = encoder.encode(jobs, &stats, frameNumber);
+  const QDir manifestDir(QFileInfo(tileManifest.fileName()).absolutePath());
+  int written = 0;
+  for (int i = 0; i < jobs.size(); ++i)
+  {
+    if (encoded[i].isEmpty() || !writeFile(fileNames[i], encoded[i], frameNumber))
+    {
+      continue;
+    }
+    written++;
+    if (i >= kept.size())
+    {
+      continue;
+    }
+    const tileSlicer::tile &rect = kept[i];
+    tilesWritten++;
+    if (tileManifest.isOpen())
+    {
+      QString video = videoFilePath;
+      video.replace('"', "\"\"");
+      QStringList fields;
+      fields << manifestDir.relativeFilePath(fileNames[i]) << QString("\"%1\"").arg(video)
+             << QString::number(frameNumber) << QString::number(ptsUs)
+             << QString::number(rect.x) << QString::number(rect.y)
+             << QString::number(rect.width) << QString::number(rect.height)
+             << QString::number(frame.width()) << QString::number(frame.height());
+      tileManifest.write((fields.join(',') + '\n').toUtf8());
+    }
+  }
+  return written;
+}
+
+/***********************************************************
+ * 函数名称: setRenditions
+ * 函数功能: 设置多分辨率输出版本
+ * 参数说明:
+ *   list - 输出版本，为空表示只导出一张原图
+ * 返回值: 无
+ * 备注: 配置了版本时不再写出默认的整帧图像，原图需要时配置
+ *       边长为 0 的版本；可与切片导出同时使用
+ ***********************************************************/
+void exportThread::setRenditions(const QVector<renditionSet::rendition> &list)
+{
+  renditions.setRenditions(list);
+}
+
+/***********************************************************
+ * 函数名称: setTimeRanges
+ * 函数功能: 设置导出时间段
+ * 参数说明:
+ *   ranges - 导出时间段，任意顺序，为空表示整个视频
+ * 返回值: 无
+ * 备注: 排序并合并重叠的时间段；只对按模式导出生效，执行计划文件时忽略
+ ***********************************************************/
+void exportThread::setTimeRanges(const QVector<timeRange> &ranges)
+{
+  timeRanges = normalizeTimeRanges(ranges);
+}
+
+/***********************************************************
+ * 函数名称: useBandEncoding
+ * 函数功能: 判断当前帧是否按条带转换编码
+ * 参数说明:
+ *   frame - 已选中的帧
+ * 返回值: 可以按条带编码时返回 true
+ * 备注: 只用于 4K 及以上、输出 JPEG 且不切片、不输出多个版本的导出；
+ *       切片和多分辨率版本需要整帧图像。预标注器收到的是压缩数据，自行解码
+ ***********************************************************/
+bool exportThread::useBandEncoding(const frameView &frame) const
+{
+  return bandEncoder::isAvailable() && (imageFormat == "jpg" || imageFormat == "jpeg") &&
+         !tiles.isEnabled() && !renditions.isEnabled() &&
+         static_cast<qint64>(frame.width) * frame.height >= BAND_ENCODE_MIN_PIXELS;
+}
+
+/***********************************************************
+ * 函数名称: setToneMap
+ * 函数功能: 设置 HDR 帧的色调映射方式
+ * 参数说明:
+ *   mode - 色调映射方式
+ * 返回值: 无
+ * 备注: 只对 libav 后端解码的 PQ/HLG 帧有效，SDR 帧不受影响
+ ***********************************************************/
+void exportThread::setToneMap(frameView::ToneMap mode)
+{
+  sourceOptions.toneMap = mode;
+}
+
+/***********************************************************
+ * 函数名称: state
+ * 函数功能: 获取当前导出状态
+ * 参数说明: 无
+ * 返回值: 当前导出状态
+ * 备注: 可在任意线程调用
+ ***********************************************************/
+exportThread::State exportThread::state() const
+{
+  return static_cast<State>(currentState.loadAcquire());
+}
+
+/***********************************************************
+ * 函数名称: stateName
+ * 函数功能: 获取导出状态名称
+ * 参数说明:
+ *   value - 导出状态
+ * 返回值: 状态名称，用于日志
+ * 备注: 无
+ ***********************************************************/
+QString exportThread::stateName(State value)
+{
+  switch (value)
+  {
+  case STATE_IDLE:
+    return "idle";
+  case STATE_OPENING:
+    return "opening";
+  case STATE_RUNNING:
+    return "running";
+  case STATE_PAUSED:
+    return "paused";
+  case STATE_FINISHING:
+    return "finishing";
+  case STATE_FINISHED:
+    return "finished";
+  case STATE_CANCELLED:
+    return "cancelled";
+  default:
+    return "failed";
+  }
+}
+
+/***********************************************************
+ * 函数名称: pause
+ * 函数功能: 请求暂停导出
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 可在任意线程调用；导出线程在读取下一帧前进入暂停，
+ *       正在编码或写出的帧先完成
+ ***********************************************************/
+void exportThread::pause()
+{
+  QMutexLocker locker(&pauseMutex);
+  pauseRequested = true;
+}
+
+/***********************************************************
+ * 函数名称: resume
+ * 函数功能: 继续已暂停的导出
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 可在任意线程调用
+ ***********************************************************/
+void exportThread::resume()
+{
+  QMutexLocker locker(&pauseMutex);
+  pauseRequested = false;
+  pauseChanged.wakeAll();
+}
+
+/***********************************************************
+ * 函数名称: cancel
+ * 函数功能: 请求取消导出
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 可在任意线程调用。设置中断请求后唤醒暂停等待和导出线程的事件分发器，
+ *       阻塞在 Qt 多媒体事件等待中的读取也会立即返回，最多再处理完当前一帧
+ ***********************************************************/
+void exportThread::cancel()
+{
+  requestInterruption();
+  {
+    QMutexLocker locker(&pauseMutex);
+    pauseChanged.wakeAll();
+  }
+  QAbstractEventDispatcher *dispatcher = eventDispatcher();
+  if (dispatcher != nullptr)
+  {
+    dispatcher->wakeUp();
+  }
+}
+
+/***********************************************************
+ * 函数名称: setState
+ * 函数功能: 切换导出状态并通知界面
+ * 参数说明:
+ *   value  - 新状态
+ *   detail - 说明，出错时为出错原因
+ * 返回值: 无
+ * 备注: 信号在导出线程发出，界面线程的槽以排队方式执行
+ ***********************************************************/
+void exportThread::setState(State value, const QString &detail)
+{
+  currentState.storeRelease(value);
+  qDebug() << "导出状态:" << stateName(value) << detail;
+  emit stateChanged(value, detail);
+}
+
+/***********************************************************
+ * 函数名称: checkpoint
+ * 函数功能: 每帧检查暂停和取消请求
+ * 参数说明:
+ *   source - 当前帧源
+ * 返回值: 可以继续读取返回 true，已取消返回 false
+ * 备注: 暂停时先让帧源停止推送，再阻塞在条件变量上直到继续或取消，
+ *       期间不轮询；暂停时长从时间预算中扣除
+ ***********************************************************/
+bool exportThread::checkpoint(frameSource *source)
+{
+  if (isInterruptionRequested())
+  {
+    return false;
+  }
+  pauseMutex.lock();
+  const bool paused = pauseRequested;
+  pauseMutex.unlock();
+  if (!paused)
+  {
+    return true;
+  }
+
+  source->setPaused(true);
+  setState(STATE_PAUSED);
+  QElapsedTimer pauseTimer;
+  pauseTimer.start();
+  pauseMutex.lock();
+  while (pauseRequested && !isInterruptionRequested())
+  {
+    pauseChanged.wait(&pauseMutex);
+  }
+  pauseMutex.unlock();
+  pausedMs += pauseTimer.elapsed();
+  source->setPaused(false);
+
+  if (isInterruptionRequested())
+  {
+    return false;
+  }
+  setState(STATE_RUNNING);
+  return true;
+}
+
+/***********************************************************
+ * 函数名称: setPreviewEnabled
+ * 函数功能: 设置是否生成导出预览
+ * 参数说明:
+ *   enabled - 是否生成
+ * 返回值: 无
+ * 备注: 需在 start() 前调用
+ ***********************************************************/
+void exportThread::setPreviewEnabled(bool enabled)
+{
+  previewEnabled = enabled;
+}
+
+/***********************************************************
+ * 函数名称: takePreview
+ * 函数功能: 取走最新的导出预览
+ * 参数说明:
+ *   image    - 返回缩小后的图像
+ *   fileName - 返回对应的导出文件，可为空
+ * 返回值: 有上次取走后新放入的预览时返回 true
+ * 备注: 可在任意线程调用，只做一次原子交换，不会等待导出线程
+ ***********************************************************/
+bool exportThread::takePreview(QImage &image, QString *fileName)
+{
+  previewFrame *item = previewSlot.fetchAndStoreOrdered(nullptr);
+  if (item == nullptr)
+  {
+    return false;
+  }
+  image = item->image;
+  if (fileName)
+  {
+    *fileName = item->fileName;
+  }
+  delete item;
+  return true;
+}
+
+/***********************************************************
+ * 函数名称: offerPreview
+ * 函数功能: 按节流间隔生成导出预览放入最新值槽
+ * 参数说明:
+ *   fileName - 刚写出的文件
+ *   source   - 编码前的图像，可为空
+ *   encoded  - 编码后的图像数据
+ * 返回值: 无
+ * 备注: 距上一张不足 PREVIEW_INTERVAL_MS 时只做一次计时比较即返回。
+ *       有编码前的图像时最近邻缩小；只有编码数据时(条带编码、蓄水池、
+ *       切片和各版本)按缩小尺寸解码，JPEG 在 DCT 域缩小，不解出整帧。
+ *       槽中的旧预览未被取走时直接替换并释放
+ ***********************************************************/
+void exportThread::offerPreview(const QString &fileName, const QImage &source, const QByteArray &encoded)
+{
+  if (!previewEnabled || (previewTimer.isValid() && previewTimer.elapsed() < PREVIEW_INTERVAL_MS))
+  {
+    return;
+  }
+  previewTimer.start();
+
+  previewFrame *item = new previewFrame;
+  item->fileName = fileName;
+  if (!source.isNull())
+  {
+    item->image = source.scaled(PREVIEW_MAX_SIZE, PREVIEW_MAX_SIZE, Qt::KeepAspectRatio, Qt::FastTransformation);
+  }
+  else
+  {
+    QBuffer buffer;
+    buffer.setData(encoded);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    const QSize size = reader.size();
+    if (size.isValid())
+    {
+      reader.setScaledSize(size.scaled(PREVIEW_MAX_SIZE, PREVIEW_MAX_SIZE, Qt::KeepAspectRatio));
+    }
+    item->image = reader.read();
+  }
+  if (item->image.isNull())
+  {
+    delete item;
+    return;
+  }
+  delete previewSlot.fetchAndStoreOrdered(item);
+}
+
+/***********************************************************
+ * 函数名称: setFrameFilters
+ * 函数功能: 设置帧分析过滤链
+ * 参数说明:
+ *   settings - 清晰度、场景变化和运动量过滤的阈值，0 表示不启用
+ * 返回值: 无
+ * 备注: 需在 start() 前调用；过滤链只作用于按导出模式选中的候选帧，
+ *       执行计划文件时按计划导出，不再过滤
+ ***********************************************************/
+void exportThread::setFrameFilters(const filterChain::options &settings)
+{
+  filters.configure(settings);
+}
+
+/***********************************************************
+ * 函数名称: setManifest
+ * 函数功能: 设置是否写出逐帧元数据清单
+ * 参数说明:
+ *   enabled  - 是否写出导出目录下的 frames.vsm
+ *   writeCsv - 是否同时写出 frames.csv
+ * 返回值: 无
+ * 备注: 需在 start() 前调用；默认写出二进制清单，不写 CSV；
+ *       只做规划时不写出图像，也不写清单
+ ***********************************************************/
+void exportThread::setManifest(bool enabled, bool writeCsv)
+{
+  manifestEnabled = enabled;
+  manifestCsv = writeCsv;
+}
+
+/***********************************************************
+ * 函数名称: recordFrame
+ * 函数功能: 暂存选中帧的清单记录
+ * 参数说明:
+ *   frame       - 选中帧的帧视图
+ *   frameNumber - 帧号，写出图像时按帧号取回记录
+ *   video       - 来源视频
+ *   mode        - 导出模式，执行计划时为 frameManifest::MODE_PLAN
+ * 返回值: 无
+ * 备注: 调用前亮度金字塔须已由该帧生成；金字塔无效(不支持的帧格式)时
+ *       只记录来源、时间戳和尺寸。平均亮度取 32x32 层，只需 1024 次加法
+ ***********************************************************/
+void exportThread::recordFrame(const frameView &frame, qint64 frameNumber, const QString &video, quint8 mode)
+{
+  frameManifest::record row;
+  row.video = video;
+  row.frameNumber = frameNumber;
+  row.ptsUs = frame.ptsUs;
+  row.width = frame.width;
+  row.height = frame.height;
+  row.mode = mode;
+  row.flags = frame.keyframe ? frameManifest::FLAG_KEYFRAME : 0;
+  if (pyramid.isValid())
+  {
+    const int top = lumaPyramid::LEVEL_COUNT - 1;
+    const int count = lumaPyramid::levelSize(top) * lumaPyramid::levelSize(top);
+    const quint8 *luma = pyramid.level(top);
+    qint64 sum = 0;
+    for (int i = 0; i < count; ++i)
     {
-      // 正交分布导出
+      sum += luma[i];
     }
+    row.hash = perceptualHash(pyramid);
+    row.sharpness = static_cast<float>(pyramid.gradientMean());
+    row.brightness = static_cast<float>(sum) / count;
+    row.flags |= frameManifest::FLAG_ANALYSED;
   }
+  pendingRecords.insert(frameNumber, row);
 }
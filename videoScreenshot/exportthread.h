@@ -33,52 +33,193 @@
  *   6. setExportMode             - 设置导出模式
  *   7. setInterval               - 设置间隔帧数
  *   8. setRandomCount            - 设置随机截图数
- *   9. setOrthogonalCount        - 设置正交分布数
+ *   9. setDiversityCount         - 设置多样性导出的帧数
  *   10. run                      - 线程运行函数，处理视频导出
- *   11. processVideoFrame        - 处理视频帧
+ *   11. runSource                - 从帧源逐帧拉取并导出
  *   12. saveImage                - 保存图像
+ *   13. statsUpdated             - 信号，周期性发送流水线统计快照
+ *   14. publishStats             - 按节流间隔发送统计快照
+ *   15. setTraceEnabled          - 设置是否记录时间线追踪
+ *   16. setImageFormat           - 设置输出图像格式和质量
+ *   17. setRawVideoFormat        - 设置无头 YUV 输入的格式
+ *   18. beginExport              - 导出开始前的公共准备
+ *   19. finishExport             - 导出结束后的公共收尾
+ *   20. selectFrame              - 判断当前帧是否需要导出
+ *   21. setDecoder               - 设置解码后端和解码线程
+ *   22. setFrameSource           - 注入自定义帧源
+ *   23. setKeyframeGap           - 设置关键帧导出的最小时间间隔
+ *   24. setRandomSeed            - 设置随机导出的种子
+ *   25. encodeImage              - 将当前帧编码为图像数据
+ *   26. writeImage               - 将图像数据写入导出目录
+ *   27. flushReservoir           - 写出随机导出蓄水池中的帧
+ *   28. setPlanOutput            - 设置只规划不导出，计划追加到文件
+ *   29. setPlanExecution         - 设置执行计划文件
+ *   30. runPlan                  - 认领并执行计划分片
+ *   31. runShard                 - 执行一个计划分片
+ *   32. planOutputName           - 生成计划条目的输出文件名
+ *   33. writeFile                - 将图像数据写入指定文件
+ *   34. setDedupIndex            - 设置跨数据集近重复索引
+ *   35. isDuplicate              - 判断候选帧是否与索引中的图像近重复
+ *   36. setTimeBudget            - 设置每个视频的处理时间预算
+ *   37. flushDiversity           - 选出并写出多样性导出的帧
+ *   38. writePicked              - 写出或规划采样器选出的帧
+ *   39. setAnnotation            - 设置 YOLO 预标注
+ *   40. setTiling                - 设置切片导出
+ *   41. writeOutputs             - 将一帧的切片和各版本并行编码后写出
+ *   42. imageBaseName            - 生成导出图像不含后缀的路径
+ *   43. setRenditions            - 设置多分辨率输出版本
+ *   44. setTimeRanges            - 设置导出时间段
+ *   45. useBandEncoding          - 判断当前帧是否按条带转换编码
+ *   46. setToneMap               - 设置 HDR 帧的色调映射方式
+ *   47. state                    - 获取当前导出状态
+ *   48. stateName                - 获取导出状态名称
+ *   49. pause                    - 请求暂停导出
+ *   50. resume                   - 继续已暂停的导出
+ *   51. cancel                   - 请求取消导出
+ *   52. setState                 - 切换导出状态并通知界面
+ *   53. checkpoint               - 每帧检查暂停和取消请求
+ *   54. setPreviewEnabled        - 设置是否生成导出预览
+ *   55. takePreview              - 取走最新的导出预览
+ *   56. offerPreview             - 按节流间隔生成导出预览
+ *   57. setFrameFilters          - 设置帧分析过滤链
+ *   58. setManifest              - 设置是否写出逐帧元数据清单
+ *   59. recordFrame              - 暂存选中帧的清单记录
  *
  * 版本历史:
  *   - 版本 1.0 (2025-02-05) - LiuJiaLe
  *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 增加分阶段流水线统计和 JSON 运行报告
+ *     * 增加 Chrome trace-event 时间线追踪，每个导出使用自己的追踪记录器
+ *     * 支持选择输出图像格式，文件名附加帧号避免同一秒内覆盖
+ *     * 支持 Y4M/无头 YUV/标准输入的免解码原始帧输入
+ *     * 改为从帧源接口拉取帧，QMediaPlayer 移入导出线程内创建
+ *     * 增加关键帧导出模式，可按最小时间间隔稀疏化
+ *     * 等间隔导出预先把采样计划交给帧源，按帧号选帧
+ *     * 随机导出改为带种子的单遍蓄水池采样，只缓存 k 帧压缩图像
+ *     * 支持只规划不导出生成计划文件，以及多进程/多主机分片执行计划文件
+ *     * 编码前按持久化感知哈希索引跳过与已有数据集近重复的帧
+ *     * 正交分布导出占位改为多样性导出: 流式 k-center 选出画面差异最大的帧
+ *     * 写出图像后交给 YOLO 预标注器批量推理，在同目录写出标注文件
+ *     * 增加 SAHI 式切片导出: 零拷贝切片视图并行编码，坐标写入切片清单
+ *     * 支持一次解码输出多个分辨率版本，级联缩小后与切片一起并行编码；
+ *       随机/多样性导出时池中帧以 PNG 暂存，避免二次有损压缩
+ *     * 支持每个视频多个导出时间段，帧源跳转越过段外区域
+ *     * 4K 及以上的帧按条带转换并编码为 JPEG，不生成整帧 RGB 图像
+ *     * 支持 10bit HDR 输入，转换为 8bit 时按所选方式做色调映射
+ *     * 导出生命周期改为显式状态: 可暂停/继续/取消，出错原因经 stateChanged 通知界面
+ *     * 增加导出预览: 按节流间隔把刚写出的帧缩小后放入无锁的最新值槽，界面定时取走
+ *     * 增加帧分析过滤链: 候选帧只生成一次亮度金字塔，清晰度/场景变化/运动量过滤和近重复检查共用
+ *     * 每写出一张图像向按列存放的逐帧元数据清单追加一行，可选同时写出 CSV
+ *     * 执行计划分片期间由单独的线程每半个认领失效时间刷新一次认领，暂停或阻塞时
+ *       认领也不会失效；认领被回收时停止该分片
+ *     * 文件名、计划条目和清单改用帧源给出的帧序号，帧源跳帧时仍是视频中的真实帧号
+ *     * 近重复索引在选帧时只查询，图像写出成功后才加入；只规划时不加入
  ***********************************************************/
 
 #ifndef EXPORTTHREAD_H
 #define EXPORTTHREAD_H
 
 #include <QThread>
-#include <QMediaPlayer>
-#include <QVideoProbe>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QMutex>
+#include <QWaitCondition>
 #include <QImage>
 #include <QString>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QFile>
+
+#include "framesource.h"
+#include "pipelinestats.h"
+#include "reservoirsampler.h"
+#include "exportplan.h"
+#include "dedupindex.h"
+#include "diversitysampler.h"
+#include "yoloannotator.h"
+#include "tileslicer.h"
+#include "renditionset.h"
+#include "parallelencoder.h"
+#include "bandencoder.h"
+#include "lumapyramid.h"
+#include "filterchain.h"
+#include "framemanifest.h"
 
 class exportThread : public QThread
 {
     Q_OBJECT
 
 public:
+    // 导出状态，每次切换都经 stateChanged 信号通知
+    enum State
+    {
+        STATE_IDLE = 0,  // 尚未开始
+        STATE_OPENING,   // 正在打开帧源
+        STATE_RUNNING,   // 正在读取和导出
+        STATE_PAUSED,    // 已暂停，导出线程阻塞等待继续或取消，不占用 CPU
+        STATE_FINISHING, // 读取结束，正在写出暂存的帧和运行报告
+        STATE_FINISHED,  // 正常结束
+        STATE_CANCELLED, // 已取消
+        STATE_FAILED     // 出错结束
+    };
+    Q_ENUM(State)
+
     explicit exportThread(QObject *parent = nullptr);
     ~exportThread();
 
+    State state() const;                        // 获取当前导出状态，线程安全
+    static QString stateName(State value);      // 获取导出状态名称
+    void pause();                               // 请求暂停导出，线程安全
+    void resume();                              // 继续已暂停的导出，线程安全
+    void cancel();                              // 请求取消导出，线程安全
+
     void setVideoFile(const QString &filePath); // 设置视频文件路径
     void setExportPath(const QString &path);    // 设置导出路径
     void setExportName(const QString &name);    // 设置导出名称
     void setExportMode(int mode);               // 设置导出模式
     void setInterval(int interval);             // 设置间隔帧数
     void setRandomCount(int count);             // 设置随机截图数
-    void setOrthogonalCount(int count);         // 设置正交分布数
+    void setDiversityCount(int count);          // 设置多样性导出的帧数
+    void setTraceEnabled(bool enabled);         // 设置是否记录时间线追踪
+    void setImageFormat(const QString &format,
+                        int quality = -1);      // 设置输出图像格式和质量
+    void setRawVideoFormat(int width, int height,
+                           const QString &pixelFormat,
+                           double fps);         // 设置无头 YUV 输入的格式
+    void setDecoder(const QString &backend, int threads,
+                    frameSourceOptions::ThreadType type); // 设置解码后端和解码线程
+    void setFrameSource(frameSource *source);   // 注入自定义帧源，线程接管其所有权
+    void setKeyframeGap(int gapMs);             // 设置关键帧导出的最小时间间隔
+    void setRandomSeed(quint64 seed);           // 设置随机导出的种子
+    void setPlanOutput(const QString &planFile); // 设置只规划不导出，计划追加到文件
+    void setPlanExecution(const QString &planFile,
+                          const QString &claimDirectory,
+                          int staleSeconds);    // 设置执行计划文件
+    void setDedupIndex(const QString &indexFile,
+                       int maxDistance);        // 设置跨数据集近重复索引
+    void setTimeBudget(int seconds);            // 设置每个视频的处理时间预算
+    void setAnnotation(const yoloAnnotator::options &settings); // 设置 YOLO 预标注
+    void setTiling(int tileSize, int overlap,
+                   double minStdDev);           // 设置切片导出，切片边长为 0 表示导出整帧
+    void setRenditions(const QVector<renditionSet::rendition> &list); // 设置多分辨率输出版本
+    void setTimeRanges(const QVector<timeRange> &ranges); // 设置导出时间段，为空表示整个视频
+    void setToneMap(frameView::ToneMap mode);   // 设置 HDR 帧的色调映射方式
+    void setPreviewEnabled(bool enabled);       // 设置是否生成导出预览
+    bool takePreview(QImage &image, QString *fileName = nullptr); // 取走最新的导出预览，线程安全且不阻塞
+    void setFrameFilters(const filterChain::options &settings); // 设置帧分析过滤链
+    void setManifest(bool enabled, bool writeCsv); // 设置是否写出逐帧元数据清单及 CSV 清单
     void saveImage();                           // 保存图像
 
+signals:
+    void statsUpdated(const QJsonObject &snapshot); // 流水线统计快照
+    void stateChanged(exportThread::State state, const QString &detail); // 导出状态变化，detail 为出错原因等说明
+
 protected:
     void run() override; // 线程运行函数，处理视频导出
 
-private slots:
-    void processVideoFrame(const QVideoFrame &frame); // 处理视频帧
-
 private:
-    QMediaPlayer *mediaPlayer; // 媒体播放器
-    QVideoProbe *videoProbe;   // 视频探测器
-    QImage currentFrame;       // 当前视频帧
+    QImage currentFrame; // 当前视频帧
 
     QString videoFilePath; // 视频文件路径
     QString exportPath;    // 导出路径
@@ -86,11 +227,107 @@ private:
     int exportMode;        // 导出模式
     int interval;          // 间隔帧数
     int randomCount;       // 随机截图数
-    int orthogonalCount;   // 正交分布数
+    int diversityCount;    // 多样性导出的帧数
     int totalFrames;       // 总帧数
     int frameCount;        // 帧计数器
 
     bool isExporting; // 是否正在导出
+
+    void publishStats(bool force); // 按节流间隔发送统计快照
+    void runSource(frameSource *source); // 从帧源逐帧拉取并导出
+    bool beginExport();            // 导出开始前的公共准备
+    void finishExport(qint64 duration, bool tracing); // 导出结束后的公共收尾
+    bool selectFrame(const frameView &frame); // 判断当前帧是否需要导出
+    bool encodeImage(QByteArray &encoded, const QString &format,
+                     int quality);            // 将当前帧编码为图像数据
+    bool writeImage(const QByteArray &encoded, qint64 frameNumber,
+                    const QImage &source = QImage()); // 将图像数据写入导出目录
+    bool writeFile(const QString &fileName, const QByteArray &encoded,
+                   qint64 frameNumber,
+                   const QImage &source = QImage()); // 将图像数据写入指定文件
+    void flushReservoir();                    // 写出随机导出蓄水池中的帧
+    void flushDiversity();                    // 选出并写出多样性导出的帧
+    void writePicked(const QVector<reservoirSampler::entry> &picked); // 写出或规划采样器选出的帧
+    void runPlan();                           // 认领并执行计划分片
+    int runShard(const exportPlan::shard &part,
+                 const QString &claimDirectory); // 执行一个计划分片，执行中定期刷新认领
+    QString planOutputName(qint64 frameNumber) const; // 生成计划条目的输出文件名
+    bool isDuplicate(const lumaPyramid &candidate, quint64 &hash); // 判断候选帧是否与索引中的图像近重复
+    int writeOutputs(const QImage &frame, const QString &baseName, const QString &format,
+                     qint64 frameNumber, qint64 ptsUs); // 将一帧的切片和各版本并行编码后写出
+    QString imageBaseName(qint64 frameNumber) const;  // 生成导出图像不含后缀的路径
+    bool useBandEncoding(const frameView &frame) const; // 判断当前帧是否按条带转换编码
+    void setState(State value, const QString &detail = QString()); // 切换导出状态并通知界面
+    bool checkpoint(frameSource *source);     // 每帧检查暂停和取消请求，需要停止时返回 false
+    void offerPreview(const QString &fileName, const QImage &source,
+                      const QByteArray &encoded); // 按节流间隔生成导出预览放入最新值槽
+    void recordFrame(const frameView &frame, qint64 frameNumber,
+                     const QString &video, quint8 mode); // 暂存选中帧的清单记录，写出图像时追加到清单
+
+    // 一张导出预览
+    struct previewFrame
+    {
+        QImage image;     // 缩小后的图像
+        QString fileName; // 对应的导出文件
+    };
+
+    pipelineStats stats;          // 流水线分阶段统计
+    QElapsedTimer statsTimer;     // 统计快照节流计时器
+    QString reportFileName;       // 运行报告文件路径
+    bool traceEnabled;            // 是否记录时间线追踪
+    traceLogger tracer;           // 本线程导出的时间线追踪记录器
+    QString imageFormat;          // 输出图像格式(jpg/png/bmp)
+    int imageQuality;             // 输出图像质量，-1 为编码器默认
+    qint64 receivedFrames;        // 帧源实际交付(解码)的帧数，作为追踪事件的帧号
+    qint64 currentFrameNumber;    // 当前帧在视频中的帧号(帧序号+1)，用于文件名、计划和清单
+    frameSourceOptions sourceOptions; // 帧源创建参数
+    frameSource *injectedSource;      // 注入的帧源，为空时按路径创建
+    int keyframeGapMs;                // 关键帧导出的最小时间间隔(毫秒)，0 为不限
+    qint64 lastSelectedPtsUs;         // 上一个导出帧的时间戳(微秒)，-1 为尚未导出
+    bool keyframeFlagsKnown;          // 当前帧源是否提供关键帧标记
+    quint64 randomSeed;               // 随机导出的种子
+    reservoirSampler reservoir;       // 随机导出的蓄水池
+    int reservoirSlot;                // 当前帧入池的槽位，-1 为落选
+    QString planOutputFile;           // 只规划时的计划文件，为空表示直接导出
+    QVector<exportPlan::entry> plannedEntries; // 本次规划得到的条目
+    QString planInputFile;            // 要执行的计划文件，为空表示按模式导出
+    QString claimDir;                 // 分片认领目录
+    int staleClaimSeconds;            // 认领失效时间(秒)，0 为永不回收
+    QString dedupIndexFile;           // 近重复索引文件，为空表示不去重
+    int dedupMaxDistance;             // 视为近重复的最大汉明距离
+    dedupIndex dedup;                 // 近重复索引
+    qint64 duplicateFrames;           // 因近重复跳过的帧数
+    QHash<qint64, quint64> pendingHashes; // 选中帧的哈希，按帧号索引，图像写出成功后才加入索引
+    diversitySampler diversity;       // 多样性导出的候选池
+    int diversitySlot;                // 当前帧入池的槽位，-1 为落选
+    int timeBudgetSec;                // 每个视频的处理时间预算(秒)，0 为不限
+    QElapsedTimer budgetTimer;        // 处理时间预算计时器
+    yoloAnnotator::options annotation; // YOLO 预标注参数，模型为空表示不标注
+    yoloAnnotator *annotator;         // 本次导出的预标注器，未启用时为空
+    tileSlicer tiles;                 // 切片导出器
+    renditionSet renditions;          // 多分辨率输出版本
+    parallelEncoder encoder;          // 切片和各版本的并行编码器
+    bandEncoder bands;                // 大分辨率帧的条带编码器
+    QFile tileManifest;               // 切片清单，记录每个切片在原帧中的位置
+    qint64 tilesWritten;              // 已写出的切片数
+    qint64 tilesSkipped;              // 因无内容跳过的切片数
+    qint64 currentPtsUs;              // 当前帧的显示时间戳(微秒)
+    QVector<timeRange> timeRanges;    // 导出时间段，按入点排序且互不重叠，为空表示整个视频
+    int activeRange;                  // 当前帧所在或即将进入的时间段序号
+    QAtomicInt currentState;          // 当前导出状态
+    QMutex pauseMutex;                // 保护暂停请求
+    QWaitCondition pauseChanged;      // 暂停请求撤销或取消时唤醒导出线程
+    bool pauseRequested;              // 是否请求暂停
+    qint64 pausedMs;                  // 本次导出累计暂停时长(毫秒)，不计入时间预算
+    bool previewEnabled;              // 是否生成导出预览
+    QElapsedTimer previewTimer;       // 导出预览节流计时器
+    QAtomicPointer<previewFrame> previewSlot; // 最新的导出预览，导出线程放入、界面线程取走，为空表示没有新预览
+    lumaPyramid pyramid;              // 当前候选帧的亮度金字塔，过滤链和近重复检查共用
+    filterChain filters;              // 帧分析过滤链
+    bool manifestEnabled;             // 是否写出逐帧元数据清单
+    bool manifestCsv;                 // 是否同时写出 CSV 清单
+    frameManifest manifest;           // 逐帧元数据清单
+    QHash<qint64, frameManifest::record> pendingRecords; // 已选中尚未写出的帧的清单记录，按帧号索引
 };
 
 #endif // EXPORTTHREAD_H
\ No newline at end of file
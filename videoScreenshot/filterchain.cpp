@@ -0,0 +1,333 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: filterchain.cpp
+ *
+ * 模块描述:
+ *   该模块实现了导出前的帧分析过滤链和内置过滤器。
+ *
+ * 主要功能:
+ *   1. 清晰度过滤: 直接取金字塔生成时统计的全分辨率梯度均值
+ *   2. 场景变化过滤: 比较 32 桶亮度直方图，每帧 32 次运算
+ *   3. 运动量过滤: 比较 64x64 层与上一个导出帧的平均亮度差
+ *   4. 依次运行过滤器并短路，统计各过滤器的结果
+ *
+ * 函数列表:
+ *   1. filterChain               - 构造函数
+ *   2. ~filterChain              - 析构函数，释放过滤器
+ *   3. configure                 - 按设置创建内置过滤器
+ *   4. addFilter                 - 在链尾加入过滤器
+ *   5. clear                     - 释放全部过滤器
+ *   6. reset                     - 清空参考画面和统计
+ *   7. evaluate                  - 依次运行过滤器判断候选帧
+ *   8. commit                    - 通知过滤器候选帧已被选中
+ *   9. report                    - 生成各过滤器的统计
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#include "filterchain.h"
+#include <QJsonArray>
+#include <cstring>
+#include "lumapyramid.h"
+
+namespace
+{
+    const int MOTION_LEVEL = 2; // 运动量过滤使用的金字塔层(64x64)
+
+    // 清晰度过滤器，梯度均值已在生成金字塔时统计，本身只有一次比较
+    class sharpnessFilter : public frameFilter
+    {
+    public:
+        explicit sharpnessFilter(double threshold) : minGradient(threshold) {}
+
+        QString name() const override { return "sharpness"; }
+
+        bool accept(const lumaPyramid &pyramid, double &score) override
+        {
+            score = pyramid.gradientMean();
+            return score >= minGradient;
+        }
+
+    private:
+        double minGradient; // 最低梯度均值
+    };
+
+    // 场景变化过滤器，只保留与上一个候选帧亮度分布明显不同的帧
+    class sceneChangeFilter : public frameFilter
+    {
+    public:
+        explicit sceneChangeFilter(double thresholdPercent) : minChange(thresholdPercent), hasReference(false) {}
+
+        QString name() const override { return "sceneChange"; }
+
+        bool accept(const lumaPyramid &pyramid, double &score) override
+        {
+            const quint32 *bins = pyramid.histogram();
+            if (!hasReference)
+            {
+                score = 100.0;
+            }
+            else
+            {
+                // 直方图差异的一半即两帧之间需要改变亮度分桶的采样点比例
+                qint64 difference = 0;
+                for (int i = 0; i < lumaPyramid::HISTOGRAM_BINS; ++i)
+                {
+                    difference += qAbs(static_cast<qint64>(bins[i]) - static_cast<qint64>(reference[i]));
+                }
+                score = 100.0 * difference / (2.0 * lumaPyramid::BASE_SIZE * lumaPyramid::BASE_SIZE);
+            }
+            // 参考取上一个候选帧，逐渐变化的画面不会累积成场景变化
+            std::memcpy(reference, bins, sizeof(reference));
+            hasReference = true;
+            return score >= minChange;
+        }
+
+        void reset() override { hasReference = false; }
+
+    private:
+        double minChange;                              // 最小直方图差异(%)
+        quint32 reference[lumaPyramid::HISTOGRAM_BINS]; // 上一个候选帧的直方图
+        bool hasReference;                             // 是否已有参考直方图
+    };
+
+    // 运动量过滤器，跳过与上一个导出帧相比几乎没有变化的帧
+    class motionFilter : public frameFilter
+    {
+    public:
+        explicit motionFilter(double threshold) : minDifference(threshold) {}
+
+        QString name() const override { return "motion"; }
+
+        bool accept(const lumaPyramid &pyramid, double &score) override
+        {
+            if (reference.isEmpty())
+            {
+                score = 255.0;
+                return true;
+            }
+            const int count = lumaPyramid::levelSize(MOTION_LEVEL) * lumaPyramid::levelSize(MOTION_LEVEL);
+            const quint8 *current = pyramid.level(MOTION_LEVEL);
+            const quint8 *previous = reference.constData();
+            qint64 difference = 0;
+            for (int i = 0; i < count; ++i)
+            {
+                difference += qAbs(static_cast<int>(current[i]) - static_cast<int>(previous[i]));
+            }
+            score = static_cast<double>(difference) / count;
+            return score >= minDifference;
+        }
+
+        void commit(const lumaPyramid &pyramid) override
+        {
+            const int count = lumaPyramid::levelSize(MOTION_LEVEL) * lumaPyramid::levelSize(MOTION_LEVEL);
+            reference.resize(count);
+            std::memcpy(reference.data(), pyramid.level(MOTION_LEVEL), static_cast<size_t>(count));
+        }
+
+        void reset() override { reference.clear(); }
+
+    private:
+        double minDifference;      // 最小平均亮度差
+        QVector<quint8> reference; // 上一个导出帧的 64x64 层，为空表示尚未导出
+    };
+}
+
+/***********************************************************
+ * 函数名称: filterChain
+ * 函数功能: 过滤链的构造函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 初始没有过滤器，全部候选帧都被接受
+ ***********************************************************/
+filterChain::filterChain()
+{
+}
+
+/***********************************************************
+ * 函数名称: ~filterChain
+ * 函数功能: 过滤链的析构函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 释放全部过滤器
+ ***********************************************************/
+filterChain::~filterChain()
+{
+    clear();
+}
+
+/***********************************************************
+ * 函数名称: configure
+ * 函数功能: 按设置创建内置过滤器
+ * 参数说明:
+ *   settings - 各内置过滤器的阈值
+ * 返回值: 无
+ * 备注: 替换已有的全部过滤器；按每帧开销从低到高排列:
+ *       清晰度只比较一个数，场景变化比较 32 个分桶，运动量比较 4096 个像素
+ ***********************************************************/
+void filterChain::configure(const options &settings)
+{
+    clear();
+    config = settings;
+    if (settings.minSharpness > 0)
+    {
+        addFilter(new sharpnessFilter(settings.minSharpness));
+    }
+    if (settings.minSceneChange > 0)
+    {
+        addFilter(new sceneChangeFilter(settings.minSceneChange));
+    }
+    if (settings.minMotion > 0)
+    {
+        addFilter(new motionFilter(settings.minMotion));
+    }
+}
+
+/***********************************************************
+ * 函数名称: addFilter
+ * 函数功能: 在链尾加入过滤器
+ * 参数说明:
+ *   filter - 过滤器，过滤链接管其所有权
+ * 返回值: 无
+ * 备注: 开销较大的过滤器应排在后面，以便被前面的过滤器短路
+ ***********************************************************/
+void filterChain::addFilter(frameFilter *filter)
+{
+    if (filter == nullptr)
+    {
+        return;
+    }
+    stage item;
+    item.filter = filter;
+    item.evaluated = 0;
+    item.rejected = 0;
+    item.scoreSum = 0;
+    filters.append(item);
+}
+
+/***********************************************************
+ * 函数名称: clear
+ * 函数功能: 释放全部过滤器
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 无
+ ***********************************************************/
+void filterChain::clear()
+{
+    for (const stage &item : filters)
+    {
+        delete item.filter;
+    }
+    filters.clear();
+}
+
+/***********************************************************
+ * 函数名称: reset
+ * 函数功能: 清空参考画面和统计
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 每次导出开始时调用，上一个视频的画面不参与比较
+ ***********************************************************/
+void filterChain::reset()
+{
+    for (stage &item : filters)
+    {
+        item.filter->reset();
+        item.evaluated = 0;
+        item.rejected = 0;
+        item.scoreSum = 0;
+    }
+}
+
+/***********************************************************
+ * 函数名称: evaluate
+ * 函数功能: 依次运行过滤器判断候选帧
+ * 参数说明:
+ *   pyramid - 候选帧的亮度金字塔
+ * 返回值: 全部过滤器接受时返回 true
+ * 备注: 任一过滤器拒绝即返回，后面的过滤器不再运行；
+ *       金字塔无效(不支持的帧格式)时不做判断，直接接受
+ ***********************************************************/
+bool filterChain::evaluate(const lumaPyramid &pyramid)
+{
+    if (!pyramid.isValid())
+    {
+        return true;
+    }
+    for (stage &item : filters)
+    {
+        double score = 0;
+        const bool accepted = item.filter->accept(pyramid, score);
+        item.evaluated++;
+        item.scoreSum += score;
+        if (!accepted)
+        {
+            item.rejected++;
+            return false;
+        }
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: commit
+ * 函数功能: 通知过滤器候选帧已被选中
+ * 参数说明:
+ *   pyramid - 被选中帧的亮度金字塔
+ * 返回值: 无
+ * 备注: 候选帧通过过滤链后还可能被近重复检查或采样器淘汰，
+ *       只有最终选中的帧才作为运动量过滤的参考画面
+ ***********************************************************/
+void filterChain::commit(const lumaPyramid &pyramid)
+{
+    if (!pyramid.isValid())
+    {
+        return;
+    }
+    for (const stage &item : filters)
+    {
+        item.filter->commit(pyramid);
+    }
+}
+
+/***********************************************************
+ * 函数名称: report
+ * 函数功能: 生成各过滤器的统计
+ * 参数说明: 无
+ * 返回值: 包含阈值和各过滤器统计的 JSON 对象
+ * 备注: 平均得分可用于调整阈值，例如先以很小的阈值试跑一段视频
+ ***********************************************************/
+QJsonObject filterChain::report() const
+{
+    QJsonObject result;
+    result["minSharpness"] = config.minSharpness;
+    result["minSceneChange"] = config.minSceneChange;
+    result["minMotion"] = config.minMotion;
+    QJsonArray stages;
+    for (const stage &item : filters)
+    {
+        QJsonObject entry;
+        entry["name"] = item.filter->name();
+        entry["evaluated"] = static_cast<double>(item.evaluated);
+        entry["rejected"] = static_cast<double>(item.rejected);
+        entry["meanScore"] = item.evaluated > 0 ? item.scoreSum / item.evaluated : 0.0;
+        stages.append(entry);
+    }
+    result["stages"] = stages;
+    return result;
+}
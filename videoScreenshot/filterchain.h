@@ -0,0 +1,106 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: filterchain.h
+ *
+ * 模块描述:
+ *   该模块定义了导出前的帧分析过滤链。过滤器不读取原始帧，只读取每个
+ *   候选帧生成一次的亮度金字塔，按开销从低到高排列，前面的过滤器拒绝
+ *   后不再运行后面的过滤器。内置清晰度、场景变化和运动量三个过滤器，
+ *   新的过滤器实现 frameFilter 接口后由 addFilter 加入即可。
+ *
+ * 主要功能:
+ *   1. 按设置创建内置过滤器
+ *   2. 依次运行过滤器，任一过滤器拒绝即短路
+ *   3. 统计各过滤器的评估数、拒绝数和平均得分
+ *
+ * 函数列表:
+ *   1. filterChain               - 构造函数
+ *   2. ~filterChain              - 析构函数，释放过滤器
+ *   3. configure                 - 按设置创建内置过滤器
+ *   4. addFilter                 - 在链尾加入过滤器
+ *   5. clear                     - 释放全部过滤器
+ *   6. reset                     - 清空参考画面和统计，每次导出开始时调用
+ *   7. evaluate                  - 依次运行过滤器判断候选帧
+ *   8. commit                    - 通知过滤器候选帧已被选中
+ *   9. report                    - 生成各过滤器的统计
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#ifndef FILTERCHAIN_H
+#define FILTERCHAIN_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+class lumaPyramid;
+
+// 帧分析过滤器，只读取亮度金字塔
+class frameFilter
+{
+public:
+    virtual ~frameFilter() {}
+
+    virtual QString name() const = 0; // 过滤器名称，用于运行报告
+    virtual bool accept(const lumaPyramid &pyramid, double &score) = 0; // 判断候选帧，score 返回本帧得分
+    virtual void commit(const lumaPyramid &pyramid) { Q_UNUSED(pyramid); } // 候选帧已被选中，按需更新参考画面
+    virtual void reset() {}                                                // 清空参考画面
+};
+
+class filterChain
+{
+public:
+    // 内置过滤器的阈值，0 表示不启用该过滤器
+    struct options
+    {
+        double minSharpness;   // 全分辨率亮度梯度均值低于此值的帧视为模糊
+        double minSceneChange; // 与上一个候选帧的亮度直方图差异(%)低于此值的帧视为同一场景
+        double minMotion;      // 与上一个导出帧的平均亮度差低于此值的帧视为静止
+
+        options() : minSharpness(0), minSceneChange(0), minMotion(0) {}
+    };
+
+    filterChain();
+    ~filterChain();
+
+    void configure(const options &settings);     // 按设置创建内置过滤器
+    void addFilter(frameFilter *filter);         // 在链尾加入过滤器，过滤链接管其所有权
+    void clear();                                // 释放全部过滤器
+    void reset();                                // 清空参考画面和统计，每次导出开始时调用
+    bool isEnabled() const { return !filters.isEmpty(); } // 是否有启用的过滤器
+    bool evaluate(const lumaPyramid &pyramid);   // 依次运行过滤器，全部接受时返回 true
+    void commit(const lumaPyramid &pyramid);     // 通知过滤器候选帧已被选中
+    QJsonObject report() const;                  // 生成各过滤器的统计
+    const options &settings() const { return config; }
+
+private:
+    // 链中的一个过滤器及其统计
+    struct stage
+    {
+        frameFilter *filter; // 过滤器
+        qint64 evaluated;    // 评估的帧数，被前面的过滤器拒绝的帧不计入
+        qint64 rejected;     // 拒绝的帧数
+        double scoreSum;     // 得分之和，用于报告平均得分以便调整阈值
+    };
+
+    QVector<stage> filters; // 按运行顺序排列的过滤器
+    options config;         // 内置过滤器的阈值
+};
+
+#endif // FILTERCHAIN_H
@@ -0,0 +1,223 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: framedescriptor.cpp
+ *
+ * 模块描述:
+ *   该模块实现了帧外观描述子。在帧上均匀取 32x32 个采样点，
+ *   亮度按 4x4 个点、色度按 8x8 个点平均到各自的缩略图格子中。
+ *   采样点数与分辨率无关。距离计算在 x86 上使用 SSE2 的 psadbw，
+ *   在 ARM 上使用 NEON，一次处理 16 字节。
+ *
+ * 主要功能:
+ *   1. 直接从原始帧计算描述子，无需颜色转换
+ *   2. 计算两个描述子的 L1 距离(SSE2/NEON 加速)
+ *
+ * 函数列表:
+ *   1. computeDescriptor         - 从帧计算描述子
+ *   2. descriptorDistance        - 计算两个描述子的 L1 距离
+ *   3. samplePixel               - 读取一个采样点的 YCbCr 值
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 支持 P010/YUV420P10 帧，取 10bit 样本的高 8 位
+ ***********************************************************/
+
+#include "framedescriptor.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DESCRIPTOR_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define DESCRIPTOR_NEON
+#endif
+
+namespace
+{
+    const int SAMPLE_GRID = 32; // 每个方向的采样点数
+    const int LUMA_STEP = SAMPLE_GRID / frameDescriptor::LUMA_GRID;
+    const int CHROMA_STEP = SAMPLE_GRID / frameDescriptor::CHROMA_GRID;
+}
+
+/***********************************************************
+ * 函数名称: samplePixel
+ * 函数功能: 读取一个采样点的 YCbCr 值
+ * 参数说明:
+ *   frame - 帧视图
+ *   x     - 列
+ *   y     - 行
+ *   ycc   - 返回 Y、Cb、Cr
+ * 返回值: 无
+ * 备注: 灰度帧的色度为 128；RGB32 按 BT.601 全范围换算；
+ *       10bit 帧取 16 位样本的高 8 位有效位
+ ***********************************************************/
+static inline void samplePixel(const frameView &frame, int x, int y, int ycc[3])
+{
+    const uchar *luma = frame.planes[0] + static_cast<qint64>(y) * frame.strides[0];
+    switch (frame.format)
+    {
+    case frameView::FORMAT_YUV420P:
+    case frameView::FORMAT_YUV422P:
+    case frameView::FORMAT_YUV444P:
+    {
+        const int cx = frame.format == frameView::FORMAT_YUV444P ? x : x / 2;
+        const int cy = frame.format == frameView::FORMAT_YUV420P ? y / 2 : y;
+        ycc[0] = luma[x];
+        ycc[1] = frame.planes[1][static_cast<qint64>(cy) * frame.strides[1] + cx];
+        ycc[2] = frame.planes[2][static_cast<qint64>(cy) * frame.strides[2] + cx];
+        break;
+    }
+    case frameView::FORMAT_NV12:
+    {
+        const uchar *chroma = frame.planes[1] + static_cast<qint64>(y / 2) * frame.strides[1] + (x / 2) * 2;
+        ycc[0] = luma[x];
+        ycc[1] = chroma[0];
+        ycc[2] = chroma[1];
+        break;
+    }
+    case frameView::FORMAT_YUV420P10:
+    {
+        const quint16 *cb = reinterpret_cast<const quint16 *>(frame.planes[1] + static_cast<qint64>(y / 2) * frame.strides[1]);
+        const quint16 *cr = reinterpret_cast<const quint16 *>(frame.planes[2] + static_cast<qint64>(y / 2) * frame.strides[2]);
+        ycc[0] = (reinterpret_cast<const quint16 *>(luma)[x] >> 2) & 0xff;
+        ycc[1] = (cb[x / 2] >> 2) & 0xff;
+        ycc[2] = (cr[x / 2] >> 2) & 0xff;
+        break;
+    }
+    case frameView::FORMAT_P010:
+    {
+        const quint16 *chroma = reinterpret_cast<const quint16 *>(frame.planes[1] + static_cast<qint64>(y / 2) * frame.strides[1]) +
+                                (x / 2) * 2;
+        ycc[0] = reinterpret_cast<const quint16 *>(luma)[x] >> 8;
+        ycc[1] = chroma[0] >> 8;
+        ycc[2] = chroma[1] >> 8;
+        break;
+    }
+    case frameView::FORMAT_RGB32:
+    {
+        const uchar *pixel = luma + x * 4;
+        const int b = pixel[0];
+        const int g = pixel[1];
+        const int r = pixel[2];
+        ycc[0] = (77 * r + 150 * g + 29 * b) >> 8;
+        ycc[1] = ((-43 * r - 85 * g + 128 * b) >> 8) + 128;
+        ycc[2] = ((128 * r - 107 * g - 21 * b) >> 8) + 128;
+        break;
+    }
+    default:
+        ycc[0] = luma[x];
+        ycc[1] = 128;
+        ycc[2] = 128;
+        break;
+    }
+}
+
+/***********************************************************
+ * 函数名称: computeDescriptor
+ * 函数功能: 从帧计算描述子
+ * 参数说明:
+ *   frame      - 帧视图
+ *   descriptor - 返回描述子
+ * 返回值: 帧有效时返回 true
+ * 备注: 共读取 1024 个采样点，8K 帧与 480p 帧耗时相同
+ ***********************************************************/
+bool computeDescriptor(const frameView &frame, frameDescriptor &descriptor)
+{
+    if (!frame.isValid())
+    {
+        return false;
+    }
+
+    int columns[SAMPLE_GRID];
+    for (int i = 0; i < SAMPLE_GRID; ++i)
+    {
+        columns[i] = static_cast<int>((2 * i + 1) * static_cast<qint64>(frame.width) / (2 * SAMPLE_GRID));
+    }
+
+    int luma[frameDescriptor::LUMA_GRID * frameDescriptor::LUMA_GRID] = {0};
+    int cb[frameDescriptor::CHROMA_GRID * frameDescriptor::CHROMA_GRID] = {0};
+    int cr[frameDescriptor::CHROMA_GRID * frameDescriptor::CHROMA_GRID] = {0};
+    for (int i = 0; i < SAMPLE_GRID; ++i)
+    {
+        const int y = static_cast<int>((2 * i + 1) * static_cast<qint64>(frame.height) / (2 * SAMPLE_GRID));
+        const int lumaRow = (i / LUMA_STEP) * frameDescriptor::LUMA_GRID;
+        const int chromaRow = (i / CHROMA_STEP) * frameDescriptor::CHROMA_GRID;
+        for (int j = 0; j < SAMPLE_GRID; ++j)
+        {
+            int ycc[3];
+            samplePixel(frame, columns[j], y, ycc);
+            luma[lumaRow + j / LUMA_STEP] += ycc[0];
+            cb[chromaRow + j / CHROMA_STEP] += ycc[1];
+            cr[chromaRow + j / CHROMA_STEP] += ycc[2];
+        }
+    }
+
+    uchar *out = descriptor.values;
+    for (int i = 0; i < frameDescriptor::LUMA_GRID * frameDescriptor::LUMA_GRID; ++i)
+    {
+        *out++ = static_cast<uchar>(luma[i] / (LUMA_STEP * LUMA_STEP));
+    }
+    for (int i = 0; i < frameDescriptor::CHROMA_GRID * frameDescriptor::CHROMA_GRID; ++i)
+    {
+        *out++ = static_cast<uchar>(cb[i] / (CHROMA_STEP * CHROMA_STEP));
+    }
+    for (int i = 0; i < frameDescriptor::CHROMA_GRID * frameDescriptor::CHROMA_GRID; ++i)
+    {
+        *out++ = static_cast<uchar>(cr[i] / (CHROMA_STEP * CHROMA_STEP));
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: descriptorDistance
+ * 函数功能: 计算两个描述子的 L1 距离
+ * 参数说明:
+ *   a - 描述子
+ *   b - 描述子
+ * 返回值: 各字节差的绝对值之和
+ * 备注: 多样性选帧的内层循环，SSE2 每 16 字节一条 psadbw
+ ***********************************************************/
+int descriptorDistance(const frameDescriptor &a, const frameDescriptor &b)
+{
+#if defined(DESCRIPTOR_SSE2)
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < frameDescriptor::SIZE; i += 16)
+    {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a.values + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b.values + i));
+        sum = _mm_add_epi64(sum, _mm_sad_epu8(va, vb));
+    }
+    return _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_srli_si128(sum, 8));
+#elif defined(DESCRIPTOR_NEON)
+    uint16x8_t sum = vdupq_n_u16(0);
+    for (int i = 0; i < frameDescriptor::SIZE; i += 16)
+    {
+        sum = vpadalq_u8(sum, vabdq_u8(vld1q_u8(a.values + i), vld1q_u8(b.values + i)));
+    }
+    const uint32x4_t wide = vpaddlq_u16(sum);
+    const uint64x2_t total = vpaddlq_u32(wide);
+    return static_cast<int>(vgetq_lane_u64(total, 0) + vgetq_lane_u64(total, 1));
+#else
+    int sum = 0;
+    for (int i = 0; i < frameDescriptor::SIZE; ++i)
+    {
+        sum += qAbs(static_cast<int>(a.values[i]) - static_cast<int>(b.values[i]));
+    }
+    return sum;
+#endif
+}
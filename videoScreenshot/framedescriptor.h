@@ -0,0 +1,54 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: framedescriptor.h
+ *
+ * 模块描述:
+ *   该模块定义了紧凑的帧外观描述子: 8x8 亮度缩略图加 4x4 的两个色度
+ *   缩略图，共 96 字节。描述子之间的 L1 距离衡量两帧画面的差异，
+ *   用于多样性导出。
+ *
+ * 主要功能:
+ *   1. 直接从原始帧计算描述子，无需颜色转换
+ *   2. 计算两个描述子的 L1 距离(SSE2/NEON 加速)
+ *
+ * 函数列表:
+ *   1. computeDescriptor         - 从帧计算描述子
+ *   2. descriptorDistance        - 计算两个描述子的 L1 距离
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#ifndef FRAMEDESCRIPTOR_H
+#define FRAMEDESCRIPTOR_H
+
+#include <QtGlobal>
+#include "frameview.h"
+
+struct alignas(16) frameDescriptor
+{
+    static const int LUMA_GRID = 8;   // 亮度缩略图边长
+    static const int CHROMA_GRID = 4; // 色度缩略图边长
+    static const int SIZE = LUMA_GRID * LUMA_GRID + 2 * CHROMA_GRID * CHROMA_GRID; // 字节数，16 的倍数
+
+    uchar values[SIZE]; // 亮度 8x8，Cb 4x4，Cr 4x4
+};
+
+bool computeDescriptor(const frameView &frame, frameDescriptor &descriptor); // 从帧计算描述子
+int descriptorDistance(const frameDescriptor &a, const frameDescriptor &b);  // 两个描述子的 L1 距离
+
+#endif // FRAMEDESCRIPTOR_H
@@ -0,0 +1,635 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: framemanifest.cpp
+ *
+ * 模块描述:
+ *   该模块实现了逐帧元数据清单的写入和内存映射读取。
+ *
+ * 主要功能:
+ *   1. 按列缓存记录，整块追加写出二进制清单和可选的 CSV 清单
+ *   2. 内存映射打开清单，按块提供各列的指针
+ *   3. 生成 CSV 表头和记录行
+ *
+ * 函数列表:
+ *   1. frameManifest             - 构造函数
+ *   2. ~frameManifest            - 析构函数，写出缓存的记录
+ *   3. create                    - 打开清单追加写入
+ *   4. append                    - 缓存一行记录
+ *   5. flush                     - 将缓存的记录作为一个数据块写出
+ *   6. open                      - 只读内存映射打开清单
+ *   7. close                     - 写出缓存的记录并关闭清单
+ *   8. row                       - 读取一行记录
+ *   9. csvHeader                 - 生成 CSV 表头
+ *   10. csvLine                  - 生成一行 CSV 记录
+ *   11. stringId                 - 获取字符串在当前块字符串表中的序号
+ *   12. string                   - 获取数据块字符串表中的字符串
+ *   13. readChunkHeader          - 读取并校验一个完整数据块的块头
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 打开追加前截掉末尾不完整的数据块，写出不完整时截回块起点
+ *     * 追加和截断在清单锁内进行，不会截掉其他进程正在写的数据块
+ *     * 只读打开时报告末尾无法识别的字节数
+ ***********************************************************/
+
+#include "framemanifest.h"
+#include <QDebug>
+#include <QFileInfo>
+#include <QLockFile>
+#include <cstring>
+
+namespace
+{
+    const char CHUNK_MAGIC[8] = {'V', 'S', 'F', 'R', 'A', 'M', 'E', '1'};
+    const quint32 CHUNK_VERSION = 1;
+    const int APPEND_LOCK_TIMEOUT_MS = 60000; // 等待其他进程写完数据块的最长时间
+
+    // 数据块头，每个数据块都以块头开始，追加写出时无需改写文件头
+    struct chunkHeader
+    {
+        char magic[8];
+        quint32 version;
+        quint32 rows;        // 行数
+        quint32 strings;     // 字符串表的字符串数
+        quint32 stringBytes; // 字符串数据的字节数
+        quint64 size;        // 整个数据块的字节数，包括块头
+        quint64 reserved;
+    };
+
+    inline qint64 aligned(qint64 bytes)
+    {
+        return (bytes + 7) & ~static_cast<qint64>(7);
+    }
+
+    // 数据块内各列的偏移，写入和读取共用以保证两边布局一致；
+    // 8 字节的列在前，每列按 8 字节对齐，映射后可直接按类型指针访问
+    struct chunkLayout
+    {
+        qint64 frameNumbers, ptsUs, hashes, sharpness, brightness, widths, heights;
+        qint64 videos, files, modes, flags, stringOffsets, stringData, size;
+
+        chunkLayout(qint64 rows, qint64 strings, qint64 stringBytes)
+        {
+            qint64 position = sizeof(chunkHeader);
+            frameNumbers = position;
+            position += aligned(rows * 8);
+            ptsUs = position;
+            position += aligned(rows * 8);
+            hashes = position;
+            position += aligned(rows * 8);
+            sharpness = position;
+            position += aligned(rows * 4);
+            brightness = position;
+            position += aligned(rows * 4);
+            widths = position;
+            position += aligned(rows * 4);
+            heights = position;
+            position += aligned(rows * 4);
+            videos = position;
+            position += aligned(rows * 4);
+            files = position;
+            position += aligned(rows * 4);
+            modes = position;
+            position += aligned(rows);
+            flags = position;
+            position += aligned(rows);
+            stringOffsets = position;
+            position += aligned((strings + 1) * 4);
+            stringData = position;
+            position += aligned(stringBytes);
+            size = position;
+        }
+    };
+
+    /***********************************************************
+     * 函数名称: readChunkHeader
+     * 函数功能: 读取并校验一个完整数据块的块头
+     * 参数说明:
+     *   data      - 数据块起始地址
+     *   available - 从 data 起到文件末尾的字节数
+     *   header    - 返回块头
+     *   layout    - 返回块内各列的偏移
+     * 返回值: 块头有效且整个数据块都在文件内时返回 true
+     * 备注: 写入前的截断和只读打开共用，两边对"完整数据块"的判断一致
+     ***********************************************************/
+    bool readChunkHeader(const uchar *data, qint64 available, chunkHeader &header, chunkLayout &layout)
+    {
+        if (available < static_cast<qint64>(sizeof(chunkHeader)))
+        {
+            return false;
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, CHUNK_MAGIC, sizeof(CHUNK_MAGIC)) != 0 || header.version != CHUNK_VERSION)
+        {
+            return false;
+        }
+        layout = chunkLayout(header.rows, header.strings, header.stringBytes);
+        return static_cast<qint64>(header.size) == layout.size && layout.size <= available;
+    }
+
+    // CSV 文本字段加引号，字段内的引号写两次
+    QByteArray quoted(const QString &text)
+    {
+        QByteArray field = text.toUtf8();
+        field.replace('"', "\"\"");
+        return "\"" + field + "\"";
+    }
+}
+
+/***********************************************************
+ * 函数名称: string
+ * 函数功能: 获取数据块字符串表中的字符串
+ * 参数说明:
+ *   id - 字符串序号
+ * 返回值: 字符串，序号越界时为空
+ * 备注: 无
+ ***********************************************************/
+QString frameManifest::chunk::string(quint32 id) const
+{
+    if (id >= static_cast<quint32>(strings))
+    {
+        return QString();
+    }
+    return QString::fromUtf8(stringData + stringOffsets[id], static_cast<int>(stringOffsets[id + 1] - stringOffsets[id]));
+}
+
+/***********************************************************
+ * 函数名称: frameManifest
+ * 函数功能: 逐帧元数据清单的构造函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 无
+ ***********************************************************/
+frameManifest::frameManifest() : writtenRows(0),
+                                 mapped(nullptr),
+                                 mappedRows(0),
+                                 unreadBytes(0)
+{
+}
+
+/***********************************************************
+ * 函数名称: ~frameManifest
+ * 函数功能: 逐帧元数据清单的析构函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 写出缓存的记录，解除映射
+ ***********************************************************/
+frameManifest::~frameManifest()
+{
+    close();
+}
+
+/***********************************************************
+ * 函数名称: create
+ * 函数功能: 打开清单追加写入
+ * 参数说明:
+ *   fileName - 二进制清单路径，不存在时创建
+ *   writeCsv - 是否同时写出同目录同名的 .csv 清单
+ *   error    - 返回错误描述，可为空
+ * 返回值: 成功返回 true
+ * 备注: 二进制清单不经 QFile 缓冲，每个数据块以一次写调用追加，
+ *       本地文件系统上多个进程追加同一清单时数据块不会交错。
+ *       已有清单末尾不完整的数据块(上次写出中断)先截掉，之后的数据块
+ *       紧接最后一个完整数据块，只读打开时不会被中间的残块挡住
+ ***********************************************************/
+bool frameManifest::create(const QString &fileName, bool writeCsv, QString *error)
+{
+    close();
+
+    writer.setFileName(fileName);
+    if (!writer.open(QIODevice::ReadWrite | QIODevice::Append | QIODevice::Unbuffered))
+    {
+        if (error)
+        {
+            *error = writer.errorString();
+        }
+        return false;
+    }
+
+    // 在清单锁内扫描，其他进程此时不会有写了一半的数据块
+    QLockFile lock(fileName + ".lock");
+    lock.setStaleLockTime(0);
+    if (!lock.tryLock(APPEND_LOCK_TIMEOUT_MS))
+    {
+        if (error)
+        {
+            *error = "Frame manifest is locked: " + fileName;
+        }
+        close();
+        return false;
+    }
+    const qint64 fileSize = writer.size();
+    qint64 validSize = 0;
+    if (fileSize > 0)
+    {
+        uchar *data = writer.map(0, fileSize);
+        if (data == nullptr)
+        {
+            if (error)
+            {
+                *error = writer.errorString();
+            }
+            close();
+            return false;
+        }
+        chunkHeader header;
+        chunkLayout layout(0, 0, 0);
+        while (readChunkHeader(data + validSize, fileSize - validSize, header, layout))
+        {
+            validSize += layout.size;
+        }
+        writer.unmap(data);
+    }
+    if (validSize < fileSize)
+    {
+        qDebug() << "Frame manifest has" << fileSize - validSize << "trailing bytes, truncated:" << fileName;
+        if (!writer.resize(validSize))
+        {
+            if (error)
+            {
+                *error = writer.errorString();
+            }
+            close();
+            return false;
+        }
+    }
+    lock.unlock();
+    if (writeCsv)
+    {
+        const QFileInfo info(fileName);
+        csvWriter.setFileName(QString("%1/%2.csv").arg(info.absolutePath()).arg(info.completeBaseName()));
+        if (!csvWriter.open(QIODevice::WriteOnly | QIODevice::Append))
+        {
+            if (error)
+            {
+                *error = csvWriter.errorString();
+            }
+            close();
+            return false;
+        }
+        if (csvWriter.size() == 0)
+        {
+            csvWriter.write(csvHeader());
+        }
+    }
+    manifestFileName = fileName;
+    writtenRows = 0;
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: append
+ * 函数功能: 缓存一行记录
+ * 参数说明:
+ *   row - 记录
+ * 返回值: 无
+ * 备注: 记录按列放入当前块，满 CHUNK_ROWS 行时写出；未打开写入时忽略
+ ***********************************************************/
+void frameManifest::append(const record &row)
+{
+    if (!writer.isOpen())
+    {
+        return;
+    }
+    frameNumbers.append(row.frameNumber);
+    ptsUs.append(row.ptsUs);
+    hashes.append(row.hash);
+    sharpness.append(row.sharpness);
+    brightness.append(row.brightness);
+    widths.append(row.width);
+    heights.append(row.height);
+    videos.append(stringId(row.video));
+    files.append(stringId(row.file));
+    modes.append(static_cast<char>(row.mode));
+    flags.append(static_cast<char>(row.flags));
+    if (csvWriter.isOpen())
+    {
+        csvBuffer.append(csvLine(row));
+    }
+    if (frameNumbers.size() >= CHUNK_ROWS)
+    {
+        flush();
+    }
+}
+
+/***********************************************************
+ * 函数名称: flush
+ * 函数功能: 将缓存的记录作为一个数据块写出
+ * 参数说明: 无
+ * 返回值: 写出成功或没有缓存的记录时返回 true
+ * 备注: 整块在内存中拼好后一次写出，CSV 行随后写出；
+ *       写出失败时丢弃该块并把文件截回块起点，不影响之后的数据块。
+ *       写出在清单锁内进行，截断时不会误伤其他进程追加的数据块
+ ***********************************************************/
+bool frameManifest::flush()
+{
+    const int rows = frameNumbers.size();
+    if (!writer.isOpen() || rows == 0)
+    {
+        return true;
+    }
+
+    QVector<quint32> stringOffsets(strings.size() + 1);
+    stringOffsets[0] = 0;
+    for (int i = 0; i < strings.size(); ++i)
+    {
+        stringOffsets[i + 1] = stringOffsets[i] + static_cast<quint32>(strings[i].size());
+    }
+    const chunkLayout layout(rows, strings.size(), stringOffsets.last());
+
+    chunkHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CHUNK_MAGIC, sizeof(CHUNK_MAGIC));
+    header.version = CHUNK_VERSION;
+    header.rows = static_cast<quint32>(rows);
+    header.strings = static_cast<quint32>(strings.size());
+    header.stringBytes = stringOffsets.last();
+    header.size = static_cast<quint64>(layout.size);
+
+    QByteArray block(static_cast<int>(layout.size), '\0');
+    char *out = block.data();
+    std::memcpy(out, &header, sizeof(header));
+    std::memcpy(out + layout.frameNumbers, frameNumbers.constData(), rows * sizeof(qint64));
+    std::memcpy(out + layout.ptsUs, ptsUs.constData(), rows * sizeof(qint64));
+    std::memcpy(out + layout.hashes, hashes.constData(), rows * sizeof(quint64));
+    std::memcpy(out + layout.sharpness, sharpness.constData(), rows * sizeof(float));
+    std::memcpy(out + layout.brightness, brightness.constData(), rows * sizeof(float));
+    std::memcpy(out + layout.widths, widths.constData(), rows * sizeof(qint32));
+    std::memcpy(out + layout.heights, heights.constData(), rows * sizeof(qint32));
+    std::memcpy(out + layout.videos, videos.constData(), rows * sizeof(quint32));
+    std::memcpy(out + layout.files, files.constData(), rows * sizeof(quint32));
+    std::memcpy(out + layout.modes, modes.constData(), rows);
+    std::memcpy(out + layout.flags, flags.constData(), rows);
+    std::memcpy(out + layout.stringOffsets, stringOffsets.constData(), stringOffsets.size() * sizeof(quint32));
+    char *text = out + layout.stringData;
+    for (const QByteArray &item : strings)
+    {
+        std::memcpy(text, item.constData(), item.size());
+        text += item.size();
+    }
+
+    bool written = false;
+    QLockFile lock(manifestFileName + ".lock");
+    lock.setStaleLockTime(0);
+    if (lock.tryLock(APPEND_LOCK_TIMEOUT_MS))
+    {
+        const qint64 chunkStart = writer.size();
+        written = writer.write(block) == block.size();
+        if (!written && writer.size() > chunkStart && !writer.resize(chunkStart))
+        {
+            qDebug() << "Truncate frame manifest failed:" << manifestFileName << writer.errorString();
+        }
+        lock.unlock();
+    }
+    else
+    {
+        qDebug() << "Frame manifest is locked:" << manifestFileName;
+    }
+    if (written)
+    {
+        writtenRows += rows;
+        if (csvWriter.isOpen())
+        {
+            csvWriter.write(csvBuffer);
+            csvWriter.flush();
+        }
+    }
+    else
+    {
+        qDebug() << "Write frame manifest failed:" << manifestFileName << writer.errorString();
+    }
+
+    frameNumbers.clear();
+    ptsUs.clear();
+    hashes.clear();
+    sharpness.clear();
+    brightness.clear();
+    widths.clear();
+    heights.clear();
+    videos.clear();
+    files.clear();
+    modes.clear();
+    flags.clear();
+    strings.clear();
+    stringIds.clear();
+    csvBuffer.clear();
+    return written;
+}
+
+/***********************************************************
+ * 函数名称: open
+ * 函数功能: 只读内存映射打开清单
+ * 参数说明:
+ *   fileName - 清单文件路径
+ *   error    - 返回错误描述，可为空
+ * 返回值: 成功返回 true
+ * 备注: 只检查各块头，不读取列数据；末尾不完整的数据块(写出中断或
+ *       其他进程正在追加)之前的数据块照常可读，此时仍返回 true，
+ *       被跳过的字节数由 trailingBytes() 返回并写入 error
+ ***********************************************************/
+bool frameManifest::open(const QString &fileName, QString *error)
+{
+    close();
+
+    reader.setFileName(fileName);
+    if (!reader.open(QIODevice::ReadOnly))
+    {
+        if (error)
+        {
+            *error = reader.errorString();
+        }
+        return false;
+    }
+    const qint64 fileSize = reader.size();
+    if (fileSize == 0)
+    {
+        manifestFileName = fileName;
+        return true;
+    }
+    mapped = reader.map(0, fileSize);
+    if (mapped == nullptr)
+    {
+        if (error)
+        {
+            *error = reader.errorString();
+        }
+        close();
+        return false;
+    }
+
+    qint64 position = 0;
+    chunkHeader header;
+    chunkLayout layout(0, 0, 0);
+    while (readChunkHeader(mapped + position, fileSize - position, header, layout))
+    {
+        const uchar *base = mapped + position;
+        chunk item;
+        item.rows = static_cast<int>(header.rows);
+        item.frameNumbers = reinterpret_cast<const qint64 *>(base + layout.frameNumbers);
+        item.ptsUs = reinterpret_cast<const qint64 *>(base + layout.ptsUs);
+        item.hashes = reinterpret_cast<const quint64 *>(base + layout.hashes);
+        item.sharpness = reinterpret_cast<const float *>(base + layout.sharpness);
+        item.brightness = reinterpret_cast<const float *>(base + layout.brightness);
+        item.widths = reinterpret_cast<const qint32 *>(base + layout.widths);
+        item.heights = reinterpret_cast<const qint32 *>(base + layout.heights);
+        item.videos = reinterpret_cast<const quint32 *>(base + layout.videos);
+        item.files = reinterpret_cast<const quint32 *>(base + layout.files);
+        item.modes = base + layout.modes;
+        item.flags = base + layout.flags;
+        item.strings = static_cast<int>(header.strings);
+        item.stringOffsets = reinterpret_cast<const quint32 *>(base + layout.stringOffsets);
+        item.stringData = reinterpret_cast<const char *>(base + layout.stringData);
+        chunks.append(item);
+        mappedRows += item.rows;
+        position += layout.size;
+    }
+
+    if (chunks.isEmpty())
+    {
+        if (error)
+        {
+            *error = "Not a frame manifest: " + fileName;
+        }
+        close();
+        return false;
+    }
+    manifestFileName = fileName;
+    unreadBytes = fileSize - position;
+    if (unreadBytes > 0)
+    {
+        qDebug() << "Frame manifest has" << unreadBytes << "trailing bytes after chunk" << chunks.size() << ":" << fileName;
+        if (error)
+        {
+            *error = QString("%1 trailing bytes after the last complete chunk").arg(unreadBytes);
+        }
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: close
+ * 函数功能: 写出缓存的记录并关闭清单
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 之前取得的数据块指针全部失效
+ ***********************************************************/
+void frameManifest::close()
+{
+    if (writer.isOpen())
+    {
+        flush();
+        writer.close();
+    }
+    csvWriter.close();
+    if (mapped != nullptr)
+    {
+        reader.unmap(mapped);
+        mapped = nullptr;
+    }
+    reader.close();
+    chunks.clear();
+    mappedRows = 0;
+    unreadBytes = 0;
+    manifestFileName.clear();
+}
+
+/***********************************************************
+ * 函数名称: row
+ * 函数功能: 读取一行记录
+ * 参数说明:
+ *   chunkIndex - 数据块序号
+ *   rowIndex   - 块内行号
+ * 返回值: 记录
+ * 备注: 需要复制字符串，批量筛选时应直接读取 chunkAt 返回的列指针
+ ***********************************************************/
+frameManifest::record frameManifest::row(int chunkIndex, int rowIndex) const
+{
+    const chunk &item = chunks[chunkIndex];
+    record result;
+    result.file = item.string(item.files[rowIndex]);
+    result.video = item.string(item.videos[rowIndex]);
+    result.frameNumber = item.frameNumbers[rowIndex];
+    result.ptsUs = item.ptsUs[rowIndex];
+    result.hash = item.hashes[rowIndex];
+    result.sharpness = item.sharpness[rowIndex];
+    result.brightness = item.brightness[rowIndex];
+    result.width = item.widths[rowIndex];
+    result.height = item.heights[rowIndex];
+    result.mode = item.modes[rowIndex];
+    result.flags = item.flags[rowIndex];
+    return result;
+}
+
+/***********************************************************
+ * 函数名称: csvHeader
+ * 函数功能: 生成 CSV 表头
+ * 参数说明: 无
+ * 返回值: 以换行结尾的表头
+ * 备注: 无
+ ***********************************************************/
+QByteArray frameManifest::csvHeader()
+{
+    return "file,video,frame,pts_us,hash,sharpness,brightness,frame_width,frame_height,mode,keyframe,analysed\n";
+}
+
+/***********************************************************
+ * 函数名称: csvLine
+ * 函数功能: 生成一行 CSV 记录
+ * 参数说明:
+ *   row - 记录
+ * 返回值: 以换行结尾的记录行
+ * 备注: 哈希写为 16 位十六进制，计划执行写出的帧导出模式写为 plan
+ ***********************************************************/
+QByteArray frameManifest::csvLine(const record &row)
+{
+    QByteArray line;
+    line.append(quoted(row.file)).append(',');
+    line.append(quoted(row.video)).append(',');
+    line.append(QByteArray::number(row.frameNumber)).append(',');
+    line.append(QByteArray::number(row.ptsUs)).append(',');
+    line.append(QByteArray::number(row.hash, 16).rightJustified(16, '0')).append(',');
+    line.append(QByteArray::number(row.sharpness, 'f', 3)).append(',');
+    line.append(QByteArray::number(row.brightness, 'f', 3)).append(',');
+    line.append(QByteArray::number(row.width)).append(',');
+    line.append(QByteArray::number(row.height)).append(',');
+    line.append(row.mode == MODE_PLAN ? QByteArray("plan") : QByteArray::number(row.mode)).append(',');
+    line.append((row.flags & FLAG_KEYFRAME) ? '1' : '0').append(',');
+    line.append((row.flags & FLAG_ANALYSED) ? '1' : '0').append('\n');
+    return line;
+}
+
+/***********************************************************
+ * 函数名称: stringId
+ * 函数功能: 获取字符串在当前块字符串表中的序号
+ * 参数说明:
+ *   text - 字符串
+ * 返回值: 序号，新字符串加入字符串表
+ * 备注: 同一视频的行共用一个字符串，来源视频列只占每行 4 字节
+ ***********************************************************/
+quint32 frameManifest::stringId(const QString &text)
+{
+    QHash<QString, quint32>::const_iterator found = stringIds.constFind(text);
+    if (found != stringIds.constEnd())
+    {
+        return found.value();
+    }
+    const quint32 id = static_cast<quint32>(strings.size());
+    strings.append(text.toUtf8());
+    stringIds.insert(text, id);
+    return id;
+}
@@ -0,0 +1,170 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: framemanifest.h
+ *
+ * 模块描述:
+ *   该模块定义了逐帧元数据清单。每写出一张图像记录一行: 来源视频、帧号、
+ *   时间戳、感知哈希、清晰度、平均亮度、原帧尺寸和导出模式，下游筛选
+ *   数据集时只读清单，不再解码图像。
+ *   清单为按列存放的二进制文件，由若干数据块组成，每块最多 4096 行，
+ *   块内每列连续存放并按 8 字节对齐，字符串存放在块内的字符串表中。
+ *   写入时在内存中按列缓存，每满一块以一次写调用追加到文件末尾；
+ *   读取时整个文件只读内存映射，各列直接以指针访问，不做解析和复制。
+ *   可选同时追加写出 CSV 清单。
+ *
+ * 主要功能:
+ *   1. 按列缓存记录，整块追加写出二进制清单和可选的 CSV 清单
+ *   2. 内存映射打开清单，按块提供各列的指针
+ *   3. 生成 CSV 表头和记录行
+ *
+ * 函数列表:
+ *   1. frameManifest             - 构造函数
+ *   2. ~frameManifest            - 析构函数，写出缓存的记录
+ *   3. create                    - 打开清单追加写入
+ *   4. append                    - 缓存一行记录
+ *   5. flush                     - 将缓存的记录作为一个数据块写出
+ *   6. open                      - 只读内存映射打开清单
+ *   7. close                     - 写出缓存的记录并关闭清单
+ *   8. row                       - 读取一行记录
+ *   9. csvHeader                 - 生成 CSV 表头
+ *   10. csvLine                  - 生成一行 CSV 记录
+ *   11. stringId                 - 获取字符串在当前块字符串表中的序号
+ *   12. string                   - 获取数据块字符串表中的字符串
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 追加前截掉末尾不完整的数据块，只读打开时报告末尾无法识别的字节
+ ***********************************************************/
+
+#ifndef FRAMEMANIFEST_H
+#define FRAMEMANIFEST_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+class frameManifest
+{
+public:
+    static const int CHUNK_ROWS = 4096;   // 每个数据块的最大行数
+    static const quint8 MODE_PLAN = 0xff; // 导出模式列: 由计划执行写出
+
+    // 标记列的各位
+    enum Flag
+    {
+        FLAG_KEYFRAME = 0x01, // 关键帧
+        FLAG_ANALYSED = 0x02  // 哈希、清晰度和亮度有效，不支持的帧格式为 0
+    };
+
+    // 一行记录
+    struct record
+    {
+        QString file;       // 图像文件，相对于清单所在目录
+        QString video;      // 来源视频
+        qint64 frameNumber; // 帧号
+        qint64 ptsUs;       // 显示时间戳(微秒)
+        quint64 hash;       // 64 位感知哈希
+        float sharpness;    // 全分辨率亮度梯度均值
+        float brightness;   // 平均亮度(0~255)
+        qint32 width;       // 原帧宽度
+        qint32 height;      // 原帧高度
+        quint8 mode;        // 导出模式，计划执行为 MODE_PLAN
+        quint8 flags;       // Flag 的组合
+
+        record() : frameNumber(-1), ptsUs(0), hash(0), sharpness(0), brightness(0),
+                   width(0), height(0), mode(0), flags(0) {}
+    };
+
+    // 映射后的一个数据块，各列指针直接指向映射内存，关闭清单后失效
+    struct chunk
+    {
+        int rows;                     // 行数
+        const qint64 *frameNumbers;   // 帧号列
+        const qint64 *ptsUs;          // 时间戳列
+        const quint64 *hashes;        // 感知哈希列
+        const float *sharpness;       // 清晰度列
+        const float *brightness;      // 平均亮度列
+        const qint32 *widths;         // 原帧宽度列
+        const qint32 *heights;        // 原帧高度列
+        const quint32 *videos;        // 来源视频列，字符串表序号
+        const quint32 *files;         // 图像文件列，字符串表序号
+        const quint8 *modes;          // 导出模式列
+        const quint8 *flags;          // 标记列
+        int strings;                  // 字符串表的字符串数
+        const quint32 *stringOffsets; // 各字符串的起始位置，共 strings + 1 项
+        const char *stringData;       // UTF-8 字符串数据
+
+        QString string(quint32 id) const; // 获取字符串表中的字符串
+    };
+
+    frameManifest();
+    ~frameManifest();
+
+    bool create(const QString &fileName, bool writeCsv,
+                QString *error = nullptr);                 // 打开清单追加写入，writeCsv 时同时写出同名 .csv
+    void append(const record &row);                        // 缓存一行记录，满一块时写出
+    bool flush();                                          // 将缓存的记录作为一个数据块写出
+    bool open(const QString &fileName, QString *error = nullptr); // 只读内存映射打开清单
+    void close();                                          // 写出缓存的记录并关闭清单
+
+    bool isWriting() const { return writer.isOpen(); }     // 是否已打开追加写入
+    QString fileName() const { return manifestFileName; }  // 清单文件路径
+    qint64 rowsWritten() const { return writtenRows; }     // 本次打开后追加的行数
+    qint64 rowCount() const { return mappedRows; }         // 映射的清单总行数
+    qint64 trailingBytes() const { return unreadBytes; }   // 最后一个完整数据块之后无法识别的字节数
+    int chunkCount() const { return chunks.size(); }       // 映射的清单数据块数
+    const chunk &chunkAt(int n) const { return chunks[n]; } // 获取映射的数据块
+    record row(int chunkIndex, int rowIndex) const;        // 读取一行记录
+
+    static QByteArray csvHeader();                         // 生成 CSV 表头
+    static QByteArray csvLine(const record &row);          // 生成一行 CSV 记录
+
+private:
+    quint32 stringId(const QString &text);                 // 获取字符串在当前块字符串表中的序号
+
+    QString manifestFileName;       // 清单文件路径
+    QFile writer;                   // 二进制清单，追加写入
+    QFile csvWriter;                // CSV 清单，未启用时不打开
+    QByteArray csvBuffer;           // 尚未写出的 CSV 行
+    qint64 writtenRows;             // 本次打开后追加的行数
+
+    // 当前块按列缓存的记录
+    QVector<qint64> frameNumbers;
+    QVector<qint64> ptsUs;
+    QVector<quint64> hashes;
+    QVector<float> sharpness;
+    QVector<float> brightness;
+    QVector<qint32> widths;
+    QVector<qint32> heights;
+    QVector<quint32> videos;
+    QVector<quint32> files;
+    QByteArray modes;
+    QByteArray flags;
+    QVector<QByteArray> strings;    // 当前块的字符串表
+    QHash<QString, quint32> stringIds; // 字符串到字符串表序号
+
+    QFile reader;                   // 只读映射的清单文件
+    uchar *mapped;                  // 映射地址，未映射时为空
+    QVector<chunk> chunks;          // 映射的数据块
+    qint64 mappedRows;              // 映射的清单总行数
+    qint64 unreadBytes;             // 最后一个完整数据块之后无法识别的字节数
+};
+
+#endif // FRAMEMANIFEST_H
@@ -0,0 +1,173 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: framesource.cpp
+ *
+ * 模块描述:
+ *   该模块实现了帧源接口的公共部分和帧源工厂。
+ *
+ * 主要功能:
+ *   1. 根据输入路径和参数创建具体帧源
+ *   2. 提供默认的视频时长估算
+ *
+ * 函数列表:
+ *   1. frameSource::create       - 根据输入路径和参数创建帧源
+ *   2. frameSource::backendNames - 获取当前编译支持的后端名称
+ *   3. frameSource::durationMs   - 获取视频时长
+ *   4. frameSource::setKeyframeSampling - 设置只输出关键帧
+ *   5. frameSource::setSamplingInterval - 设置等间隔采样计划
+ *   6. frameSource::setTimeRanges       - 设置只输出指定时间段内的帧
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 增加关键帧采样的默认实现
+ *     * 增加等间隔采样计划的默认实现
+ *     * 增加导出时间段的默认实现
+ *     * libav 帧源按创建参数设置 HDR 色调映射方式
+ ***********************************************************/
+
+#include "framesource.h"
+#include <QDebug>
+#include "qtframesource.h"
+#include "y4msource.h"
+#ifdef HAVE_FFMPEG
+#include "libavframesource.h"
+#endif
+
+/***********************************************************
+ * 函数名称: frameSource::durationMs
+ * 函数功能: 获取视频时长
+ * 参数说明: 无
+ * 返回值: 视频时长(毫秒)，未知时返回 -1
+ * 备注: 默认按帧数和帧率估算，能从容器读取时长的后端应重写
+ ***********************************************************/
+qint64 frameSource::durationMs() const
+{
+    const qint64 frames = frameCount();
+    const double rate = frameRate();
+    if (frames < 0 || rate <= 0)
+    {
+        return -1;
+    }
+    return static_cast<qint64>(frames * 1000 / rate);
+}
+
+/***********************************************************
+ * 函数名称: frameSource::create
+ * 函数功能: 根据输入路径和参数创建帧源
+ * 参数说明:
+ *   path    - 输入路径
+ *   options - 帧源创建参数
+ * 返回值: 未打开的帧源，由调用者释放
+ * 备注: Y4M/YUV/标准输入总是使用免解码的原始帧源；
+ *       后端为空时优先使用 libav(编译时启用 ffmpeg)，否则使用 Qt 多媒体
+ ***********************************************************/
+frameSource *frameSource::create(const QString &path, const frameSourceOptions &options)
+{
+    if (y4mSource::isRawInput(path) || options.backend == "raw")
+    {
+        y4mSource *source = new y4mSource();
+        source->setRawFormat(options.rawWidth, options.rawHeight,
+                             frameView::formatFromName(options.rawPixelFormat),
+                             qRound(options.rawFrameRate * 1000), 1000);
+        return source;
+    }
+
+#ifdef HAVE_FFMPEG
+    if (options.backend.isEmpty() || options.backend == "libav")
+    {
+        libavFrameSource *source = new libavFrameSource();
+        source->setThreading(options.decoderThreads, options.threadType);
+        source->setToneMap(options.toneMap);
+        return source;
+    }
+#else
+    if (options.backend == "libav")
+    {
+        qDebug() << "libav backend not compiled in, falling back to qt";
+    }
+#endif
+
+    return new qtFrameSource();
+}
+
+/***********************************************************
+ * 函数名称: frameSource::backendNames
+ * 函数功能: 获取当前编译支持的后端名称
+ * 参数说明: 无
+ * 返回值: 后端名称列表，第一个为默认后端
+ * 备注: 供设置界面和命令行帮助使用
+ ***********************************************************/
+QStringList frameSource::backendNames()
+{
+    QStringList names;
+#ifdef HAVE_FFMPEG
+    names << "libav";
+#endif
+    names << "qt";
+    return names;
+}
+
+/***********************************************************
+ * 函数名称: frameSource::setKeyframeSampling
+ * 函数功能: 设置只输出关键帧
+ * 参数说明:
+ *   enabled  - 是否只输出关键帧
+ *   minGapUs - 相邻两个输出关键帧的最小时间间隔(微秒)，0 为不限
+ * 返回值: 帧源在解码前完成过滤时返回 true
+ * 备注: 需在 open() 前调用。默认实现不做任何过滤，返回 false，
+ *       由调用方按帧视图的关键帧标记和时间戳自行筛选
+ ***********************************************************/
+bool frameSource::setKeyframeSampling(bool enabled, qint64 minGapUs)
+{
+    Q_UNUSED(enabled);
+    Q_UNUSED(minGapUs);
+    return false;
+}
+
+/***********************************************************
+ * 函数名称: frameSource::setSamplingInterval
+ * 函数功能: 设置等间隔采样计划
+ * 参数说明:
+ *   interval - 采样间隔(帧)，小于等于 1 表示每帧都需要
+ *   phase    - 被导出帧的帧号对间隔取余的值，即 index % interval == phase 的帧会被导出
+ * 返回值: 帧源会跳过计划外的帧时返回 true
+ * 备注: 需在 open() 前调用。默认实现忽略计划，每帧都输出，返回 false；
+ *       无论返回值如何，调用方都按帧视图的帧号再筛选一次
+ ***********************************************************/
+bool frameSource::setSamplingInterval(int interval, int phase)
+{
+    Q_UNUSED(interval);
+    Q_UNUSED(phase);
+    return false;
+}
+
+/***********************************************************
+ * 函数名称: frameSource::setTimeRanges
+ * 函数功能: 设置只输出指定时间段内的帧
+ * 参数说明:
+ *   ranges - 按入点排序、互不重叠的时间段，为空表示整个视频
+ * 返回值: 帧源会跳转越过段外区域时返回 true
+ * 备注: 需在 open() 前调用。默认实现不跳转，每帧都输出，返回 false；
+ *       无论返回值如何，调用方都按帧视图的时间戳再筛选一次，
+ *       并在越过最后一个时间段后停止读取
+ ***********************************************************/
+bool frameSource::setTimeRanges(const QVector<timeRange> &ranges)
+{
+    Q_UNUSED(ranges);
+    return false;
+}
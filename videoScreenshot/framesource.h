@@ -0,0 +1,117 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: framesource.h
+ *
+ * 模块描述:
+ *   该模块定义了导出流水线的帧源接口。导出线程以拉取方式逐帧读取，
+ *   帧携带显示时间戳、关键帧标志和像素格式，与具体解码后端无关。
+ *
+ * 主要功能:
+ *   1. 定义帧源接口(打开/关闭/读取下一帧)
+ *   2. 定义帧源创建参数(后端、解码线程、无头 YUV 格式)
+ *   3. 根据输入路径和参数创建具体帧源
+ *
+ * 函数列表:
+ *   1. frameSource::create       - 根据输入路径和参数创建帧源
+ *   2. frameSource::backendNames - 获取当前编译支持的后端名称
+ *   3. frameSource::setStats     - 设置阶段统计对象
+ *   4. frameSource::durationMs   - 获取视频时长
+ *   5. frameSource::setKeyframeSampling - 设置只输出关键帧
+ *   6. frameSource::hasKeyframeFlags    - 帧视图是否带有效的关键帧标记
+ *   7. frameSource::setSamplingInterval - 设置等间隔采样计划
+ *   8. frameSource::setTimeRanges       - 设置只输出指定时间段内的帧
+ *   9. frameSource::setPaused           - 暂停/继续产生帧
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 增加关键帧采样接口，支持的后端在解码前丢弃非关键帧
+ *     * 增加等间隔采样计划接口，支持的后端跳过不会被导出的帧
+ *     * 增加导出时间段接口，支持的后端跳转到各时间段，不解码段间区域
+ *     * 帧源创建参数增加 HDR 色调映射方式
+ *     * 增加暂停接口，按实时速度推送帧的后端在导出暂停时停止推送
+ ***********************************************************/
+
+#ifndef FRAMESOURCE_H
+#define FRAMESOURCE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "frameview.h"
+#include "timerange.h"
+
+class pipelineStats;
+
+// 帧源创建参数
+struct frameSourceOptions
+{
+    enum ThreadType
+    {
+        THREAD_AUTO = 0, // 由解码器决定
+        THREAD_FRAME,    // 帧级并行，吞吐高但延迟多若干帧
+        THREAD_SLICE     // 片级并行，延迟低，依赖码流按片编码
+    };
+
+    QString backend;        // 后端名称(qt/libav/raw)，为空时自动选择
+    int decoderThreads;     // 解码线程数，0 为自动
+    ThreadType threadType;  // 解码并行方式
+    int rawWidth;           // 无头 YUV 输入的宽度
+    int rawHeight;          // 无头 YUV 输入的高度
+    QString rawPixelFormat; // 无头 YUV 输入的像素格式
+    double rawFrameRate;    // 无头 YUV 输入的帧率
+    frameView::ToneMap toneMap; // HDR 帧转换为 8bit 时的色调映射方式
+
+    frameSourceOptions() : decoderThreads(0), threadType(THREAD_AUTO), rawWidth(0), rawHeight(0),
+                           rawPixelFormat("yuv420p"), rawFrameRate(25.0), toneMap(frameView::TONEMAP_HABLE) {}
+};
+
+class frameSource
+{
+public:
+    frameSource() : stats(nullptr) {}
+    virtual ~frameSource() {}
+
+    virtual bool open(const QString &path) = 0;     // 打开输入
+    virtual void close() = 0;                       // 关闭输入
+    virtual bool readFrame(frameView &frame) = 0;   // 读取下一帧，视图在下一次调用前有效
+    virtual int width() const = 0;                  // 帧宽度
+    virtual int height() const = 0;                 // 帧高度
+    virtual double frameRate() const = 0;           // 帧率
+    virtual qint64 frameCount() const = 0;          // 总帧数，未知时为 -1
+    virtual qint64 durationMs() const;              // 视频时长，未知时按帧数估算
+    virtual QString errorString() const = 0;        // 错误描述
+    virtual QString backendName() const = 0;        // 后端名称
+    virtual bool setKeyframeSampling(bool enabled,
+                                     qint64 minGapUs); // 设置只输出关键帧，返回是否由帧源在解码前过滤
+    virtual bool hasKeyframeFlags() const { return true; } // 帧视图是否带有效的关键帧标记
+    virtual bool setSamplingInterval(int interval,
+                                     int phase);        // 设置等间隔采样计划，返回是否由帧源跳过不导出的帧
+    virtual bool setTimeRanges(const QVector<timeRange> &ranges); // 设置导出时间段，返回是否由帧源跳过段外区域
+    virtual void setPaused(bool paused) { Q_UNUSED(paused); } // 暂停/继续产生帧，拉取式后端无需处理
+
+    void setStats(pipelineStats *pipeline) { stats = pipeline; } // 设置阶段统计对象
+
+    static frameSource *create(const QString &path,
+                               const frameSourceOptions &options); // 根据输入路径和参数创建帧源
+    static QStringList backendNames();                             // 获取当前编译支持的后端名称
+
+protected:
+    pipelineStats *stats; // 阶段统计对象，为空时不记录
+};
+
+#endif // FRAMESOURCE_H
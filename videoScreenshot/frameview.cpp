@@ -0,0 +1,337 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: frameview.cpp
+ *
+ * 模块描述:
+ *   该模块实现了原始视频帧视图的格式辅助函数。
+ *
+ * 主要功能:
+ *   1. 计算各像素格式的平面尺寸和帧字节数
+ *   2. 像素格式与名称互相转换
+ *
+ * 函数列表:
+ *   1. planeCount                - 获取像素格式的平面数
+ *   2. planeSize                 - 获取指定平面的宽高(字节)
+ *   3. bufferSize                - 获取紧凑排列时一帧的字节数
+ *   4. formatFromName            - 根据名称获取像素格式
+ *   5. formatName                - 获取像素格式名称
+ *   6. setPacked                 - 按紧凑排列设置平面指针
+ *   7. isHighBitDepth            - 像素格式是否为 16 位容器的高位深格式
+ *   8. toneMapFromName           - 根据名称获取色调映射方式
+ *   9. toneMapName               - 获取色调映射方式名称
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 增加 P010/YUV420P10 格式和色调映射方式名称
+ ***********************************************************/
+
+#include "frameview.h"
+
+/***********************************************************
+ * 函数名称: planeCount
+ * 函数功能: 获取像素格式的平面数
+ * 参数说明:
+ *   format - 像素格式
+ * 返回值: 平面数，未知格式返回 0
+ * 备注: 无
+ ***********************************************************/
+int frameView::planeCount(PixelFormat format)
+{
+    switch (format)
+    {
+    case FORMAT_GRAY8:
+    case FORMAT_RGB32:
+        return 1;
+    case FORMAT_NV12:
+    case FORMAT_P010:
+        return 2;
+    case FORMAT_YUV420P:
+    case FORMAT_YUV422P:
+    case FORMAT_YUV444P:
+    case FORMAT_YUV420P10:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+/***********************************************************
+ * 函数名称: planeSize
+ * 函数功能: 获取指定平面的宽高(字节)
+ * 参数说明:
+ *   format   - 像素格式
+ *   width    - 帧宽度
+ *   height   - 帧高度
+ *   plane    - 平面序号
+ *   rowBytes - 返回该平面每行有效字节数
+ *   rows     - 返回该平面行数
+ * 返回值: 无
+ * 备注: 色度平面按向上取整计算，与 ffmpeg 一致
+ ***********************************************************/
+void frameView::planeSize(PixelFormat format, int width, int height, int plane, int *rowBytes, int *rows)
+{
+    int bytes = 0;
+    int lines = 0;
+    const int halfWidth = (width + 1) / 2;
+    const int halfHeight = (height + 1) / 2;
+
+    if (plane == 0)
+    {
+        bytes = format == FORMAT_RGB32 ? width * 4 : (isHighBitDepth(format) ? width * 2 : width);
+        lines = height;
+    }
+    else if (plane < planeCount(format))
+    {
+        switch (format)
+        {
+        case FORMAT_YUV420P:
+            bytes = halfWidth;
+            lines = halfHeight;
+            break;
+        case FORMAT_YUV422P:
+            bytes = halfWidth;
+            lines = height;
+            break;
+        case FORMAT_YUV444P:
+            bytes = width;
+            lines = height;
+            break;
+        case FORMAT_NV12:
+            bytes = halfWidth * 2;
+            lines = halfHeight;
+            break;
+        case FORMAT_YUV420P10:
+            bytes = halfWidth * 2;
+            lines = halfHeight;
+            break;
+        case FORMAT_P010:
+            bytes = halfWidth * 4;
+            lines = halfHeight;
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (rowBytes != nullptr)
+    {
+        *rowBytes = bytes;
+    }
+    if (rows != nullptr)
+    {
+        *rows = lines;
+    }
+}
+
+/***********************************************************
+ * 函数名称: bufferSize
+ * 函数功能: 获取紧凑排列时一帧的字节数
+ * 参数说明:
+ *   format - 像素格式
+ *   width  - 帧宽度
+ *   height - 帧高度
+ * 返回值: 字节数
+ * 备注: 紧凑排列即行跨度等于行有效字节数，平面首尾相接
+ ***********************************************************/
+qint64 frameView::bufferSize(PixelFormat format, int width, int height)
+{
+    qint64 total = 0;
+    for (int plane = 0; plane < planeCount(format); ++plane)
+    {
+        int rowBytes = 0;
+        int rows = 0;
+        planeSize(format, width, height, plane, &rowBytes, &rows);
+        total += static_cast<qint64>(rowBytes) * rows;
+    }
+    return total;
+}
+
+/***********************************************************
+ * 函数名称: formatFromName
+ * 函数功能: 根据名称获取像素格式
+ * 参数说明:
+ *   name - ffmpeg 风格的格式名，如 yuv420p、nv12
+ * 返回值: 像素格式，无法识别返回 FORMAT_UNKNOWN
+ * 备注: 无
+ ***********************************************************/
+frameView::PixelFormat frameView::formatFromName(const QString &name)
+{
+    const QString key = name.trimmed().toLower();
+    if (key == "gray" || key == "gray8")
+    {
+        return FORMAT_GRAY8;
+    }
+    if (key == "yuv420p" || key == "i420")
+    {
+        return FORMAT_YUV420P;
+    }
+    if (key == "yuv422p")
+    {
+        return FORMAT_YUV422P;
+    }
+    if (key == "yuv444p")
+    {
+        return FORMAT_YUV444P;
+    }
+    if (key == "nv12")
+    {
+        return FORMAT_NV12;
+    }
+    if (key == "bgra" || key == "rgb32")
+    {
+        return FORMAT_RGB32;
+    }
+    if (key == "yuv420p10" || key == "yuv420p10le")
+    {
+        return FORMAT_YUV420P10;
+    }
+    if (key == "p010" || key == "p010le")
+    {
+        return FORMAT_P010;
+    }
+    return FORMAT_UNKNOWN;
+}
+
+/***********************************************************
+ * 函数名称: formatName
+ * 函数功能: 获取像素格式名称
+ * 参数说明:
+ *   format - 像素格式
+ * 返回值: ffmpeg 风格的格式名
+ * 备注: 无
+ ***********************************************************/
+QString frameView::formatName(PixelFormat format)
+{
+    switch (format)
+    {
+    case FORMAT_GRAY8:
+        return "gray";
+    case FORMAT_YUV420P:
+        return "yuv420p";
+    case FORMAT_YUV422P:
+        return "yuv422p";
+    case FORMAT_YUV444P:
+        return "yuv444p";
+    case FORMAT_NV12:
+        return "nv12";
+    case FORMAT_RGB32:
+        return "bgra";
+    case FORMAT_YUV420P10:
+        return "yuv420p10le";
+    case FORMAT_P010:
+        return "p010le";
+    default:
+        return "unknown";
+    }
+}
+
+/***********************************************************
+ * 函数名称: setPacked
+ * 函数功能: 按紧凑排列设置平面指针
+ * 参数说明:
+ *   data        - 帧数据起始地址
+ *   pixelFormat - 像素格式
+ *   frameWidth  - 帧宽度
+ *   frameHeight - 帧高度
+ * 返回值: 无
+ * 备注: 不拷贝数据，视图有效期与 data 相同
+ ***********************************************************/
+void frameView::setPacked(const uchar *data, PixelFormat pixelFormat, int frameWidth, int frameHeight)
+{
+    format = pixelFormat;
+    width = frameWidth;
+    height = frameHeight;
+
+    const uchar *cursor = data;
+    for (int plane = 0; plane < MAX_PLANES; ++plane)
+    {
+        int rowBytes = 0;
+        int rows = 0;
+        planeSize(format, width, height, plane, &rowBytes, &rows);
+        planes[plane] = rowBytes > 0 ? cursor : nullptr;
+        strides[plane] = rowBytes;
+        cursor += static_cast<qint64>(rowBytes) * rows;
+    }
+}
+
+/***********************************************************
+ * 函数名称: isHighBitDepth
+ * 函数功能: 像素格式是否为 16 位容器的高位深格式
+ * 参数说明:
+ *   format - 像素格式
+ * 返回值: P010/YUV420P10 返回 true
+ * 备注: 这类格式每个样本占 2 字节，只读 8 位样本的代码须先换算
+ ***********************************************************/
+bool frameView::isHighBitDepth(PixelFormat format)
+{
+    return format == FORMAT_YUV420P10 || format == FORMAT_P010;
+}
+
+/***********************************************************
+ * 函数名称: toneMapFromName
+ * 函数功能: 根据名称获取色调映射方式
+ * 参数说明:
+ *   name - clip、reinhard 或 hable
+ *   ok   - 返回是否识别，可为空
+ * 返回值: 色调映射方式，无法识别时返回 TONEMAP_HABLE
+ * 备注: 无
+ ***********************************************************/
+frameView::ToneMap frameView::toneMapFromName(const QString &name, bool *ok)
+{
+    const QString key = name.trimmed().toLower();
+    ToneMap toneMap = TONEMAP_HABLE;
+    bool known = true;
+    if (key == "clip")
+    {
+        toneMap = TONEMAP_CLIP;
+    }
+    else if (key == "reinhard")
+    {
+        toneMap = TONEMAP_REINHARD;
+    }
+    else if (key != "hable")
+    {
+        known = false;
+    }
+    if (ok != nullptr)
+    {
+        *ok = known;
+    }
+    return toneMap;
+}
+
+/***********************************************************
+ * 函数名称: toneMapName
+ * 函数功能: 获取色调映射方式名称
+ * 参数说明:
+ *   toneMap - 色调映射方式
+ * 返回值: clip、reinhard 或 hable
+ * 备注: 无
+ ***********************************************************/
+QString frameView::toneMapName(ToneMap toneMap)
+{
+    switch (toneMap)
+    {
+    case TONEMAP_CLIP:
+        return "clip";
+    case TONEMAP_REINHARD:
+        return "reinhard";
+    default:
+        return "hable";
+    }
+}
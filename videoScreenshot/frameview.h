@@ -0,0 +1,120 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: frameview.h
+ *
+ * 模块描述:
+ *   该模块定义了原始视频帧的只读视图。视图只保存各平面的指针和行跨度，
+ *   不拥有像素内存，可以直接指向内存映射文件或解码器缓冲区，避免拷贝。
+ *
+ * 主要功能:
+ *   1. 描述帧的像素格式、尺寸、平面指针和时间戳
+ *   2. 计算各像素格式的平面尺寸和帧字节数
+ *   3. 像素格式与名称互相转换
+ *
+ * 函数列表:
+ *   1. planeCount                - 获取像素格式的平面数
+ *   2. planeSize                 - 获取指定平面的宽高(字节)
+ *   3. bufferSize                - 获取紧凑排列时一帧的字节数
+ *   4. formatFromName            - 根据名称获取像素格式
+ *   5. formatName                - 获取像素格式名称
+ *   6. setPacked                 - 按紧凑排列设置平面指针
+ *   7. isHighBitDepth            - 像素格式是否为 16 位容器的高位深格式
+ *   8. toneMapFromName           - 根据名称获取色调映射方式
+ *   9. toneMapName               - 获取色调映射方式名称
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 增加 10bit 的 P010/YUV420P10 格式，以及 HDR 传递特性和色调映射方式
+ ***********************************************************/
+
+#ifndef FRAMEVIEW_H
+#define FRAMEVIEW_H
+
+#include <QString>
+#include <QtGlobal>
+
+struct frameView
+{
+    enum PixelFormat
+    {
+        FORMAT_UNKNOWN = 0,
+        FORMAT_GRAY8,
+        FORMAT_YUV420P,
+        FORMAT_YUV422P,
+        FORMAT_YUV444P,
+        FORMAT_NV12,
+        FORMAT_RGB32,
+        FORMAT_YUV420P10, // 平面 4:2:0，每个样本 16 位小端，低 10 位有效
+        FORMAT_P010       // 亮度平面 + UV 交错平面，每个样本 16 位小端，高 10 位有效
+    };
+
+    // 传递特性(光电转换曲线)
+    enum Transfer
+    {
+        TRANSFER_SDR = 0, // BT.709/BT.601 等 SDR 伽马
+        TRANSFER_PQ,      // SMPTE ST 2084 (HDR10)
+        TRANSFER_HLG      // ARIB STD-B67 (HLG)
+    };
+
+    // HDR 到 8bit SDR 的色调映射方式
+    enum ToneMap
+    {
+        TONEMAP_CLIP = 0, // 超出 SDR 参考白的部分直接截断
+        TONEMAP_REINHARD, // 扩展 Reinhard 曲线，高光按峰值亮度压缩
+        TONEMAP_HABLE     // Hable(Uncharted 2) 胶片曲线，保留较多高光层次
+    };
+
+    static const int MAX_PLANES = 3;
+
+    const uchar *planes[MAX_PLANES]; // 各平面起始地址
+    int strides[MAX_PLANES];         // 各平面行跨度(字节)
+    int width;                       // 宽度
+    int height;                      // 高度
+    PixelFormat format;              // 像素格式
+    qint64 ptsUs;                    // 显示时间戳(微秒)
+    qint64 index;                    // 帧序号(从0开始)
+    bool keyframe;                   // 是否为关键帧
+    Transfer transfer;               // 传递特性
+    ToneMap toneMap;                 // 转换为 8bit 时的色调映射方式，仅 HDR 帧有效
+
+    frameView() : width(0), height(0), format(FORMAT_UNKNOWN), ptsUs(0), index(0), keyframe(false),
+                  transfer(TRANSFER_SDR), toneMap(TONEMAP_HABLE)
+    {
+        for (int i = 0; i < MAX_PLANES; ++i)
+        {
+            planes[i] = nullptr;
+            strides[i] = 0;
+        }
+    }
+
+    bool isValid() const { return format != FORMAT_UNKNOWN && width > 0 && height > 0 && planes[0] != nullptr; }
+
+    static int planeCount(PixelFormat format);                                      // 获取像素格式的平面数
+    static void planeSize(PixelFormat format, int width, int height, int plane,
+                          int *rowBytes, int *rows);                                // 获取指定平面的宽高(字节)
+    static qint64 bufferSize(PixelFormat format, int width, int height);           // 获取紧凑排列时一帧的字节数
+    static PixelFormat formatFromName(const QString &name);                         // 根据名称获取像素格式
+    static QString formatName(PixelFormat format);                                  // 获取像素格式名称
+    void setPacked(const uchar *data, PixelFormat pixelFormat, int frameWidth,
+                   int frameHeight);                                                // 按紧凑排列设置平面指针
+    static bool isHighBitDepth(PixelFormat format);                                 // 是否为 16 位容器的高位深格式
+    static ToneMap toneMapFromName(const QString &name, bool *ok = nullptr);        // 根据名称获取色调映射方式
+    static QString toneMapName(ToneMap toneMap);                                    // 获取色调映射方式名称
+};
+
+#endif // FRAMEVIEW_H
@@ -0,0 +1,764 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: gridview.cpp
+ *
+ * 模块描述:
+ *   该模块实现了多机位同步宫格视图。
+ *
+ * 主要功能:
+ *   1. 按时间偏移对齐并同步播放多路视频
+ *   2. 共用解码线程池和预览画面内存预算
+ *   3. 同步截取同一时刻的全部画面
+ *
+ * 函数列表:
+ *   1. gridView                  - 构造函数，初始化UI
+ *   2. ~gridView                 - 析构函数，等待解码任务结束并释放帧源
+ *   3. initUI                    - 初始化用户界面
+ *   4. isAvailable               - 是否编译了宫格视图所需的 libav 后端
+ *   5. setStreams                - 设置要同步播放的视频和时间偏移
+ *   6. clearStreams              - 停止播放并释放全部视频
+ *   7. setToneMap                - 设置 HDR 帧的色调映射方式
+ *   8. setFrameBudget            - 设置预览画面共用的内存预算
+ *   9. play                      - 开始播放
+ *   10. pause                    - 暂停播放
+ *   11. togglePlayPause          - 切换播放/暂停状态
+ *   12. seek                     - 跳转到主时钟位置
+ *   13. position                 - 获取主时钟位置
+ *   14. captureAll               - 同步截取全部画面
+ *   15. tick                     - 推进主时钟并为空闲的视频安排解码
+ *   16. openSource               - 创建并打开一路视频的帧源
+ *   17. decodeStream             - 解码一路视频到主时钟位置
+ *   18. captureStream            - 截取一路视频在指定时刻的原始帧
+ *   19. surfaceSize              - 计算预览画面尺寸
+ *   20. cellRect                 - 计算格子位置
+ *   21. paintEvent               - 绘制全部格子
+ *   22. resizeEvent              - 窗口大小变化时更新预览画面尺寸
+ *   23. clockUs                  - 获取主时钟位置(微秒)
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#include "gridview.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QPainter>
+#include <QRunnable>
+#include <QThread>
+#include <QTime>
+#include <QVBoxLayout>
+#include <cmath>
+#include <limits>
+#include "colorconvert.h"
+#include "framesource.h"
+
+namespace
+{
+    const int DISPLAY_INTERVAL_MS = 33;          // 显示刷新间隔，约 30fps
+    const qint64 CATCH_UP_LIMIT_US = 2000000;    // 落后超过该值(微秒)时重新跳转，不再顺序解码追赶
+    const qint64 CAPTURE_WINDOW_US = 1000000;    // 截图时从目标时刻起最多解码的时长(微秒)
+    const int CELL_SPACING = 2;                  // 格子间距(像素)
+
+    // 将毫秒格式化为 "时:分:秒"
+    QString formatMs(qint64 ms)
+    {
+        return QTime(0, 0).addMSecs(static_cast<int>(ms)).toString("hh:mm:ss");
+    }
+}
+
+// 解码一路视频到主时钟位置的任务
+class gridView::decodeTask : public QRunnable
+{
+public:
+    decodeTask(gridView *view, stream *item, qint64 clockUs, QSize surface)
+        : view(view), item(item), clockUs(clockUs), surface(surface)
+    {
+    }
+
+    void run() override
+    {
+        view->decodeStream(item, clockUs, surface);
+        item->busy.storeRelease(0);
+    }
+
+private:
+    gridView *view;
+    stream *item;
+    qint64 clockUs;
+    QSize surface;
+};
+
+// 截取一路视频在指定时刻的原始帧的任务
+class gridView::captureTask : public QRunnable
+{
+public:
+    captureTask(gridView *view, const stream *item, qint64 clockUs, const QString &fileName)
+        : view(view), item(item), clockUs(clockUs), fileName(fileName)
+    {
+    }
+
+    void run() override
+    {
+        if (view->captureStream(item, clockUs, fileName))
+        {
+            view->savedCaptures.fetchAndAddOrdered(1);
+        }
+        if (view->pendingCaptures.fetchAndAddOrdered(-1) == 1)
+        {
+            // 信号在线程池线程发出，界面线程的槽以排队方式执行
+            emit view->captureFinished(view->savedCaptures.loadAcquire(), view->streams.size(),
+                                       view->captureDirectory);
+        }
+    }
+
+private:
+    gridView *view;
+    const stream *item;
+    qint64 clockUs;
+    QString fileName;
+};
+
+/***********************************************************
+ * 函数名称: gridView
+ * 函数功能: 宫格视图的构造函数
+ * 参数说明:
+ *   parent - 父窗口指针,默认为nullptr
+ * 返回值: 无
+ * 备注: 解码线程数取 CPU 核数，由全部视频共用
+ ***********************************************************/
+gridView::gridView(QWidget *parent) : QWidget(parent),
+                                      clockBaseUs(0),
+                                      durationUs(0),
+                                      playing(false),
+                                      stopping(0),
+                                      pendingCaptures(0),
+                                      savedCaptures(0),
+                                      toneMap(frameView::TONEMAP_HABLE),
+                                      frameBudgetBytes(DEFAULT_FRAME_BUDGET)
+{
+    decodePool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+    displayTimer.setInterval(DISPLAY_INTERVAL_MS);
+    connect(&displayTimer, &QTimer::timeout, this, &gridView::tick);
+    initUI();
+}
+
+/***********************************************************
+ * 函数名称: ~gridView
+ * 函数功能: 宫格视图的析构函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 等待解码和截图任务结束后释放帧源
+ ***********************************************************/
+gridView::~gridView()
+{
+    clearStreams();
+}
+
+/***********************************************************
+ * 函数名称: initUI
+ * 函数功能: 初始化用户界面
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 格子绘制在控制栏上方的区域
+ ***********************************************************/
+void gridView::initUI()
+{
+    setWindowTitle(tr("多机位宫格"));
+    resize(1280, 800);
+
+    controlBar = new QWidget(this);
+    playPauseButton = new QPushButton("Play", controlBar);
+    progressBar = new QSlider(Qt::Horizontal, controlBar);
+    progressBar->setRange(0, 0);
+    timeLabel = new QLabel("00:00:00 / 00:00:00", controlBar);
+    captureButton = new QPushButton(tr("同步截图"), controlBar);
+
+    QHBoxLayout *controlLayout = new QHBoxLayout(controlBar);
+    controlLayout->setContentsMargins(0, 0, 0, 0);
+    controlLayout->addWidget(playPauseButton);
+    controlLayout->addWidget(progressBar);
+    controlLayout->addWidget(timeLabel);
+    controlLayout->addWidget(captureButton);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->addStretch(1);
+    mainLayout->addWidget(controlBar);
+    setLayout(mainLayout);
+
+    connect(playPauseButton, &QPushButton::clicked, this, &gridView::togglePlayPause);
+    connect(progressBar, &QSlider::sliderMoved, this, &gridView::seek);
+    connect(captureButton, &QPushButton::clicked, this, &gridView::captureRequested);
+}
+
+/***********************************************************
+ * 函数名称: isAvailable
+ * 函数功能: 是否编译了宫格视图所需的 libav 后端
+ * 参数说明: 无
+ * 返回值: 以 CONFIG+=ffmpeg 编译时返回 true
+ * 备注: Qt 多媒体后端只能按实时速度播放，无法按主时钟跳转和逐帧对齐
+ ***********************************************************/
+bool gridView::isAvailable()
+{
+    return frameSource::backendNames().contains("libav");
+}
+
+/***********************************************************
+ * 函数名称: setStreams
+ * 函数功能: 设置要同步播放的视频和时间偏移
+ * 参数说明:
+ *   paths     - 视频文件路径，最多 MAX_STREAMS 个
+ *   offsetsMs - 各视频的时间偏移(毫秒)，视频时间 = 主时钟 + 偏移；不足的按 0 处理
+ *   error     - 失败时返回错误描述，可为空
+ * 返回值: 全部视频打开成功返回 true
+ * 备注: 替换当前的全部视频，主时钟回到 0 并暂停；
+ *       任一视频打开失败时不保留任何视频
+ ***********************************************************/
+bool gridView::setStreams(const QStringList &paths, const QVector<qint64> &offsetsMs, QString *error)
+{
+    clearStreams();
+    if (!isAvailable() || paths.isEmpty() || paths.size() > MAX_STREAMS)
+    {
+        if (error)
+        {
+            *error = !isAvailable() ? tr("多机位宫格需要 libav 解码后端(CONFIG+=ffmpeg)")
+                                    : tr("请选择 1 到 %1 个视频").arg(MAX_STREAMS);
+        }
+        return false;
+    }
+
+    for (int i = 0; i < paths.size(); ++i)
+    {
+        QString openError;
+        frameSource *source = openSource(paths[i], 0, 0, &openError);
+        if (source == nullptr)
+        {
+            if (error)
+            {
+                *error = QString("%1: %2").arg(paths[i]).arg(openError);
+            }
+            clearStreams();
+            return false;
+        }
+
+        stream *item = new stream;
+        item->path = paths[i];
+        item->offsetUs = i < offsetsMs.size() ? offsetsMs[i] * 1000 : 0;
+        item->durationUs = qMax<qint64>(0, source->durationMs()) * 1000;
+        item->frameUs = static_cast<qint64>(1000000.0 / qMax(source->frameRate(), 1.0));
+        item->source = source;
+        item->decodedPtsUs = -1;
+        item->seekUs = -1;
+        item->finished = false;
+        item->previewPtsUs = -1;
+        streams.append(item);
+        durationUs = qMax(durationUs, item->durationUs - item->offsetUs);
+    }
+
+    currentSurface = surfaceSize();
+    progressBar->setRange(0, static_cast<int>(durationUs / 1000));
+    progressBar->setValue(0);
+    timeLabel->setText(QString("%1 / %2").arg(formatMs(0)).arg(formatMs(durationUs / 1000)));
+    displayTimer.start();
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: clearStreams
+ * 函数功能: 停止播放并释放全部视频
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 阻塞到已提交的解码和截图任务全部结束
+ ***********************************************************/
+void gridView::clearStreams()
+{
+    displayTimer.stop();
+    playing = false;
+    playPauseButton->setText("Play");
+    stopping.storeRelease(1);
+    decodePool.waitForDone();
+    stopping.storeRelease(0);
+
+    for (stream *item : streams)
+    {
+        delete item->source;
+        delete item;
+    }
+    streams.clear();
+    clockBaseUs = 0;
+    durationUs = 0;
+    update();
+}
+
+/***********************************************************
+ * 函数名称: setToneMap
+ * 函数功能: 设置 HDR 帧的色调映射方式
+ * 参数说明:
+ *   value - 色调映射方式
+ * 返回值: 无
+ * 备注: 对之后打开的帧源生效，需在 setStreams 前调用
+ ***********************************************************/
+void gridView::setToneMap(frameView::ToneMap value)
+{
+    toneMap = value;
+}
+
+/***********************************************************
+ * 函数名称: setFrameBudget
+ * 函数功能: 设置预览画面共用的内存预算
+ * 参数说明:
+ *   bytes - 全部视频的预览画面合计可用的字节数
+ * 返回值: 无
+ * 备注: 视频越多，每路的预览画面越小；格子本身更小时以格子为准
+ ***********************************************************/
+void gridView::setFrameBudget(qint64 bytes)
+{
+    frameBudgetBytes = qMax<qint64>(bytes, 1024 * 1024);
+    currentSurface = surfaceSize();
+}
+
+/***********************************************************
+ * 函数名称: play
+ * 函数功能: 开始播放
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 已到末尾时从头播放
+ ***********************************************************/
+void gridView::play()
+{
+    if (streams.isEmpty() || playing)
+    {
+        return;
+    }
+    if (clockBaseUs >= durationUs)
+    {
+        seek(0);
+    }
+    clock.start();
+    playing = true;
+    playPauseButton->setText("Pause");
+}
+
+/***********************************************************
+ * 函数名称: pause
+ * 函数功能: 暂停播放
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 主时钟停在当前位置，解码任务追到该位置后不再提交
+ ***********************************************************/
+void gridView::pause()
+{
+    if (!playing)
+    {
+        return;
+    }
+    clockBaseUs = clockUs();
+    playing = false;
+    playPauseButton->setText("Play");
+}
+
+/***********************************************************
+ * 函数名称: togglePlayPause
+ * 函数功能: 切换播放/暂停状态
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 无
+ ***********************************************************/
+void gridView::togglePlayPause()
+{
+    if (playing)
+    {
+        pause();
+    }
+    else
+    {
+        play();
+    }
+}
+
+/***********************************************************
+ * 函数名称: seek
+ * 函数功能: 跳转到主时钟位置
+ * 参数说明:
+ *   positionMs - 主时钟位置(毫秒)
+ * 返回值: 无
+ * 备注: 只记录跳转位置，由各路视频的下一个解码任务重新打开帧源并跳转，
+ *       界面线程不阻塞
+ ***********************************************************/
+void gridView::seek(int positionMs)
+{
+    clockBaseUs = qBound<qint64>(0, static_cast<qint64>(positionMs) * 1000, durationUs);
+    if (playing)
+    {
+        clock.start();
+    }
+    for (stream *item : streams)
+    {
+        QMutexLocker locker(&item->mutex);
+        item->seekUs = clockBaseUs;
+    }
+}
+
+/***********************************************************
+ * 函数名称: position
+ * 函数功能: 获取主时钟位置
+ * 参数说明: 无
+ * 返回值: 主时钟位置(毫秒)
+ * 备注: 无
+ ***********************************************************/
+qint64 gridView::position() const
+{
+    return clockUs() / 1000;
+}
+
+/***********************************************************
+ * 函数名称: clockUs
+ * 函数功能: 获取主时钟位置(微秒)
+ * 参数说明: 无
+ * 返回值: 主时钟位置(微秒)，不超过总长
+ * 备注: 无
+ ***********************************************************/
+qint64 gridView::clockUs() const
+{
+    if (!playing)
+    {
+        return clockBaseUs;
+    }
+    return qMin(durationUs, clockBaseUs + clock.nsecsElapsed() / 1000);
+}
+
+/***********************************************************
+ * 函数名称: captureAll
+ * 函数功能: 同步截取全部画面
+ * 参数说明:
+ *   directory - 保存目录，不存在时创建
+ *   baseName  - 文件名前缀，每路视频保存为 <前缀>_cam<序号>.jpg
+ * 返回值: 已提交截图任务返回 true，没有视频或上一次截图未完成时返回 false
+ * 备注: 取当前主时钟时刻，每路视频各自重新打开帧源解码该时刻的原始分辨率帧，
+ *       与预览画面的解码进度无关；任务在共用线程池中执行，全部完成后发出 captureFinished
+ ***********************************************************/
+bool gridView::captureAll(const QString &directory, const QString &baseName)
+{
+    if (streams.isEmpty() || pendingCaptures.loadAcquire() != 0)
+    {
+        return false;
+    }
+    QDir().mkpath(directory);
+
+    const qint64 instantUs = clockUs();
+    captureDirectory = directory;
+    savedCaptures.storeRelease(0);
+    pendingCaptures.storeRelease(streams.size());
+    for (int i = 0; i < streams.size(); ++i)
+    {
+        const QString fileName = QString("%1/%2_cam%3.jpg").arg(directory).arg(baseName).arg(i + 1, 2, 10, QChar('0'));
+        decodePool.start(new captureTask(this, streams[i], instantUs, fileName));
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: tick
+ * 函数功能: 推进主时钟并为空闲的视频安排解码
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 正在解码的视频本轮跳过，下一轮按新的主时钟位置解码，
+ *       解码慢的视频只会少显示几帧，不会拖慢其他视频
+ ***********************************************************/
+void gridView::tick()
+{
+    const qint64 nowUs = clockUs();
+    if (playing && nowUs >= durationUs)
+    {
+        pause();
+    }
+
+    for (stream *item : streams)
+    {
+        {
+            QMutexLocker locker(&item->mutex);
+            if (item->finished && item->seekUs < 0)
+            {
+                continue;
+            }
+        }
+        if (item->busy.testAndSetAcquire(0, 1))
+        {
+            decodePool.start(new decodeTask(this, item, nowUs, currentSurface));
+        }
+    }
+
+    if (!progressBar->isSliderDown())
+    {
+        progressBar->setValue(static_cast<int>(nowUs / 1000));
+    }
+    timeLabel->setText(QString("%1 / %2").arg(formatMs(nowUs / 1000)).arg(formatMs(durationUs / 1000)));
+    update();
+}
+
+/***********************************************************
+ * 函数名称: openSource
+ * 函数功能: 创建并打开一路视频的帧源
+ * 参数说明:
+ *   path    - 视频文件路径
+ *   beginUs - 起始位置(微秒)，大于 0 时跳转到该位置之前的关键帧
+ *   endUs   - 结束位置(微秒)，0 为到视频末尾
+ *   error   - 失败时返回错误描述
+ * 返回值: 已打开的帧源，失败返回 nullptr
+ * 备注: 每个帧源只用一个解码线程，并行度由共用的解码线程池决定
+ ***********************************************************/
+frameSource *gridView::openSource(const QString &path, qint64 beginUs, qint64 endUs, QString *error) const
+{
+    frameSourceOptions options;
+    options.backend = "libav";
+    options.decoderThreads = 1;
+    options.toneMap = toneMap;
+    frameSource *source = frameSource::create(path, options);
+    if (beginUs > 0 || endUs > 0)
+    {
+        QVector<timeRange> ranges(1);
+        ranges[0].beginUs = beginUs;
+        ranges[0].endUs = endUs > 0 ? endUs : std::numeric_limits<qint64>::max();
+        source->setTimeRanges(ranges);
+    }
+    if (!source->open(path))
+    {
+        *error = source->errorString();
+        delete source;
+        return nullptr;
+    }
+    return source;
+}
+
+/***********************************************************
+ * 函数名称: decodeStream
+ * 函数功能: 解码一路视频到主时钟位置
+ * 参数说明:
+ *   item    - 视频
+ *   clockUs - 提交任务时的主时钟位置(微秒)
+ *   surface - 预览画面尺寸
+ * 返回值: 无
+ * 备注: 在解码线程池中执行。当前画面仍覆盖目标时刻时直接返回；
+ *       目标时刻之前的帧只解码不转换，只有目标帧缩小转换为预览画面；
+ *       有待处理的跳转或落后过多时重新打开帧源，从目标时刻之前的关键帧解码
+ ***********************************************************/
+void gridView::decodeStream(stream *item, qint64 clockUs, QSize surface)
+{
+    qint64 seekUs;
+    {
+        QMutexLocker locker(&item->mutex);
+        seekUs = item->seekUs;
+        item->seekUs = -1;
+    }
+
+    const qint64 targetUs = clockUs + item->offsetUs;
+    if (seekUs < 0 && item->decodedPtsUs >= 0 && targetUs - item->decodedPtsUs > CATCH_UP_LIMIT_US)
+    {
+        seekUs = clockUs;
+    }
+    if (seekUs >= 0)
+    {
+        delete item->source;
+        QString error;
+        item->source = openSource(item->path, qMax<qint64>(0, seekUs + item->offsetUs), 0, &error);
+        item->decodedPtsUs = -1;
+        QMutexLocker locker(&item->mutex);
+        item->finished = item->source == nullptr;
+        if (item->source == nullptr)
+        {
+            qDebug() << "Grid reopen failed:" << item->path << error;
+            return;
+        }
+    }
+
+    // 视频尚未开始，或当前画面仍覆盖目标时刻
+    if (targetUs < 0 || (item->decodedPtsUs >= 0 && item->decodedPtsUs + item->frameUs > targetUs))
+    {
+        return;
+    }
+
+    frameView frame;
+    bool reached = false;
+    while (!stopping.loadAcquire())
+    {
+        if (!item->source->readFrame(frame))
+        {
+            QMutexLocker locker(&item->mutex);
+            item->finished = true;
+            break;
+        }
+        item->decodedPtsUs = frame.ptsUs;
+        if (frame.ptsUs + item->frameUs > targetUs)
+        {
+            reached = true;
+            break;
+        }
+    }
+    if (!reached)
+    {
+        return;
+    }
+
+    // 帧视图指向帧源内部缓冲区，须在下一次读取前完成转换
+    const QImage image = convertFrameToThumbnail(frame, surface.width(), surface.height());
+    QMutexLocker locker(&item->mutex);
+    item->preview = image;
+    item->previewPtsUs = frame.ptsUs;
+}
+
+/***********************************************************
+ * 函数名称: captureStream
+ * 函数功能: 截取一路视频在指定时刻的原始帧
+ * 参数说明:
+ *   item     - 视频
+ *   clockUs  - 主时钟时刻(微秒)
+ *   fileName - 保存的文件名
+ * 返回值: 保存成功返回 true
+ * 备注: 在解码线程池中执行，使用独立的帧源，取目标时刻及之后的第一帧，
+ *       与 MainWindow 单画面截图取帧的方式一致
+ ***********************************************************/
+bool gridView::captureStream(const stream *item, qint64 clockUs, const QString &fileName) const
+{
+    const qint64 targetUs = clockUs + item->offsetUs;
+    if (targetUs < 0 || targetUs >= item->durationUs)
+    {
+        qDebug() << "Grid capture out of range:" << item->path << targetUs;
+        return false;
+    }
+
+    QString error;
+    frameSource *source = openSource(item->path, targetUs, targetUs + CAPTURE_WINDOW_US, &error);
+    if (source == nullptr)
+    {
+        qDebug() << "Grid capture open failed:" << item->path << error;
+        return false;
+    }
+
+    QImage image;
+    frameView frame;
+    if (source->readFrame(frame))
+    {
+        image = convertFrameToImage(frame);
+    }
+    delete source;
+    if (image.isNull() || !image.save(fileName))
+    {
+        qDebug() << "Grid capture failed:" << item->path << fileName;
+        return false;
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: surfaceSize
+ * 函数功能: 计算预览画面尺寸
+ * 参数说明: 无
+ * 返回值: 每路视频预览画面的最大尺寸
+ * 备注: 不超过格子大小；预算按每路两份画面计算(绘制时持有一份，
+ *       解码线程生成下一份)，超出时按面积等比缩小
+ ***********************************************************/
+QSize gridView::surfaceSize() const
+{
+    if (streams.isEmpty())
+    {
+        return QSize();
+    }
+    const QSize cell = cellRect(0).size();
+    const qint64 budgetPixels = frameBudgetBytes / (static_cast<qint64>(streams.size()) * 2 * 4);
+    const qint64 cellPixels = static_cast<qint64>(cell.width()) * cell.height();
+    if (cellPixels <= budgetPixels || cellPixels <= 0)
+    {
+        return cell.expandedTo(QSize(1, 1));
+    }
+    const double scale = std::sqrt(static_cast<double>(budgetPixels) / cellPixels);
+    return QSize(qMax(1, static_cast<int>(cell.width() * scale)), qMax(1, static_cast<int>(cell.height() * scale)));
+}
+
+/***********************************************************
+ * 函数名称: cellRect
+ * 函数功能: 计算格子位置
+ * 参数说明:
+ *   index - 视频序号
+ * 返回值: 格子在窗口中的位置
+ * 备注: 列数取视频数的平方根向上取整，格子均分控制栏上方的区域
+ ***********************************************************/
+QRect gridView::cellRect(int index) const
+{
+    const int count = qMax(1, streams.size());
+    const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(count))));
+    const int rows = (count + columns - 1) / columns;
+    const QRect area(0, 0, width(), qMax(0, controlBar->geometry().top() - CELL_SPACING));
+    const int cellWidth = qMax(1, (area.width() - CELL_SPACING * (columns - 1)) / columns);
+    const int cellHeight = qMax(1, (area.height() - CELL_SPACING * (rows - 1)) / rows);
+    return QRect((index % columns) * (cellWidth + CELL_SPACING), (index / columns) * (cellHeight + CELL_SPACING),
+                 cellWidth, cellHeight);
+}
+
+/***********************************************************
+ * 函数名称: paintEvent
+ * 函数功能: 绘制全部格子
+ * 参数说明:
+ *   event - 绘制事件
+ * 返回值: 无
+ * 备注: 预览画面按比例放入格子，左上角标注机位序号、文件名和偏移
+ ***********************************************************/
+void gridView::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter painter(this);
+    painter.fillRect(QRect(0, 0, width(), controlBar->geometry().top()), Qt::black);
+    painter.setPen(Qt::white);
+
+    for (int i = 0; i < streams.size(); ++i)
+    {
+        const QRect cell = cellRect(i);
+        QImage image;
+        {
+            QMutexLocker locker(&streams[i]->mutex);
+            image = streams[i]->preview;
+        }
+        if (!image.isNull())
+        {
+            const QSize fitted = image.size().scaled(cell.size(), Qt::KeepAspectRatio);
+            const QRect target(cell.x() + (cell.width() - fitted.width()) / 2,
+                               cell.y() + (cell.height() - fitted.height()) / 2,
+                               fitted.width(), fitted.height());
+            painter.drawImage(target, image);
+        }
+        const QString label = QString("%1  %2  %3%4s")
+                                  .arg(i + 1)
+                                  .arg(QFileInfo(streams[i]->path).fileName())
+                                  .arg(streams[i]->offsetUs >= 0 ? "+" : "")
+                                  .arg(streams[i]->offsetUs / 1000000.0, 0, 'f', 3);
+        painter.drawText(cell.adjusted(6, 4, -6, -4), Qt::AlignLeft | Qt::AlignTop, label);
+    }
+}
+
+/***********************************************************
+ * 函数名称: resizeEvent
+ * 函数功能: 窗口大小变化时更新预览画面尺寸
+ * 参数说明:
+ *   event - 大小变化事件
+ * 返回值: 无
+ * 备注: 新尺寸从下一次解码的帧开始生效
+ ***********************************************************/
+void gridView::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    currentSurface = surfaceSize();
+}
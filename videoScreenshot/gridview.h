@@ -0,0 +1,171 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: gridview.h
+ *
+ * 模块描述:
+ *   该模块定义了多机位同步宫格视图，用于多视角采集设备的标注。
+ *   最多 16 路视频按各自的时间偏移对齐到同一主时钟播放，全部视频
+ *   共用一个解码线程池和一份预览画面内存预算。每路视频同一时刻只有
+ *   一个解码任务，落后时只解码不转换，预览画面按格子大小直接缩小转换，
+ *   不生成整帧图像。同步截图按同一主时钟时刻从每路视频解码原始分辨率的帧。
+ *   需要 libav 解码后端。
+ *
+ * 主要功能:
+ *   1. 按时间偏移对齐并同步播放多路视频
+ *   2. 共用解码线程池和预览画面内存预算
+ *   3. 同步截取同一时刻的全部画面
+ *
+ * 函数列表:
+ *   1. gridView                  - 构造函数，初始化UI
+ *   2. ~gridView                 - 析构函数，等待解码任务结束并释放帧源
+ *   3. initUI                    - 初始化用户界面
+ *   4. isAvailable               - 是否编译了宫格视图所需的 libav 后端
+ *   5. setStreams                - 设置要同步播放的视频和时间偏移
+ *   6. clearStreams              - 停止播放并释放全部视频
+ *   7. setToneMap                - 设置 HDR 帧的色调映射方式
+ *   8. setFrameBudget            - 设置预览画面共用的内存预算
+ *   9. play                      - 开始播放
+ *   10. pause                    - 暂停播放
+ *   11. togglePlayPause          - 切换播放/暂停状态
+ *   12. seek                     - 跳转到主时钟位置
+ *   13. position                 - 获取主时钟位置
+ *   14. captureAll               - 同步截取全部画面
+ *   15. tick                     - 推进主时钟并为空闲的视频安排解码
+ *   16. openSource               - 创建并打开一路视频的帧源
+ *   17. decodeStream             - 解码一路视频到主时钟位置
+ *   18. captureStream            - 截取一路视频在指定时刻的原始帧
+ *   19. surfaceSize              - 计算预览画面尺寸
+ *   20. cellRect                 - 计算格子位置
+ *   21. paintEvent               - 绘制全部格子
+ *   22. resizeEvent              - 窗口大小变化时更新预览画面尺寸
+ *   23. clockUs                  - 获取主时钟位置(微秒)
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#ifndef GRIDVIEW_H
+#define GRIDVIEW_H
+
+#include <QAtomicInt>
+#include <QImage>
+#include <QLabel>
+#include <QMutex>
+#include <QPushButton>
+#include <QSlider>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QWidget>
+#include "frameview.h"
+
+class frameSource;
+
+class gridView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static const int MAX_STREAMS = 16;                           // 最多同时播放的视频数
+    static const qint64 DEFAULT_FRAME_BUDGET = 64 * 1024 * 1024; // 预览画面默认内存预算(字节)
+
+    explicit gridView(QWidget *parent = nullptr);
+    ~gridView();
+
+    static bool isAvailable(); // 是否编译了宫格视图所需的 libav 后端
+    bool setStreams(const QStringList &paths, const QVector<qint64> &offsetsMs,
+                    QString *error = nullptr);     // 设置要同步播放的视频和时间偏移
+    void clearStreams();                           // 停止播放并释放全部视频
+    void setToneMap(frameView::ToneMap value);     // 设置 HDR 帧的色调映射方式
+    void setFrameBudget(qint64 bytes);             // 设置预览画面共用的内存预算
+    qint64 position() const;                       // 获取主时钟位置(毫秒)
+    bool captureAll(const QString &directory,
+                    const QString &baseName);      // 同步截取全部画面
+
+public slots:
+    void play();            // 开始播放
+    void pause();           // 暂停播放
+    void togglePlayPause(); // 切换播放/暂停状态
+    void seek(int positionMs); // 跳转到主时钟位置
+
+signals:
+    void captureRequested(); // 点击同步截图按钮
+    void captureFinished(int saved, int total, const QString &directory); // 同步截图完成
+
+protected:
+    void paintEvent(QPaintEvent *event) override;   // 绘制全部格子
+    void resizeEvent(QResizeEvent *event) override; // 窗口大小变化时更新预览画面尺寸
+
+private slots:
+    void tick(); // 推进主时钟并为空闲的视频安排解码
+
+private:
+    class decodeTask;
+    class captureTask;
+
+    // 一路视频，帧源只由该路当前的解码任务使用
+    struct stream
+    {
+        QString path;          // 视频文件路径
+        qint64 offsetUs;       // 时间偏移(微秒)，视频时间 = 主时钟 + 偏移
+        qint64 durationUs;     // 视频时长(微秒)
+        qint64 frameUs;        // 帧间隔(微秒)
+        frameSource *source;   // 帧源
+        qint64 decodedPtsUs;   // 最近解码的帧时间戳(微秒)，-1 为尚未解码
+        QAtomicInt busy;       // 是否有解码任务正在处理该路视频
+        QMutex mutex;          // 保护以下成员
+        qint64 seekUs;         // 待处理的跳转位置(主时钟，微秒)，-1 为无
+        bool finished;         // 是否已读到视频末尾
+        QImage preview;        // 最新的预览画面
+        qint64 previewPtsUs;   // 预览画面的时间戳(微秒)，-1 为无
+    };
+
+    void initUI(); // 初始化用户界面
+    frameSource *openSource(const QString &path, qint64 beginUs, qint64 endUs,
+                            QString *error) const;                   // 创建并打开一路视频的帧源
+    void decodeStream(stream *item, qint64 clockUs, QSize surface);   // 解码一路视频到主时钟位置
+    bool captureStream(const stream *item, qint64 clockUs,
+                       const QString &fileName) const;               // 截取一路视频在指定时刻的原始帧
+    QSize surfaceSize() const;                                       // 计算预览画面尺寸
+    QRect cellRect(int index) const;                                 // 计算格子位置
+    qint64 clockUs() const;                                          // 获取主时钟位置(微秒)
+
+    QVector<stream *> streams;   // 全部视频
+    QThreadPool decodePool;      // 共用的解码线程池
+    QTimer displayTimer;         // 显示刷新定时器
+    QElapsedTimer clock;         // 播放计时
+    qint64 clockBaseUs;          // 计时开始时的主时钟位置(微秒)
+    qint64 durationUs;           // 主时钟总长(微秒)
+    bool playing;                // 是否正在播放
+    QAtomicInt stopping;         // 是否正在释放视频，解码任务尽快返回
+    QAtomicInt pendingCaptures;  // 尚未完成的截图任务数
+    QAtomicInt savedCaptures;    // 本次同步截图已保存的画面数
+    QString captureDirectory;    // 本次同步截图的保存目录
+    frameView::ToneMap toneMap;  // HDR 帧的色调映射方式
+    qint64 frameBudgetBytes;     // 预览画面共用的内存预算(字节)
+    QSize currentSurface;        // 当前预览画面尺寸
+
+    QWidget *controlBar;         // 控制栏
+    QPushButton *playPauseButton; // 播放/暂停按钮
+    QSlider *progressBar;        // 进度条(毫秒)
+    QLabel *timeLabel;           // 播放时间标签
+    QPushButton *captureButton;  // 同步截图按钮
+};
+
+#endif // GRIDVIEW_H
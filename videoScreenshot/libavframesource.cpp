@@ -0,0 +1,708 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: libavframesource.cpp
+ *
+ * 模块描述:
+ *   该模块实现了直接调用 libavformat/libavcodec 的帧源。
+ *
+ * 主要功能:
+ *   1. 解复用视频流并逐包送入解码器
+ *   2. 配置解码线程数和帧级/片级并行
+ *   3. 将 AVFrame 映射为帧视图
+ *
+ * 函数列表:
+ *   1. libavFrameSource          - 构造函数
+ *   2. ~libavFrameSource         - 析构函数，释放解码器
+ *   3. setThreading              - 设置解码线程数和并行方式
+ *   4. open                      - 打开视频文件并初始化解码器
+ *   5. close                     - 释放解码器和容器
+ *   6. readFrame                 - 读取下一帧
+ *   7. readVideoPacket           - 读取下一个视频流数据包
+ *   8. mapFrame                  - 将 AVFrame 映射为帧视图
+ *   9. avErrorString             - 获取 libav 错误描述
+ *   10. width                    - 帧宽度
+ *   11. height                   - 帧高度
+ *   12. setKeyframeSampling      - 设置只解码关键帧
+ *   13. setSamplingInterval      - 设置等间隔采样计划
+ *   14. decodeNextFrame          - 解码下一帧到 decodedFrame
+ *   15. packetWanted             - 判断数据包对应的帧是否会被导出
+ *   16. indexFromPts             - 将流时间戳换算为帧号
+ *   17. setTimeRanges            - 设置导出时间段
+ *   18. selectRange              - 切换到指定时间段
+ *   19. seekToRange              - 跳转到当前时间段入点之前的关键帧
+ *   20. setToneMap               - 设置 HDR 帧的色调映射方式
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 增加关键帧采样，非关键帧数据包在解复用后直接丢弃
+ *     * 增加等间隔采样计划，计划外的非参考帧在解码器内丢弃，
+ *       计划外的参考帧只解码不映射，避免 swscale 转换
+ *     * 增加导出时间段，跳转到各段入点之前的关键帧，段间区域不解码，
+ *       入点之前的预滚帧只解码参考帧且不映射
+ *     * P010/YUV420P10 直接映射，其余高位深格式经 swscale 转为 YUV420P10
+ *       而不是 yuv420p，保留 10bit 供色调映射使用；按 color_trc 标记 PQ/HLG
+ ***********************************************************/
+
+#include "libavframesource.h"
+#include "pipelinestats.h"
+#include <QDebug>
+
+extern "C"
+{
+#include <libavutil/pixdesc.h>
+}
+
+// 与下一时间段入点相距不足该值(微秒)时顺序解码过去，不跳转；
+// 跳转需要清空解码器并从关键帧重新解码，短间隔内顺序解码更快
+static const qint64 RANGE_SEEK_THRESHOLD_US = 2000000;
+
+/***********************************************************
+ * 函数名称: libavFrameSource
+ * 函数功能: libav 帧源的构造函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 默认自动选择线程数和并行方式
+ ***********************************************************/
+libavFrameSource::libavFrameSource() : formatContext(nullptr),
+                                       codecContext(nullptr),
+                                       packet(nullptr),
+                                       decodedFrame(nullptr),
+                                       convertedFrame(nullptr),
+                                       swsContext(nullptr),
+                                       streamIndex(-1),
+                                       startPts(0),
+                                       fps(25.0),
+                                       totalFrames(-1),
+                                       duration(-1),
+                                       nextIndex(0),
+                                       draining(false),
+                                       threadCount(0),
+                                       threadType(frameSourceOptions::THREAD_AUTO),
+                                       keyframesOnly(false),
+                                       minKeyframeGapUs(0),
+                                       nextKeyframePts(AV_NOPTS_VALUE),
+                                       samplingInterval(0),
+                                       samplingPhase(0),
+                                       rangeIndex(0),
+                                       rangeBeginPts(0),
+                                       rangeEndPts(0),
+                                       rangeSeeked(false),
+                                       toneMap(frameView::TONEMAP_HABLE)
+{
+    timeBase.num = 1;
+    timeBase.den = 1000000;
+}
+
+/***********************************************************
+ * 函数名称: ~libavFrameSource
+ * 函数功能: libav 帧源的析构函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 无
+ ***********************************************************/
+libavFrameSource::~libavFrameSource()
+{
+    close();
+}
+
+/***********************************************************
+ * 函数名称: setThreading
+ * 函数功能: 设置解码线程数和并行方式
+ * 参数说明:
+ *   threads - 解码线程数，0 为自动(按 CPU 核数)
+ *   type    - 并行方式
+ * 返回值: 无
+ * 备注: 需在 open() 前调用。帧级并行吞吐最高，但每个线程额外缓存一帧，
+ *       延迟和内存随线程数增长；片级并行只对按多片编码的码流有效
+ ***********************************************************/
+void libavFrameSource::setThreading(int threads, frameSourceOptions::ThreadType type)
+{
+    threadCount = qMax(0, threads);
+    threadType = type;
+}
+
+/***********************************************************
+ * 函数名称: setToneMap
+ * 函数功能: 设置 HDR 帧的色调映射方式
+ * 参数说明:
+ *   mode - 色调映射方式
+ * 返回值: 无
+ * 备注: 写入每个输出帧视图，由颜色转换在转为 8bit 时使用；SDR 帧忽略
+ ***********************************************************/
+void libavFrameSource::setToneMap(frameView::ToneMap mode)
+{
+    toneMap = mode;
+}
+
+/***********************************************************
+ * 函数名称: setKeyframeSampling
+ * 函数功能: 设置只解码关键帧
+ * 参数说明:
+ *   enabled  - 是否只解码关键帧
+ *   minGapUs - 相邻两个输出关键帧的最小时间间隔(微秒)，0 为不限
+ * 返回值: 总是返回 true，过滤在送入解码器之前完成
+ * 备注: 需在 open() 前调用。P/B 帧数据包读出后不送解码器，间隔内的关键帧
+ *       同样在解码前丢弃，长 GOP 素材的解码量降为原来的 1/GOP 甚至更低
+ ***********************************************************/
+bool libavFrameSource::setKeyframeSampling(bool enabled, qint64 minGapUs)
+{
+    keyframesOnly = enabled;
+    minKeyframeGapUs = qMax<qint64>(0, minGapUs);
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: setSamplingInterval
+ * 函数功能: 设置等间隔采样计划
+ * 参数说明:
+ *   interval - 采样间隔(帧)，小于等于 1 表示每帧都需要
+ *   phase    - 被导出帧的帧号对间隔取余的值
+ * 返回值: 总是返回 true，计划外的帧不会被输出
+ * 备注: 需在 open() 前调用。计划外的非参考帧(可丢弃的 B 帧等)不解码；
+ *       计划外的参考帧为维持参考链仍需解码，但解码后直接丢弃，不做映射和转换
+ ***********************************************************/
+bool libavFrameSource::setSamplingInterval(int interval, int phase)
+{
+    samplingInterval = interval;
+    samplingPhase = interval > 1 ? ((phase % interval) + interval) % interval : 0;
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: setTimeRanges
+ * 函数功能: 设置导出时间段
+ * 参数说明:
+ *   list - 按入点排序、互不重叠的时间段，为空表示整个视频
+ * 返回值: 总是返回 true，段外的帧不会被输出
+ * 备注: 需在 open() 前调用。打开后跳转到第一段入点之前的关键帧；
+ *       每越过一段的出点，若下一段入点足够远则再次跳转，
+ *       越过最后一段后不再读包
+ ***********************************************************/
+bool libavFrameSource::setTimeRanges(const QVector<timeRange> &list)
+{
+    ranges = list;
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: selectRange
+ * 函数功能: 切换到指定时间段
+ * 参数说明:
+ *   index - 时间段序号，等于段数表示已越过最后一段
+ * 返回值: 无
+ * 备注: 把入点/出点换算到视频流时间基
+ ***********************************************************/
+void libavFrameSource::selectRange(int index)
+{
+    rangeIndex = index;
+    rangeSeeked = false;
+    if (index < ranges.size())
+    {
+        rangeBeginPts = startPts + av_rescale_q(ranges[index].beginUs, AVRational{1, 1000000}, timeBase);
+        rangeEndPts = startPts + av_rescale_q(ranges[index].endUs, AVRational{1, 1000000}, timeBase);
+    }
+}
+
+/***********************************************************
+ * 函数名称: seekToRange
+ * 函数功能: 跳转到当前时间段入点之前的关键帧
+ * 参数说明: 无
+ * 返回值: 跳转成功返回 true
+ * 备注: 跳转后清空解码器中缓存的帧；失败时保持原位置顺序解码，
+ *       段外的帧仍会被丢弃，只是不能省去解码
+ ***********************************************************/
+bool libavFrameSource::seekToRange()
+{
+    rangeSeeked = true;
+    const int ret = av_seek_frame(formatContext, streamIndex, rangeBeginPts, AVSEEK_FLAG_BACKWARD);
+    if (ret < 0)
+    {
+        qDebug() << "Seek failed:" << avErrorString(ret);
+        return false;
+    }
+    avcodec_flush_buffers(codecContext);
+    draining = false;
+    nextKeyframePts = AV_NOPTS_VALUE;
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: open
+ * 函数功能: 打开视频文件并初始化解码器
+ * 参数说明:
+ *   path - 视频文件路径
+ * 返回值: 成功返回 true
+ * 备注: 选择容器中的最佳视频流
+ ***********************************************************/
+bool libavFrameSource::open(const QString &path)
+{
+    close();
+    error.clear();
+
+    int ret = avformat_open_input(&formatContext, path.toUtf8().constData(), nullptr, nullptr);
+    if (ret < 0)
+    {
+        error = avErrorString(ret);
+        return false;
+    }
+    ret = avformat_find_stream_info(formatContext, nullptr);
+    if (ret < 0)
+    {
+        error = avErrorString(ret);
+        close();
+        return false;
+    }
+
+    const AVCodec *decoder = nullptr;
+    streamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_VIDEO, -1, -1, &decoder, 0);
+    if (streamIndex < 0 || decoder == nullptr)
+    {
+        error = "no decodable video stream";
+        close();
+        return false;
+    }
+
+    AVStream *stream = formatContext->streams[streamIndex];
+    codecContext = avcodec_alloc_context3(decoder);
+    avcodec_parameters_to_context(codecContext, stream->codecpar);
+    codecContext->thread_count = threadCount;
+    switch (threadType)
+    {
+    case frameSourceOptions::THREAD_FRAME:
+        codecContext->thread_type = FF_THREAD_FRAME;
+        break;
+    case frameSourceOptions::THREAD_SLICE:
+        codecContext->thread_type = FF_THREAD_SLICE;
+        break;
+    default:
+        codecContext->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+        break;
+    }
+
+    if (keyframesOnly)
+    {
+        // 解码器层面同样跳过非关键帧，防御个别容器关键帧标记不准确
+        codecContext->skip_frame = AVDISCARD_NONKEY;
+    }
+
+    ret = avcodec_open2(codecContext, decoder, nullptr);
+    if (ret < 0)
+    {
+        error = avErrorString(ret);
+        close();
+        return false;
+    }
+
+    packet = av_packet_alloc();
+    decodedFrame = av_frame_alloc();
+    timeBase = stream->time_base;
+    startPts = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+
+    const AVRational rate = av_guess_frame_rate(formatContext, stream, nullptr);
+    fps = rate.num > 0 && rate.den > 0 ? av_q2d(rate) : 25.0;
+    if (stream->duration != AV_NOPTS_VALUE)
+    {
+        duration = av_rescale_q(stream->duration, timeBase, AVRational{1, 1000});
+    }
+    else if (formatContext->duration != AV_NOPTS_VALUE)
+    {
+        duration = formatContext->duration / 1000;
+    }
+    totalFrames = stream->nb_frames > 0 ? stream->nb_frames
+                                        : (duration > 0 ? static_cast<qint64>(duration / 1000.0 * fps) : -1);
+    nextIndex = 0;
+    nextKeyframePts = AV_NOPTS_VALUE;
+    draining = false;
+    if (!ranges.isEmpty())
+    {
+        selectRange(0);
+        if (ranges[0].beginUs > RANGE_SEEK_THRESHOLD_US)
+        {
+            seekToRange();
+        }
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: close
+ * 函数功能: 释放解码器和容器
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 可重复调用
+ ***********************************************************/
+void libavFrameSource::close()
+{
+    sws_freeContext(swsContext);
+    swsContext = nullptr;
+    av_frame_free(&convertedFrame);
+    av_frame_free(&decodedFrame);
+    av_packet_free(&packet);
+    avcodec_free_context(&codecContext);
+    avformat_close_input(&formatContext);
+    streamIndex = -1;
+}
+
+/***********************************************************
+ * 函数名称: width
+ * 函数功能: 帧宽度
+ * 参数说明: 无
+ * 返回值: 解码器输出宽度，未打开返回 0
+ * 备注: 无
+ ***********************************************************/
+int libavFrameSource::width() const
+{
+    return codecContext != nullptr ? codecContext->width : 0;
+}
+
+/***********************************************************
+ * 函数名称: height
+ * 函数功能: 帧高度
+ * 参数说明: 无
+ * 返回值: 解码器输出高度，未打开返回 0
+ * 备注: 无
+ ***********************************************************/
+int libavFrameSource::height() const
+{
+    return codecContext != nullptr ? codecContext->height : 0;
+}
+
+/***********************************************************
+ * 函数名称: readFrame
+ * 函数功能: 读取下一帧
+ * 参数说明:
+ *   frame - 返回帧视图
+ * 返回值: 成功返回 true，结束或出错返回 false
+ * 备注: 设置了采样计划时，计划外的帧解码后直接跳过，不输出也不映射；
+ *       帧号在跳帧(关键帧采样/采样计划/时间段)时按时间戳换算，保持与原视频一致；
+ *       设置了时间段时，段外的帧解码后直接跳过，入点较远时先跳转
+ ***********************************************************/
+bool libavFrameSource::readFrame(frameView &frame)
+{
+    if (codecContext == nullptr || (!ranges.isEmpty() && rangeIndex >= ranges.size()))
+    {
+        return false;
+    }
+
+    while (true)
+    {
+        av_frame_unref(decodedFrame);
+        if (!decodeNextFrame())
+        {
+            return false;
+        }
+
+        const qint64 pts = decodedFrame->best_effort_timestamp;
+        if (!ranges.isEmpty() && pts != AV_NOPTS_VALUE)
+        {
+            while (rangeIndex < ranges.size() && pts >= rangeEndPts)
+            {
+                selectRange(rangeIndex + 1);
+            }
+            if (rangeIndex >= ranges.size())
+            {
+                // 已越过最后一个时间段
+                return false;
+            }
+            if (pts < rangeBeginPts)
+            {
+                if (!rangeSeeked &&
+                    av_rescale_q(rangeBeginPts - pts, timeBase, AVRational{1, 1000000}) > RANGE_SEEK_THRESHOLD_US)
+                {
+                    seekToRange();
+                }
+                // 段间区域或入点之前的预滚帧
+                continue;
+            }
+        }
+
+        const bool skipping = keyframesOnly || samplingInterval > 1 || !ranges.isEmpty();
+        const qint64 index = skipping && pts != AV_NOPTS_VALUE ? indexFromPts(pts) : nextIndex;
+        nextIndex++;
+        if (samplingInterval > 1 && index % samplingInterval != samplingPhase)
+        {
+            // 为维持参考链解码的计划外帧
+            continue;
+        }
+
+        if (!mapFrame(frame))
+        {
+            return false;
+        }
+        frame.index = index;
+        frame.ptsUs = pts != AV_NOPTS_VALUE ? av_rescale_q(pts - startPts, timeBase, AVRational{1, 1000000})
+                                            : static_cast<qint64>(index * 1000000 / fps);
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(58, 7, 100)
+        frame.keyframe = (decodedFrame->flags & AV_FRAME_FLAG_KEY) != 0;
+#else
+        frame.keyframe = decodedFrame->key_frame != 0;
+#endif
+        return true;
+    }
+}
+
+/***********************************************************
+ * 函数名称: decodeNextFrame
+ * 函数功能: 解码下一帧到 decodedFrame
+ * 参数说明: 无
+ * 返回值: 成功返回 true，结束或出错返回 false
+ * 备注: 读包计入解复用阶段，送包和取帧计入解码阶段；
+ *       文件结束后送入空包排空解码器中缓存的帧。
+ *       有采样计划或时间段时逐包调整 skip_frame：计划外或入点之前的包允许
+ *       解码器丢弃非参考帧，容器已标记为可丢弃的这类包则根本不送入解码器
+ ***********************************************************/
+bool libavFrameSource::decodeNextFrame()
+{
+    while (true)
+    {
+        int ret = 0;
+        {
+            pipelineStats::scopedStage timer(stats, pipelineStats::STAGE_DECODE, nextIndex + 1);
+            ret = avcodec_receive_frame(codecContext, decodedFrame);
+        }
+        if (ret == 0)
+        {
+            return true;
+        }
+        if (ret == AVERROR_EOF || (ret == AVERROR(EAGAIN) && draining))
+        {
+            return false;
+        }
+        if (ret != AVERROR(EAGAIN))
+        {
+            error = avErrorString(ret);
+            return false;
+        }
+
+        bool gotPacket = false;
+        {
+            pipelineStats::scopedStage timer(stats, pipelineStats::STAGE_DEMUX, nextIndex + 1);
+            gotPacket = readVideoPacket();
+        }
+        if (gotPacket && (samplingInterval > 1 || !ranges.isEmpty()) && !keyframesOnly)
+        {
+            const bool wanted = packetWanted();
+            if (!wanted && (packet->flags & AV_PKT_FLAG_DISPOSABLE) != 0)
+            {
+                av_packet_unref(packet);
+                continue;
+            }
+            // 帧级并行时每次送包都会把该设置复制到工作线程，逐包切换有效
+            codecContext->skip_frame = wanted ? AVDISCARD_DEFAULT : AVDISCARD_NONREF;
+        }
+        {
+            pipelineStats::scopedStage timer(stats, pipelineStats::STAGE_DECODE, nextIndex + 1);
+            ret = avcodec_send_packet(codecContext, gotPacket ? packet : nullptr);
+        }
+        av_packet_unref(packet);
+        draining = !gotPacket;
+        if (ret < 0 && ret != AVERROR(EAGAIN) && ret != AVERROR_EOF && ret != AVERROR_INVALIDDATA)
+        {
+            error = avErrorString(ret);
+            return false;
+        }
+    }
+}
+
+/***********************************************************
+ * 函数名称: packetWanted
+ * 函数功能: 判断当前数据包对应的帧是否会被导出
+ * 参数说明: 无
+ * 返回值: 会被导出或无法判断时返回 true
+ * 备注: 按显示时间戳换算帧号，适用于恒定帧率的素材；
+ *       当前时间段入点之前的包不需要；没有时间戳的包保守地视为需要
+ ***********************************************************/
+bool libavFrameSource::packetWanted() const
+{
+    if (packet->pts == AV_NOPTS_VALUE)
+    {
+        return true;
+    }
+    if (!ranges.isEmpty() && rangeIndex < ranges.size() && packet->pts < rangeBeginPts)
+    {
+        return false;
+    }
+    return samplingInterval <= 1 || indexFromPts(packet->pts) % samplingInterval == samplingPhase;
+}
+
+/***********************************************************
+ * 函数名称: indexFromPts
+ * 函数功能: 将流时间戳换算为帧号
+ * 参数说明:
+ *   pts - 视频流时间基下的时间戳
+ * 返回值: 从 0 开始的帧号
+ * 备注: 按平均帧率四舍五入，起始时间戳之前的帧记为 0
+ ***********************************************************/
+qint64 libavFrameSource::indexFromPts(qint64 pts) const
+{
+    const qint64 ptsUs = av_rescale_q(pts - startPts, timeBase, AVRational{1, 1000000});
+    return qMax<qint64>(0, qRound64(ptsUs * fps / 1000000.0));
+}
+
+/***********************************************************
+ * 函数名称: readVideoPacket
+ * 函数功能: 读取下一个视频流数据包
+ * 参数说明: 无
+ * 返回值: 读到视频包返回 true，文件结束或出错返回 false
+ * 备注: 其他流的数据包直接丢弃；关键帧采样时非关键帧数据包
+ *       和最小间隔内的关键帧数据包也在此丢弃，不进入解码器
+ ***********************************************************/
+bool libavFrameSource::readVideoPacket()
+{
+    while (av_read_frame(formatContext, packet) >= 0)
+    {
+        if (packet->stream_index == streamIndex)
+        {
+            if (!keyframesOnly)
+            {
+                return true;
+            }
+            if ((packet->flags & AV_PKT_FLAG_KEY) != 0)
+            {
+                const qint64 pts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+                if (pts == AV_NOPTS_VALUE || nextKeyframePts == AV_NOPTS_VALUE || pts >= nextKeyframePts)
+                {
+                    if (pts != AV_NOPTS_VALUE && minKeyframeGapUs > 0)
+                    {
+                        nextKeyframePts = pts + av_rescale_q(minKeyframeGapUs, AVRational{1, 1000000}, timeBase);
+                    }
+                    return true;
+                }
+            }
+        }
+        av_packet_unref(packet);
+    }
+    return false;
+}
+
+/***********************************************************
+ * 函数名称: mapFrame
+ * 函数功能: 将 AVFrame 映射为帧视图
+ * 参数说明:
+ *   frame - 返回帧视图
+ * 返回值: 成功返回 true
+ * 备注: 常见的平面 YUV/NV12/灰度/BGRA 以及 P010/YUV420P10 直接引用解码器缓冲区，
+ *       其余高位深格式经 swscale 转为 YUV420P10，其余格式转为 yuv420p；
+ *       传递特性为 PQ/HLG 的帧标记为 HDR，转换为 8bit 时做色调映射
+ ***********************************************************/
+bool libavFrameSource::mapFrame(frameView &frame)
+{
+    frame = frameView();
+    frame.width = decodedFrame->width;
+    frame.height = decodedFrame->height;
+    frame.toneMap = toneMap;
+    if (decodedFrame->color_trc == AVCOL_TRC_SMPTE2084)
+    {
+        frame.transfer = frameView::TRANSFER_PQ;
+    }
+    else if (decodedFrame->color_trc == AVCOL_TRC_ARIB_STD_B67)
+    {
+        frame.transfer = frameView::TRANSFER_HLG;
+    }
+
+    switch (decodedFrame->format)
+    {
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUVJ420P:
+        frame.format = frameView::FORMAT_YUV420P;
+        break;
+    case AV_PIX_FMT_YUV422P:
+    case AV_PIX_FMT_YUVJ422P:
+        frame.format = frameView::FORMAT_YUV422P;
+        break;
+    case AV_PIX_FMT_YUV444P:
+    case AV_PIX_FMT_YUVJ444P:
+        frame.format = frameView::FORMAT_YUV444P;
+        break;
+    case AV_PIX_FMT_NV12:
+        frame.format = frameView::FORMAT_NV12;
+        break;
+    case AV_PIX_FMT_GRAY8:
+        frame.format = frameView::FORMAT_GRAY8;
+        break;
+    case AV_PIX_FMT_BGRA:
+    case AV_PIX_FMT_BGR0:
+        frame.format = frameView::FORMAT_RGB32;
+        break;
+    case AV_PIX_FMT_YUV420P10LE:
+        frame.format = frameView::FORMAT_YUV420P10;
+        break;
+    case AV_PIX_FMT_P010LE:
+        frame.format = frameView::FORMAT_P010;
+        break;
+    default:
+        break;
+    }
+
+    const AVFrame *source = decodedFrame;
+    if (frame.format == frameView::FORMAT_UNKNOWN)
+    {
+        const AVPixFmtDescriptor *descriptor = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(decodedFrame->format));
+        const bool wide = descriptor != nullptr && descriptor->comp[0].depth > 8;
+        const AVPixelFormat target = wide ? AV_PIX_FMT_YUV420P10LE : AV_PIX_FMT_YUV420P;
+        if (convertedFrame == nullptr || convertedFrame->width != decodedFrame->width ||
+            convertedFrame->height != decodedFrame->height || convertedFrame->format != target)
+        {
+            av_frame_free(&convertedFrame);
+            convertedFrame = av_frame_alloc();
+            convertedFrame->format = target;
+            convertedFrame->width = decodedFrame->width;
+            convertedFrame->height = decodedFrame->height;
+            if (av_frame_get_buffer(convertedFrame, 0) < 0)
+            {
+                error = "cannot allocate conversion frame";
+                return false;
+            }
+        }
+        swsContext = sws_getCachedContext(swsContext, decodedFrame->width, decodedFrame->height,
+                                          static_cast<AVPixelFormat>(decodedFrame->format),
+                                          convertedFrame->width, convertedFrame->height, target,
+                                          SWS_BILINEAR, nullptr, nullptr, nullptr);
+        if (swsContext == nullptr)
+        {
+            error = "unsupported pixel format";
+            return false;
+        }
+        sws_scale(swsContext, decodedFrame->data, decodedFrame->linesize, 0, decodedFrame->height,
+                  convertedFrame->data, convertedFrame->linesize);
+        source = convertedFrame;
+        frame.format = wide ? frameView::FORMAT_YUV420P10 : frameView::FORMAT_YUV420P;
+    }
+
+    for (int plane = 0; plane < frameView::planeCount(frame.format); ++plane)
+    {
+        frame.planes[plane] = source->data[plane];
+        frame.strides[plane] = source->linesize[plane];
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: avErrorString
+ * 函数功能: 获取 libav 错误描述
+ * 参数说明:
+ *   code - libav 返回的错误码
+ * 返回值: 错误描述
+ * 备注: 无
+ ***********************************************************/
+QString libavFrameSource::avErrorString(int code)
+{
+    char buffer[AV_ERROR_MAX_STRING_SIZE] = {0};
+    av_strerror(code, buffer, sizeof(buffer));
+    return QString::fromLocal8Bit(buffer);
+}
@@ -0,0 +1,136 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: libavframesource.h
+ *
+ * 模块描述:
+ *   该模块定义了直接调用 libavformat/libavcodec 的帧源，不经过播放器，
+ *   不受实时播放速度限制，解码线程数和并行方式(帧级/片级)可配置。
+ *   仅在 qmake CONFIG+=ffmpeg 时编译。
+ *
+ * 主要功能:
+ *   1. 解复用视频流并逐包送入解码器
+ *   2. 配置解码线程数和帧级/片级并行
+ *   3. 将 AVFrame 映射为帧视图，非常见格式经 swscale 转为 yuv420p，
+ *      10bit 格式保持 10bit 并标记 HDR 传递特性
+ *
+ * 函数列表:
+ *   1. libavFrameSource          - 构造函数
+ *   2. ~libavFrameSource         - 析构函数，释放解码器
+ *   3. setThreading              - 设置解码线程数和并行方式
+ *   4. open                      - 打开视频文件并初始化解码器
+ *   5. close                     - 释放解码器和容器
+ *   6. readFrame                 - 读取下一帧
+ *   7. readVideoPacket           - 读取下一个视频流数据包
+ *   8. mapFrame                  - 将 AVFrame 映射为帧视图
+ *   9. avErrorString             - 获取 libav 错误描述
+ *   10. setKeyframeSampling      - 设置只解码关键帧
+ *   11. setSamplingInterval      - 设置等间隔采样计划
+ *   12. decodeNextFrame          - 解码下一帧到 decodedFrame
+ *   13. packetWanted             - 判断数据包对应的帧是否会被导出
+ *   14. indexFromPts             - 将流时间戳换算为帧号
+ *   15. setTimeRanges            - 设置导出时间段
+ *   16. selectRange              - 切换到指定时间段
+ *   17. seekToRange              - 跳转到当前时间段入点之前的关键帧
+ *   18. setToneMap               - 设置 HDR 帧的色调映射方式
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 增加关键帧采样，解复用后只把关键帧数据包送入解码器
+ *     * 增加等间隔采样计划，计划外的非参考帧不解码，计划外的参考帧不映射不转换
+ *     * 增加导出时间段，跳转到各段入点之前的关键帧，段间区域不解码
+ *     * P010/YUV420P10 直接映射，其余 10bit 格式转为 YUV420P10，按 color_trc 标记 PQ/HLG
+ ***********************************************************/
+
+#ifndef LIBAVFRAMESOURCE_H
+#define LIBAVFRAMESOURCE_H
+
+#include "framesource.h"
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libswscale/swscale.h>
+}
+
+class libavFrameSource : public frameSource
+{
+public:
+    libavFrameSource();
+    ~libavFrameSource();
+
+    void setThreading(int threads, frameSourceOptions::ThreadType type); // 设置解码线程数和并行方式
+    void setToneMap(frameView::ToneMap mode);                           // 设置 HDR 帧的色调映射方式
+
+    bool open(const QString &path) override;   // 打开视频文件并初始化解码器
+    void close() override;                     // 释放解码器和容器
+    bool readFrame(frameView &frame) override; // 读取下一帧
+
+    int width() const override;                               // 帧宽度
+    int height() const override;                              // 帧高度
+    double frameRate() const override { return fps; }         // 帧率
+    qint64 frameCount() const override { return totalFrames; } // 总帧数，未知时为 -1
+    qint64 durationMs() const override { return duration; }   // 视频时长
+    QString errorString() const override { return error; }    // 错误描述
+    QString backendName() const override { return "libav"; }  // 后端名称
+    bool setKeyframeSampling(bool enabled, qint64 minGapUs) override; // 设置只解码关键帧
+    bool setSamplingInterval(int interval, int phase) override;      // 设置等间隔采样计划
+    bool setTimeRanges(const QVector<timeRange> &list) override;     // 设置导出时间段
+
+    static QString avErrorString(int code); // 获取 libav 错误描述
+
+protected:
+    bool readVideoPacket();            // 读取下一个视频流数据包
+    bool decodeNextFrame();            // 解码下一帧到 decodedFrame
+    bool packetWanted() const;         // 判断当前数据包对应的帧是否会被导出
+    qint64 indexFromPts(qint64 pts) const; // 将流时间戳换算为帧号
+    bool mapFrame(frameView &frame);   // 将 AVFrame 映射为帧视图
+    void selectRange(int index);       // 切换到指定时间段
+    bool seekToRange();                // 跳转到当前时间段入点之前的关键帧
+
+    AVFormatContext *formatContext; // 容器上下文
+    AVCodecContext *codecContext;   // 解码器上下文
+    AVPacket *packet;               // 复用的数据包
+    AVFrame *decodedFrame;          // 复用的解码帧
+    AVFrame *convertedFrame;        // swscale 转换后的帧
+    SwsContext *swsContext;         // swscale 上下文
+    int streamIndex;                // 视频流序号
+    AVRational timeBase;            // 视频流时间基
+    qint64 startPts;                // 视频流起始时间戳
+    double fps;                     // 帧率
+    qint64 totalFrames;             // 总帧数，未知时为 -1
+    qint64 duration;                // 视频时长(毫秒)
+    qint64 nextIndex;               // 下一帧序号
+    bool draining;                  // 是否已送入结束标记
+    int threadCount;                // 解码线程数，0 为自动
+    frameSourceOptions::ThreadType threadType; // 解码并行方式
+    QString error;                  // 错误描述
+    bool keyframesOnly;             // 是否只解码关键帧
+    qint64 minKeyframeGapUs;        // 相邻输出关键帧的最小间隔(微秒)
+    qint64 nextKeyframePts;         // 下一个可接受关键帧的最早时间戳(流时间基)
+    int samplingInterval;           // 等间隔采样的间隔，小于等于 1 表示不跳帧
+    int samplingPhase;              // 被导出帧的帧号对间隔取余的值
+    QVector<timeRange> ranges;      // 导出时间段，为空表示整个视频
+    int rangeIndex;                 // 当前时间段序号，等于段数表示已越过最后一段
+    qint64 rangeBeginPts;           // 当前时间段入点(流时间基)
+    qint64 rangeEndPts;             // 当前时间段出点(流时间基)
+    bool rangeSeeked;               // 是否已为当前时间段跳转过
+    frameView::ToneMap toneMap;     // HDR 帧的色调映射方式
+};
+
+#endif // LIBAVFRAMESOURCE_H
@@ -0,0 +1,214 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: lumapyramid.cpp
+ *
+ * 模块描述:
+ *   该模块实现了帧分析共用的缩小亮度金字塔。
+ *
+ * 主要功能:
+ *   1. 一次遍历原始帧生成四层亮度金字塔
+ *   2. 同一遍中统计全分辨率梯度均值和亮度直方图
+ *
+ * 函数列表:
+ *   1. lumaPyramid               - 构造函数，分配各层缓冲区
+ *   2. build                     - 一次遍历原始帧生成金字塔
+ *   3. level                     - 获取一层的亮度数据
+ *   4. readLuma                  - 读取一个像素的 8 位亮度
+ *   5. sampleBase                - 采样第 0 层并统计梯度和直方图
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#include "lumapyramid.h"
+#include <algorithm>
+
+namespace
+{
+    // 原始帧的亮度存放方式，每种方式实例化一份采样循环，循环内不再判断格式
+    enum LumaLayout
+    {
+        LAYOUT_PLANAR8,  // YUV/NV12/灰度的 8 位亮度平面
+        LAYOUT_PLANAR16, // P010/YUV420P10 的 16 位亮度平面
+        LAYOUT_RGB32     // RGB32，按 BT.601 权重计算亮度
+    };
+
+    const int HISTOGRAM_SHIFT = 3; // 8 位亮度右移该位数得到直方图分桶
+}
+
+/***********************************************************
+ * 函数名称: readLuma
+ * 函数功能: 读取一个像素的 8 位亮度
+ * 参数说明:
+ *   line  - 像素所在行
+ *   x     - 列号
+ *   shift - 16 位样本右移位数，仅 LAYOUT_PLANAR16 使用
+ * 返回值: 0~255 的亮度
+ * 备注: 与感知哈希的取值方式一致，10bit 帧取高 8 位有效位
+ ***********************************************************/
+template <int layout>
+static inline int readLuma(const uchar *line, int x, int shift)
+{
+    if (layout == LAYOUT_RGB32)
+    {
+        const uchar *pixel = line + x * 4;
+        return (pixel[0] * 29 + pixel[1] * 150 + pixel[2] * 77) >> 8;
+    }
+    if (layout == LAYOUT_PLANAR16)
+    {
+        return (reinterpret_cast<const quint16 *>(line)[x] >> shift) & 0xff;
+    }
+    return line[x];
+}
+
+/***********************************************************
+ * 函数名称: sampleBase
+ * 函数功能: 采样第 0 层并统计梯度和直方图
+ * 参数说明:
+ *   frame       - 帧视图
+ *   columns     - 各采样列的列号
+ *   nextColumns - 各采样列右侧相邻像素的列号，最右列取自身
+ *   base        - 返回第 0 层亮度
+ *   bins        - 累加亮度直方图
+ * 返回值: 全部采样点的梯度 |dx|+|dy| 之和
+ * 备注: 每个采样点读取自身、右侧和下方三个像素，右侧像素通常在同一缓存行
+ ***********************************************************/
+template <int layout>
+static qint64 sampleBase(const frameView &frame, const int *columns, const int *nextColumns,
+                         quint8 *base, quint32 *bins)
+{
+    const int size = lumaPyramid::BASE_SIZE;
+    const int shift = frame.format == frameView::FORMAT_P010 ? 8 : 2;
+    qint64 gradientSum = 0;
+    for (int i = 0; i < size; ++i)
+    {
+        const int y = static_cast<int>((2 * i + 1) * static_cast<qint64>(frame.height) / (2 * size));
+        const int nextY = qMin(y + 1, frame.height - 1);
+        const uchar *line = frame.planes[0] + static_cast<qint64>(y) * frame.strides[0];
+        const uchar *below = frame.planes[0] + static_cast<qint64>(nextY) * frame.strides[0];
+        quint8 *out = base + i * size;
+        for (int j = 0; j < size; ++j)
+        {
+            const int luma = readLuma<layout>(line, columns[j], shift);
+            const int right = readLuma<layout>(line, nextColumns[j], shift);
+            const int down = readLuma<layout>(below, columns[j], shift);
+            gradientSum += qAbs(right - luma) + qAbs(down - luma);
+            bins[luma >> HISTOGRAM_SHIFT]++;
+            out[j] = static_cast<quint8>(luma);
+        }
+    }
+    return gradientSum;
+}
+
+/***********************************************************
+ * 函数名称: lumaPyramid
+ * 函数功能: 亮度金字塔的构造函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 各层缓冲区一次分配，之后每帧复用
+ ***********************************************************/
+lumaPyramid::lumaPyramid() : gradient(0),
+                             index(-1),
+                             valid(false)
+{
+    int total = 0;
+    for (int i = 0; i < LEVEL_COUNT; ++i)
+    {
+        offsets[i] = total;
+        total += levelSize(i) * levelSize(i);
+    }
+    data.resize(total);
+    std::fill(bins, bins + HISTOGRAM_BINS, 0u);
+}
+
+/***********************************************************
+ * 函数名称: build
+ * 函数功能: 一次遍历原始帧生成金字塔
+ * 参数说明:
+ *   frame - 帧视图
+ * 返回值: 支持的格式返回 true，失败时金字塔标记为无效
+ * 备注: 采样点数与分辨率无关，8K 帧与 480p 帧耗时相同；
+ *       梯度在原始分辨率上计算，同一批视频分辨率相同时清晰度阈值才可比
+ ***********************************************************/
+bool lumaPyramid::build(const frameView &frame)
+{
+    valid = false;
+    if (!frame.isValid())
+    {
+        return false;
+    }
+
+    int columns[BASE_SIZE];
+    int nextColumns[BASE_SIZE];
+    for (int i = 0; i < BASE_SIZE; ++i)
+    {
+        columns[i] = static_cast<int>((2 * i + 1) * static_cast<qint64>(frame.width) / (2 * BASE_SIZE));
+        nextColumns[i] = qMin(columns[i] + 1, frame.width - 1);
+    }
+
+    std::fill(bins, bins + HISTOGRAM_BINS, 0u);
+    quint8 *base = data.data() + offsets[0];
+    qint64 gradientSum;
+    if (frame.format == frameView::FORMAT_RGB32)
+    {
+        gradientSum = sampleBase<LAYOUT_RGB32>(frame, columns, nextColumns, base, bins);
+    }
+    else if (frameView::isHighBitDepth(frame.format))
+    {
+        gradientSum = sampleBase<LAYOUT_PLANAR16>(frame, columns, nextColumns, base, bins);
+    }
+    else
+    {
+        gradientSum = sampleBase<LAYOUT_PLANAR8>(frame, columns, nextColumns, base, bins);
+    }
+    gradient = static_cast<double>(gradientSum) / (BASE_SIZE * BASE_SIZE);
+
+    // 逐层 2x2 平均，只读上一层，不再访问原始帧
+    for (int n = 1; n < LEVEL_COUNT; ++n)
+    {
+        const int size = levelSize(n);
+        const quint8 *source = data.constData() + offsets[n - 1];
+        quint8 *target = data.data() + offsets[n];
+        for (int y = 0; y < size; ++y)
+        {
+            const quint8 *top = source + (2 * y) * (2 * size);
+            const quint8 *bottom = top + 2 * size;
+            for (int x = 0; x < size; ++x)
+            {
+                target[y * size + x] = static_cast<quint8>(
+                    (top[2 * x] + top[2 * x + 1] + bottom[2 * x] + bottom[2 * x + 1] + 2) >> 2);
+            }
+        }
+    }
+
+    index = frame.index;
+    valid = true;
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: level
+ * 函数功能: 获取一层的亮度数据
+ * 参数说明:
+ *   n - 层号，0 为 256x256
+ * 返回值: 按行存放的亮度，边长为 levelSize(n)
+ * 备注: 无
+ ***********************************************************/
+const quint8 *lumaPyramid::level(int n) const
+{
+    return data.constData() + offsets[qBound(0, n, LEVEL_COUNT - 1)];
+}
@@ -0,0 +1,71 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: lumapyramid.h
+ *
+ * 模块描述:
+ *   该模块定义了帧分析共用的缩小亮度金字塔。每个候选帧只遍历一次原始
+ *   帧: 在 256x256 的采样网格上读取亮度(采样位置与感知哈希一致)，顺带
+ *   读取右侧和下方相邻像素得到全分辨率梯度，并统计亮度直方图；之后逐层
+ *   2x2 平均得到 128/64/32 三层。近重复检查和过滤链的各个过滤器都只读
+ *   金字塔，增加过滤器不再增加对原始帧的遍历。
+ *
+ * 主要功能:
+ *   1. 一次遍历原始帧生成四层亮度金字塔
+ *   2. 同一遍中统计全分辨率梯度均值和亮度直方图
+ *
+ * 函数列表:
+ *   1. lumaPyramid               - 构造函数，分配各层缓冲区
+ *   2. build                     - 一次遍历原始帧生成金字塔
+ *   3. level                     - 获取一层的亮度数据
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#ifndef LUMAPYRAMID_H
+#define LUMAPYRAMID_H
+
+#include <QVector>
+#include "frameview.h"
+
+class lumaPyramid
+{
+public:
+    static const int BASE_SIZE = 256;     // 第 0 层边长，与感知哈希的采样点数一致
+    static const int LEVEL_COUNT = 4;     // 层数，边长依次为 256/128/64/32
+    static const int HISTOGRAM_BINS = 32; // 亮度直方图的分桶数
+
+    lumaPyramid();
+
+    bool build(const frameView &frame);   // 一次遍历原始帧生成金字塔
+    bool isValid() const { return valid; }
+    const quint8 *level(int n) const;     // 获取一层的亮度数据，按行存放
+    static int levelSize(int n) { return BASE_SIZE >> n; }         // 一层的边长
+    double gradientMean() const { return gradient; }               // 采样点处全分辨率亮度梯度 |dx|+|dy| 的均值
+    const quint32 *histogram() const { return bins; }              // 第 0 层的亮度直方图
+    qint64 frameIndex() const { return index; }                    // 金字塔对应的帧号
+
+private:
+    QVector<quint8> data;          // 各层按顺序连续存放
+    int offsets[LEVEL_COUNT];      // 各层在 data 中的起始位置
+    quint32 bins[HISTOGRAM_BINS];  // 亮度直方图
+    double gradient;               // 全分辨率梯度均值
+    qint64 index;                  // 帧号
+    bool valid;                    // 是否已由有效帧生成
+};
+
+#endif // LUMAPYRAMID_H
@@ -1,11 +1,410 @@
 #include "mainwindow.h"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QTextStream>
+#include "watchdaemon.h"
+#include "dedupindex.h"
+#include "yoloannotator.h"
+#include "renditionset.h"
+#include "timerange.h"
+#include "quotasampler.h"
+#include "startuptrace.h"
+#include "framemanifest.h"
+
+/***********************************************************
+ * 函数名称: buildDedupIndex
+ * 函数功能: 为已有数据集建立近重复索引
+ * 参数说明:
+ *   indexFile   - 索引文件路径，已存在时在其基础上追加
+ *   directories - 数据集目录
+ * 返回值: 进程退出码
+ * 备注: 扫描完成后整理索引，之后导出时打开索引只做内存映射
+ ***********************************************************/
+static int buildDedupIndex(const QString &indexFile, const QStringList &directories)
+{
+    QTextStream err(stderr);
+    if (indexFile.isEmpty())
+    {
+        err << "--build-dedup-index needs --dedup-index\n";
+        return 1;
+    }
+    dedupIndex index;
+    QString error;
+    if (!index.open(indexFile, &error))
+    {
+        err << "Open dedup index failed: " << error << "\n";
+        return 1;
+    }
+    for (const QString &directory : directories)
+    {
+        const int added = index.addDirectory(directory);
+        err << directory << ": " << added << " images added\n";
+    }
+    if (!index.compact(&error))
+    {
+        err << "Compact dedup index failed: " << error << "\n";
+        return 1;
+    }
+    err << indexFile << ": " << index.size() << " hashes\n";
+    return 0;
+}
+
+/***********************************************************
+ * 函数名称: balancePlan
+ * 函数功能: 按整批配额平衡计划文件
+ * 参数说明:
+ *   parser - 已解析的命令行参数
+ * 返回值: 进程退出码
+ * 备注: 输入通常是以较密间隔规划整批视频得到的候选计划，
+ *       输出写到 --plan-out，再用 --execute-plan 执行
+ ***********************************************************/
+static int balancePlan(const QCommandLineParser &parser)
+{
+    QTextStream err(stderr);
+    if (!parser.isSet("plan-out"))
+    {
+        err << "--balance-plan needs --plan-out\n";
+        return 1;
+    }
+
+    quotaSampler::options settings;
+    settings.target = parser.value("target").toLongLong();
+    settings.allocation = parser.value("quota-alloc") == "proportional" ? quotaSampler::ALLOCATE_PROPORTIONAL
+                                                                         : quotaSampler::ALLOCATE_EQUAL;
+    settings.grouping = parser.value("quota-by") == "camera" ? quotaSampler::GROUP_CAMERA
+                                                             : quotaSampler::GROUP_VIDEO;
+    settings.cameraLevel = parser.value("camera-level").toInt();
+    settings.maxPerGroup = parser.value("quota-max").toLongLong();
+    for (const QString &spec : parser.values("quota"))
+    {
+        // 分组名本身可能含 '='，取最后一个 '=' 之后的部分作为配额
+        const int separator = spec.lastIndexOf('=');
+        bool ok = false;
+        const qint64 quota = separator > 0 ? spec.mid(separator + 1).toLongLong(&ok) : 0;
+        if (!ok || quota <= 0)
+        {
+            err << "Invalid quota: " << spec << "\n";
+            return 1;
+        }
+        settings.quotas.insert(spec.left(separator), quota);
+    }
+
+    QStringList report;
+    QString error;
+    if (!quotaSampler::balancePlan(parser.value("balance-plan"), parser.value("plan-out"), settings, &report, &error))
+    {
+        err << "Balance plan failed: " << error << "\n";
+        return 1;
+    }
+    for (const QString &line : report)
+    {
+        err << line << "\n";
+    }
+    return 0;
+}
+
+/***********************************************************
+ * 函数名称: dumpManifest
+ * 函数功能: 将逐帧元数据清单转换为 CSV 输出
+ * 参数说明:
+ *   fileName - 二进制清单路径
+ * 返回值: 进程退出码
+ * 备注: CSV 写到标准输出，行数写到标准错误；未开启 CSV 清单的导出
+ *       可事后用此命令转换，清单内的文件路径相对于清单所在目录
+ ***********************************************************/
+static int dumpManifest(const QString &fileName)
+{
+    QTextStream err(stderr);
+    frameManifest manifest;
+    QString error;
+    if (!manifest.open(fileName, &error))
+    {
+        err << "Open frame manifest failed: " << error << "\n";
+        return 1;
+    }
+    QFile out;
+    out.open(stdout, QIODevice::WriteOnly);
+    out.write(frameManifest::csvHeader());
+    for (int i = 0; i < manifest.chunkCount(); ++i)
+    {
+        QByteArray text;
+        for (int j = 0; j < manifest.chunkAt(i).rows; ++j)
+        {
+            text.append(frameManifest::csvLine(manifest.row(i, j)));
+        }
+        out.write(text);
+    }
+    out.close();
+    err << fileName << ": " << manifest.rowCount() << " rows in " << manifest.chunkCount() << " chunks\n";
+    if (manifest.trailingBytes() > 0)
+    {
+        err << "Warning: " << error << " (interrupted write or a writer still appending)\n";
+    }
+    return 0;
+}
+
+/***********************************************************
+ * 函数名称: runHeadless
+ * 函数功能: 无界面导出
+ * 参数说明:
+ *   app - 应用程序对象
+ * 返回值: 进程退出码，导出失败时为 1
+ * 备注: 输入为 "-" 时从标准输入读取 Y4M 或无头 YUV，例如
+ *       ffmpeg -i in.mp4 -f yuv4mpegpipe - | videoScreenshot --headless --input - ...
+ ***********************************************************/
+static int runHeadless(QCoreApplication &app)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Export frames without opening the main window");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"headless", "Run without the main window."},
+        {"input", "Video file, .y4m/.yuv file, or - for stdin.", "file"},
+        {"output", "Export directory.", "dir", "."},
+        {"name", "Export name (sub directory).", "name", "export"},
+        {"mode", "Export mode (0 = equal interval, 1 = random, 2 = diversity, 3 = keyframes only).", "mode", "0"},
+        {"random-count", "Frames picked in random mode.", "count", "10"},
+        {"seed", "Random mode seed; the same seed and input give the same picks.", "seed", "0"},
+        {"diversity-count", "Frames picked in diversity mode.", "count", "10"},
+        {"time-budget", "Stop reading a video after this many seconds (0 = no limit).", "seconds", "0"},
+        {"plan-out", "Only plan: append the selected frames to this plan file.", "file"},
+        {"execute-plan", "Claim and export shards of this plan file (no --input needed).", "file"},
+        {"balance-plan", "Pick frames from this candidate plan across the whole batch and write them to --plan-out.", "file"},
+        {"target", "Total frames the balanced plan should keep (0 = every group up to its cap).", "count", "0"},
+        {"quota-by", "Balance across each video or each camera directory: video or camera.", "group", "video"},
+        {"quota-alloc", "Split the target equally between groups or in proportion to their candidates: equal or proportional.",
+         "mode", "equal"},
+        {"quota-max", "Most frames any one group may keep (0 = no cap).", "count", "0"},
+        {"quota", "Cap for one group, as <video or camera directory>=<count> (repeatable).", "spec"},
+        {"camera-level", "Camera directory is this many levels above each video (1 = its own directory).", "levels", "1"},
+        {"claim-dir", "Shared directory for shard claims (default <plan>.claims).", "dir"},
+        {"stale-claim", "Take over claims not refreshed for this many seconds (0 = never).", "seconds", "0"},
+        {"watch", "Watch this directory tree and export new videos (repeatable).", "dir"},
+        {"workers", "Concurrent exports in watch mode.", "count", "2"},
+        {"stable-ms", "A file is complete once its size is unchanged for this long.", "ms", "2000"},
+        {"rescan", "Full rescan period in watch mode, for network mounts (0 = off).", "seconds", "60"},
+        {"watch-ext", "Comma separated video suffixes to pick up in watch mode.", "list",
+         "mp4,mkv,avi,mov,ts,m4v,y4m"},
+        {"journal", "Watch mode journal; files recorded as done are never reprocessed.", "file",
+         QDir::homePath() + "/.videoScreenshot/watch_journal.log"},
+        {"dedup-index", "Skip frames near-duplicate to any image in this index; exported frames are added.", "file"},
+        {"dedup-distance", "Maximum Hamming distance of a near-duplicate (0-11).", "bits", "6"},
+        {"min-sharpness", "Skip blurred frames whose mean full-resolution luma gradient is below this (0 = off).", "value", "0"},
+        {"min-scene-change", "Only keep frames whose luma histogram differs from the previous candidate by this percentage (0 = off).", "percent", "0"},
+        {"min-motion", "Skip frames whose mean luma difference from the last exported frame is below this (0 = off).", "value", "0"},
+        {"no-manifest", "Do not append exported frames to the frames.vsm metadata manifest."},
+        {"manifest-csv", "Also append exported frames to frames.csv."},
+        {"dump-manifest", "Print this frames.vsm metadata manifest as CSV.", "file"},
+        {"build-dedup-index", "Add the images under this dataset directory to --dedup-index and compact it (repeatable).", "dir"},
+        {"yolo-model", "Write YOLO label files next to exported images using this ONNX model.", "file"},
+        {"yolo-batch", "Images per inference batch.", "count", "8"},
+        {"yolo-conf", "Minimum detection confidence.", "score", "0.25"},
+        {"yolo-threads", "ONNX Runtime threads per inference batch.", "count", "2"},
+        {"tile-size", "Export overlapping square tiles of this size instead of whole frames (0 = off).", "pixels", "0"},
+        {"tile-overlap", "Overlap between neighbouring tiles.", "pixels", "128"},
+        {"tile-min-stddev", "Skip tiles whose luma standard deviation is below this (0 = keep all).", "value", "0"},
+        {"rendition", "Extra output of each frame as name:max-side:format[:quality], e.g. thumb:160:jpg:70; "
+                      "0 keeps the full size (repeatable, replaces the default single image).", "spec"},
+        {"range", "Only export frames inside IN-OUT, e.g. 00:01:30-00:02:10.5 or 90-130.5; "
+                  "regions outside the ranges are skipped by seeking (repeatable).", "in-out"},
+        {"ranges-file", "Read export ranges from this job file, one IN-OUT per line.", "file"},
+        {"interval", "Interval frames.", "frames", "30"},
+        {"keyframe-gap", "Minimum time between exported keyframes (0 = all keyframes).", "ms", "0"},
+        {"format", "Image format.", "format", "jpg"},
+        {"quality", "Image quality (-1 = default).", "quality", "-1"},
+        {"raw-size", "Frame size of headerless YUV input.", "WxH"},
+        {"raw-format", "Pixel format of headerless YUV input.", "format", "yuv420p"},
+        {"raw-fps", "Frame rate of headerless YUV input.", "fps", "25"},
+        {"trace", "Write export_trace.json."},
+        {"backend", "Decoder backend: " + frameSource::backendNames().join('/') + ".", "name"},
+        {"decoder-threads", "Decoder threads (0 = auto).", "count", "0"},
+        {"thread-type", "Decoder threading: auto, frame or slice.", "type", "auto"},
+        {"tone-map", "Tone mapping of HDR (PQ/HLG) input to 8-bit output: clip, reinhard or hable.", "mode", "hable"},
+    });
+    parser.process(app);
+
+    if (parser.isSet("build-dedup-index"))
+    {
+        return buildDedupIndex(parser.value("dedup-index"), parser.values("build-dedup-index"));
+    }
+    if (parser.isSet("balance-plan"))
+    {
+        return balancePlan(parser);
+    }
+    if (parser.isSet("dump-manifest"))
+    {
+        return dumpManifest(parser.value("dump-manifest"));
+    }
+
+    yoloAnnotator::options annotation;
+    annotation.modelPath = parser.value("yolo-model");
+    annotation.batchSize = qMax(1, parser.value("yolo-batch").toInt());
+    annotation.confidence = parser.value("yolo-conf").toFloat();
+    annotation.intraThreads = qMax(1, parser.value("yolo-threads").toInt());
+
+    QVector<renditionSet::rendition> renditions;
+    for (const QString &spec : parser.values("rendition"))
+    {
+        renditionSet::rendition item;
+        QString error;
+        if (!renditionSet::parse(spec, item, &error))
+        {
+            QTextStream(stderr) << error << "\n";
+            return 1;
+        }
+        renditions.append(item);
+    }
+
+    QVector<timeRange> ranges;
+    for (const QString &text : parser.values("range"))
+    {
+        timeRange range;
+        QString error;
+        if (!parseTimeRange(text, range, &error))
+        {
+            QTextStream(stderr) << error << "\n";
+            return 1;
+        }
+        ranges.append(range);
+    }
+    if (parser.isSet("ranges-file"))
+    {
+        QString error;
+        if (!loadTimeRanges(parser.value("ranges-file"), ranges, &error))
+        {
+            QTextStream(stderr) << "Read ranges file failed: " << error << "\n";
+            return 1;
+        }
+    }
+
+    bool toneMapOk = false;
+    const frameView::ToneMap toneMap = frameView::toneMapFromName(parser.value("tone-map"), &toneMapOk);
+    if (!toneMapOk)
+    {
+        QTextStream(stderr) << "Unknown tone mapping: " << parser.value("tone-map") << "\n";
+        return 1;
+    }
+
+    if (parser.isSet("watch"))
+    {
+        // 守护模式: 导出参数取自保存的导出设置，--output 可覆盖导出路径
+        watchDaemon::options config;
+        config.directories = parser.values("watch");
+        config.extensions = parser.value("watch-ext").split(',');
+        config.exportPath = parser.isSet("output") ? parser.value("output") : QString();
+        config.journalFile = parser.value("journal");
+        config.workers = parser.value("workers").toInt();
+        config.stableMs = parser.value("stable-ms").toInt();
+        config.rescanSeconds = parser.value("rescan").toInt();
+        config.dedupIndex = parser.value("dedup-index");
+        config.dedupDistance = parser.value("dedup-distance").toInt();
+        config.annotation = annotation;
+        config.tileSize = parser.value("tile-size").toInt();
+        config.tileOverlap = parser.value("tile-overlap").toInt();
+        config.tileMinStdDev = parser.value("tile-min-stddev").toDouble();
+        config.renditions = renditions;
+        watchDaemon daemon(config);
+        if (!daemon.start())
+        {
+            return 1;
+        }
+        return app.exec();
+    }
+
+    if (!parser.isSet("input") && !parser.isSet("execute-plan"))
+    {
+        QTextStream(stderr) << "--input, --execute-plan or --watch is required in headless mode\n";
+        return 1;
+    }
+
+    exportThread worker;
+    worker.setVideoFile(parser.value("input"));
+    worker.setExportPath(parser.value("output"));
+    worker.setExportName(parser.value("name"));
+    worker.setExportMode(parser.value("mode").toInt());
+    worker.setInterval(qMax(1, parser.value("interval").toInt()));
+    worker.setKeyframeGap(parser.value("keyframe-gap").toInt());
+    worker.setRandomCount(qMax(1, parser.value("random-count").toInt()));
+    worker.setRandomSeed(parser.value("seed").toULongLong());
+    worker.setDiversityCount(qMax(1, parser.value("diversity-count").toInt()));
+    worker.setTimeBudget(parser.value("time-budget").toInt());
+    worker.setImageFormat(parser.value("format"), parser.value("quality").toInt());
+    worker.setTraceEnabled(parser.isSet("trace"));
+    worker.setPlanOutput(parser.value("plan-out"));
+    worker.setDedupIndex(parser.value("dedup-index"), parser.value("dedup-distance").toInt());
+    filterChain::options filterSettings;
+    filterSettings.minSharpness = parser.value("min-sharpness").toDouble();
+    filterSettings.minSceneChange = parser.value("min-scene-change").toDouble();
+    filterSettings.minMotion = parser.value("min-motion").toDouble();
+    worker.setFrameFilters(filterSettings);
+    worker.setManifest(!parser.isSet("no-manifest"), parser.isSet("manifest-csv"));
+    worker.setAnnotation(annotation);
+    worker.setTiling(parser.value("tile-size").toInt(), parser.value("tile-overlap").toInt(),
+                     parser.value("tile-min-stddev").toDouble());
+    worker.setRenditions(renditions);
+    worker.setTimeRanges(ranges);
+    if (parser.isSet("execute-plan"))
+    {
+        worker.setPlanExecution(parser.value("execute-plan"), parser.value("claim-dir"),
+                                parser.value("stale-claim").toInt());
+    }
+
+    const QString threadType = parser.value("thread-type");
+    worker.setDecoder(parser.value("backend"), parser.value("decoder-threads").toInt(),
+                      threadType == "frame"   ? frameSourceOptions::THREAD_FRAME
+                      : threadType == "slice" ? frameSourceOptions::THREAD_SLICE
+                                              : frameSourceOptions::THREAD_AUTO);
+    worker.setToneMap(toneMap);
+
+    const QStringList rawSize = parser.value("raw-size").split('x');
+    if (rawSize.size() == 2)
+    {
+        worker.setRawVideoFormat(rawSize[0].toInt(), rawSize[1].toInt(),
+                                 parser.value("raw-format"), parser.value("raw-fps").toDouble());
+    }
+
+    QObject::connect(&worker, &QThread::finished, &app, &QCoreApplication::quit);
+    worker.start();
+    app.exec();
+    worker.wait();
+    return worker.state() == exportThread::STATE_FAILED ? 1 : 0;
+}
 
 int main(int argc, char *argv[])
 {
+    bool headless = false;
+    bool traceStartup = !qEnvironmentVariableIsEmpty("VIDEOSCREENSHOT_STARTUP_TRACE");
+    for (int i = 1; i < argc; ++i)
+    {
+        if (qstrcmp(argv[i], "--headless") == 0)
+        {
+            headless = true;
+        }
+        else if (qstrcmp(argv[i], "--startup-trace") == 0)
+        {
+            traceStartup = true;
+        }
+    }
+    // 启动计时从进入 main 开始，只统计带界面的启动
+    startupTrace::start(traceStartup && !headless);
+
+    if (headless)
+    {
+        // 无显示环境时使用 offscreen 平台
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+        QGuiApplication app(argc, argv);
+        return runHeadless(app);
+    }
+
     QApplication a(argc, argv);
+    startupTrace::mark("QApplication");
     MainWindow w;
     w.show();
+    startupTrace::mark("MainWindow::show");
 
     return a.exec();
 }
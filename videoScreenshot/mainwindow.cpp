@@ -37,10 +37,44 @@
  *   11. updateDurationInfo       - 更新播放时间信息
  *   12. takeScreenshot           - 截取视频截图
  *   13. processVideoFrame        - 处理视频帧
+ *   14. openStatsPanel           - 打开流水线统计面板
+ *   15. onExportFinished         - 导出线程结束处理
+ *   16. markRangeIn              - 以当前播放位置为导出时间段入点
+ *   17. markRangeOut             - 以当前播放位置为出点，完成一个导出时间段
+ *   18. clearRanges              - 清除全部导出时间段
+ *   19. grabFrameAt              - 用 libav 帧源解码指定位置的一帧
+ *   20. togglePauseExport        - 暂停或继续正在进行的导出
+ *   21. cancelExport             - 取消正在进行的导出
+ *   22. onExportStateChanged     - 导出状态变化处理
+ *   23. openGridView             - 打开多机位宫格视图
+ *   24. captureGrid              - 宫格视图同步截图
+ *   25. onGridCaptureFinished    - 宫格视图同步截图完成处理
+ *   26. pollExportPreview        - 取走并显示最新的导出预览
+ *   27. warmUp                   - 窗口显示后在事件循环空闲时创建多媒体后端和导出设置
+ *   28. ensureMediaPlayer        - 创建媒体播放器、视频显示控件和帧探针
+ *   29. settingsDialog           - 获取导出设置对话框，首次使用时创建
+ *   30. statsWindow              - 获取流水线统计面板，首次使用时创建
+ *   31. gridWindow               - 获取多机位宫格视图，首次使用时创建
  *
  * 版本历史:
  *   - 版本 1.0 (2025-02-05) - LiuJiaLe
  *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 导出视频接入导出线程，增加流水线统计面板
+ *     * 导出时应用解码后端和解码线程设置
+ *     * 导出时应用关键帧最小间隔设置
+ *     * 导出时应用随机种子设置
+ *     * 导出时应用多样性导出帧数和时间预算设置
+ *     * 支持在进度条上标记多个入点/出点，只导出标记的时间段
+ *     * 导出时应用 HDR 色调映射设置；播放器无法转换的帧(如 10bit HDR)
+ *       截图时改由 libav 帧源解码并色调映射
+ *     * 工具栏增加暂停/继续导出和取消导出，状态栏显示导出状态，导出失败时弹出提示
+ *     * 增加多机位宫格视图，按时间偏移同步播放多路视频并同步截图
+ *     * 导出时在预览栏中显示最近写出的帧的缩略图
+ *     * 导出时应用帧分析过滤设置
+ *     * 导出时应用逐帧元数据清单设置
+ *     * 媒体播放器、导出设置、统计面板和宫格视图改为延迟创建: 窗口先显示，
+ *       多媒体后端和导出设置在事件循环空闲时分步创建；可选输出各启动阶段耗时
  ***********************************************************/
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
@@ -54,7 +88,17 @@
 #include <QVideoFrame>
 #include <QVideoProbe>
 #include <QMessageBox>
+#include <QInputDialog>
 #include <QThread>
+#include <QFileInfo>
+#include "colorconvert.h"
+#include "startuptrace.h"
+
+// 导出预览栏的图标边长(像素)、保留张数和轮询间隔(毫秒)，
+// 轮询间隔与导出线程生成预览的节流间隔一致
+static const int EXPORT_PREVIEW_ICON_SIZE = 120;
+static const int EXPORT_PREVIEW_HISTORY = 8;
+static const int EXPORT_PREVIEW_POLL_MS = 250;
 
 /***********************************************************
  * 函数名称: MainWindow
@@ -62,30 +106,31 @@
  * 参数说明:
  *   parent - 父窗口指针,默认为nullptr
  * 返回值: 无
- * 备注: 初始化UI界面,创建并连接媒体播放器相关组件
+ * 备注: 只创建主窗口自身的控件；多媒体后端加载插件较慢，和导出设置一起
+ *       推迟到窗口显示后的事件循环中创建，在此之前用到时由获取函数当场创建
  ***********************************************************/
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent),
                                           ui(new Ui::MainWindow),
-                                          mediaPlayer(new QMediaPlayer(this)),
-                                          videoWidget(new QVideoWidget(this)),
-                                          videoProbe(new QVideoProbe(this))
+                                          exportSettingsDialog(nullptr),
+                                          statsPanelWidget(nullptr),
+                                          gridPanel(nullptr),
+                                          videoProbe(nullptr),
+                                          mediaPlayer(nullptr),
+                                          videoWidget(nullptr),
+                                          videoContainer(nullptr),
+                                          exportWorker(nullptr),
+                                          pauseExportAction(nullptr),
+                                          cancelExportAction(nullptr),
+                                          pendingInMs(-1)
 {
     ui->setupUi(this);
+    startupTrace::mark("MainWindow::setupUi");
 
     initUI(); // 初始化界面
+    startupTrace::mark("MainWindow::initUI");
 
-    mediaPlayer->setVideoOutput(videoWidget); // 设置视频输出
-
-    exportSettingsDialog = new exportSettings(nullptr);
-
-    connect(mediaPlayer, &QMediaPlayer::positionChanged, this, &MainWindow::updatePosition);
-    connect(mediaPlayer, &QMediaPlayer::durationChanged, this, &MainWindow::updateDuration);
-
-    // 连接 QVideoProbe 到 QMediaPlayer
-    if (videoProbe->setSource(mediaPlayer))
-    {
-        connect(videoProbe, &QVideoProbe::videoFrameProbed, this, &MainWindow::processVideoFrame);
-    }
+    // 零超时定时器在事件循环处理完窗口显示和首次绘制后才触发
+    QTimer::singleShot(0, this, &MainWindow::warmUp);
 }
 
 /***********************************************************
@@ -93,12 +138,19 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent),
  * 函数功能: 主窗口类的析构函数
  * 参数说明: 无
  * 返回值: 无
- * 备注: 释放资源,删除相关控件
+ * 备注: 释放资源,删除相关控件；正在进行的导出先取消并等待线程退出
  ***********************************************************/
 MainWindow::~MainWindow()
 {
+    if (exportWorker != nullptr)
+    {
+        exportWorker->cancel();
+        exportWorker->wait();
+    }
     delete ui;
     delete exportSettingsDialog;
+    delete statsPanelWidget;
+    delete gridPanel;
 
     // 先删除不依赖于布局的控件
     delete timeLabel;
@@ -109,8 +161,13 @@ MainWindow::~MainWindow()
     delete exportNameLabel;
     delete exportNameEdit;
     delete takePhotoButton;
+    delete markInButton;
+    delete markOutButton;
+    delete clearRangesButton;
+    delete exportPreviewList;
     // 后删除视频相关控件
     delete videoWidget;
+    delete videoContainer;
     delete mediaPlayer;
     delete videoProbe;
 }
@@ -141,15 +198,18 @@ void MainWindow::initUI()
     openButton = new QPushButton("Open Video", this);
     connect(openButton, &QPushButton::clicked, this, &MainWindow::openVideoFile);
 
-    // 创建视频显示控件
-    videoWidget->setMinimumSize(640, 360); // 设置最小尺寸
+    // 创建视频显示控件的占位容器，视频显示控件在多媒体后端创建时放入
+    videoContainer = new QWidget(this);
+    videoContainer->setMinimumSize(640, 360); // 设置最小尺寸
+    QVBoxLayout *videoLayout = new QVBoxLayout(videoContainer);
+    videoLayout->setContentsMargins(0, 0, 0, 0);
 
     // 创建播放/暂停按钮
     playPauseButton = new QPushButton("Play", this);
     connect(playPauseButton, &QPushButton::clicked, this, &MainWindow::togglePlayPause);
 
     // 创建进度条
-    progressBar = new QSlider(Qt::Horizontal, this);
+    progressBar = new rangeSlider(Qt::Horizontal, this);
     progressBar->setRange(0, 100);
     connect(progressBar, &QSlider::sliderMoved, this, &MainWindow::setPosition);
 
@@ -160,11 +220,35 @@ void MainWindow::initUI()
     takePhotoButton = new QPushButton("拍照", this);
     connect(takePhotoButton, &QPushButton::clicked, this, &MainWindow::takeScreenshot);
 
+    // 创建导出时间段按钮
+    markInButton = new QPushButton("入点", this);
+    markInButton->setToolTip("以当前位置为导出时间段的入点");
+    connect(markInButton, &QPushButton::clicked, this, &MainWindow::markRangeIn);
+    markOutButton = new QPushButton("出点", this);
+    markOutButton->setToolTip("以当前位置为导出时间段的出点");
+    connect(markOutButton, &QPushButton::clicked, this, &MainWindow::markRangeOut);
+    clearRangesButton = new QPushButton("清除区间", this);
+    connect(clearRangesButton, &QPushButton::clicked, this, &MainWindow::clearRanges);
+
+    // 创建导出预览栏，只在开启预览的导出开始后显示
+    exportPreviewList = new QListWidget(this);
+    exportPreviewList->setViewMode(QListView::IconMode);
+    exportPreviewList->setFlow(QListView::LeftToRight);
+    exportPreviewList->setWrapping(false);
+    exportPreviewList->setIconSize(QSize(EXPORT_PREVIEW_ICON_SIZE, EXPORT_PREVIEW_ICON_SIZE));
+    exportPreviewList->setFixedHeight(EXPORT_PREVIEW_ICON_SIZE + 24);
+    exportPreviewList->setHidden(true);
+    previewPollTimer.setInterval(EXPORT_PREVIEW_POLL_MS);
+    connect(&previewPollTimer, &QTimer::timeout, this, &MainWindow::pollExportPreview);
+
     // 创建底部布局
     QHBoxLayout *controlLayout = new QHBoxLayout;
     controlLayout->addWidget(playPauseButton);
     controlLayout->addWidget(progressBar);
     controlLayout->addWidget(timeLabel);
+    controlLayout->addWidget(markInButton);
+    controlLayout->addWidget(markOutButton);
+    controlLayout->addWidget(clearRangesButton);
 
     // 创建布局
     QVBoxLayout *mainLayout = new QVBoxLayout;
@@ -173,10 +257,11 @@ void MainWindow::initUI()
     exportNameLayout->addWidget(exportNameLabel);
     exportNameLayout->addWidget(exportNameEdit);
     mainLayout->addLayout(exportNameLayout);
-    mainLayout->addWidget(videoWidget);
+    mainLayout->addWidget(videoContainer);
     mainLayout->addWidget(openButton);
     mainLayout->addLayout(controlLayout);
     mainLayout->addWidget(takePhotoButton);
+    mainLayout->addWidget(exportPreviewList);
 
     // 创建一个中央控件并设置布局
     QWidget *centralWidget = new QWidget(this);
@@ -193,6 +278,25 @@ void MainWindow::initUI()
     QAction *exportVideoAction = new QAction("Export Video", this);
     connect(exportVideoAction, &QAction::triggered, this, &MainWindow::exportVideo);
     toolBar->addAction(exportVideoAction);
+
+    // 暂停和取消只在导出进行中可用
+    pauseExportAction = new QAction("Pause Export", this);
+    pauseExportAction->setEnabled(false);
+    connect(pauseExportAction, &QAction::triggered, this, &MainWindow::togglePauseExport);
+    toolBar->addAction(pauseExportAction);
+
+    cancelExportAction = new QAction("Cancel Export", this);
+    cancelExportAction->setEnabled(false);
+    connect(cancelExportAction, &QAction::triggered, this, &MainWindow::cancelExport);
+    toolBar->addAction(cancelExportAction);
+
+    QAction *statsPanelAction = new QAction("Pipeline Stats", this);
+    connect(statsPanelAction, &QAction::triggered, this, &MainWindow::openStatsPanel);
+    toolBar->addAction(statsPanelAction);
+
+    QAction *gridViewAction = new QAction("Grid View", this);
+    connect(gridViewAction, &QAction::triggered, this, &MainWindow::openGridView);
+    toolBar->addAction(gridViewAction);
 }
 
 /***********************************************************
@@ -208,11 +312,14 @@ void MainWindow::openVideoFile()
     QString fileName = QFileDialog::getOpenFileName(this, "Open Video", "", "Video Files (*.mp4 *.avi *.mkv)");
     if (!fileName.isEmpty())
     {
+        ensureMediaPlayer();
         mediaPlayer->setMedia(QUrl::fromLocalFile(fileName)); // 设置视频文件路径
 
         mediaPlayer->play(); // 播放视频
 
         videoNameLabel->setText(fileName); // 显示视频文件名
+        currentVideoFile = fileName;
+        clearRanges(); // 时间段只属于当前视频
     }
 }
 
@@ -227,7 +334,7 @@ void MainWindow::openExportSettings()
 {
     // 实现导出设置功能
     // 这里只是一个示例，实际功能可以根据需求实现
-    exportSettingsDialog->show();
+    settingsDialog()->show();
     qDebug("Export settings clicked!");
 }
 
@@ -240,9 +347,294 @@ void MainWindow::openExportSettings()
  ***********************************************************/
 void MainWindow::exportVideo()
 {
-    // 实现导出视频功能
-    // 这里只是一个示例，实际功能可以根据需求实现
-    qDebug("Export video clicked!");
+    if (currentVideoFile.isEmpty())
+    {
+        QMessageBox::warning(this, tr("警告"), tr("请先打开视频文件"));
+        return;
+    }
+
+    QString exportName = exportNameEdit->text();
+    if (exportName.isEmpty())
+    {
+        QMessageBox::warning(this, tr("警告"), tr("请输入导出项目名称"));
+        return;
+    }
+
+    if (exportWorker != nullptr && exportWorker->isRunning())
+    {
+        statusBar()->showMessage(tr("导出正在进行中"), 3000);
+        return;
+    }
+
+    // 每次导出使用新的线程对象，避免沿用上一次的状态
+    delete exportWorker;
+    exportWorker = new exportThread(this);
+    exportWorker->setVideoFile(currentVideoFile);
+    exportWorker->setExportPath(settingsDialog()->getExportPath());
+    exportWorker->setExportName(exportName);
+    exportWorker->setExportMode(settingsDialog()->getExportMode());
+    exportWorker->setInterval(settingsDialog()->getInterval());
+    exportWorker->setRandomCount(settingsDialog()->getRandomCount());
+    exportWorker->setRandomSeed(static_cast<quint64>(settingsDialog()->getRandomSeed()));
+    exportWorker->setDiversityCount(settingsDialog()->getDiversityCount());
+    exportWorker->setTimeBudget(settingsDialog()->getTimeBudget());
+    exportWorker->setKeyframeGap(settingsDialog()->getKeyframeGap());
+    exportWorker->setTraceEnabled(settingsDialog()->getTraceEnabled());
+    exportWorker->setDecoder(settingsDialog()->getDecoderBackend(),
+                             settingsDialog()->getDecoderThreads(),
+                             static_cast<frameSourceOptions::ThreadType>(settingsDialog()->getDecoderThreadType()));
+    exportWorker->setTimeRanges(exportRanges);
+    exportWorker->setToneMap(static_cast<frameView::ToneMap>(settingsDialog()->getToneMap()));
+    exportWorker->setPreviewEnabled(settingsDialog()->getPreviewEnabled());
+    exportWorker->setManifest(settingsDialog()->getManifestEnabled(), settingsDialog()->getManifestCsv());
+    exportWorker->setFrameFilters(settingsDialog()->getFrameFilters());
+
+    connect(exportWorker, &exportThread::statsUpdated, statsWindow(), &statsPanel::updateStats);
+    connect(exportWorker, &exportThread::stateChanged, this, &MainWindow::onExportStateChanged);
+    connect(exportWorker, &QThread::finished, this, &MainWindow::onExportFinished);
+
+    statsWindow()->show();
+    pauseExportAction->setText("Pause Export");
+    pauseExportAction->setEnabled(true);
+    cancelExportAction->setEnabled(true);
+    exportPreviewList->clear();
+    exportPreviewList->setVisible(settingsDialog()->getPreviewEnabled());
+    if (settingsDialog()->getPreviewEnabled())
+    {
+        previewPollTimer.start();
+    }
+    exportWorker->start();
+    statusBar()->showMessage(tr("正在导出: %1").arg(currentVideoFile));
+}
+
+/***********************************************************
+ * 函数名称: openStatsPanel
+ * 函数功能: 打开流水线统计面板
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 面板由导出线程的 statsUpdated 信号实时刷新
+ ***********************************************************/
+void MainWindow::openStatsPanel()
+{
+    statsWindow()->show();
+    statsWindow()->raise();
+}
+
+/***********************************************************
+ * 函数名称: onExportFinished
+ * 函数功能: 导出线程结束处理
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 运行报告由导出线程写入导出目录下的 export_report.json；
+ *       结束原因已由 onExportStateChanged 显示在状态栏；预览栏保留最后几张预览
+ ***********************************************************/
+void MainWindow::onExportFinished()
+{
+    pollExportPreview();
+    previewPollTimer.stop();
+    pauseExportAction->setEnabled(false);
+    cancelExportAction->setEnabled(false);
+}
+
+/***********************************************************
+ * 函数名称: openGridView
+ * 函数功能: 打开多机位宫格视图
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 选择多个视频后按文件名排序，再按该顺序输入各视频的时间偏移(秒)；
+ *       视频时间 = 主时钟 + 偏移，留空的按 0 处理
+ ***********************************************************/
+void MainWindow::openGridView()
+{
+    QStringList fileNames = QFileDialog::getOpenFileNames(this, "Open Videos", "", "Video Files (*.mp4 *.avi *.mkv *.mov)");
+    if (fileNames.isEmpty())
+    {
+        return;
+    }
+    fileNames.sort();
+
+    bool ok = false;
+    const QString text = QInputDialog::getText(this, tr("时间偏移"),
+                                               tr("按文件名顺序输入各视频的时间偏移(秒)，以逗号分隔，留空为 0:"),
+                                               QLineEdit::Normal, QString(), &ok);
+    if (!ok)
+    {
+        return;
+    }
+    QVector<qint64> offsets;
+    if (!text.trimmed().isEmpty())
+    {
+        for (const QString &field : text.split(','))
+        {
+            bool valid = true;
+            const double seconds = field.trimmed().isEmpty() ? 0.0 : field.trimmed().toDouble(&valid);
+            if (!valid)
+            {
+                QMessageBox::warning(this, tr("警告"), tr("无效的时间偏移: %1").arg(field));
+                return;
+            }
+            offsets.append(qRound64(seconds * 1000.0));
+        }
+    }
+
+    gridWindow()->setToneMap(static_cast<frameView::ToneMap>(settingsDialog()->getToneMap()));
+    QString error;
+    if (!gridWindow()->setStreams(fileNames, offsets, &error))
+    {
+        QMessageBox::warning(this, tr("警告"), error);
+        return;
+    }
+    gridWindow()->show();
+    gridWindow()->raise();
+}
+
+/***********************************************************
+ * 函数名称: captureGrid
+ * 函数功能: 宫格视图同步截图
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 保存到导出目录下的项目文件夹，文件名为时间戳加机位序号
+ ***********************************************************/
+void MainWindow::captureGrid()
+{
+    const QString exportName = exportNameEdit->text();
+    if (exportName.isEmpty())
+    {
+        QMessageBox::warning(gridWindow(), tr("警告"), tr("请输入导出项目名称"));
+        return;
+    }
+
+    const QString directory = QString("%1/%2").arg(settingsDialog()->getExportPath()).arg(exportName);
+    const QString baseName = QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss");
+    if (!gridWindow()->captureAll(directory, baseName))
+    {
+        statusBar()->showMessage(tr("上一次同步截图尚未完成"), 3000);
+    }
+}
+
+/***********************************************************
+ * 函数名称: onGridCaptureFinished
+ * 函数功能: 宫格视图同步截图完成处理
+ * 参数说明:
+ *   saved     - 保存成功的画面数
+ *   total     - 视频数
+ *   directory - 保存目录
+ * 返回值: 无
+ * 备注: 无
+ ***********************************************************/
+void MainWindow::onGridCaptureFinished(int saved, int total, const QString &directory)
+{
+    statusBar()->showMessage(tr("同步截图已保存 %1/%2 张到: %3").arg(saved).arg(total).arg(directory), 3000);
+}
+
+/***********************************************************
+ * 函数名称: pollExportPreview
+ * 函数功能: 取走并显示最新的导出预览
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 由定时器驱动，取预览只做一次原子交换，界面线程不等待导出线程；
+ *       预览栏最多保留 EXPORT_PREVIEW_HISTORY 张
+ ***********************************************************/
+void MainWindow::pollExportPreview()
+{
+    QImage image;
+    QString fileName;
+    if (exportWorker == nullptr || !exportWorker->takePreview(image, &fileName))
+    {
+        return;
+    }
+
+    QListWidgetItem *item = new QListWidgetItem(QIcon(QPixmap::fromImage(image)), QFileInfo(fileName).fileName());
+    item->setToolTip(fileName);
+    exportPreviewList->insertItem(0, item);
+    while (exportPreviewList->count() > EXPORT_PREVIEW_HISTORY)
+    {
+        delete exportPreviewList->takeItem(exportPreviewList->count() - 1);
+    }
+}
+
+/***********************************************************
+ * 函数名称: togglePauseExport
+ * 函数功能: 暂停或继续正在进行的导出
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 暂停在导出线程读取下一帧前生效，状态栏随 stateChanged 信号更新
+ ***********************************************************/
+void MainWindow::togglePauseExport()
+{
+    if (exportWorker == nullptr || !exportWorker->isRunning())
+    {
+        return;
+    }
+    if (exportWorker->state() == exportThread::STATE_PAUSED)
+    {
+        exportWorker->resume();
+        pauseExportAction->setText("Pause Export");
+    }
+    else
+    {
+        exportWorker->pause();
+        pauseExportAction->setText("Resume Export");
+    }
+}
+
+/***********************************************************
+ * 函数名称: cancelExport
+ * 函数功能: 取消正在进行的导出
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 不等待线程退出，线程结束后由 onExportFinished 恢复按钮状态
+ ***********************************************************/
+void MainWindow::cancelExport()
+{
+    if (exportWorker == nullptr || !exportWorker->isRunning())
+    {
+        return;
+    }
+    exportWorker->cancel();
+    pauseExportAction->setEnabled(false);
+    cancelExportAction->setEnabled(false);
+    statusBar()->showMessage(tr("正在取消导出..."));
+}
+
+/***********************************************************
+ * 函数名称: onExportStateChanged
+ * 函数功能: 导出状态变化处理
+ * 参数说明:
+ *   state  - 新的导出状态
+ *   detail - 说明，出错时为出错原因
+ * 返回值: 无
+ * 备注: 在界面线程执行
+ ***********************************************************/
+void MainWindow::onExportStateChanged(exportThread::State state, const QString &detail)
+{
+    switch (state)
+    {
+    case exportThread::STATE_OPENING:
+        statusBar()->showMessage(tr("正在打开: %1").arg(currentVideoFile));
+        break;
+    case exportThread::STATE_RUNNING:
+        statusBar()->showMessage(tr("正在导出: %1").arg(currentVideoFile));
+        break;
+    case exportThread::STATE_PAUSED:
+        statusBar()->showMessage(tr("导出已暂停"));
+        break;
+    case exportThread::STATE_FINISHING:
+        statusBar()->showMessage(tr("正在写出剩余帧..."));
+        break;
+    case exportThread::STATE_FINISHED:
+        statusBar()->showMessage(tr("导出完成"), 3000);
+        break;
+    case exportThread::STATE_CANCELLED:
+        statusBar()->showMessage(tr("导出已取消"), 3000);
+        break;
+    case exportThread::STATE_FAILED:
+        statusBar()->showMessage(tr("导出失败"), 3000);
+        QMessageBox::warning(this, tr("导出失败"), detail);
+        break;
+    default:
+        break;
+    }
 }
 
 /***********************************************************
@@ -254,6 +646,10 @@ void MainWindow::exportVideo()
  ***********************************************************/
 void MainWindow::togglePlayPause()
 {
+    if (mediaPlayer == nullptr)
+    {
+        return; // 尚未打开过视频
+    }
     if (mediaPlayer->state() == QMediaPlayer::PlayingState)
     {
         mediaPlayer->pause();
@@ -275,6 +671,10 @@ void MainWindow::togglePlayPause()
  ***********************************************************/
 void MainWindow::setPosition(int position)
 {
+    if (mediaPlayer == nullptr)
+    {
+        return; // 尚未打开过视频
+    }
     mediaPlayer->setPosition(position);
 }
 
@@ -339,7 +739,7 @@ void MainWindow::updateDurationInfo(qint64 currentInfo)
  ***********************************************************/
 void MainWindow::takeScreenshot()
 {
-    if (!mediaPlayer->isVideoAvailable())
+    if (mediaPlayer == nullptr || !mediaPlayer->isVideoAvailable())
     {
         return;
     }
@@ -348,7 +748,7 @@ void MainWindow::takeScreenshot()
     qDebug() << realFrame.size();
 
     // 获取导出路径和项目名称
-    QString exportPath = exportSettingsDialog->getExportPath();
+    QString exportPath = settingsDialog()->getExportPath();
     QString exportName = exportNameEdit->text();
 
     // 确保导出目录存在
@@ -373,6 +773,12 @@ void MainWindow::takeScreenshot()
                        .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
     }
 
+    // 播放器给出的帧格式无法转换为 QImage 时(如 P010)，按当前位置重新解码一帧
+    if (realFrame.isNull())
+    {
+        realFrame = grabFrameAt(mediaPlayer->position());
+    }
+
     // 判断图像是否为正常图像
     if (realFrame.size().isEmpty() || realFrame.isNull())
     {
@@ -407,13 +813,22 @@ void MainWindow::takeScreenshot()
  ***********************************************************/
 void MainWindow::processVideoFrame(const QVideoFrame &frame)
 {
+    // 10bit 等格式没有对应的 QImage 格式，不能按原始内存构造图像
+    const QImage::Format imageFormat = QVideoFrame::imageFormatFromPixelFormat(frame.pixelFormat());
+    if (imageFormat == QImage::Format_Invalid)
+    {
+        realFrame = QImage();
+        return;
+    }
+
     QVideoFrame cloneFrame(frame);
     cloneFrame.map(QAbstractVideoBuffer::ReadOnly);
 
     QImage image(cloneFrame.bits(),
                  cloneFrame.width(),
                  cloneFrame.height(),
-                 QVideoFrame::imageFormatFromPixelFormat(cloneFrame.pixelFormat()));
+                 cloneFrame.bytesPerLine(),
+                 imageFormat);
 
     cloneFrame.unmap();
 
@@ -424,3 +839,219 @@ void MainWindow::processVideoFrame(const QVideoFrame &frame)
     // QString fileName = "screenshot.png";
     // image.save(fileName);
 }
+
+/***********************************************************
+ * 函数名称: markRangeIn
+ * 函数功能: 以当前播放位置为导出时间段入点
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 入点在进度条上显示为竖线，再次设置入点会替换未配对的入点
+ ***********************************************************/
+void MainWindow::markRangeIn()
+{
+    if (mediaPlayer == nullptr)
+    {
+        return; // 尚未打开过视频
+    }
+    pendingInMs = mediaPlayer->position();
+    progressBar->setPendingIn(pendingInMs);
+    statusBar()->showMessage(tr("入点: %1 ms").arg(pendingInMs), 3000);
+}
+
+/***********************************************************
+ * 函数名称: markRangeOut
+ * 函数功能: 以当前播放位置为出点，完成一个导出时间段
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 出点须晚于入点；与已有时间段重叠时合并
+ ***********************************************************/
+void MainWindow::markRangeOut()
+{
+    if (mediaPlayer == nullptr)
+    {
+        return; // 尚未打开过视频
+    }
+    const qint64 outMs = mediaPlayer->position();
+    if (pendingInMs < 0 || outMs <= pendingInMs)
+    {
+        statusBar()->showMessage(tr("请先在出点之前设置入点"), 3000);
+        return;
+    }
+
+    timeRange range;
+    range.beginUs = pendingInMs * 1000;
+    range.endUs = outMs * 1000;
+    exportRanges.append(range);
+    exportRanges = normalizeTimeRanges(exportRanges);
+    pendingInMs = -1;
+    progressBar->setPendingIn(-1);
+    progressBar->setRanges(exportRanges);
+
+    QStringList texts;
+    for (const timeRange &item : exportRanges)
+    {
+        texts.append(formatTimeRange(item));
+    }
+    progressBar->setToolTip(texts.join('\n'));
+    statusBar()->showMessage(tr("导出时间段: %1").arg(texts.join(", ")), 5000);
+}
+
+/***********************************************************
+ * 函数名称: clearRanges
+ * 函数功能: 清除全部导出时间段
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 清除后导出整个视频
+ ***********************************************************/
+void MainWindow::clearRanges()
+{
+    exportRanges.clear();
+    pendingInMs = -1;
+    progressBar->setPendingIn(-1);
+    progressBar->setRanges(exportRanges);
+    progressBar->setToolTip(QString());
+}
+
+/***********************************************************
+ * 函数名称: grabFrameAt
+ * 函数功能: 用 libav 帧源解码指定位置的一帧
+ * 参数说明:
+ *   positionMs - 播放位置(毫秒)
+ * 返回值: 转换为 8bit 的图像，未编译 libav 后端或解码失败时返回空图像
+ * 备注: 借助导出时间段跳转到位置之前的关键帧，只解码到该位置；
+ *       HDR 帧按导出设置中的色调映射方式转换
+ ***********************************************************/
+QImage MainWindow::grabFrameAt(qint64 positionMs)
+{
+    if (currentVideoFile.isEmpty() || !frameSource::backendNames().contains("libav"))
+    {
+        return QImage();
+    }
+
+    frameSourceOptions options;
+    options.backend = "libav";
+    options.toneMap = static_cast<frameView::ToneMap>(settingsDialog()->getToneMap());
+    frameSource *source = frameSource::create(currentVideoFile, options);
+    QVector<timeRange> ranges(1);
+    ranges[0].beginUs = positionMs * 1000;
+    ranges[0].endUs = ranges[0].beginUs + 1000000;
+    source->setTimeRanges(ranges);
+
+    // 帧视图指向帧源内部缓冲区，须在释放帧源前完成转换
+    QImage image;
+    frameView frame;
+    if (source->open(currentVideoFile) && source->readFrame(frame))
+    {
+        image = convertFrameToImage(frame);
+    }
+    else
+    {
+        qDebug() << "Grab frame failed:" << source->errorString();
+    }
+    delete source;
+    return image;
+}
+
+/***********************************************************
+ * 函数名称: warmUp
+ * 函数功能: 窗口显示后在事件循环空闲时创建多媒体后端和导出设置
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 多媒体后端和导出设置分在两个事件循环周期中创建，
+ *       中间可以处理窗口重绘和用户输入；QMediaPlayer 和控件只能在
+ *       界面线程创建，因此不放到后台线程
+ ***********************************************************/
+void MainWindow::warmUp()
+{
+    startupTrace::mark("event loop (window shown)");
+
+    ensureMediaPlayer();
+    startupTrace::mark("multimedia backend");
+
+    QTimer::singleShot(0, this, [this]() {
+        settingsDialog();
+        startupTrace::mark("export settings");
+        startupTrace::finish();
+    });
+}
+
+/***********************************************************
+ * 函数名称: ensureMediaPlayer
+ * 函数功能: 创建媒体播放器、视频显示控件和帧探针
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 已创建时直接返回；在空闲创建之前打开视频时由 openVideoFile 当场创建
+ ***********************************************************/
+void MainWindow::ensureMediaPlayer()
+{
+    if (mediaPlayer != nullptr)
+    {
+        return;
+    }
+
+    mediaPlayer = new QMediaPlayer(this);
+    videoWidget = new QVideoWidget(videoContainer);
+    videoProbe = new QVideoProbe(this);
+    videoContainer->layout()->addWidget(videoWidget);
+
+    mediaPlayer->setVideoOutput(videoWidget); // 设置视频输出
+
+    connect(mediaPlayer, &QMediaPlayer::positionChanged, this, &MainWindow::updatePosition);
+    connect(mediaPlayer, &QMediaPlayer::durationChanged, this, &MainWindow::updateDuration);
+
+    // 连接 QVideoProbe 到 QMediaPlayer
+    if (videoProbe->setSource(mediaPlayer))
+    {
+        connect(videoProbe, &QVideoProbe::videoFrameProbed, this, &MainWindow::processVideoFrame);
+    }
+}
+
+/***********************************************************
+ * 函数名称: settingsDialog
+ * 函数功能: 获取导出设置对话框，首次使用时创建
+ * 参数说明: 无
+ * 返回值: 导出设置对话框
+ * 备注: 构造时从 QSettings 读取上次的设置，通常已由 warmUp 提前创建
+ ***********************************************************/
+exportSettings *MainWindow::settingsDialog()
+{
+    if (exportSettingsDialog == nullptr)
+    {
+        exportSettingsDialog = new exportSettings(nullptr);
+    }
+    return exportSettingsDialog;
+}
+
+/***********************************************************
+ * 函数名称: statsWindow
+ * 函数功能: 获取流水线统计面板，首次使用时创建
+ * 参数说明: 无
+ * 返回值: 流水线统计面板
+ * 备注: 无
+ ***********************************************************/
+statsPanel *MainWindow::statsWindow()
+{
+    if (statsPanelWidget == nullptr)
+    {
+        statsPanelWidget = new statsPanel(nullptr);
+    }
+    return statsPanelWidget;
+}
+
+/***********************************************************
+ * 函数名称: gridWindow
+ * 函数功能: 获取多机位宫格视图，首次使用时创建
+ * 参数说明: 无
+ * 返回值: 多机位宫格视图
+ * 备注: 宫格视图每路各有一个媒体播放器，只在用户打开时创建
+ ***********************************************************/
+gridView *MainWindow::gridWindow()
+{
+    if (gridPanel == nullptr)
+    {
+        gridPanel = new gridView(nullptr);
+        connect(gridPanel, &gridView::captureRequested, this, &MainWindow::captureGrid);
+        connect(gridPanel, &gridView::captureFinished, this, &MainWindow::onGridCaptureFinished);
+    }
+    return gridPanel;
+}
@@ -37,10 +37,37 @@
  *   11. updateDurationInfo       - 更新播放时间信息
  *   12. takeScreenshot           - 截取视频截图
  *   13. processVideoFrame        - 处理视频帧
+ *   14. openStatsPanel           - 打开流水线统计面板
+ *   15. onExportFinished         - 导出线程结束处理
+ *   16. markRangeIn              - 以当前播放位置为导出时间段入点
+ *   17. markRangeOut             - 以当前播放位置为出点，完成一个导出时间段
+ *   18. clearRanges              - 清除全部导出时间段
+ *   19. grabFrameAt              - 用 libav 帧源解码指定位置的一帧
+ *   20. togglePauseExport        - 暂停或继续正在进行的导出
+ *   21. cancelExport             - 取消正在进行的导出
+ *   22. onExportStateChanged     - 导出状态变化处理
+ *   23. openGridView             - 打开多机位宫格视图
+ *   24. captureGrid              - 宫格视图同步截图
+ *   25. onGridCaptureFinished    - 宫格视图同步截图完成处理
+ *   26. pollExportPreview        - 取走并显示最新的导出预览
+ *   27. warmUp                   - 窗口显示后在事件循环空闲时创建多媒体后端和导出设置
+ *   28. ensureMediaPlayer        - 创建媒体播放器、视频显示控件和帧探针
+ *   29. settingsDialog           - 获取导出设置对话框，首次使用时创建
+ *   30. statsWindow              - 获取流水线统计面板，首次使用时创建
+ *   31. gridWindow               - 获取多机位宫格视图，首次使用时创建
  *
  * 版本历史:
  *   - 版本 1.0 (2025-02-05) - LiuJiaLe
  *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 导出视频接入导出线程，增加流水线统计面板
+ *     * 支持在进度条上标记多个入点/出点，只导出标记的时间段
+ *     * 播放器无法转换的帧(如 10bit HDR)截图时改由 libav 帧源解码并色调映射
+ *     * 工具栏增加暂停/继续导出和取消导出，状态栏显示导出状态，导出失败时弹出提示
+ *     * 增加多机位宫格视图，按时间偏移同步播放多路视频并同步截图
+ *     * 导出时在预览栏中显示最近写出的帧的缩略图
+ *     * 媒体播放器、导出设置、统计面板和宫格视图改为延迟创建，窗口先显示；
+ *       可选输出各启动阶段耗时
  ***********************************************************/
 
 #ifndef MAINWINDOW_H
@@ -57,8 +84,15 @@
 #include <QSlider>
 #include <QTime>
 #include <QVideoProbe>
+#include <QListWidget>
+#include <QTimer>
 
 #include "exportsettings.h"
+#include "exportthread.h"
+#include "statspanel.h"
+#include "gridview.h"
+#include "rangeslider.h"
+#include "timerange.h"
 
 namespace Ui
 {
@@ -84,26 +118,58 @@ private slots:
     void updateDurationInfo(qint64 currentInfo);      // 更新播放时间信息
     void takeScreenshot();                            // 截取视频截图
     void processVideoFrame(const QVideoFrame &frame); // 处理视频帧
+    void openStatsPanel();                            // 打开流水线统计面板
+    void onExportFinished();                          // 导出线程结束处理
+    void markRangeIn();                               // 以当前播放位置为导出时间段入点
+    void markRangeOut();                              // 以当前播放位置为出点，完成一个导出时间段
+    void clearRanges();                               // 清除全部导出时间段
+    void togglePauseExport();                         // 暂停或继续正在进行的导出
+    void cancelExport();                              // 取消正在进行的导出
+    void onExportStateChanged(exportThread::State state, const QString &detail); // 导出状态变化处理
+    void openGridView();                              // 打开多机位宫格视图
+    void captureGrid();                               // 宫格视图同步截图
+    void onGridCaptureFinished(int saved, int total, const QString &directory); // 宫格视图同步截图完成处理
+    void pollExportPreview();                         // 取走并显示最新的导出预览
+    void warmUp();                                    // 窗口显示后在事件循环空闲时创建多媒体后端和导出设置
 
 private:
     Ui::MainWindow *ui;
     exportSettings *exportSettingsDialog; // 导出设置对话框
+    statsPanel *statsPanelWidget;         // 流水线统计面板
+    gridView *gridPanel;                  // 多机位宫格视图
 
-    void initUI(); // 初始化用户界面
+    void initUI();                          // 初始化用户界面
+    QImage grabFrameAt(qint64 positionMs); // 用 libav 帧源解码指定位置的一帧
+    void ensureMediaPlayer();               // 创建媒体播放器、视频显示控件和帧探针，已创建时直接返回
+    exportSettings *settingsDialog();       // 获取导出设置对话框，首次使用时创建
+    statsPanel *statsWindow();              // 获取流水线统计面板，首次使用时创建
+    gridView *gridWindow();                 // 获取多机位宫格视图，首次使用时创建
 
-    QVideoProbe *videoProbe;
-    QMediaPlayer *mediaPlayer;    // 媒体播放器
-    QVideoWidget *videoWidget;    // 视频显示控件
+    QVideoProbe *videoProbe;      // 视频帧探针，与媒体播放器一起延迟创建
+    QMediaPlayer *mediaPlayer;    // 媒体播放器，创建前为空
+    QVideoWidget *videoWidget;    // 视频显示控件，创建前为空
+    QWidget *videoContainer;      // 视频显示控件的占位容器，先于多媒体后端显示
     QLabel *videoNameLabel;       // 显示视频名称的标签
     QPushButton *openButton;      // 打开视频文件按钮
     QPushButton *playPauseButton; // 播放/暂停按钮
-    QSlider *progressBar;         // 进度条
+    rangeSlider *progressBar;     // 进度条，显示已标记的导出时间段
     QLabel *timeLabel;            // 播放时间标签
     QLabel *exportNameLabel;      // 导出项目名称标签
     QLineEdit *exportNameEdit;    // 导出项目名称输入框
     QPushButton *takePhotoButton; // 拍照按钮
+    QPushButton *markInButton;    // 设置入点按钮
+    QPushButton *markOutButton;   // 设置出点按钮
+    QPushButton *clearRangesButton; // 清除时间段按钮
+    QListWidget *exportPreviewList; // 导出预览栏，最新的在最左
+    QTimer previewPollTimer;        // 导出预览轮询定时器
 
-    QImage realFrame; // 当前视频帧图像
+    QImage realFrame;         // 当前视频帧图像
+    QString currentVideoFile; // 当前打开的视频文件路径
+    exportThread *exportWorker; // 导出线程
+    QAction *pauseExportAction;  // 暂停/继续导出
+    QAction *cancelExportAction; // 取消导出
+    QVector<timeRange> exportRanges; // 已标记的导出时间段，为空表示整个视频
+    qint64 pendingInMs;              // 已设置但尚未配对出点的入点(毫秒)，-1 为无
 };
 
 #endif // MAINWINDOW_H
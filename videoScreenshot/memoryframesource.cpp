@@ -0,0 +1,179 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: memoryframesource.cpp
+ *
+ * 模块描述:
+ *   该模块实现了内存帧源。
+ *
+ * 主要功能:
+ *   1. 添加任意格式的帧
+ *   2. 生成带固定 GOP 结构的合成帧序列
+ *   3. 按顺序零拷贝输出帧视图
+ *
+ * 函数列表:
+ *   1. memoryFrameSource         - 构造函数
+ *   2. addFrame                  - 添加一帧
+ *   3. addSyntheticFrames        - 生成合成帧序列
+ *   4. open                      - 从头开始输出
+ *   5. close                     - 停止输出
+ *   6. readFrame                 - 读取下一帧
+ *   7. width                     - 第一帧宽度
+ *   8. height                    - 第一帧高度
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#include "memoryframesource.h"
+#include <cstring>
+
+/***********************************************************
+ * 函数名称: memoryFrameSource
+ * 函数功能: 内存帧源的构造函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 无
+ ***********************************************************/
+memoryFrameSource::memoryFrameSource() : fps(25.0),
+                                         position(-1)
+{
+}
+
+/***********************************************************
+ * 函数名称: addFrame
+ * 函数功能: 添加一帧
+ * 参数说明:
+ *   data        - 紧凑排列的像素数据，长度须等于 frameView::bufferSize
+ *   pixelFormat - 像素格式
+ *   frameWidth  - 宽度
+ *   frameHeight - 高度
+ *   keyframe    - 是否为关键帧
+ * 返回值: 无
+ * 备注: QByteArray 隐式共享，相同内容的帧只占一份内存
+ ***********************************************************/
+void memoryFrameSource::addFrame(const QByteArray &data, frameView::PixelFormat pixelFormat,
+                                 int frameWidth, int frameHeight, bool keyframe)
+{
+    storedFrame stored;
+    stored.data = data;
+    stored.format = pixelFormat;
+    stored.width = frameWidth;
+    stored.height = frameHeight;
+    stored.keyframe = keyframe;
+    frames.append(stored);
+}
+
+/***********************************************************
+ * 函数名称: addSyntheticFrames
+ * 函数功能: 生成合成帧序列
+ * 参数说明:
+ *   count       - 帧数
+ *   frameWidth  - 宽度
+ *   frameHeight - 高度
+ *   gop         - 关键帧间隔
+ *   rate        - 帧率
+ * 返回值: 无
+ * 备注: yuv420p 格式，每帧亮度不同，内容只由帧号决定
+ ***********************************************************/
+void memoryFrameSource::addSyntheticFrames(int count, int frameWidth, int frameHeight, int gop, double rate)
+{
+    fps = rate > 0 ? rate : 25.0;
+    const qint64 size = frameView::bufferSize(frameView::FORMAT_YUV420P, frameWidth, frameHeight);
+    const int lumaSize = frameWidth * frameHeight;
+    frames.reserve(frames.size() + count);
+    for (int i = 0; i < count; ++i)
+    {
+        QByteArray data(static_cast<int>(size), static_cast<char>(128));
+        memset(data.data(), 16 + (i * 7) % 220, static_cast<size_t>(lumaSize));
+        addFrame(data, frameView::FORMAT_YUV420P, frameWidth, frameHeight, gop <= 1 || i % gop == 0);
+    }
+}
+
+/***********************************************************
+ * 函数名称: open
+ * 函数功能: 从头开始输出
+ * 参数说明:
+ *   path - 被忽略
+ * 返回值: 有帧时返回 true
+ * 备注: 可重复打开，每次都从第一帧开始
+ ***********************************************************/
+bool memoryFrameSource::open(const QString &path)
+{
+    Q_UNUSED(path);
+    position = 0;
+    return !frames.isEmpty();
+}
+
+/***********************************************************
+ * 函数名称: close
+ * 函数功能: 停止输出
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 帧数据保留，可再次打开
+ ***********************************************************/
+void memoryFrameSource::close()
+{
+    position = -1;
+}
+
+/***********************************************************
+ * 函数名称: readFrame
+ * 函数功能: 读取下一帧
+ * 参数说明:
+ *   frame - 返回帧视图
+ * 返回值: 成功返回 true，全部输出后返回 false
+ * 备注: 视图直接指向内部数据
+ ***********************************************************/
+bool memoryFrameSource::readFrame(frameView &frame)
+{
+    if (position < 0 || position >= frames.size())
+    {
+        return false;
+    }
+    const storedFrame &stored = frames.at(position);
+    frame.setPacked(reinterpret_cast<const uchar *>(stored.data.constData()), stored.format,
+                    stored.width, stored.height);
+    frame.index = position;
+    frame.ptsUs = static_cast<qint64>(position * 1000000 / fps);
+    frame.keyframe = stored.keyframe;
+    position++;
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: width
+ * 函数功能: 第一帧宽度
+ * 参数说明: 无
+ * 返回值: 宽度，无帧时返回 0
+ * 备注: 无
+ ***********************************************************/
+int memoryFrameSource::width() const
+{
+    return frames.isEmpty() ? 0 : frames.first().width;
+}
+
+/***********************************************************
+ * 函数名称: height
+ * 函数功能: 第一帧高度
+ * 参数说明: 无
+ * 返回值: 高度，无帧时返回 0
+ * 备注: 无
+ ***********************************************************/
+int memoryFrameSource::height() const
+{
+    return frames.isEmpty() ? 0 : frames.first().height;
+}
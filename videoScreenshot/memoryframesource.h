@@ -0,0 +1,85 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: memoryframesource.h
+ *
+ * 模块描述:
+ *   该模块定义了内存帧源，按顺序输出预先放入内存的帧，不做任何 I/O 和解码。
+ *   用于确定性的性能测试和采样逻辑验证，结果只取决于帧内容和导出参数。
+ *
+ * 主要功能:
+ *   1. 添加任意格式的帧
+ *   2. 生成带固定 GOP 结构的合成帧序列
+ *   3. 按顺序零拷贝输出帧视图
+ *
+ * 函数列表:
+ *   1. memoryFrameSource         - 构造函数
+ *   2. addFrame                  - 添加一帧
+ *   3. addSyntheticFrames        - 生成合成帧序列
+ *   4. setFrameRate              - 设置帧率
+ *   5. open                      - 从头开始输出
+ *   6. close                     - 停止输出
+ *   7. readFrame                 - 读取下一帧
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#ifndef MEMORYFRAMESOURCE_H
+#define MEMORYFRAMESOURCE_H
+
+#include <QByteArray>
+#include <QVector>
+#include "framesource.h"
+
+class memoryFrameSource : public frameSource
+{
+public:
+    memoryFrameSource();
+
+    void addFrame(const QByteArray &data, frameView::PixelFormat pixelFormat,
+                  int frameWidth, int frameHeight, bool keyframe); // 添加一帧(紧凑排列)
+    void addSyntheticFrames(int count, int frameWidth, int frameHeight,
+                            int gop, double rate);                 // 生成合成帧序列
+    void setFrameRate(double rate) { fps = rate > 0 ? rate : 25.0; }  // 设置帧率
+
+    bool open(const QString &path) override;   // 从头开始输出，路径被忽略
+    void close() override;                     // 停止输出
+    bool readFrame(frameView &frame) override; // 读取下一帧
+
+    int width() const override;                                         // 第一帧宽度
+    int height() const override;                                        // 第一帧高度
+    double frameRate() const override { return fps; }                   // 帧率
+    qint64 frameCount() const override { return frames.size(); }        // 总帧数
+    QString errorString() const override { return QString(); }          // 错误描述
+    QString backendName() const override { return "memory"; }           // 后端名称
+
+private:
+    struct storedFrame
+    {
+        QByteArray data;               // 紧凑排列的像素数据
+        frameView::PixelFormat format; // 像素格式
+        int width;                     // 宽度
+        int height;                    // 高度
+        bool keyframe;                 // 是否为关键帧
+    };
+
+    QVector<storedFrame> frames; // 全部帧
+    double fps;                  // 帧率
+    int position;                // 下一帧序号，-1 表示未打开
+};
+
+#endif // MEMORYFRAMESOURCE_H
@@ -0,0 +1,119 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: parallelencoder.cpp
+ *
+ * 模块描述:
+ *   该模块实现了并行图像编码器。
+ *
+ * 主要功能:
+ *   1. 在线程池中并行编码一组图像，每张图像可指定格式和质量
+ *   2. 各图像的编码耗时计入编码阶段统计
+ *
+ * 函数列表:
+ *   1. parallelEncoder           - 构造函数
+ *   2. encode                    - 并行编码一组图像
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#include "parallelencoder.h"
+#include "pipelinestats.h"
+#include <QBuffer>
+#include <QDebug>
+#include <QRunnable>
+#include <QThread>
+
+namespace
+{
+    // 编码一张图像的任务，结果写入调用方持有的缓冲区
+    class encodeTask : public QRunnable
+    {
+    public:
+        encodeTask(const parallelEncoder::job &item, QByteArray *output, pipelineStats *stats, qint64 frameNumber)
+            : item(item), output(output), stats(stats), frameNumber(frameNumber)
+        {
+        }
+
+        void run() override
+        {
+            pipelineStats::scopedStage timer(stats, pipelineStats::STAGE_ENCODE, frameNumber);
+            QBuffer buffer(output);
+            buffer.open(QIODevice::WriteOnly);
+            if (!item.image.save(&buffer, item.format.constData(), item.quality))
+            {
+                output->clear();
+            }
+        }
+
+    private:
+        parallelEncoder::job item;
+        QByteArray *output;
+        pipelineStats *stats;
+        qint64 frameNumber;
+    };
+}
+
+/***********************************************************
+ * 函数名称: parallelEncoder
+ * 函数功能: 并行图像编码器的构造函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 编码线程数取 CPU 核数
+ ***********************************************************/
+parallelEncoder::parallelEncoder()
+{
+    pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+}
+
+/***********************************************************
+ * 函数名称: encode
+ * 函数功能: 并行编码一组图像
+ * 参数说明:
+ *   jobs        - 待编码的图像
+ *   stats       - 阶段统计对象，可为空
+ *   frameNumber - 帧号，用于阶段统计
+ * 返回值: 与 jobs 一一对应的编码数据，编码失败的为空
+ * 备注: 每张图像一个任务，阻塞到全部完成；图像引用的缓冲区在返回前
+ *       须保持有效。只有一张图像时直接在调用线程编码
+ ***********************************************************/
+QVector<QByteArray> parallelEncoder::encode(const QVector<job> &jobs, pipelineStats *stats, qint64 frameNumber)
+{
+    QVector<QByteArray> encoded(jobs.size());
+    if (jobs.size() == 1)
+    {
+        encodeTask task(jobs[0], &encoded[0], stats, frameNumber);
+        task.run();
+    }
+    else
+    {
+        for (int i = 0; i < jobs.size(); ++i)
+        {
+            pool.start(new encodeTask(jobs[i], &encoded[i], stats, frameNumber));
+        }
+        pool.waitForDone();
+    }
+
+    for (int i = 0; i < encoded.size(); ++i)
+    {
+        if (encoded[i].isEmpty())
+        {
+            qDebug() << "Image encode failed, frame:" << frameNumber << "image:" << i;
+        }
+    }
+    return encoded;
+}
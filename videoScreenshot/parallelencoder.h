@@ -0,0 +1,65 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: parallelencoder.h
+ *
+ * 模块描述:
+ *   该模块定义了并行图像编码器。一帧派生出的多张图像(切片、各分辨率
+ *   版本)在独立的线程池中同时编码，调用方阻塞到全部完成后按顺序写出。
+ *
+ * 主要功能:
+ *   1. 在线程池中并行编码一组图像，每张图像可指定格式和质量
+ *   2. 各图像的编码耗时计入编码阶段统计
+ *
+ * 函数列表:
+ *   1. parallelEncoder           - 构造函数
+ *   2. encode                    - 并行编码一组图像
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#ifndef PARALLELENCODER_H
+#define PARALLELENCODER_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QThreadPool>
+#include <QVector>
+
+class pipelineStats;
+
+class parallelEncoder
+{
+public:
+    // 一张待编码的图像
+    struct job
+    {
+        QImage image;      // 图像，可以是引用其他缓冲区的视图
+        QByteArray format; // 图像格式后缀
+        int quality;       // 图像质量，-1 为编码器默认
+    };
+
+    parallelEncoder();
+
+    QVector<QByteArray> encode(const QVector<job> &jobs, pipelineStats *stats,
+                               qint64 frameNumber); // 并行编码一组图像
+
+private:
+    QThreadPool pool; // 编码线程池
+};
+
+#endif // PARALLELENCODER_H
@@ -0,0 +1,258 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: phash.cpp
+ *
+ * 模块描述:
+ *   该模块实现了 64 位感知哈希。亮度按 256x256 个采样点均匀采样后
+ *   平均成 32x32 缩略图，做二维 DCT 取左上 8x8 低频系数，
+ *   每个系数与交流系数的中位数比较得到一位。
+ *
+ * 主要功能:
+ *   1. 直接从原始帧的亮度计算哈希，无需颜色转换
+ *   2. 从 QImage 计算哈希，用于已有数据集图像
+ *   3. 从已生成的亮度金字塔计算哈希，不再读取原始帧
+ *
+ * 函数列表:
+ *   1. perceptualHash            - 计算帧、图像或亮度金字塔的感知哈希
+ *   2. sampleLuma                - 采样亮度生成缩略图
+ *   3. hashFromThumbnail         - 由缩略图计算哈希
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 支持 P010/YUV420P10 帧，取 10bit 亮度的高 8 位
+ *     * 增加从亮度金字塔计算哈希，与帧分析过滤链共用一次采样
+ ***********************************************************/
+
+#include "phash.h"
+#include <algorithm>
+#include <cmath>
+#include "lumapyramid.h"
+
+namespace
+{
+    const int THUMB_SIZE = 32;       // 缩略图边长
+    const int SAMPLES_PER_CELL = 8;  // 每个缩略图像素每个方向的采样点数
+    const int DCT_SIZE = 8;          // 保留的低频系数边长
+    const int SAMPLE_COUNT = THUMB_SIZE * SAMPLES_PER_CELL;
+    const double PI = 3.14159265358979323846;
+
+    // DCT 基函数表 cos((2x+1)uπ/64)，u < 8
+    struct dctTable
+    {
+        float basis[DCT_SIZE][THUMB_SIZE];
+
+        dctTable()
+        {
+            for (int u = 0; u < DCT_SIZE; ++u)
+            {
+                for (int x = 0; x < THUMB_SIZE; ++x)
+                {
+                    basis[u][x] = static_cast<float>(std::cos((2 * x + 1) * u * PI / (2 * THUMB_SIZE)));
+                }
+            }
+        }
+    };
+}
+
+/***********************************************************
+ * 函数名称: sampleLuma
+ * 函数功能: 采样亮度生成缩略图
+ * 参数说明:
+ *   frame - 帧视图
+ *   thumb - 返回 32x32 缩略图
+ * 返回值: 支持的格式返回 true
+ * 备注: 采样点数与分辨率无关，8K 帧与 480p 帧耗时相同；
+ *       YUV/NV12/灰度直接读取亮度平面，RGB32 按 BT.601 权重计算亮度；
+ *       10bit 帧取 16 位样本的高 8 位有效位，不做色调映射
+ ***********************************************************/
+static bool sampleLuma(const frameView &frame, float thumb[THUMB_SIZE * THUMB_SIZE])
+{
+    if (!frame.isValid())
+    {
+        return false;
+    }
+    const bool rgb = frame.format == frameView::FORMAT_RGB32;
+    const bool wide = frameView::isHighBitDepth(frame.format);
+    const int wideShift = frame.format == frameView::FORMAT_P010 ? 8 : 2;
+
+    int columns[SAMPLE_COUNT];
+    for (int i = 0; i < SAMPLE_COUNT; ++i)
+    {
+        columns[i] = static_cast<int>((2 * i + 1) * static_cast<qint64>(frame.width) / (2 * SAMPLE_COUNT));
+    }
+
+    std::fill(thumb, thumb + THUMB_SIZE * THUMB_SIZE, 0.0f);
+    for (int i = 0; i < SAMPLE_COUNT; ++i)
+    {
+        const int y = static_cast<int>((2 * i + 1) * static_cast<qint64>(frame.height) / (2 * SAMPLE_COUNT));
+        const uchar *line = frame.planes[0] + static_cast<qint64>(y) * frame.strides[0];
+        float *cells = thumb + (i / SAMPLES_PER_CELL) * THUMB_SIZE;
+        for (int j = 0; j < SAMPLE_COUNT; ++j)
+        {
+            int luma;
+            if (rgb)
+            {
+                const uchar *pixel = line + columns[j] * 4;
+                luma = (pixel[0] * 29 + pixel[1] * 150 + pixel[2] * 77) >> 8;
+            }
+            else if (wide)
+            {
+                luma = (reinterpret_cast<const quint16 *>(line)[columns[j]] >> wideShift) & 0xff;
+            }
+            else
+            {
+                luma = line[columns[j]];
+            }
+            cells[j / SAMPLES_PER_CELL] += static_cast<float>(luma);
+        }
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: hashFromThumbnail
+ * 函数功能: 由缩略图计算哈希
+ * 参数说明:
+ *   thumb - 32x32 缩略图
+ * 返回值: 64 位哈希，第 v*8+u 位对应系数 (v,u)
+ * 备注: 直流系数不参与中位数且恒为 0，哈希对亮度的整体偏移和缩放不变
+ ***********************************************************/
+static quint64 hashFromThumbnail(const float thumb[THUMB_SIZE * THUMB_SIZE])
+{
+    static const dctTable table;
+
+    // 先对每行做一维 DCT，再对列做一维 DCT，只计算低频部分
+    float rows[THUMB_SIZE][DCT_SIZE];
+    for (int y = 0; y < THUMB_SIZE; ++y)
+    {
+        const float *line = thumb + y * THUMB_SIZE;
+        for (int u = 0; u < DCT_SIZE; ++u)
+        {
+            float sum = 0.0f;
+            for (int x = 0; x < THUMB_SIZE; ++x)
+            {
+                sum += line[x] * table.basis[u][x];
+            }
+            rows[y][u] = sum;
+        }
+    }
+
+    float coefficients[DCT_SIZE * DCT_SIZE];
+    for (int v = 0; v < DCT_SIZE; ++v)
+    {
+        for (int u = 0; u < DCT_SIZE; ++u)
+        {
+            float sum = 0.0f;
+            for (int y = 0; y < THUMB_SIZE; ++y)
+            {
+                sum += rows[y][u] * table.basis[v][y];
+            }
+            coefficients[v * DCT_SIZE + u] = sum;
+        }
+    }
+
+    float sorted[DCT_SIZE * DCT_SIZE - 1];
+    std::copy(coefficients + 1, coefficients + DCT_SIZE * DCT_SIZE, sorted);
+    const int middle = (DCT_SIZE * DCT_SIZE - 1) / 2;
+    std::nth_element(sorted, sorted + middle, sorted + DCT_SIZE * DCT_SIZE - 1);
+    const float median = sorted[middle];
+
+    quint64 hash = 0;
+    for (int i = 1; i < DCT_SIZE * DCT_SIZE; ++i)
+    {
+        if (coefficients[i] > median)
+        {
+            hash |= Q_UINT64_C(1) << i;
+        }
+    }
+    return hash;
+}
+
+/***********************************************************
+ * 函数名称: perceptualHash
+ * 函数功能: 从原始帧亮度计算感知哈希
+ * 参数说明:
+ *   frame - 帧视图
+ * 返回值: 64 位哈希，帧无效时返回 0
+ * 备注: 不做颜色转换，可在编码前对候选帧调用
+ ***********************************************************/
+quint64 perceptualHash(const frameView &frame)
+{
+    float thumb[THUMB_SIZE * THUMB_SIZE];
+    if (!sampleLuma(frame, thumb))
+    {
+        return 0;
+    }
+    return hashFromThumbnail(thumb);
+}
+
+/***********************************************************
+ * 函数名称: perceptualHash
+ * 函数功能: 从图像计算感知哈希
+ * 参数说明:
+ *   image - 图像
+ * 返回值: 64 位哈希，图像为空时返回 0
+ * 备注: 转换为 RGB32 后按帧视图处理，与视频帧的哈希可直接比较
+ ***********************************************************/
+quint64 perceptualHash(const QImage &image)
+{
+    if (image.isNull())
+    {
+        return 0;
+    }
+    const QImage rgb = (image.format() == QImage::Format_RGB32 || image.format() == QImage::Format_ARGB32)
+                           ? image
+                           : image.convertToFormat(QImage::Format_RGB32);
+    frameView frame;
+    frame.planes[0] = rgb.constBits();
+    frame.strides[0] = rgb.bytesPerLine();
+    frame.width = rgb.width();
+    frame.height = rgb.height();
+    frame.format = frameView::FORMAT_RGB32;
+    return perceptualHash(frame);
+}
+
+/***********************************************************
+ * 函数名称: perceptualHash
+ * 函数功能: 从亮度金字塔计算感知哈希
+ * 参数说明:
+ *   pyramid - 已生成的亮度金字塔
+ * 返回值: 64 位哈希，金字塔无效时返回 0
+ * 备注: 金字塔第 0 层的采样位置和取值与 sampleLuma 相同，
+ *       按 8x8 求和得到的缩略图逐位一致，哈希与从原始帧计算的结果相同
+ ***********************************************************/
+quint64 perceptualHash(const lumaPyramid &pyramid)
+{
+    if (!pyramid.isValid() || lumaPyramid::BASE_SIZE != SAMPLE_COUNT)
+    {
+        return 0;
+    }
+    float thumb[THUMB_SIZE * THUMB_SIZE];
+    std::fill(thumb, thumb + THUMB_SIZE * THUMB_SIZE, 0.0f);
+    const quint8 *base = pyramid.level(0);
+    for (int i = 0; i < SAMPLE_COUNT; ++i)
+    {
+        const quint8 *line = base + i * SAMPLE_COUNT;
+        float *cells = thumb + (i / SAMPLES_PER_CELL) * THUMB_SIZE;
+        for (int j = 0; j < SAMPLE_COUNT; ++j)
+        {
+            cells[j / SAMPLES_PER_CELL] += static_cast<float>(line[j]);
+        }
+    }
+    return hashFromThumbnail(thumb);
+}
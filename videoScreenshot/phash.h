@@ -0,0 +1,57 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: phash.h
+ *
+ * 模块描述:
+ *   该模块定义了 64 位感知哈希(DCT pHash)的计算接口。内容相近的图像
+ *   哈希的汉明距离小，对缩放、重新压缩和整体亮度变化不敏感。
+ *
+ * 主要功能:
+ *   1. 直接从原始帧的亮度计算哈希，无需颜色转换
+ *   2. 从 QImage 计算哈希，用于已有数据集图像
+ *   3. 计算两个哈希的汉明距离
+ *   4. 从亮度金字塔计算哈希，与帧分析过滤链共用一次采样
+ *
+ * 函数列表:
+ *   1. perceptualHash            - 计算帧、图像或亮度金字塔的感知哈希
+ *   2. hammingDistance           - 计算两个哈希的汉明距离
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 增加从亮度金字塔计算哈希
+ ***********************************************************/
+
+#ifndef PHASH_H
+#define PHASH_H
+
+#include <QImage>
+#include <QtAlgorithms>
+#include "frameview.h"
+
+class lumaPyramid;
+
+quint64 perceptualHash(const frameView &frame); // 从原始帧亮度计算感知哈希
+quint64 perceptualHash(const QImage &image);    // 从图像计算感知哈希
+quint64 perceptualHash(const lumaPyramid &pyramid); // 从亮度金字塔计算感知哈希
+
+inline int hammingDistance(quint64 a, quint64 b) // 两个哈希的汉明距离
+{
+    return static_cast<int>(qPopulationCount(a ^ b));
+}
+
+#endif // PHASH_H
@@ -0,0 +1,403 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: pipelinestats.cpp
+ *
+ * 模块描述:
+ *   该模块实现了导出流水线的分阶段统计类。所有计数器均为无锁原子量，
+ *   可以在解码、编码等不同线程中并发记录。
+ *
+ * 主要功能:
+ *   1. 低开销地记录各阶段的单帧耗时
+ *   2. 对数分桶直方图，估算 p50/p99 延迟
+ *   3. 记录队列深度和写入字节数
+ *   4. 生成 JSON 快照并写出运行报告
+ *
+ * 函数列表:
+ *   1. pipelineStats             - 构造函数，初始化计数器
+ *   2. reset                     - 清空所有计数器并重新计时
+ *   3. recordLatency             - 记录一次阶段耗时
+ *   4. setQueueDepth             - 设置阶段输入队列深度
+ *   5. addBytesWritten           - 累加写入字节数
+ *   6. snapshot                  - 生成当前统计快照
+ *   7. writeReport               - 写出 JSON 运行报告
+ *   8. stageName                 - 获取阶段名称
+ *   9. peakRssBytes              - 获取进程峰值常驻内存
+ *   10. bucketIndex              - 计算耗时所属的直方图桶
+ *   11. bucketValue              - 计算直方图桶的代表值
+ *   12. percentile               - 根据直方图估算分位数
+ *   13. stageKey                 - 获取阶段名称字面量
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 作用域计时同时写入时间线追踪
+ *     * 增加预标注推理阶段
+ *     * 追踪记录器由导出设置，构造时默认不追踪
+ ***********************************************************/
+
+#include "pipelinestats.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QtAlgorithms>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/***********************************************************
+ * 函数名称: pipelineStats
+ * 函数功能: 统计类的构造函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 清空计数器并开始计时，默认不追踪
+ ***********************************************************/
+pipelineStats::pipelineStats() : tracer(nullptr)
+{
+    reset();
+}
+
+/***********************************************************
+ * 函数名称: reset
+ * 函数功能: 清空所有计数器并重新计时
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 应在导出任务开始前调用
+ ***********************************************************/
+void pipelineStats::reset()
+{
+    for (int s = 0; s < STAGE_COUNT; ++s)
+    {
+        stageCounters &c = stages[s];
+        c.frames.store(0, std::memory_order_relaxed);
+        c.totalNs.store(0, std::memory_order_relaxed);
+        c.maxNs.store(0, std::memory_order_relaxed);
+        c.queueDepth.store(0, std::memory_order_relaxed);
+        c.queueDepthMax.store(0, std::memory_order_relaxed);
+        for (int i = 0; i < BUCKET_COUNT; ++i)
+        {
+            c.buckets[i].store(0, std::memory_order_relaxed);
+        }
+    }
+    bytesWritten.store(0, std::memory_order_relaxed);
+    wallClock.start();
+}
+
+/***********************************************************
+ * 函数名称: recordLatency
+ * 函数功能: 记录一次阶段耗时
+ * 参数说明:
+ *   stage - 流水线阶段
+ *   nsecs - 耗时(纳秒)
+ * 返回值: 无
+ * 备注: 仅使用 relaxed 原子操作，可在任意线程调用
+ ***********************************************************/
+void pipelineStats::recordLatency(Stage stage, qint64 nsecs)
+{
+    if (stage < 0 || stage >= STAGE_COUNT)
+    {
+        return;
+    }
+
+    const quint64 value = nsecs > 0 ? static_cast<quint64>(nsecs) : 0;
+    stageCounters &c = stages[stage];
+    c.frames.fetch_add(1, std::memory_order_relaxed);
+    c.totalNs.fetch_add(value, std::memory_order_relaxed);
+    c.buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+
+    quint64 previous = c.maxNs.load(std::memory_order_relaxed);
+    while (value > previous &&
+           !c.maxNs.compare_exchange_weak(previous, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+/***********************************************************
+ * 函数名称: setQueueDepth
+ * 函数功能: 设置阶段输入队列深度
+ * 参数说明:
+ *   stage - 流水线阶段
+ *   depth - 当前队列中等待的帧数
+ * 返回值: 无
+ * 备注: 同时记录历史最大深度
+ ***********************************************************/
+void pipelineStats::setQueueDepth(Stage stage, int depth)
+{
+    if (stage < 0 || stage >= STAGE_COUNT)
+    {
+        return;
+    }
+
+    stageCounters &c = stages[stage];
+    c.queueDepth.store(depth, std::memory_order_relaxed);
+
+    int previous = c.queueDepthMax.load(std::memory_order_relaxed);
+    while (depth > previous &&
+           !c.queueDepthMax.compare_exchange_weak(previous, depth, std::memory_order_relaxed))
+    {
+    }
+}
+
+/***********************************************************
+ * 函数名称: addBytesWritten
+ * 函数功能: 累加写入字节数
+ * 参数说明:
+ *   bytes - 本次写入的字节数
+ * 返回值: 无
+ * 备注: 无
+ ***********************************************************/
+void pipelineStats::addBytesWritten(qint64 bytes)
+{
+    bytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+/***********************************************************
+ * 函数名称: snapshot
+ * 函数功能: 生成当前统计快照
+ * 参数说明: 无
+ * 返回值: 包含各阶段统计的 JSON 对象
+ * 备注: 瓶颈阶段取累计耗时最长的阶段
+ ***********************************************************/
+QJsonObject pipelineStats::snapshot() const
+{
+    const qint64 elapsedNs = qMax<qint64>(wallClock.nsecsElapsed(), 1);
+    const double elapsedSec = elapsedNs / 1e9;
+
+    QJsonArray stageArray;
+    int bottleneck = -1;
+    quint64 bottleneckNs = 0;
+    quint64 histogram[BUCKET_COUNT];
+
+    for (int s = 0; s < STAGE_COUNT; ++s)
+    {
+        const stageCounters &c = stages[s];
+        const quint64 frames = c.frames.load(std::memory_order_relaxed);
+        const quint64 totalNs = c.totalNs.load(std::memory_order_relaxed);
+
+        quint64 histogramTotal = 0;
+        for (int i = 0; i < BUCKET_COUNT; ++i)
+        {
+            histogram[i] = c.buckets[i].load(std::memory_order_relaxed);
+            histogramTotal += histogram[i];
+        }
+
+        QJsonObject stage;
+        stage["name"] = stageName(static_cast<Stage>(s));
+        stage["frames"] = static_cast<double>(frames);
+        stage["fps"] = frames / elapsedSec;
+        stage["busyRatio"] = static_cast<double>(totalNs) / elapsedNs;
+        stage["meanUs"] = frames ? totalNs / 1e3 / frames : 0.0;
+        stage["p50Us"] = percentile(histogram, histogramTotal, 0.50) / 1e3;
+        stage["p99Us"] = percentile(histogram, histogramTotal, 0.99) / 1e3;
+        stage["maxUs"] = c.maxNs.load(std::memory_order_relaxed) / 1e3;
+        stage["queueDepth"] = c.queueDepth.load(std::memory_order_relaxed);
+        stage["queueDepthMax"] = c.queueDepthMax.load(std::memory_order_relaxed);
+        stageArray.append(stage);
+
+        if (frames > 0 && totalNs > bottleneckNs)
+        {
+            bottleneckNs = totalNs;
+            bottleneck = s;
+        }
+    }
+
+    const qint64 bytes = bytesWritten.load(std::memory_order_relaxed);
+
+    QJsonObject result;
+    result["elapsedMs"] = elapsedNs / 1e6;
+    result["stages"] = stageArray;
+    result["bytesWritten"] = static_cast<double>(bytes);
+    result["writeMBps"] = bytes / 1048576.0 / elapsedSec;
+    result["peakRssBytes"] = static_cast<double>(peakRssBytes());
+    result["bottleneck"] = bottleneck >= 0 ? stageName(static_cast<Stage>(bottleneck)) : QString();
+    return result;
+}
+
+/***********************************************************
+ * 函数名称: writeReport
+ * 函数功能: 写出 JSON 运行报告
+ * 参数说明:
+ *   fileName - 报告文件路径
+ *   jobInfo  - 任务描述信息(视频路径、导出模式等)
+ * 返回值: 写出成功返回 true
+ * 备注: 使用 QSaveFile 保证报告文件完整写入
+ ***********************************************************/
+bool pipelineStats::writeReport(const QString &fileName, const QJsonObject &jobInfo) const
+{
+    QJsonObject report;
+    report["job"] = jobInfo;
+    report["finishedAt"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    report["stats"] = snapshot();
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    file.write(QJsonDocument(report).toJson(QJsonDocument::Indented));
+    return file.commit();
+}
+
+/***********************************************************
+ * 函数名称: stageName
+ * 函数功能: 获取阶段名称
+ * 参数说明:
+ *   stage - 流水线阶段
+ * 返回值: 阶段名称字符串
+ * 备注: 名称用于 JSON 报告和界面显示
+ ***********************************************************/
+QString pipelineStats::stageName(Stage stage)
+{
+    return QString::fromLatin1(stageKey(stage));
+}
+
+/***********************************************************
+ * 函数名称: stageKey
+ * 函数功能: 获取阶段名称字面量
+ * 参数说明:
+ *   stage - 流水线阶段
+ * 返回值: 静态字符串，可直接作为追踪事件名
+ * 备注: 无
+ ***********************************************************/
+const char *pipelineStats::stageKey(Stage stage)
+{
+    switch (stage)
+    {
+    case STAGE_DEMUX:
+        return "demux";
+    case STAGE_DECODE:
+        return "decode";
+    case STAGE_CONVERT:
+        return "convert";
+    case STAGE_FILTER:
+        return "filter";
+    case STAGE_ENCODE:
+        return "encode";
+    case STAGE_WRITE:
+        return "write";
+    case STAGE_INFER:
+        return "infer";
+    default:
+        return "";
+    }
+}
+
+/***********************************************************
+ * 函数名称: peakRssBytes
+ * 函数功能: 获取进程峰值常驻内存
+ * 参数说明: 无
+ * 返回值: 峰值常驻内存(字节)，获取失败返回 0
+ * 备注: Windows 使用 PeakWorkingSetSize，其余平台使用 getrusage
+ ***********************************************************/
+qint64 pipelineStats::peakRssBytes()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return static_cast<qint64>(counters.PeakWorkingSetSize);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#if defined(Q_OS_MACOS)
+    return static_cast<qint64>(usage.ru_maxrss);
+#else
+    return static_cast<qint64>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+/***********************************************************
+ * 函数名称: bucketIndex
+ * 函数功能: 计算耗时所属的直方图桶
+ * 参数说明:
+ *   nsecs - 耗时(纳秒)
+ * 返回值: 桶序号
+ * 备注: 小于8的值直接映射，其余按最高位和后续3位分桶
+ ***********************************************************/
+int pipelineStats::bucketIndex(quint64 nsecs)
+{
+    if (nsecs < (1u << SUB_BUCKET_BITS))
+    {
+        return static_cast<int>(nsecs);
+    }
+
+    const int msb = 63 - static_cast<int>(qCountLeadingZeroBits(nsecs));
+    const int shift = msb - SUB_BUCKET_BITS;
+    const int sub = static_cast<int>((nsecs >> shift) & ((1u << SUB_BUCKET_BITS) - 1));
+    return ((shift + 1) << SUB_BUCKET_BITS) | sub;
+}
+
+/***********************************************************
+ * 函数名称: bucketValue
+ * 函数功能: 计算直方图桶的代表值
+ * 参数说明:
+ *   index - 桶序号
+ * 返回值: 桶区间中点(纳秒)
+ * 备注: 与 bucketIndex 互逆
+ ***********************************************************/
+quint64 pipelineStats::bucketValue(int index)
+{
+    if (index < (1 << SUB_BUCKET_BITS))
+    {
+        return static_cast<quint64>(index);
+    }
+
+    const int shift = (index >> SUB_BUCKET_BITS) - 1;
+    const quint64 sub = static_cast<quint64>(index & ((1 << SUB_BUCKET_BITS) - 1));
+    const quint64 lower = ((1ull << SUB_BUCKET_BITS) + sub) << shift;
+    return lower + ((1ull << shift) >> 1);
+}
+
+/***********************************************************
+ * 函数名称: percentile
+ * 函数功能: 根据直方图估算分位数
+ * 参数说明:
+ *   histogram - 各桶计数
+ *   total     - 计数总和
+ *   ratio     - 分位比例(0~1)
+ * 返回值: 分位数估计值(纳秒)
+ * 备注: 无样本时返回 0
+ ***********************************************************/
+quint64 pipelineStats::percentile(const quint64 *histogram, quint64 total, double ratio)
+{
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    const quint64 target = qMax<quint64>(1, static_cast<quint64>(total * ratio + 0.5));
+    quint64 cumulative = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        cumulative += histogram[i];
+        if (cumulative >= target)
+        {
+            return bucketValue(i);
+        }
+    }
+    return bucketValue(BUCKET_COUNT - 1);
+}
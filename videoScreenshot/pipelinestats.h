@@ -0,0 +1,159 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: pipelinestats.h
+ *
+ * 模块描述:
+ *   该模块定义了导出流水线的分阶段统计类，记录各阶段的帧数、耗时分布、
+ *   队列深度、写入字节数和进程峰值内存，用于定位瓶颈和评估硬件。
+ *
+ * 主要功能:
+ *   1. 低开销地记录各阶段(解复用/解码/转换/过滤/编码/写入/推理)的单帧耗时
+ *   2. 对数分桶直方图，估算 p50/p99 延迟
+ *   3. 记录队列深度和写入字节数
+ *   4. 生成 JSON 快照并写出运行报告
+ *
+ * 函数列表:
+ *   1. pipelineStats             - 构造函数，初始化计数器
+ *   2. reset                     - 清空所有计数器并重新计时
+ *   3. recordLatency             - 记录一次阶段耗时
+ *   4. setQueueDepth             - 设置阶段输入队列深度
+ *   5. addBytesWritten           - 累加写入字节数
+ *   6. snapshot                  - 生成当前统计快照
+ *   7. writeReport               - 写出 JSON 运行报告
+ *   8. stageName                 - 获取阶段名称
+ *   9. peakRssBytes              - 获取进程峰值常驻内存
+ *   10. stageKey                 - 获取阶段名称字面量
+ *   11. setTracer                - 设置本次导出的时间线追踪记录器
+ *   12. activeTracer             - 获取正在记录的追踪记录器
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 作用域计时同时写入时间线追踪
+ *     * 作用域计时支持空统计对象，供帧源内部计时使用
+ *     * 增加预标注推理阶段
+ *     * 作用域计时写入统计对象所属导出的追踪记录器，不再使用全局追踪
+ ***********************************************************/
+
+#ifndef PIPELINESTATS_H
+#define PIPELINESTATS_H
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QString>
+#include <atomic>
+
+#include "tracelogger.h"
+
+class pipelineStats
+{
+public:
+    enum Stage
+    {
+        STAGE_DEMUX = 0,
+        STAGE_DECODE,
+        STAGE_CONVERT,
+        STAGE_FILTER,
+        STAGE_ENCODE,
+        STAGE_WRITE,
+        STAGE_INFER,
+        STAGE_COUNT
+    };
+
+    // 作用域计时器: 构造时开始计时，析构时记录到对应阶段；所属导出开启追踪时同时写入时间线
+    class scopedStage
+    {
+    public:
+        scopedStage(pipelineStats &stats, Stage stage, qint64 frame = -1)
+            : owner(&stats), which(stage), frameIndex(frame), tracer(stats.activeTracer()),
+              traceBeginNs(tracer != nullptr ? traceLogger::nowNs() : -1) { timer.start(); }
+        // 统计对象为空时(帧源未接入导出)既不计入统计也不写时间线
+        scopedStage(pipelineStats *stats, Stage stage, qint64 frame = -1)
+            : owner(stats), which(stage), frameIndex(frame),
+              tracer(stats != nullptr ? stats->activeTracer() : nullptr),
+              traceBeginNs(tracer != nullptr ? traceLogger::nowNs() : -1) { timer.start(); }
+        ~scopedStage()
+        {
+            const qint64 elapsed = timer.nsecsElapsed();
+            if (owner != nullptr)
+            {
+                owner->recordLatency(which, elapsed);
+            }
+            if (tracer != nullptr)
+            {
+                tracer->record(stageKey(which), traceBeginNs, elapsed, frameIndex);
+            }
+        }
+
+    private:
+        pipelineStats *owner;
+        Stage which;
+        qint64 frameIndex;
+        traceLogger *tracer;
+        qint64 traceBeginNs;
+        QElapsedTimer timer;
+    };
+
+    pipelineStats();
+
+    void reset();                                   // 清空所有计数器并重新计时
+    void recordLatency(Stage stage, qint64 nsecs);  // 记录一次阶段耗时
+    void setQueueDepth(Stage stage, int depth);     // 设置阶段输入队列深度
+    void addBytesWritten(qint64 bytes);             // 累加写入字节数
+    QJsonObject snapshot() const;                   // 生成当前统计快照
+    bool writeReport(const QString &fileName,
+                     const QJsonObject &jobInfo) const; // 写出 JSON 运行报告
+
+    // 设置本次导出的追踪记录器，nullptr 表示不追踪；reset() 不影响该设置
+    void setTracer(traceLogger *logger) { tracer.store(logger, std::memory_order_release); }
+    // 获取正在记录的追踪记录器，未设置或已停止时返回 nullptr
+    traceLogger *activeTracer() const
+    {
+        traceLogger *logger = tracer.load(std::memory_order_acquire);
+        return logger != nullptr && logger->isEnabled() ? logger : nullptr;
+    }
+
+    static QString stageName(Stage stage);    // 获取阶段名称
+    static const char *stageKey(Stage stage); // 获取阶段名称字面量
+    static qint64 peakRssBytes();             // 获取进程峰值常驻内存
+
+private:
+    // 对数分桶: 每个2的幂区间再细分8个子桶，相对误差约 12%
+    static const int SUB_BUCKET_BITS = 3;
+    static const int BUCKET_COUNT = 64 << SUB_BUCKET_BITS;
+
+    struct stageCounters
+    {
+        std::atomic<quint64> frames;
+        std::atomic<quint64> totalNs;
+        std::atomic<quint64> maxNs;
+        std::atomic<int> queueDepth;
+        std::atomic<int> queueDepthMax;
+        std::atomic<quint64> buckets[BUCKET_COUNT];
+    };
+
+    static int bucketIndex(quint64 nsecs);
+    static quint64 bucketValue(int index);
+    static quint64 percentile(const quint64 *histogram, quint64 total, double ratio);
+
+    stageCounters stages[STAGE_COUNT];
+    std::atomic<qint64> bytesWritten;
+    std::atomic<traceLogger *> tracer;
+    QElapsedTimer wallClock;
+};
+
+#endif // PIPELINESTATS_H
@@ -0,0 +1,473 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: qtframesource.cpp
+ *
+ * 模块描述:
+ *   该模块实现了基于 Qt 多媒体的帧源。
+ *
+ * 主要功能:
+ *   1. 在导出线程上创建并驱动 QMediaPlayer
+ *   2. 通过视频表面接收解码帧
+ *   3. 将 QVideoFrame 映射为帧视图
+ *
+ * 函数列表:
+ *   1. frameGrabSurface::supportedPixelFormats - 声明支持的像素格式
+ *   2. frameGrabSurface::present  - 接收一帧
+ *   3. qtFrameSource              - 构造函数
+ *   4. ~qtFrameSource             - 析构函数，释放播放器
+ *   5. open                       - 打开视频文件并开始播放
+ *   6. close                      - 停止播放并释放播放器
+ *   7. readFrame                  - 读取下一帧
+ *   8. frameCount                 - 按时长和帧率估算总帧数
+ *   9. mapFrame                   - 将 QVideoFrame 映射为帧视图
+ *   10. setPaused                 - 暂停/继续播放
+ *   11. isInterrupted             - 当前线程是否收到中断请求
+ *   12. peakQueuedFrames          - 获取帧队列曾达到的最大长度
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 等待媒体加载和等待新帧时响应线程中断请求，新帧超时视为出错
+ *     * 导出暂停时暂停播放器
+ *     * 帧队列达到高水位时暂停播放器，读取回落到低水位后继续播放；
+ *       读取时即使队列非空也分发已投递的帧，使暂停请求及时生效
+ ***********************************************************/
+
+#include "qtframesource.h"
+#include <QEventLoop>
+#include <QMediaMetaData>
+#include <QThread>
+#include <QTimer>
+#include <QUrl>
+#include "pipelinestats.h"
+
+// 等待媒体加载的超时时间(毫秒)
+static const int MEDIA_LOAD_TIMEOUT_MS = 30000;
+
+// 播放中连续该时间(毫秒)收不到新帧视为播放器卡死
+static const int FRAME_STALL_TIMEOUT_MS = 10000;
+
+/***********************************************************
+ * 函数名称: isInterrupted
+ * 函数功能: 当前线程是否收到中断请求
+ * 参数说明: 无
+ * 返回值: 收到返回 true
+ * 备注: 导出线程取消时请求中断并唤醒本线程的事件分发器，
+ *       使阻塞在 WaitForMoreEvents 的等待立即返回
+ ***********************************************************/
+static bool isInterrupted()
+{
+    return QThread::currentThread()->isInterruptionRequested();
+}
+
+/***********************************************************
+ * 函数名称: frameGrabSurface::supportedPixelFormats
+ * 函数功能: 声明支持的像素格式
+ * 参数说明:
+ *   handleType - 帧缓冲区类型
+ * 返回值: 支持的像素格式列表，优先平面 YUV，避免后端先转 RGB
+ * 备注: 只接受可映射到内存的帧
+ ***********************************************************/
+QList<QVideoFrame::PixelFormat> frameGrabSurface::supportedPixelFormats(
+    QAbstractVideoBuffer::HandleType handleType) const
+{
+    if (handleType != QAbstractVideoBuffer::NoHandle)
+    {
+        return QList<QVideoFrame::PixelFormat>();
+    }
+    return QList<QVideoFrame::PixelFormat>()
+           << QVideoFrame::Format_YUV420P
+           << QVideoFrame::Format_YV12
+           << QVideoFrame::Format_NV12
+           << QVideoFrame::Format_Y8
+           << QVideoFrame::Format_RGB32
+           << QVideoFrame::Format_ARGB32
+           << QVideoFrame::Format_ARGB32_Premultiplied
+           << QVideoFrame::Format_RGB24
+           << QVideoFrame::Format_BGR32;
+}
+
+/***********************************************************
+ * 函数名称: frameGrabSurface::present
+ * 函数功能: 接收一帧
+ * 参数说明:
+ *   frame - 解码帧
+ * 返回值: 始终返回 true
+ * 备注: 只做引用计数拷贝，映射和转换推迟到 readFrame。
+ *       播放器按实时速度推送帧，达到高水位时发出 queueFull 由帧源暂停播放；
+ *       暂停前已投递的帧仍然入队，不丢帧
+ ***********************************************************/
+bool frameGrabSurface::present(const QVideoFrame &frame)
+{
+    frames.enqueue(frame);
+    peakQueued = qMax(peakQueued, frames.size());
+    if (frames.size() >= MAX_QUEUED_FRAMES)
+    {
+        emit queueFull();
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: qtFrameSource
+ * 函数功能: Qt 多媒体帧源的构造函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 播放器推迟到 open() 创建，以便归属于导出线程
+ ***********************************************************/
+qtFrameSource::qtFrameSource() : mediaPlayer(nullptr),
+                                 surface(nullptr),
+                                 frameWidth(0),
+                                 frameHeight(0),
+                                 fps(25.0),
+                                 duration(-1),
+                                 nextIndex(0),
+                                 finished(false),
+                                 throttled(false),
+                                 exportPaused(false),
+                                 peakQueued(0)
+{
+}
+
+/***********************************************************
+ * 函数名称: ~qtFrameSource
+ * 函数功能: Qt 多媒体帧源的析构函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 必须在调用 open() 的线程上析构
+ ***********************************************************/
+qtFrameSource::~qtFrameSource()
+{
+    close();
+}
+
+/***********************************************************
+ * 函数名称: open
+ * 函数功能: 打开视频文件并开始播放
+ * 参数说明:
+ *   path - 视频文件路径
+ * 返回值: 媒体加载成功返回 true
+ * 备注: 用事件循环等待加载状态变化，不再轮询休眠
+ ***********************************************************/
+bool qtFrameSource::open(const QString &path)
+{
+    close();
+    peakQueued = 0;
+
+    mediaPlayer = new QMediaPlayer(nullptr, QMediaPlayer::VideoSurface);
+    surface = new frameGrabSurface();
+    mediaPlayer->setVideoOutput(surface);
+
+    // 帧队列达到高水位时暂停播放，由 readFrame 在队列回落后恢复
+    QObject::connect(surface, &frameGrabSurface::queueFull, [this]() {
+        if (!throttled && !finished && !exportPaused)
+        {
+            throttled = true;
+            mediaPlayer->pause();
+        }
+    });
+
+    QObject::connect(mediaPlayer, &QMediaPlayer::mediaStatusChanged, [this](QMediaPlayer::MediaStatus status) {
+        if (status == QMediaPlayer::EndOfMedia || status == QMediaPlayer::InvalidMedia)
+        {
+            finished = true;
+        }
+    });
+    QObject::connect(mediaPlayer, QOverload<QMediaPlayer::Error>::of(&QMediaPlayer::error), [this](QMediaPlayer::Error) {
+        error = mediaPlayer->errorString();
+        finished = true;
+    });
+    QObject::connect(mediaPlayer, &QMediaPlayer::stateChanged, [this](QMediaPlayer::State state) {
+        if (state == QMediaPlayer::StoppedState)
+        {
+            finished = true;
+        }
+    });
+
+    // 等待媒体加载完成，期间只在有事件时醒来
+    QEventLoop loop;
+    QTimer timeout;
+    timeout.setSingleShot(true);
+    mediaPlayer->setMedia(QUrl::fromLocalFile(path));
+    timeout.start(MEDIA_LOAD_TIMEOUT_MS);
+    while (timeout.isActive() && !isInterrupted() &&
+           (mediaPlayer->mediaStatus() == QMediaPlayer::UnknownMediaStatus ||
+            mediaPlayer->mediaStatus() == QMediaPlayer::NoMedia ||
+            mediaPlayer->mediaStatus() == QMediaPlayer::LoadingMedia))
+    {
+        loop.processEvents(QEventLoop::WaitForMoreEvents);
+    }
+
+    if (mediaPlayer->mediaStatus() != QMediaPlayer::LoadedMedia &&
+        mediaPlayer->mediaStatus() != QMediaPlayer::BufferedMedia)
+    {
+        if (isInterrupted())
+        {
+            error = "cancelled while loading media";
+        }
+        else if (!timeout.isActive())
+        {
+            error = QString("media load timed out after %1 ms").arg(MEDIA_LOAD_TIMEOUT_MS);
+        }
+        else
+        {
+            error = mediaPlayer->errorString().isEmpty() ? QString("media load failed") : mediaPlayer->errorString();
+        }
+        close();
+        return false;
+    }
+
+    duration = mediaPlayer->duration();
+    const double metaRate = mediaPlayer->metaData(QMediaMetaData::VideoFrameRate).toDouble();
+    fps = metaRate > 0 ? metaRate : 25.0;
+    finished = false;
+    throttled = false;
+    nextIndex = 0;
+    if (!exportPaused)
+    {
+        mediaPlayer->play();
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: close
+ * 函数功能: 停止播放并释放播放器
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 无
+ ***********************************************************/
+void qtFrameSource::close()
+{
+    if (currentFrame.isMapped())
+    {
+        currentFrame.unmap();
+    }
+    currentFrame = QVideoFrame();
+    fallbackImage = QImage();
+    if (mediaPlayer != nullptr)
+    {
+        QObject::disconnect(mediaPlayer, nullptr, nullptr, nullptr);
+        mediaPlayer->stop();
+        delete mediaPlayer;
+        mediaPlayer = nullptr;
+    }
+    if (surface != nullptr)
+    {
+        QObject::disconnect(surface, nullptr, nullptr, nullptr);
+        peakQueued = qMax(peakQueued, surface->peakQueued);
+    }
+    delete surface;
+    surface = nullptr;
+    finished = true;
+    throttled = false;
+}
+
+/***********************************************************
+ * 函数名称: readFrame
+ * 函数功能: 读取下一帧
+ * 参数说明:
+ *   frame - 返回帧视图
+ * 返回值: 成功返回 true，播放结束返回 false
+ * 备注: 等待期间在当前线程处理事件，视频表面在此期间收到新帧；
+ *       等待时间即解码耗时，计入解码阶段。线程收到中断请求时返回 false，
+ *       超过 FRAME_STALL_TIMEOUT_MS 收不到新帧时设置错误并返回 false。
+ *       队列非空时也先分发一次已投递的事件，使高水位暂停不被积压的帧事件推迟；
+ *       取出后队列回落到低水位且因高水位暂停过时继续播放
+ ***********************************************************/
+bool qtFrameSource::readFrame(frameView &frame)
+{
+    if (mediaPlayer == nullptr)
+    {
+        return false;
+    }
+    if (currentFrame.isMapped())
+    {
+        currentFrame.unmap();
+    }
+
+    {
+        pipelineStats::scopedStage timer(stats, pipelineStats::STAGE_DECODE, nextIndex + 1);
+        QEventLoop loop;
+        QTimer stall;
+        stall.setSingleShot(true);
+        stall.start(FRAME_STALL_TIMEOUT_MS);
+        if (!surface->frames.isEmpty())
+        {
+            loop.processEvents();
+        }
+        while (surface->frames.isEmpty() && !finished && !isInterrupted() && stall.isActive())
+        {
+            loop.processEvents(QEventLoop::WaitForMoreEvents);
+        }
+        if (surface->frames.isEmpty())
+        {
+            if (!finished && !isInterrupted())
+            {
+                error = QString("no video frame within %1 ms").arg(FRAME_STALL_TIMEOUT_MS);
+            }
+            return false;
+        }
+        currentFrame = surface->frames.dequeue();
+        if (throttled && surface->frames.size() <= frameGrabSurface::RESUME_QUEUED_FRAMES)
+        {
+            throttled = false;
+            if (!finished && !exportPaused)
+            {
+                mediaPlayer->play();
+            }
+        }
+    }
+
+    if (!mapFrame(frame))
+    {
+        return false;
+    }
+    frame.index = nextIndex;
+    frame.ptsUs = currentFrame.startTime() >= 0 ? currentFrame.startTime()
+                                                : static_cast<qint64>(nextIndex * 1000000 / fps);
+    frame.keyframe = false; // Qt 多媒体不提供帧类型
+    nextIndex++;
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: frameCount
+ * 函数功能: 按时长和帧率估算总帧数
+ * 参数说明: 无
+ * 返回值: 估算帧数，时长未知返回 -1
+ * 备注: 无
+ ***********************************************************/
+qint64 qtFrameSource::frameCount() const
+{
+    return duration > 0 ? static_cast<qint64>(duration / 1000.0 * fps) : -1;
+}
+
+/***********************************************************
+ * 函数名称: mapFrame
+ * 函数功能: 将 QVideoFrame 映射为帧视图
+ * 参数说明:
+ *   frame - 返回帧视图
+ * 返回值: 映射成功返回 true
+ * 备注: 平面 YUV/NV12/灰度/RGB32 直接引用映射内存，
+ *       其余格式经 QImage 转为 RGB32 后引用
+ ***********************************************************/
+bool qtFrameSource::mapFrame(frameView &frame)
+{
+    if (!currentFrame.map(QAbstractVideoBuffer::ReadOnly))
+    {
+        error = "cannot map video frame";
+        return false;
+    }
+
+    frame = frameView();
+    frame.width = frameWidth = currentFrame.width();
+    frame.height = frameHeight = currentFrame.height();
+    switch (currentFrame.pixelFormat())
+    {
+    case QVideoFrame::Format_YUV420P:
+    case QVideoFrame::Format_YV12:
+    {
+        // YV12 的 V 平面在 U 之前
+        const bool swapChroma = currentFrame.pixelFormat() == QVideoFrame::Format_YV12;
+        frame.format = frameView::FORMAT_YUV420P;
+        frame.planes[0] = currentFrame.bits(0);
+        frame.strides[0] = currentFrame.bytesPerLine(0);
+        frame.planes[1] = currentFrame.bits(swapChroma ? 2 : 1);
+        frame.strides[1] = currentFrame.bytesPerLine(swapChroma ? 2 : 1);
+        frame.planes[2] = currentFrame.bits(swapChroma ? 1 : 2);
+        frame.strides[2] = currentFrame.bytesPerLine(swapChroma ? 1 : 2);
+        return true;
+    }
+    case QVideoFrame::Format_NV12:
+        frame.format = frameView::FORMAT_NV12;
+        frame.planes[0] = currentFrame.bits(0);
+        frame.strides[0] = currentFrame.bytesPerLine(0);
+        frame.planes[1] = currentFrame.bits(1);
+        frame.strides[1] = currentFrame.bytesPerLine(1);
+        return true;
+    case QVideoFrame::Format_Y8:
+        frame.format = frameView::FORMAT_GRAY8;
+        frame.planes[0] = currentFrame.bits();
+        frame.strides[0] = currentFrame.bytesPerLine();
+        return true;
+    case QVideoFrame::Format_RGB32:
+    case QVideoFrame::Format_ARGB32:
+    case QVideoFrame::Format_ARGB32_Premultiplied:
+        frame.format = frameView::FORMAT_RGB32;
+        frame.planes[0] = currentFrame.bits();
+        frame.strides[0] = currentFrame.bytesPerLine();
+        return true;
+    default:
+        break;
+    }
+
+    const QImage::Format imageFormat = QVideoFrame::imageFormatFromPixelFormat(currentFrame.pixelFormat());
+    if (imageFormat == QImage::Format_Invalid)
+    {
+        error = "unsupported video frame format";
+        currentFrame.unmap();
+        return false;
+    }
+    fallbackImage = QImage(currentFrame.bits(), currentFrame.width(), currentFrame.height(),
+                           currentFrame.bytesPerLine(), imageFormat)
+                        .convertToFormat(QImage::Format_RGB32);
+    currentFrame.unmap();
+    frame.format = frameView::FORMAT_RGB32;
+    frame.planes[0] = fallbackImage.constBits();
+    frame.strides[0] = fallbackImage.bytesPerLine();
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: setPaused
+ * 函数功能: 暂停/继续播放
+ * 参数说明:
+ *   paused - true 暂停，false 继续
+ * 返回值: 无
+ * 备注: 播放器按实时速度推送帧，导出暂停期间须同时暂停播放，
+ *       否则视频表面的帧队列会持续增长。因高水位暂停期间继续导出时
+ *       不恢复播放，由 readFrame 在队列回落后恢复
+ ***********************************************************/
+void qtFrameSource::setPaused(bool paused)
+{
+    exportPaused = paused;
+    if (mediaPlayer == nullptr || finished)
+    {
+        return;
+    }
+    if (paused)
+    {
+        mediaPlayer->pause();
+    }
+    else if (!throttled)
+    {
+        mediaPlayer->play();
+    }
+}
+
+/***********************************************************
+ * 函数名称: peakQueuedFrames
+ * 函数功能: 获取帧队列曾达到的最大长度
+ * 参数说明: 无
+ * 返回值: 本次 open() 以来帧队列的最大长度
+ * 备注: 用于验证消费慢于播放时队列受高水位约束
+ ***********************************************************/
+int qtFrameSource::peakQueuedFrames() const
+{
+    return surface != nullptr ? qMax(peakQueued, surface->peakQueued) : peakQueued;
+}
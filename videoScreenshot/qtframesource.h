@@ -0,0 +1,121 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: qtframesource.h
+ *
+ * 模块描述:
+ *   该模块定义了基于 Qt 多媒体的帧源。QMediaPlayer 在 open() 中创建，
+ *   因此属于调用 open() 的导出线程；解码后的帧输出到自定义视频表面，
+ *   readFrame() 在导出线程上驱动事件循环直到取得下一帧。
+ *
+ * 主要功能:
+ *   1. 在导出线程上创建并驱动 QMediaPlayer
+ *   2. 通过视频表面接收解码帧，不依赖 QVideoProbe
+ *   3. 将 QVideoFrame 映射为帧视图
+ *
+ * 函数列表:
+ *   1. frameGrabSurface          - 接收解码帧的视频表面
+ *   2. qtFrameSource             - 构造函数
+ *   3. ~qtFrameSource            - 析构函数，释放播放器
+ *   4. open                      - 打开视频文件并开始播放
+ *   5. close                     - 停止播放并释放播放器
+ *   6. readFrame                 - 读取下一帧
+ *   7. mapFrame                  - 将 QVideoFrame 映射为帧视图
+ *   8. setPaused                 - 暂停/继续播放
+ *   9. peakQueuedFrames          - 获取帧队列曾达到的最大长度
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 声明不提供关键帧标记，关键帧导出时由导出线程按时间间隔退化处理
+ *     * 导出暂停时暂停播放器；等待可被线程中断请求打断，新帧超时视为出错
+ *     * 帧队列达到上限时暂停播放器，读取使队列回落后继续播放，
+ *       消费慢于实时播放时内存不再随视频长度增长
+ ***********************************************************/
+
+#ifndef QTFRAMESOURCE_H
+#define QTFRAMESOURCE_H
+
+#include <QAbstractVideoSurface>
+#include <QImage>
+#include <QMediaPlayer>
+#include <QQueue>
+#include <QVideoFrame>
+#include "framesource.h"
+
+// 接收解码帧的视频表面，present() 在表面所属线程上被调用
+class frameGrabSurface : public QAbstractVideoSurface
+{
+    Q_OBJECT
+
+public:
+    static const int MAX_QUEUED_FRAMES = 8;    // 帧队列高水位，达到时请求暂停播放
+    static const int RESUME_QUEUED_FRAMES = 2; // 帧队列低水位，读取后回落到此时继续播放
+
+    explicit frameGrabSurface(QObject *parent = nullptr) : QAbstractVideoSurface(parent), peakQueued(0) {}
+
+    QList<QVideoFrame::PixelFormat> supportedPixelFormats(
+        QAbstractVideoBuffer::HandleType handleType = QAbstractVideoBuffer::NoHandle) const override;
+    bool present(const QVideoFrame &frame) override;
+
+    QQueue<QVideoFrame> frames; // 已收到尚未读取的帧
+    int peakQueued;             // 帧队列曾达到的最大长度
+
+signals:
+    void queueFull(); // 帧队列达到高水位
+};
+
+class qtFrameSource : public frameSource
+{
+public:
+    qtFrameSource();
+    ~qtFrameSource();
+
+    bool open(const QString &path) override;   // 打开视频文件并开始播放
+    void close() override;                     // 停止播放并释放播放器
+    bool readFrame(frameView &frame) override; // 读取下一帧
+
+    int width() const override { return frameWidth; }          // 帧宽度
+    int height() const override { return frameHeight; }        // 帧高度
+    double frameRate() const override { return fps; }          // 帧率
+    qint64 frameCount() const override;                        // 按时长和帧率估算总帧数
+    qint64 durationMs() const override { return duration; }    // 视频时长
+    QString errorString() const override { return error; }     // 错误描述
+    bool hasKeyframeFlags() const override { return false; } // Qt 多媒体不提供帧类型
+    QString backendName() const override { return "qt"; }      // 后端名称
+    void setPaused(bool paused) override;                      // 暂停/继续播放
+    int peakQueuedFrames() const;                              // 帧队列曾达到的最大长度
+
+private:
+    bool mapFrame(frameView &frame); // 将 QVideoFrame 映射为帧视图
+
+    QMediaPlayer *mediaPlayer; // 媒体播放器，在 open() 所在线程创建
+    frameGrabSurface *surface; // 接收解码帧的视频表面
+    QVideoFrame currentFrame;  // 当前映射中的帧，下一次读取前保持映射
+    QImage fallbackImage;      // 非 YUV/RGB32 帧转换后的图像
+    int frameWidth;            // 帧宽度
+    int frameHeight;           // 帧高度
+    double fps;                // 帧率
+    qint64 duration;           // 视频时长(毫秒)
+    qint64 nextIndex;          // 下一帧序号
+    bool finished;             // 播放是否已结束
+    bool throttled;            // 是否因帧队列达到高水位而暂停了播放器
+    bool exportPaused;         // 导出是否处于暂停状态
+    int peakQueued;            // 已关闭的播放器的帧队列最大长度
+    QString error;             // 错误描述
+};
+
+#endif // QTFRAMESOURCE_H
@@ -0,0 +1,423 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: quotasampler.cpp
+ *
+ * 模块描述:
+ *   该模块实现了整批导出的配额采样器。
+ *
+ * 主要功能:
+ *   1. 按视频或机位分组统计候选帧
+ *   2. 带上限的注水式配额分配，未用完的配额重新分配
+ *   3. 流式等间隔挑选，生成平衡后的计划文件
+ *
+ * 函数列表:
+ *   1. quotaSampler              - 构造函数
+ *   2. groupOf                   - 获取视频所属的分组
+ *   3. addCandidate              - 第一遍: 统计一个候选帧
+ *   4. allocate                  - 按目标总数为各分组和视频分配配额
+ *   5. accept                    - 第二遍: 判断一个候选帧是否选中
+ *   6. summary                   - 生成各分组的配额说明
+ *   7. balancePlan               - 流式读取两遍计划文件并写出平衡后的计划
+ *   8. waterFill                 - 带上限的注水式分配
+ *   9. readVideo                 - 读取计划文件一行的视频路径
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#include "quotasampler.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPair>
+#include <QSaveFile>
+#include <algorithm>
+#include <cmath>
+
+/***********************************************************
+ * 函数名称: readVideo
+ * 函数功能: 读取计划文件一行的视频路径
+ * 参数说明:
+ *   line  - 去掉首尾空白的一行
+ *   video - 返回视频路径
+ * 返回值: 格式正确返回 true
+ * 备注: 只取 video 字段，选中的行原样写出，不重新序列化
+ ***********************************************************/
+static bool readVideo(const QByteArray &line, QString &video)
+{
+    const QJsonObject object = QJsonDocument::fromJson(line).object();
+    if (!object.contains("video"))
+    {
+        return false;
+    }
+    video = object["video"].toString();
+    return !video.isEmpty();
+}
+
+/***********************************************************
+ * 函数名称: quotaSampler
+ * 函数功能: 配额采样器的构造函数
+ * 参数说明:
+ *   settings - 采样参数
+ * 返回值: 无
+ * 备注: 无
+ ***********************************************************/
+quotaSampler::quotaSampler(const options &settings) : config(settings)
+{
+    config.cameraLevel = qMax(1, config.cameraLevel);
+}
+
+/***********************************************************
+ * 函数名称: groupOf
+ * 函数功能: 获取视频所属的分组
+ * 参数说明:
+ *   video - 视频文件路径
+ * 返回值: 按视频分组时为视频路径，按机位分组时为上级目录路径
+ * 备注: 只处理路径文本，不访问文件系统，计划中的视频可以不在本机
+ ***********************************************************/
+QString quotaSampler::groupOf(const QString &video) const
+{
+    if (config.grouping == GROUP_VIDEO)
+    {
+        return video;
+    }
+    QString directory = QFileInfo(video).path();
+    for (int i = 1; i < config.cameraLevel; ++i)
+    {
+        directory = QFileInfo(directory).path();
+    }
+    return directory;
+}
+
+/***********************************************************
+ * 函数名称: addCandidate
+ * 函数功能: 第一遍: 统计一个候选帧
+ * 参数说明:
+ *   video - 候选帧所属的视频
+ * 返回值: 无
+ * 备注: 每个视频和分组只保存计数
+ ***********************************************************/
+void quotaSampler::addCandidate(const QString &video)
+{
+    int index = sourceOfVideo.value(video, -1);
+    if (index < 0)
+    {
+        const QString name = groupOf(video);
+        int groupIndex = groupOfName.value(name, -1);
+        if (groupIndex < 0)
+        {
+            group created;
+            created.name = name;
+            created.candidates = 0;
+            created.quota = 0;
+            groups.append(created);
+            groupIndex = groups.size() - 1;
+            groupOfName.insert(name, groupIndex);
+        }
+
+        source item;
+        item.group = groupIndex;
+        item.candidates = 0;
+        item.quota = 0;
+        item.seen = 0;
+        item.taken = 0;
+        sources.append(item);
+        index = sources.size() - 1;
+        sourceOfVideo.insert(video, index);
+        groups[groupIndex].sources.append(index);
+    }
+    sources[index].candidates++;
+    groups[sources[index].group].candidates++;
+}
+
+/***********************************************************
+ * 函数名称: waterFill
+ * 函数功能: 带上限的注水式分配
+ * 参数说明:
+ *   capacity - 各来源最多可分配的数量
+ *   weight   - 各来源的权重
+ *   total    - 要分配的总数
+ * 返回值: 各来源分配到的数量，总和不超过 total 和容量之和
+ * 备注: 按权重计算份额，份额不小于容量的来源直接取满并退出，
+ *       剩余数量在其他来源之间重新计算份额，直到没有来源取满；
+ *       最后按份额取整，余数按小数部分从大到小逐个补齐
+ ***********************************************************/
+QVector<qint64> quotaSampler::waterFill(const QVector<qint64> &capacity, const QVector<double> &weight, qint64 total)
+{
+    const int count = capacity.size();
+    QVector<qint64> result(count, 0);
+    QVector<bool> active(count, false);
+    for (int i = 0; i < count; ++i)
+    {
+        active[i] = capacity[i] > 0 && weight[i] > 0;
+    }
+
+    qint64 remaining = total;
+    while (remaining > 0)
+    {
+        double weightSum = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            if (active[i])
+            {
+                weightSum += weight[i];
+            }
+        }
+        if (weightSum <= 0)
+        {
+            break;
+        }
+
+        bool saturated = false;
+        for (int i = 0; i < count; ++i)
+        {
+            if (active[i] && static_cast<double>(capacity[i]) <= remaining * weight[i] / weightSum)
+            {
+                result[i] = capacity[i];
+                active[i] = false;
+                saturated = true;
+            }
+        }
+        if (saturated)
+        {
+            remaining = total;
+            for (int i = 0; i < count; ++i)
+            {
+                remaining -= result[i];
+            }
+            continue;
+        }
+
+        // 没有来源会取满，份额加一也不超过容量
+        QVector<QPair<double, int>> fractions;
+        qint64 assigned = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            if (active[i])
+            {
+                const double exact = remaining * weight[i] / weightSum;
+                const qint64 share = static_cast<qint64>(std::floor(exact));
+                result[i] = share;
+                assigned += share;
+                fractions.append(qMakePair(exact - share, i));
+            }
+        }
+        std::sort(fractions.begin(), fractions.end(), [](const QPair<double, int> &a, const QPair<double, int> &b)
+                  { return a.first > b.first || (a.first == b.first && a.second < b.second); });
+        for (int k = 0; k < fractions.size() && assigned < remaining; ++k, ++assigned)
+        {
+            result[fractions[k].second]++;
+        }
+        break;
+    }
+    return result;
+}
+
+/***********************************************************
+ * 函数名称: allocate
+ * 函数功能: 按目标总数为各分组和视频分配配额
+ * 参数说明: 无
+ * 返回值: 实际分配的总数，候选帧不足时小于目标总数
+ * 备注: 先在分组之间分配，再在组内各视频之间分配，两级使用同一分配方式；
+ *       分组的容量为候选帧数与配额上限的较小者，候选帧少于份额的分组和
+ *       没有候选帧的分组用不完的配额分给其他分组；目标总数为 0 时各组取满容量
+ ***********************************************************/
+qint64 quotaSampler::allocate()
+{
+    QVector<qint64> capacity(groups.size());
+    QVector<double> weight(groups.size());
+    qint64 capacitySum = 0;
+    for (int i = 0; i < groups.size(); ++i)
+    {
+        const qint64 limit = config.quotas.value(groups[i].name, config.maxPerGroup);
+        capacity[i] = limit > 0 ? qMin(limit, groups[i].candidates) : groups[i].candidates;
+        weight[i] = config.allocation == ALLOCATE_PROPORTIONAL ? static_cast<double>(groups[i].candidates) : 1.0;
+        capacitySum += capacity[i];
+    }
+    const QVector<qint64> groupQuota = waterFill(capacity, weight, config.target > 0 ? config.target : capacitySum);
+
+    qint64 allocated = 0;
+    for (int i = 0; i < groups.size(); ++i)
+    {
+        group &item = groups[i];
+        item.quota = groupQuota[i];
+        QVector<qint64> sourceCapacity(item.sources.size());
+        QVector<double> sourceWeight(item.sources.size());
+        for (int j = 0; j < item.sources.size(); ++j)
+        {
+            const source &member = sources[item.sources[j]];
+            sourceCapacity[j] = member.candidates;
+            sourceWeight[j] = config.allocation == ALLOCATE_PROPORTIONAL ? static_cast<double>(member.candidates) : 1.0;
+        }
+        const QVector<qint64> sourceQuota = waterFill(sourceCapacity, sourceWeight, item.quota);
+        for (int j = 0; j < item.sources.size(); ++j)
+        {
+            source &member = sources[item.sources[j]];
+            member.quota = sourceQuota[j];
+            member.seen = 0;
+            member.taken = 0;
+        }
+        allocated += item.quota;
+    }
+    return allocated;
+}
+
+/***********************************************************
+ * 函数名称: accept
+ * 函数功能: 第二遍: 判断一个候选帧是否选中
+ * 参数说明:
+ *   video - 候选帧所属的视频
+ * 返回值: 选中返回 true
+ * 备注: 视频的 n 个候选帧中选 q 个时，第 k 个选中位置为 (2k+1)n/(2q)，
+ *       各位置在视频内等间隔分布，只需已读数和已选数两个计数；
+ *       第一遍未出现的视频不选
+ ***********************************************************/
+bool quotaSampler::accept(const QString &video)
+{
+    const int index = sourceOfVideo.value(video, -1);
+    if (index < 0)
+    {
+        return false;
+    }
+    source &item = sources[index];
+    bool selected = false;
+    if (item.taken < item.quota)
+    {
+        const qint64 next = (2 * item.taken + 1) * item.candidates / (2 * item.quota);
+        selected = item.seen == next;
+    }
+    item.seen++;
+    if (selected)
+    {
+        item.taken++;
+    }
+    return selected;
+}
+
+/***********************************************************
+ * 函数名称: summary
+ * 函数功能: 生成各分组的配额说明
+ * 参数说明: 无
+ * 返回值: 每组一行: 分组名、配额、候选帧数和视频数
+ * 备注: 用于命令行输出，按分组首次出现的顺序排列
+ ***********************************************************/
+QStringList quotaSampler::summary() const
+{
+    QStringList lines;
+    for (const group &item : groups)
+    {
+        lines.append(QString("%1: %2 of %3 candidates from %4 video(s)")
+                         .arg(item.name)
+                         .arg(item.quota)
+                         .arg(item.candidates)
+                         .arg(item.sources.size()));
+    }
+    return lines;
+}
+
+/***********************************************************
+ * 函数名称: balancePlan
+ * 函数功能: 流式读取两遍计划文件并写出平衡后的计划
+ * 参数说明:
+ *   inputFile  - 候选帧计划文件，通常以较密的间隔规划整批视频得到
+ *   outputFile - 平衡后的计划文件，已存在时整体替换
+ *   settings   - 采样参数
+ *   report     - 返回各分组的配额说明，可为空
+ *   error      - 返回错误描述，可为空
+ * 返回值: 成功返回 true
+ * 备注: 两遍都逐行读取，不保存条目；选中的行原样写出，
+ *       输出经 QSaveFile 写入，失败时不留下不完整的计划
+ ***********************************************************/
+bool quotaSampler::balancePlan(const QString &inputFile, const QString &outputFile,
+                               const options &settings, QStringList *report, QString *error)
+{
+    if (QFileInfo(inputFile).absoluteFilePath() == QFileInfo(outputFile).absoluteFilePath())
+    {
+        if (error != nullptr)
+        {
+            *error = "output plan must differ from the input plan";
+        }
+        return false;
+    }
+    QFile input(inputFile);
+    if (!input.open(QIODevice::ReadOnly))
+    {
+        if (error != nullptr)
+        {
+            *error = input.errorString();
+        }
+        return false;
+    }
+
+    // 第一遍: 只统计各视频的候选帧数
+    quotaSampler sampler(settings);
+    int lineNumber = 0;
+    QString video;
+    while (!input.atEnd())
+    {
+        const QByteArray line = input.readLine().trimmed();
+        lineNumber++;
+        if (line.isEmpty())
+        {
+            continue;
+        }
+        if (!readVideo(line, video))
+        {
+            if (error != nullptr)
+            {
+                *error = QString("%1:%2: malformed entry").arg(inputFile).arg(lineNumber);
+            }
+            return false;
+        }
+        sampler.addCandidate(video);
+    }
+    sampler.allocate();
+    if (report != nullptr)
+    {
+        *report = sampler.summary();
+    }
+
+    // 第二遍: 按配额挑选并原样写出
+    QSaveFile output(outputFile);
+    if (!input.seek(0) || !output.open(QIODevice::WriteOnly))
+    {
+        if (error != nullptr)
+        {
+            *error = output.errorString();
+        }
+        return false;
+    }
+    while (!input.atEnd())
+    {
+        const QByteArray line = input.readLine().trimmed();
+        if (!line.isEmpty() && readVideo(line, video) && sampler.accept(video))
+        {
+            output.write(line);
+            output.write("\n", 1);
+        }
+    }
+    if (!output.commit())
+    {
+        if (error != nullptr)
+        {
+            *error = output.errorString();
+        }
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,125 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: quotasampler.h
+ *
+ * 模块描述:
+ *   该模块定义了整批导出的配额采样器。按视频独立的等间隔/随机导出会让
+ *   长视频在数据集中占大多数；配额采样器面向整个计划文件，按目标总数
+ *   在各视频或各机位之间平均或按候选帧数比例分配配额，候选帧不足或
+ *   全部被过滤的来源用不完的配额重新分给其他来源。
+ *   计划文件流式读取两遍: 第一遍只统计每个来源的候选帧数，第二遍按配额
+ *   在各来源内等间隔挑选条目并原样写出，内存只与来源数有关，与帧数无关。
+ *
+ * 主要功能:
+ *   1. 按视频或机位(视频所在的上级目录)分组统计候选帧
+ *   2. 带上限的注水式配额分配，未用完的配额重新分配
+ *   3. 流式等间隔挑选，生成平衡后的计划文件
+ *
+ * 函数列表:
+ *   1. quotaSampler              - 构造函数
+ *   2. groupOf                   - 获取视频所属的分组
+ *   3. addCandidate              - 第一遍: 统计一个候选帧
+ *   4. allocate                  - 按目标总数为各分组和视频分配配额
+ *   5. accept                    - 第二遍: 判断一个候选帧是否选中
+ *   6. summary                   - 生成各分组的配额说明
+ *   7. balancePlan               - 流式读取两遍计划文件并写出平衡后的计划
+ *   8. waterFill                 - 带上限的注水式分配
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#ifndef QUOTASAMPLER_H
+#define QUOTASAMPLER_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class quotaSampler
+{
+public:
+    // 配额在来源之间的分配方式
+    enum Allocation
+    {
+        ALLOCATE_EQUAL = 0,   // 各来源平均分配
+        ALLOCATE_PROPORTIONAL // 按各来源的候选帧数比例分配
+    };
+
+    // 配额分组方式
+    enum Grouping
+    {
+        GROUP_VIDEO = 0, // 每个视频一组
+        GROUP_CAMERA     // 按视频所在的上级目录分组，组内各视频再分配
+    };
+
+    struct options
+    {
+        qint64 target;                 // 目标总帧数
+        Allocation allocation;         // 分配方式
+        Grouping grouping;             // 分组方式
+        int cameraLevel;               // 机位目录的层级，1 为视频所在目录，2 为再上一级
+        qint64 maxPerGroup;            // 每组配额上限，0 为不限
+        QHash<QString, qint64> quotas; // 指定分组的配额上限，覆盖 maxPerGroup
+
+        options() : target(0), allocation(ALLOCATE_EQUAL), grouping(GROUP_VIDEO), cameraLevel(1), maxPerGroup(0) {}
+    };
+
+    explicit quotaSampler(const options &settings);
+
+    QString groupOf(const QString &video) const; // 获取视频所属的分组
+    void addCandidate(const QString &video);     // 第一遍: 统计一个候选帧
+    qint64 allocate();                           // 为各分组和视频分配配额，返回实际分配的总数
+    bool accept(const QString &video);           // 第二遍: 判断一个候选帧是否选中
+    QStringList summary() const;                 // 生成各分组的配额说明，每组一行
+
+    static bool balancePlan(const QString &inputFile, const QString &outputFile,
+                            const options &settings, QStringList *report = nullptr,
+                            QString *error = nullptr); // 流式读取两遍计划文件并写出平衡后的计划
+
+private:
+    // 一个视频的计数
+    struct source
+    {
+        int group;         // 所属分组序号
+        qint64 candidates; // 候选帧数
+        qint64 quota;      // 分配的配额
+        qint64 seen;       // 第二遍已读到的候选帧数
+        qint64 taken;      // 第二遍已选中的帧数
+    };
+
+    // 一个分组的计数
+    struct group
+    {
+        QString name;          // 分组名称
+        QVector<int> sources;  // 组内视频在 sources 中的序号
+        qint64 candidates;     // 组内候选帧数
+        qint64 quota;          // 分配的配额
+    };
+
+    static QVector<qint64> waterFill(const QVector<qint64> &capacity, const QVector<double> &weight,
+                                     qint64 total); // 带上限的注水式分配
+
+    options config;                    // 采样参数
+    QVector<source> sources;           // 全部视频
+    QVector<group> groups;             // 全部分组
+    QHash<QString, int> sourceOfVideo; // 视频路径到 sources 序号
+    QHash<QString, int> groupOfName;   // 分组名称到 groups 序号
+};
+
+#endif // QUOTASAMPLER_H
@@ -0,0 +1,125 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: rangeslider.cpp
+ *
+ * 模块描述:
+ *   该模块实现了带导出时间段标记的进度条。
+ *
+ * 主要功能:
+ *   1. 设置要显示的导出时间段和待配对的入点
+ *   2. 在滑槽上绘制时间段和入点标记
+ *
+ * 函数列表:
+ *   1. rangeSlider               - 构造函数
+ *   2. setRanges                 - 设置要显示的导出时间段
+ *   3. setPendingIn              - 设置待配对的入点
+ *   4. paintEvent                - 绘制进度条和时间段标记
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#include "rangeslider.h"
+#include <QPainter>
+#include <QStyle>
+#include <QStyleOptionSlider>
+
+/***********************************************************
+ * 函数名称: rangeSlider
+ * 函数功能: 带时间段标记的进度条的构造函数
+ * 参数说明:
+ *   orientation - 方向，只支持水平方向的标记
+ *   parent      - 父窗口指针,默认为nullptr
+ * 返回值: 无
+ * 备注: 无
+ ***********************************************************/
+rangeSlider::rangeSlider(Qt::Orientation orientation, QWidget *parent) : QSlider(orientation, parent),
+                                                                          pendingInMs(-1)
+{
+}
+
+/***********************************************************
+ * 函数名称: setRanges
+ * 函数功能: 设置要显示的导出时间段
+ * 参数说明:
+ *   list - 导出时间段
+ * 返回值: 无
+ * 备注: 无
+ ***********************************************************/
+void rangeSlider::setRanges(const QVector<timeRange> &list)
+{
+    ranges = list;
+    update();
+}
+
+/***********************************************************
+ * 函数名称: setPendingIn
+ * 函数功能: 设置待配对的入点
+ * 参数说明:
+ *   positionMs - 入点(毫秒)，-1 为无
+ * 返回值: 无
+ * 备注: 已标记入点、尚未标记出点时显示为一条竖线
+ ***********************************************************/
+void rangeSlider::setPendingIn(qint64 positionMs)
+{
+    pendingInMs = positionMs;
+    update();
+}
+
+/***********************************************************
+ * 函数名称: paintEvent
+ * 函数功能: 绘制进度条和时间段标记
+ * 参数说明:
+ *   event - 绘制事件
+ * 返回值: 无
+ * 备注: 先按样式绘制普通进度条，再在滑槽上叠加半透明的时间段色块；
+ *       位置换算与滑块一致，扣除滑块宽度
+ ***********************************************************/
+void rangeSlider::paintEvent(QPaintEvent *event)
+{
+    QSlider::paintEvent(event);
+    if ((ranges.isEmpty() && pendingInMs < 0) || maximum() <= minimum())
+    {
+        return;
+    }
+
+    QStyleOptionSlider option;
+    initStyleOption(&option);
+    const QRect groove = style()->subControlRect(QStyle::CC_Slider, &option, QStyle::SC_SliderGroove, this);
+    const QRect handle = style()->subControlRect(QStyle::CC_Slider, &option, QStyle::SC_SliderHandle, this);
+    const int span = groove.width() - handle.width();
+    const int origin = groove.left() + handle.width() / 2;
+    auto positionOf = [&](qint64 ms)
+    {
+        const int value = static_cast<int>(qBound<qint64>(minimum(), ms, maximum()));
+        return origin + QStyle::sliderPositionFromValue(minimum(), maximum(), value, span);
+    };
+
+    QPainter painter(this);
+    for (const timeRange &range : ranges)
+    {
+        const int left = positionOf(range.beginUs / 1000);
+        const int right = positionOf(range.endUs / 1000);
+        painter.fillRect(QRect(left, groove.top(), qMax(1, right - left), groove.height()),
+                         QColor(0, 160, 80, 140));
+    }
+    if (pendingInMs >= 0)
+    {
+        const int x = positionOf(pendingInMs);
+        painter.fillRect(QRect(x - 1, groove.top(), 2, groove.height()), QColor(220, 120, 0));
+    }
+}
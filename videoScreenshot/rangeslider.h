@@ -0,0 +1,62 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: rangeslider.h
+ *
+ * 模块描述:
+ *   该模块定义了带导出时间段标记的进度条。在普通进度条的滑槽上
+ *   画出已标记的导出时间段和尚未配对的入点，滑块取值为毫秒。
+ *
+ * 主要功能:
+ *   1. 设置要显示的导出时间段和待配对的入点
+ *   2. 在滑槽上绘制时间段和入点标记
+ *
+ * 函数列表:
+ *   1. rangeSlider               - 构造函数
+ *   2. setRanges                 - 设置要显示的导出时间段
+ *   3. setPendingIn              - 设置待配对的入点
+ *   4. paintEvent                - 绘制进度条和时间段标记
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#ifndef RANGESLIDER_H
+#define RANGESLIDER_H
+
+#include <QSlider>
+#include <QVector>
+#include "timerange.h"
+
+class rangeSlider : public QSlider
+{
+    Q_OBJECT
+
+public:
+    explicit rangeSlider(Qt::Orientation orientation, QWidget *parent = nullptr);
+
+    void setRanges(const QVector<timeRange> &list); // 设置要显示的导出时间段
+    void setPendingIn(qint64 positionMs);           // 设置待配对的入点(毫秒)，-1 为无
+
+protected:
+    void paintEvent(QPaintEvent *event) override; // 绘制进度条和时间段标记
+
+private:
+    QVector<timeRange> ranges; // 要显示的导出时间段
+    qint64 pendingInMs;        // 待配对的入点(毫秒)，-1 为无
+};
+
+#endif // RANGESLIDER_H
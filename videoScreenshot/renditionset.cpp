@@ -0,0 +1,137 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: renditionset.cpp
+ *
+ * 模块描述:
+ *   该模块实现了多分辨率版本集合。
+ *
+ * 主要功能:
+ *   1. 解析 "名称:边长:格式[:质量]" 形式的版本配置
+ *   2. 由一帧级联缩小生成全部版本
+ *
+ * 函数列表:
+ *   1. parse                     - 解析一个版本配置
+ *   2. setRenditions             - 设置版本列表
+ *   3. build                     - 由一帧生成全部版本
+ *   4. targetSize                - 计算版本的目标尺寸
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#include "renditionset.h"
+#include <QStringList>
+#include <algorithm>
+#include <climits>
+
+/***********************************************************
+ * 函数名称: parse
+ * 函数功能: 解析一个版本配置
+ * 参数说明:
+ *   spec  - "名称:边长:格式[:质量]"，如 "train:640:jpg:90"，边长 0 为原始尺寸
+ *   item  - 返回解析出的版本
+ *   error - 失败时返回错误描述，可为空
+ * 返回值: 成功返回 true
+ * 备注: 名称用作子目录名，不能包含路径分隔符
+ ***********************************************************/
+bool renditionSet::parse(const QString &spec, rendition &item, QString *error)
+{
+    const QStringList fields = spec.split(':');
+    bool sizeOk = false;
+    bool qualityOk = true;
+    item.name = fields.value(0).trimmed();
+    item.maxSize = fields.value(1).toInt(&sizeOk);
+    item.format = fields.value(2).trimmed().toLower().toLatin1();
+    item.quality = fields.size() > 3 ? fields[3].toInt(&qualityOk) : -1;
+    if (fields.size() < 3 || fields.size() > 4 || item.name.isEmpty() || item.name.contains('/') ||
+        item.name.contains('\\') || !sizeOk || item.maxSize < 0 || item.format.isEmpty() || !qualityOk)
+    {
+        if (error)
+        {
+            *error = QStringLiteral("版本配置应为 名称:边长:格式[:质量]，实际为 \"%1\"").arg(spec);
+        }
+        return false;
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: setRenditions
+ * 函数功能: 设置版本列表
+ * 参数说明:
+ *   list - 版本列表
+ * 返回值: 无
+ * 备注: 预先按尺寸从大到小排好级联顺序，原始尺寸排在最前
+ ***********************************************************/
+void renditionSet::setRenditions(const QVector<rendition> &list)
+{
+    items = list;
+    order.clear();
+    for (int i = 0; i < items.size(); ++i)
+    {
+        order.append(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b)
+                     {
+                         const int sizeA = items[a].maxSize > 0 ? items[a].maxSize : INT_MAX;
+                         const int sizeB = items[b].maxSize > 0 ? items[b].maxSize : INT_MAX;
+                         return sizeA > sizeB; });
+}
+
+/***********************************************************
+ * 函数名称: targetSize
+ * 函数功能: 计算版本的目标尺寸
+ * 参数说明:
+ *   frameSize - 原帧尺寸
+ *   maxSize   - 最长边，0 为原始尺寸
+ * 返回值: 等比缩放后的尺寸，不放大
+ * 备注: 无
+ ***********************************************************/
+QSize renditionSet::targetSize(const QSize &frameSize, int maxSize)
+{
+    if (maxSize <= 0 || qMax(frameSize.width(), frameSize.height()) <= maxSize)
+    {
+        return frameSize;
+    }
+    return frameSize.scaled(maxSize, maxSize, Qt::KeepAspectRatio);
+}
+
+/***********************************************************
+ * 函数名称: build
+ * 函数功能: 由一帧生成全部版本
+ * 参数说明:
+ *   frame - 已转换的整帧图像
+ * 返回值: 各版本图像，顺序与版本列表一致
+ * 备注: 从大到小依次缩小，每个版本从上一个较大的版本缩出，
+ *       缩略图只需处理训练图大小的像素；与原帧同尺寸的版本直接
+ *       共享原帧缓冲区，不复制
+ ***********************************************************/
+QVector<QImage> renditionSet::build(const QImage &frame) const
+{
+    QVector<QImage> images(items.size());
+    QImage current = frame;
+    for (int index : order)
+    {
+        const QSize target = targetSize(frame.size(), items[index].maxSize);
+        if (target != current.size())
+        {
+            current = current.scaled(target, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+        images[index] = current;
+    }
+    return images;
+}
@@ -0,0 +1,74 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: renditionset.h
+ *
+ * 模块描述:
+ *   该模块定义了多分辨率版本集合。每个选中帧只解码和转换一次，
+ *   按配置生成若干版本(如原图归档、640 训练图、缩略图)，各版本有
+ *   自己的尺寸、格式和质量。版本按尺寸从大到小级联缩小，每个版本
+ *   从上一个较大的版本缩出，而不是都从原图缩出。
+ *
+ * 主要功能:
+ *   1. 解析 "名称:边长:格式[:质量]" 形式的版本配置
+ *   2. 由一帧级联缩小生成全部版本
+ *
+ * 函数列表:
+ *   1. parse                     - 解析一个版本配置
+ *   2. setRenditions             - 设置版本列表
+ *   3. build                     - 由一帧生成全部版本
+ *   4. targetSize                - 计算版本的目标尺寸
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#ifndef RENDITIONSET_H
+#define RENDITIONSET_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+class renditionSet
+{
+public:
+    // 一个输出版本
+    struct rendition
+    {
+        QString name;      // 版本名称，作为输出子目录名
+        int maxSize;       // 最长边(像素)，0 为原始尺寸
+        QByteArray format; // 图像格式后缀
+        int quality;       // 图像质量，-1 为编码器默认
+    };
+
+    static bool parse(const QString &spec, rendition &item,
+                      QString *error = nullptr);        // 解析一个版本配置
+    void setRenditions(const QVector<rendition> &list); // 设置版本列表
+    bool isEnabled() const { return !items.isEmpty(); } // 是否配置了多个版本
+    const QVector<rendition> &renditions() const { return items; } // 版本列表
+
+    QVector<QImage> build(const QImage &frame) const;   // 由一帧生成全部版本，顺序与版本列表一致
+    static QSize targetSize(const QSize &frameSize, int maxSize); // 计算版本的目标尺寸
+
+private:
+    QVector<rendition> items; // 版本列表，按配置顺序
+    QVector<int> order;       // 按尺寸从大到小排列的版本下标
+};
+
+#endif // RENDITIONSET_H
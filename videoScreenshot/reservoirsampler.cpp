@@ -0,0 +1,194 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: reservoirsampler.cpp
+ *
+ * 模块描述:
+ *   该模块实现了带种子的蓄水池采样器。
+ *
+ * 主要功能:
+ *   1. 按种子初始化采样状态
+ *   2. 逐帧判断是否入池以及替换的槽位
+ *   3. 保存入池帧的压缩数据，结束时按帧号顺序取出
+ *
+ * 函数列表:
+ *   1. reservoirSampler          - 构造函数
+ *   2. reset                     - 设置容量和种子并清空
+ *   3. offer                     - 提交下一帧，返回入池槽位
+ *   4. store                     - 保存入池帧的压缩数据
+ *   5. takeSorted                - 按帧号顺序取出全部入池帧
+ *   6. nextUniform               - 生成 (0,1) 区间的均匀随机数
+ *   7. advance                   - 计算下一个入池位置
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 入池帧记录时间戳，只做规划时可以不保存图像数据
+ ***********************************************************/
+
+#include "reservoirsampler.h"
+#include <algorithm>
+#include <cmath>
+
+/***********************************************************
+ * 函数名称: reservoirSampler
+ * 函数功能: 蓄水池采样器的构造函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 默认容量为 0，使用前需调用 reset()
+ ***********************************************************/
+reservoirSampler::reservoirSampler() : capacity(0),
+                                       itemsSeen(0),
+                                       nextAccept(0),
+                                       weight(0.0)
+{
+}
+
+/***********************************************************
+ * 函数名称: reset
+ * 函数功能: 设置容量和种子并清空
+ * 参数说明:
+ *   size - 池容量 k
+ *   seed - 随机种子
+ * 返回值: 无
+ * 备注: 前 k 帧必然入池，之后的入池位置由 L 算法跳跃计算
+ ***********************************************************/
+void reservoirSampler::reset(int size, quint64 seed)
+{
+    capacity = qMax(0, size);
+    entries.clear();
+    entries.reserve(capacity);
+    itemsSeen = 0;
+    nextAccept = 0;
+    rng.seed(seed);
+    weight = capacity > 0 ? std::exp(std::log(nextUniform()) / capacity) : 0.0;
+}
+
+/***********************************************************
+ * 函数名称: offer
+ * 函数功能: 提交下一帧，返回入池槽位
+ * 参数说明: 无
+ * 返回值: 入池时返回要写入的槽位，落选返回 -1
+ * 备注: 池未满时依次占用新槽位；池满后只有到达预先算出的位置才入池，
+ *       并随机替换一个槽位。落选判断只是一次整数比较
+ ***********************************************************/
+int reservoirSampler::offer()
+{
+    const qint64 position = itemsSeen++;
+    if (capacity <= 0)
+    {
+        return -1;
+    }
+    if (position < capacity)
+    {
+        entries.append(entry());
+        if (position == capacity - 1)
+        {
+            nextAccept = capacity;
+            advance();
+        }
+        return static_cast<int>(position);
+    }
+    if (position != nextAccept)
+    {
+        return -1;
+    }
+
+    const int slot = qMin(capacity - 1, static_cast<int>(nextUniform() * capacity));
+    weight *= std::exp(std::log(nextUniform()) / capacity);
+    nextAccept++;
+    advance();
+    return slot;
+}
+
+/***********************************************************
+ * 函数名称: store
+ * 函数功能: 保存入池帧的压缩数据
+ * 参数说明:
+ *   slot        - offer() 返回的槽位
+ *   frameNumber - 帧号
+ *   ptsUs       - 显示时间戳(微秒)
+ *   data        - 已编码的图像数据
+ * 返回值: 无
+ * 备注: 覆盖槽位中原有的帧，其内存随之释放
+ ***********************************************************/
+void reservoirSampler::store(int slot, qint64 frameNumber, qint64 ptsUs, const QByteArray &data)
+{
+    if (slot < 0 || slot >= entries.size())
+    {
+        return;
+    }
+    entries[slot].frameNumber = frameNumber;
+    entries[slot].ptsUs = ptsUs;
+    entries[slot].data = data;
+}
+
+/***********************************************************
+ * 函数名称: takeSorted
+ * 函数功能: 按帧号顺序取出全部入池帧
+ * 参数说明: 无
+ * 返回值: 按帧号升序排列的入池帧
+ * 备注: 取出后池被清空；编码失败未保存过帧的槽位被略去
+ ***********************************************************/
+QVector<reservoirSampler::entry> reservoirSampler::takeSorted()
+{
+    QVector<entry> result;
+    result.reserve(entries.size());
+    for (const entry &item : entries)
+    {
+        if (item.frameNumber >= 0)
+        {
+            result.append(item);
+        }
+    }
+    entries.clear();
+    std::sort(result.begin(), result.end(), [](const entry &a, const entry &b)
+              { return a.frameNumber < b.frameNumber; });
+    return result;
+}
+
+/***********************************************************
+ * 函数名称: nextUniform
+ * 函数功能: 生成 (0,1) 区间的均匀随机数
+ * 参数说明: 无
+ * 返回值: 开区间 (0,1) 内的随机数
+ * 备注: 取高 53 位并偏移半个单位，不使用实现相关的标准库分布，
+ *       保证不同编译器下相同种子得到相同序列，且结果不为 0 以便取对数
+ ***********************************************************/
+double reservoirSampler::nextUniform()
+{
+    return (static_cast<double>(rng() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+/***********************************************************
+ * 函数名称: advance
+ * 函数功能: 计算下一个入池位置
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: L 算法: 跳过的帧数服从参数为 W 的几何分布，
+ *       期望入池次数为 k(1 + ln(n/k))
+ ***********************************************************/
+void reservoirSampler::advance()
+{
+    const double denominator = std::log(1.0 - weight);
+    if (denominator >= 0.0)
+    {
+        return;
+    }
+    const double skip = std::floor(std::log(nextUniform()) / denominator);
+    // 防止极端情况下溢出，跳跃量足够大时等价于不再入池
+    nextAccept += skip < 4.0e18 ? static_cast<qint64>(skip) : static_cast<qint64>(4.0e18);
+}
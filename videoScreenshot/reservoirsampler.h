@@ -0,0 +1,88 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: reservoirsampler.h
+ *
+ * 模块描述:
+ *   该模块定义了带种子的蓄水池采样器，在单次遍历中从长度未知的帧序列里
+ *   等概率选出 k 帧。采用 Li 的 L 算法，提前算出下一个入池的位置，
+ *   落选的帧无需转换和编码。池中只保存 k 个已编码的压缩图像，
+ *   内存占用与视频长度无关。相同种子和相同输入得到相同结果。
+ *
+ * 主要功能:
+ *   1. 按种子初始化采样状态
+ *   2. 逐帧判断是否入池以及替换的槽位
+ *   3. 保存入池帧的压缩数据，结束时按帧号顺序取出
+ *
+ * 函数列表:
+ *   1. reservoirSampler          - 构造函数
+ *   2. reset                     - 设置容量和种子并清空
+ *   3. offer                     - 提交下一帧，返回入池槽位
+ *   4. store                     - 保存入池帧的压缩数据
+ *   5. takeSorted                - 按帧号顺序取出全部入池帧
+ *   6. nextUniform               - 生成 (0,1) 区间的均匀随机数
+ *   7. advance                   - 计算下一个入池位置
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 入池帧记录时间戳，只做规划时可以不保存图像数据
+ ***********************************************************/
+
+#ifndef RESERVOIRSAMPLER_H
+#define RESERVOIRSAMPLER_H
+
+#include <QByteArray>
+#include <QVector>
+#include <random>
+
+class reservoirSampler
+{
+public:
+    // 池中的一帧
+    struct entry
+    {
+        qint64 frameNumber; // 帧号，用于输出文件名和排序
+        qint64 ptsUs;       // 显示时间戳(微秒)
+        QByteArray data;    // 已编码的图像数据，只做规划时为空
+
+        entry() : frameNumber(-1), ptsUs(0) {}
+    };
+
+    reservoirSampler();
+
+    void reset(int capacity, quint64 seed);                   // 设置容量和种子并清空
+    int offer();                                              // 提交下一帧，返回入池槽位，落选返回 -1
+    void store(int slot, qint64 frameNumber, qint64 ptsUs,
+               const QByteArray &data);                       // 保存入池帧的压缩数据
+    QVector<entry> takeSorted();                              // 按帧号顺序取出全部入池帧
+
+    qint64 seen() const { return itemsSeen; }      // 已提交的帧数
+    int size() const { return entries.size(); }    // 当前池中帧数
+
+private:
+    double nextUniform(); // 生成 (0,1) 区间的均匀随机数
+    void advance();       // 计算下一个入池位置
+
+    QVector<entry> entries; // 池中的帧
+    int capacity;           // 池容量 k
+    qint64 itemsSeen;       // 已提交的帧数
+    qint64 nextAccept;      // 下一个入池的帧位置(从 0 开始)
+    double weight;          // L 算法的当前权重 W
+    std::mt19937_64 rng;    // 随机数发生器，算法由标准规定，跨平台结果一致
+};
+
+#endif // RESERVOIRSAMPLER_H
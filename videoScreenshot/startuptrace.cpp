@@ -0,0 +1,112 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: startuptrace.cpp
+ *
+ * 模块描述:
+ *   该模块实现了启动耗时追踪。
+ *
+ * 主要功能:
+ *   1. 记录各启动阶段的耗时
+ *   2. 启动完成后输出耗时列表
+ *
+ * 函数列表:
+ *   1. start                     - 开始计时
+ *   2. mark                      - 记录一个阶段结束
+ *   3. finish                    - 输出各阶段耗时并停止记录
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#include "startuptrace.h"
+#include <QElapsedTimer>
+#include <QPair>
+#include <QTextStream>
+#include <QVector>
+
+bool startupTrace::enabledFlag = false;
+
+namespace
+{
+    QElapsedTimer startupClock;                 // 从 start 开始计时
+    qint64 lastMarkNs = 0;                      // 上一个阶段结束的时间(纳秒)
+    QVector<QPair<QString, qint64>> phases;     // 各阶段名称和耗时(纳秒)
+}
+
+/***********************************************************
+ * 函数名称: start
+ * 函数功能: 开始计时
+ * 参数说明:
+ *   enabled - 是否记录
+ * 返回值: 无
+ * 备注: 应在 main 的第一行调用，第一个阶段从这里开始计时
+ ***********************************************************/
+void startupTrace::start(bool enabled)
+{
+    enabledFlag = enabled;
+    if (!enabled)
+    {
+        return;
+    }
+    phases.clear();
+    lastMarkNs = 0;
+    startupClock.start();
+}
+
+/***********************************************************
+ * 函数名称: mark
+ * 函数功能: 记录一个阶段结束
+ * 参数说明:
+ *   phase - 阶段名称
+ * 返回值: 无
+ * 备注: 未开启或已输出后直接返回
+ ***********************************************************/
+void startupTrace::mark(const QString &phase)
+{
+    if (!enabledFlag)
+    {
+        return;
+    }
+    const qint64 nowNs = startupClock.nsecsElapsed();
+    phases.append(qMakePair(phase, nowNs - lastMarkNs));
+    lastMarkNs = nowNs;
+}
+
+/***********************************************************
+ * 函数名称: finish
+ * 函数功能: 输出各阶段耗时并停止记录
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 每行一个阶段，毫秒保留两位小数，最后一行为总耗时
+ ***********************************************************/
+void startupTrace::finish()
+{
+    if (!enabledFlag)
+    {
+        return;
+    }
+    enabledFlag = false;
+
+    QTextStream err(stderr);
+    err << "startup trace:\n";
+    for (const QPair<QString, qint64> &phase : phases)
+    {
+        err << QString("  %1 %2 ms\n").arg(phase.first, -28).arg(phase.second / 1e6, 9, 'f', 2);
+    }
+    err << QString("  %1 %2 ms\n").arg("total", -28).arg(lastMarkNs / 1e6, 9, 'f', 2);
+    err.flush();
+}
@@ -0,0 +1,56 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: startuptrace.h
+ *
+ * 模块描述:
+ *   该模块定义了启动耗时追踪。以 --startup-trace 参数或
+ *   VIDEOSCREENSHOT_STARTUP_TRACE 环境变量开启后，启动过程中每个阶段
+ *   结束时记录一次，启动完成后在标准错误输出各阶段的耗时和总耗时，
+ *   用于发现冷启动变慢。未开启时每个记录点只有一次分支。
+ *   只在界面线程使用。
+ *
+ * 主要功能:
+ *   1. 记录各启动阶段的耗时
+ *   2. 启动完成后输出耗时列表
+ *
+ * 函数列表:
+ *   1. start                     - 开始计时
+ *   2. mark                      - 记录一个阶段结束
+ *   3. finish                    - 输出各阶段耗时并停止记录
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <QString>
+
+class startupTrace
+{
+public:
+    static void start(bool enabled);           // 开始计时，enabled 为 false 时之后的调用都不做任何事
+    static bool isEnabled() { return enabledFlag; } // 是否正在记录
+    static void mark(const QString &phase);    // 记录一个阶段结束，耗时为距上一个阶段结束的时间
+    static void finish();                      // 输出各阶段耗时并停止记录
+
+private:
+    static bool enabledFlag; // 是否正在记录
+};
+
+#endif // STARTUPTRACE_H
@@ -0,0 +1,141 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: statspanel.cpp
+ *
+ * 模块描述:
+ *   该模块实现了流水线统计面板，实时显示导出线程发送的分阶段统计快照。
+ *
+ * 主要功能:
+ *   1. 显示各阶段帧率、p50/p99 延迟和队列深度
+ *   2. 显示写入速率、峰值内存和当前瓶颈阶段
+ *
+ * 函数列表:
+ *   1. statsPanel                - 构造函数，初始化UI
+ *   2. ~statsPanel               - 析构函数，释放资源
+ *   3. initUI                    - 初始化用户界面
+ *   4. updateStats               - 根据统计快照刷新显示
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#include "statspanel.h"
+#include <QHeaderView>
+#include <QJsonArray>
+
+/***********************************************************
+ * 函数名称: statsPanel
+ * 函数功能: 统计面板的构造函数
+ * 参数说明:
+ *   parent - 父窗口指针,默认为nullptr
+ * 返回值: 无
+ * 备注: 初始化UI界面
+ ***********************************************************/
+statsPanel::statsPanel(QWidget *parent) : QWidget(parent)
+{
+    initUI();
+}
+
+/***********************************************************
+ * 函数名称: ~statsPanel
+ * 函数功能: 统计面板的析构函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 释放控件和布局
+ ***********************************************************/
+statsPanel::~statsPanel()
+{
+    delete stageTable;
+    delete summaryLabel;
+    delete mainLayout;
+}
+
+/***********************************************************
+ * 函数名称: initUI
+ * 函数功能: 初始化用户界面
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 创建分阶段统计表格和汇总标签
+ ***********************************************************/
+void statsPanel::initUI()
+{
+    setWindowTitle(tr("流水线统计"));
+    resize(640, 300);
+
+    mainLayout = new QVBoxLayout(this);
+
+    stageTable = new QTableWidget(0, 6, this);
+    stageTable->setHorizontalHeaderLabels(QStringList() << tr("阶段") << tr("帧数") << tr("帧率")
+                                                        << tr("p50(ms)") << tr("p99(ms)") << tr("队列(最大)"));
+    stageTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    stageTable->verticalHeader()->setVisible(false);
+    stageTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    summaryLabel = new QLabel(tr("等待导出开始..."), this);
+
+    mainLayout->addWidget(stageTable);
+    mainLayout->addWidget(summaryLabel);
+    setLayout(mainLayout);
+}
+
+/***********************************************************
+ * 函数名称: updateStats
+ * 函数功能: 根据统计快照刷新显示
+ * 参数说明:
+ *   snapshot - pipelineStats::snapshot 生成的 JSON 对象
+ * 返回值: 无
+ * 备注: 瓶颈阶段所在行加粗显示
+ ***********************************************************/
+void statsPanel::updateStats(const QJsonObject &snapshot)
+{
+    const QJsonArray stages = snapshot["stages"].toArray();
+    const QString bottleneck = snapshot["bottleneck"].toString();
+
+    stageTable->setRowCount(stages.size());
+    for (int row = 0; row < stages.size(); ++row)
+    {
+        const QJsonObject stage = stages[row].toObject();
+        const QStringList cells = QStringList()
+                                  << stage["name"].toString()
+                                  << QString::number(stage["frames"].toDouble(), 'f', 0)
+                                  << QString::number(stage["fps"].toDouble(), 'f', 1)
+                                  << QString::number(stage["p50Us"].toDouble() / 1000.0, 'f', 2)
+                                  << QString::number(stage["p99Us"].toDouble() / 1000.0, 'f', 2)
+                                  << QString("%1 (%2)").arg(stage["queueDepth"].toInt()).arg(stage["queueDepthMax"].toInt());
+
+        QFont font = stageTable->font();
+        font.setBold(stage["name"].toString() == bottleneck);
+        for (int column = 0; column < cells.size(); ++column)
+        {
+            QTableWidgetItem *item = stageTable->item(row, column);
+            if (item == nullptr)
+            {
+                item = new QTableWidgetItem;
+                stageTable->setItem(row, column, item);
+            }
+            item->setText(cells[column]);
+            item->setFont(font);
+        }
+    }
+
+    summaryLabel->setText(tr("耗时: %1 s  写入: %2 MB (%3 MB/s)  峰值内存: %4 MB  瓶颈: %5")
+                              .arg(snapshot["elapsedMs"].toDouble() / 1000.0, 0, 'f', 1)
+                              .arg(snapshot["bytesWritten"].toDouble() / 1048576.0, 0, 'f', 1)
+                              .arg(snapshot["writeMBps"].toDouble(), 0, 'f', 1)
+                              .arg(snapshot["peakRssBytes"].toDouble() / 1048576.0, 0, 'f', 0)
+                              .arg(bottleneck.isEmpty() ? tr("无") : bottleneck));
+}
@@ -0,0 +1,64 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: statspanel.h
+ *
+ * 模块描述:
+ *   该模块定义了流水线统计面板，实时显示导出线程发送的分阶段统计快照。
+ *
+ * 主要功能:
+ *   1. 显示各阶段帧率、p50/p99 延迟和队列深度
+ *   2. 显示写入速率、峰值内存和当前瓶颈阶段
+ *
+ * 函数列表:
+ *   1. statsPanel                - 构造函数，初始化UI
+ *   2. ~statsPanel               - 析构函数，释放资源
+ *   3. initUI                    - 初始化用户界面
+ *   4. updateStats               - 根据统计快照刷新显示
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#ifndef STATSPANEL_H
+#define STATSPANEL_H
+
+#include <QWidget>
+#include <QLabel>
+#include <QTableWidget>
+#include <QVBoxLayout>
+#include <QJsonObject>
+
+class statsPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit statsPanel(QWidget *parent = nullptr);
+    ~statsPanel();
+
+public slots:
+    void updateStats(const QJsonObject &snapshot); // 根据统计快照刷新显示
+
+private:
+    void initUI(); // 初始化用户界面
+
+    QVBoxLayout *mainLayout;   // 主布局
+    QTableWidget *stageTable;  // 分阶段统计表格
+    QLabel *summaryLabel;      // 汇总信息标签
+};
+
+#endif // STATSPANEL_H
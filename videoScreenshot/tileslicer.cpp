@@ -0,0 +1,211 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: tileslicer.cpp
+ *
+ * 模块描述:
+ *   该模块实现了切片导出器。
+ *
+ * 主要功能:
+ *   1. 计算带重叠的切片网格
+ *   2. 创建零拷贝的切片视图
+ *   3. 按亮度标准差判断空切片
+ *
+ * 函数列表:
+ *   1. tileSlicer                - 构造函数
+ *   2. setTiling                 - 设置切片尺寸、重叠和空切片阈值
+ *   3. layout                    - 计算一帧的切片网格
+ *   4. view                      - 创建切片的零拷贝视图
+ *   5. lumaStdDev                - 估算图像的亮度标准差
+ *   6. isBlank                   - 判断切片是否无内容
+ *   7. tileOffsets               - 计算一个方向上的切片起点
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 切片编码移入并行编码器，与多分辨率版本在同一批中编码
+ ***********************************************************/
+
+#include "tileslicer.h"
+#include <cmath>
+
+namespace
+{
+    const int STDDEV_SAMPLES = 64; // 估算标准差时每个方向的采样点数
+}
+
+/***********************************************************
+ * 函数名称: tileOffsets
+ * 函数功能: 计算一个方向上的切片起点
+ * 参数说明:
+ *   length - 帧在该方向上的长度
+ *   size   - 切片边长
+ *   step   - 相邻切片起点间距
+ * 返回值: 切片起点列表
+ * 备注: 最后一个切片靠齐边缘，与前一个切片的重叠可能大于设定值；
+ *       帧比切片小时只有一个起点 0
+ ***********************************************************/
+static QVector<int> tileOffsets(int length, int size, int step)
+{
+    QVector<int> offsets;
+    if (length <= size)
+    {
+        offsets.append(0);
+        return offsets;
+    }
+    for (int offset = 0;; offset += step)
+    {
+        if (offset + size >= length)
+        {
+            offsets.append(length - size);
+            break;
+        }
+        offsets.append(offset);
+    }
+    return offsets;
+}
+
+/***********************************************************
+ * 函数名称: tileSlicer
+ * 函数功能: 切片导出器的构造函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 默认不切片
+ ***********************************************************/
+tileSlicer::tileSlicer() : size(0),
+                           overlapPixels(0),
+                           blankThreshold(0)
+{
+}
+
+/***********************************************************
+ * 函数名称: setTiling
+ * 函数功能: 设置切片尺寸、重叠和空切片阈值
+ * 参数说明:
+ *   tileSize  - 切片边长(像素)，0 为不切片
+ *   overlap   - 相邻切片重叠(像素)，限制在 [0, tileSize/2]
+ *   minStdDev - 亮度标准差低于此值的切片不导出，0 为全部导出
+ * 返回值: 无
+ * 备注: 无
+ ***********************************************************/
+void tileSlicer::setTiling(int tileSize, int overlap, double minStdDev)
+{
+    size = qMax(0, tileSize);
+    overlapPixels = qBound(0, overlap, size / 2);
+    blankThreshold = qMax(0.0, minStdDev);
+}
+
+/***********************************************************
+ * 函数名称: layout
+ * 函数功能: 计算一帧的切片网格
+ * 参数说明:
+ *   frameWidth  - 帧宽度
+ *   frameHeight - 帧高度
+ * 返回值: 按行排列的切片位置
+ * 备注: 切片边长不超过帧的宽高
+ ***********************************************************/
+QVector<tileSlicer::tile> tileSlicer::layout(int frameWidth, int frameHeight) const
+{
+    QVector<tile> tiles;
+    if (size <= 0 || frameWidth <= 0 || frameHeight <= 0)
+    {
+        return tiles;
+    }
+
+    const int step = size - overlapPixels;
+    const QVector<int> columns = tileOffsets(frameWidth, size, step);
+    const QVector<int> rows = tileOffsets(frameHeight, size, step);
+    tiles.reserve(columns.size() * rows.size());
+    for (int y : rows)
+    {
+        for (int x : columns)
+        {
+            tile rect;
+            rect.x = x;
+            rect.y = y;
+            rect.width = qMin(size, frameWidth);
+            rect.height = qMin(size, frameHeight);
+            tiles.append(rect);
+        }
+    }
+    return tiles;
+}
+
+/***********************************************************
+ * 函数名称: view
+ * 函数功能: 创建切片的零拷贝视图
+ * 参数说明:
+ *   frame - 已转换的整帧图像
+ *   rect  - 切片位置
+ * 返回值: 与整帧共享像素的只读图像
+ * 备注: 视图直接引用整帧的缓冲区，沿用整帧的行跨度，不持有引用计数；
+ *       只能在整帧有效期间使用，需要保留时须 copy()
+ ***********************************************************/
+QImage tileSlicer::view(const QImage &frame, const tile &rect)
+{
+    const uchar *origin = frame.constBits() + static_cast<qint64>(rect.y) * frame.bytesPerLine() +
+                          static_cast<qint64>(rect.x) * (frame.depth() / 8);
+    return QImage(origin, rect.width, rect.height, frame.bytesPerLine(), frame.format());
+}
+
+/***********************************************************
+ * 函数名称: lumaStdDev
+ * 函数功能: 估算图像的亮度标准差
+ * 参数说明:
+ *   image - RGB32/ARGB32 格式的图像
+ * 返回值: 亮度(0-255)标准差
+ * 备注: 均匀取最多 64x64 个采样点，耗时与切片大小无关
+ ***********************************************************/
+double tileSlicer::lumaStdDev(const QImage &image)
+{
+    const int columns = qMin(STDDEV_SAMPLES, image.width());
+    const int rows = qMin(STDDEV_SAMPLES, image.height());
+    if (columns <= 0 || rows <= 0)
+    {
+        return 0;
+    }
+
+    qint64 sum = 0;
+    qint64 sumSquares = 0;
+    for (int i = 0; i < rows; ++i)
+    {
+        const int y = static_cast<int>((2 * i + 1) * static_cast<qint64>(image.height()) / (2 * rows));
+        const QRgb *line = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+        for (int j = 0; j < columns; ++j)
+        {
+            const QRgb pixel = line[(2 * j + 1) * static_cast<qint64>(image.width()) / (2 * columns)];
+            const int luma = (77 * qRed(pixel) + 150 * qGreen(pixel) + 29 * qBlue(pixel)) >> 8;
+            sum += luma;
+            sumSquares += luma * luma;
+        }
+    }
+    const double count = static_cast<double>(rows) * columns;
+    const double mean = sum / count;
+    return std::sqrt(qMax(0.0, sumSquares / count - mean * mean));
+}
+
+/***********************************************************
+ * 函数名称: isBlank
+ * 函数功能: 判断切片是否无内容
+ * 参数说明:
+ *   tileView - 切片视图
+ * 返回值: 设置了阈值且亮度标准差低于阈值时返回 true
+ * 备注: 纯色天空、黑边、遮挡画面等切片标准差接近 0
+ ***********************************************************/
+bool tileSlicer::isBlank(const QImage &tileView) const
+{
+    return blankThreshold > 0 && lumaStdDev(tileView) < blankThreshold;
+}
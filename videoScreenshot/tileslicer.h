@@ -0,0 +1,81 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: tileslicer.h
+ *
+ * 模块描述:
+ *   该模块定义了切片导出器，用于小目标检测数据集(SAHI 式切片)。
+ *   把一帧按带重叠的网格切成固定大小的切片，最后一行/列靠齐画面边缘。
+ *   切片是指向已转换帧缓冲区的 QImage 视图，不复制像素，交给并行
+ *   编码器同时编码。可按亮度标准差跳过无内容的切片。
+ *
+ * 主要功能:
+ *   1. 计算带重叠的切片网格
+ *   2. 创建零拷贝的切片视图
+ *   3. 按亮度标准差判断空切片
+ *
+ * 函数列表:
+ *   1. tileSlicer                - 构造函数
+ *   2. setTiling                 - 设置切片尺寸、重叠和空切片阈值
+ *   3. layout                    - 计算一帧的切片网格
+ *   4. view                      - 创建切片的零拷贝视图
+ *   5. lumaStdDev                - 估算图像的亮度标准差
+ *   6. isBlank                   - 判断切片是否无内容
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 切片编码移入并行编码器，与多分辨率版本在同一批中编码
+ ***********************************************************/
+
+#ifndef TILESLICER_H
+#define TILESLICER_H
+
+#include <QImage>
+#include <QVector>
+
+class tileSlicer
+{
+public:
+    // 一个切片在帧中的位置
+    struct tile
+    {
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    tileSlicer();
+
+    void setTiling(int tileSize, int overlap, double minStdDev); // 设置切片尺寸、重叠和空切片阈值
+    bool isEnabled() const { return size > 0; }                 // 是否启用切片导出
+    int tileSize() const { return size; }                       // 切片边长(像素)
+    int overlap() const { return overlapPixels; }               // 相邻切片重叠(像素)
+    double minStdDev() const { return blankThreshold; }         // 空切片阈值，0 为不跳过
+
+    QVector<tile> layout(int frameWidth, int frameHeight) const; // 计算一帧的切片网格
+    static QImage view(const QImage &frame, const tile &rect);  // 创建切片的零拷贝视图
+    static double lumaStdDev(const QImage &image);              // 估算图像的亮度标准差
+    bool isBlank(const QImage &tileView) const;                 // 判断切片是否无内容
+
+private:
+    int size;              // 切片边长(像素)，0 为不切片
+    int overlapPixels;     // 相邻切片重叠(像素)
+    double blankThreshold; // 亮度标准差低于此值的切片视为无内容，0 为不跳过
+};
+
+#endif // TILESLICER_H
@@ -0,0 +1,203 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: timerange.cpp
+ *
+ * 模块描述:
+ *   该模块实现了导出时间段的解析和整理。
+ *
+ * 主要功能:
+ *   1. 解析 "入点-出点" 形式的时间段
+ *   2. 读取每行一个时间段的任务文件
+ *   3. 排序并合并重叠的时间段
+ *
+ * 函数列表:
+ *   1. parseTimeRange            - 解析一个时间段
+ *   2. loadTimeRanges            - 从任务文件读取时间段
+ *   3. normalizeTimeRanges       - 排序并合并时间段
+ *   4. formatTimeRange           - 将时间段格式化为文本
+ *   5. parseTimeUs               - 解析一个时间点
+ *   6. formatTimeUs              - 将时间点格式化为文本
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#include "timerange.h"
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+#include <algorithm>
+
+/***********************************************************
+ * 函数名称: parseTimeUs
+ * 函数功能: 解析一个时间点
+ * 参数说明:
+ *   text - "时:分:秒"、"分:秒" 或 "秒"，秒可带小数
+ *   ok   - 返回是否解析成功
+ * 返回值: 时间点(微秒)
+ * 备注: 无
+ ***********************************************************/
+static qint64 parseTimeUs(const QString &text, bool *ok)
+{
+    const QStringList fields = text.trimmed().split(':');
+    *ok = fields.size() <= 3;
+    double seconds = 0;
+    for (int i = 0; i < fields.size() && *ok; ++i)
+    {
+        bool fieldOk = false;
+        const double value = fields[i].toDouble(&fieldOk);
+        *ok = fieldOk && value >= 0 && (i == 0 || value < 60);
+        seconds = seconds * 60 + value;
+    }
+    return static_cast<qint64>(seconds * 1000000.0 + 0.5);
+}
+
+/***********************************************************
+ * 函数名称: formatTimeUs
+ * 函数功能: 将时间点格式化为文本
+ * 参数说明:
+ *   us - 时间点(微秒)
+ * 返回值: "时:分:秒.毫秒" 形式的文本
+ * 备注: 无
+ ***********************************************************/
+static QString formatTimeUs(qint64 us)
+{
+    const qint64 ms = us / 1000;
+    return QString("%1:%2:%3.%4")
+        .arg(ms / 3600000, 2, 10, QChar('0'))
+        .arg(ms / 60000 % 60, 2, 10, QChar('0'))
+        .arg(ms / 1000 % 60, 2, 10, QChar('0'))
+        .arg(ms % 1000, 3, 10, QChar('0'));
+}
+
+/***********************************************************
+ * 函数名称: parseTimeRange
+ * 函数功能: 解析一个时间段
+ * 参数说明:
+ *   text  - "入点-出点"，如 "00:01:30-00:02:10.5" 或 "90-130.5"
+ *   range - 返回解析出的时间段
+ *   error - 失败时返回错误描述，可为空
+ * 返回值: 成功返回 true
+ * 备注: 出点必须晚于入点
+ ***********************************************************/
+bool parseTimeRange(const QString &text, timeRange &range, QString *error)
+{
+    const QStringList fields = text.split('-');
+    bool beginOk = false;
+    bool endOk = false;
+    if (fields.size() == 2)
+    {
+        range.beginUs = parseTimeUs(fields[0], &beginOk);
+        range.endUs = parseTimeUs(fields[1], &endOk);
+    }
+    if (!beginOk || !endOk || range.endUs <= range.beginUs)
+    {
+        if (error)
+        {
+            *error = QStringLiteral("时间段应为 入点-出点 且出点晚于入点，实际为 \"%1\"").arg(text);
+        }
+        return false;
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: loadTimeRanges
+ * 函数功能: 从任务文件读取时间段
+ * 参数说明:
+ *   fileName - 任务文件，每行一个 "入点-出点"，# 开头为注释
+ *   ranges   - 读取的时间段追加到此列表
+ *   error    - 失败时返回错误描述，可为空
+ * 返回值: 成功返回 true
+ * 备注: 空行忽略，任一行格式错误即失败
+ ***********************************************************/
+bool loadTimeRanges(const QString &fileName, QVector<timeRange> &ranges, QString *error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        if (error)
+        {
+            *error = file.errorString();
+        }
+        return false;
+    }
+
+    QTextStream stream(&file);
+    int lineNumber = 0;
+    while (!stream.atEnd())
+    {
+        const QString line = stream.readLine().trimmed();
+        lineNumber++;
+        if (line.isEmpty() || line.startsWith('#'))
+        {
+            continue;
+        }
+        timeRange range;
+        if (!parseTimeRange(line, range, error))
+        {
+            if (error)
+            {
+                *error = QString("%1:%2: %3").arg(fileName).arg(lineNumber).arg(*error);
+            }
+            return false;
+        }
+        ranges.append(range);
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: normalizeTimeRanges
+ * 函数功能: 排序并合并时间段
+ * 参数说明:
+ *   ranges - 任意顺序的时间段
+ * 返回值: 按入点排序、互不重叠的时间段
+ * 备注: 重叠或首尾相接的时间段合并为一个
+ ***********************************************************/
+QVector<timeRange> normalizeTimeRanges(QVector<timeRange> ranges)
+{
+    std::sort(ranges.begin(), ranges.end(), [](const timeRange &a, const timeRange &b)
+              { return a.beginUs < b.beginUs; });
+
+    QVector<timeRange> merged;
+    for (const timeRange &range : ranges)
+    {
+        if (!merged.isEmpty() && range.beginUs <= merged.last().endUs)
+        {
+            merged.last().endUs = qMax(merged.last().endUs, range.endUs);
+        }
+        else
+        {
+            merged.append(range);
+        }
+    }
+    return merged;
+}
+
+/***********************************************************
+ * 函数名称: formatTimeRange
+ * 函数功能: 将时间段格式化为文本
+ * 参数说明:
+ *   range - 时间段
+ * 返回值: 可被 parseTimeRange 解析的文本
+ * 备注: 精确到毫秒
+ ***********************************************************/
+QString formatTimeRange(const timeRange &range)
+{
+    return formatTimeUs(range.beginUs) + "-" + formatTimeUs(range.endUs);
+}
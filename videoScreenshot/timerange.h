@@ -0,0 +1,59 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: timerange.h
+ *
+ * 模块描述:
+ *   该模块定义了导出时间段(入点/出点)。一个视频可以有多个时间段，
+ *   只有落在时间段内的帧会被导出，支持跳转的帧源直接跳过段间区域，
+ *   不解码。时间段可在界面进度条上标记，也可由命令行或任务文件给出。
+ *
+ * 主要功能:
+ *   1. 解析 "入点-出点" 形式的时间段
+ *   2. 读取每行一个时间段的任务文件
+ *   3. 排序并合并重叠的时间段
+ *
+ * 函数列表:
+ *   1. parseTimeRange            - 解析一个时间段
+ *   2. loadTimeRanges            - 从任务文件读取时间段
+ *   3. normalizeTimeRanges       - 排序并合并时间段
+ *   4. formatTimeRange           - 将时间段格式化为文本
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#ifndef TIMERANGE_H
+#define TIMERANGE_H
+
+#include <QString>
+#include <QVector>
+
+// 一个导出时间段，左闭右开
+struct timeRange
+{
+    qint64 beginUs; // 入点(微秒)
+    qint64 endUs;   // 出点(微秒)
+};
+
+bool parseTimeRange(const QString &text, timeRange &range,
+                    QString *error = nullptr);             // 解析一个时间段
+bool loadTimeRanges(const QString &fileName, QVector<timeRange> &ranges,
+                    QString *error = nullptr);             // 从任务文件读取时间段
+QVector<timeRange> normalizeTimeRanges(QVector<timeRange> ranges); // 排序并合并时间段
+QString formatTimeRange(const timeRange &range);           // 将时间段格式化为文本
+
+#endif // TIMERANGE_H
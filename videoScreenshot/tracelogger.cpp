@@ -0,0 +1,371 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: tracelogger.cpp
+ *
+ * 模块描述:
+ *   该模块实现了时间线追踪记录器。线程首次向某个记录器记录事件时在该记录器
+ *   内登记一个固定容量的缓冲区，此后只有该线程写入，写入后用 release 语义
+ *   发布计数，输出时用 acquire 语义读取，无需加锁。缓冲区写满后丢弃新事件并计数。
+ *   每个线程缓存最近一次使用的 (追踪编号, 缓冲区)，编号全局唯一且不复用，
+ *   记录器清空或析构后旧缓存不会再被命中。
+ *
+ * 主要功能:
+ *   1. 开始/停止一次追踪
+ *   2. 按线程记录作用域事件
+ *   3. 输出 Chrome trace-event JSON
+ *
+ * 函数列表:
+ *   1. traceLogger               - 构造函数
+ *   2. ~traceLogger              - 析构函数，释放缓冲区
+ *   3. start                     - 清空上次的事件并开始记录
+ *   4. stop                      - 停止记录
+ *   5. nowNs                     - 获取追踪时钟的当前时间
+ *   6. record                    - 记录一个完整事件
+ *   7. clear                     - 释放所有线程的缓冲区
+ *   8. writeChromeTrace          - 输出 Chrome trace-event JSON
+ *   9. currentBuffer             - 获取当前线程在本记录器中的缓冲区
+ *   10. escapeJson               - 转义 JSON 字符串
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 改为每个导出拥有的记录器，缓冲区登记在记录器内，输出只含本次导出的事件
+ *     * 开始追踪时丢弃上次的缓冲区而不是原地清零计数，不与正在记录的线程竞争
+ *     * 缓冲区在开始下一次追踪、输出后和析构时释放
+ ***********************************************************/
+
+#include "tracelogger.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QMutexLocker>
+#include <QThread>
+#include <chrono>
+
+// 每个线程最多缓存的事件数，约 2 MB
+static const int TRACE_BUFFER_CAPACITY = 1 << 16;
+
+struct traceEvent
+{
+    const char *name;
+    qint64 beginNs;
+    qint64 durationNs;
+    qint64 frame;
+};
+
+struct traceThreadBuffer
+{
+    int tid;
+    QString name;
+    std::atomic<int> count;
+    std::atomic<quint64> dropped;
+    std::vector<traceEvent> events;
+};
+
+namespace
+{
+    const std::chrono::steady_clock::time_point traceEpoch = std::chrono::steady_clock::now();
+
+    std::atomic<quint64> nextGeneration(1); // 追踪编号，0 表示尚未开始
+
+    // 当前线程最近使用的缓冲区及其所属追踪编号
+    thread_local quint64 localGeneration = 0;
+    thread_local traceThreadBuffer *localBuffer = nullptr;
+}
+
+/***********************************************************
+ * 函数名称: escapeJson
+ * 函数功能: 转义 JSON 字符串
+ * 参数说明:
+ *   text - 原始字符串
+ * 返回值: 转义后的 UTF-8 字节串
+ * 备注: 仅处理引号、反斜杠和控制字符
+ ***********************************************************/
+static QByteArray escapeJson(const QByteArray &text)
+{
+    QByteArray result;
+    result.reserve(text.size());
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            result.append('\\');
+            result.append(c);
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            result.append(' ');
+        }
+        else
+        {
+            result.append(c);
+        }
+    }
+    return result;
+}
+
+/***********************************************************
+ * 函数名称: traceLogger
+ * 函数功能: 时间线追踪记录器的构造函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 创建后不记录，start() 后开始
+ ***********************************************************/
+traceLogger::traceLogger() : enabledFlag(false), generation(0)
+{
+}
+
+/***********************************************************
+ * 函数名称: ~traceLogger
+ * 函数功能: 时间线追踪记录器的析构函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 释放所有线程的缓冲区
+ ***********************************************************/
+traceLogger::~traceLogger()
+{
+    clear();
+}
+
+/***********************************************************
+ * 函数名称: start
+ * 函数功能: 清空上次的事件并开始记录
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 应在所属导出的流水线空闲(导出开始前)调用；
+ *       上次的缓冲区整体丢弃，换用新的追踪编号
+ ***********************************************************/
+void traceLogger::start()
+{
+    clear();
+    generation.store(nextGeneration.fetch_add(1, std::memory_order_relaxed), std::memory_order_release);
+    enabledFlag.store(true, std::memory_order_release);
+}
+
+/***********************************************************
+ * 函数名称: stop
+ * 函数功能: 停止记录
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 已记录的事件保留，输出后再调用 clear() 释放
+ ***********************************************************/
+void traceLogger::stop()
+{
+    enabledFlag.store(false, std::memory_order_release);
+}
+
+/***********************************************************
+ * 函数名称: clear
+ * 函数功能: 释放所有线程的缓冲区
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 停止记录并作废追踪编号，各线程缓存的旧缓冲区指针不会再被使用；
+ *       应在所属导出的流水线空闲时调用
+ ***********************************************************/
+void traceLogger::clear()
+{
+    enabledFlag.store(false, std::memory_order_release);
+    generation.store(0, std::memory_order_release);
+    QMutexLocker locker(&mutex);
+    for (traceThreadBuffer *buffer : buffers)
+    {
+        delete buffer;
+    }
+    buffers.clear();
+    bufferOfThread.clear();
+}
+
+/***********************************************************
+ * 函数名称: currentBuffer
+ * 函数功能: 获取当前线程在本记录器中的缓冲区
+ * 参数说明: 无
+ * 返回值: 当前线程的缓冲区指针，记录器已清空时返回 nullptr
+ * 备注: 线程缓存命中时不加锁；首次记录时分配并登记
+ ***********************************************************/
+traceThreadBuffer *traceLogger::currentBuffer()
+{
+    const quint64 current = generation.load(std::memory_order_acquire);
+    if (current == 0)
+    {
+        return nullptr;
+    }
+    if (localGeneration == current)
+    {
+        return localBuffer;
+    }
+
+    QMutexLocker locker(&mutex);
+    if (generation.load(std::memory_order_relaxed) != current)
+    {
+        return nullptr;
+    }
+    const Qt::HANDLE thread = QThread::currentThreadId();
+    traceThreadBuffer *buffer = bufferOfThread.value(thread, nullptr);
+    if (buffer == nullptr)
+    {
+        buffer = new traceThreadBuffer;
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+        buffer->events.resize(TRACE_BUFFER_CAPACITY);
+        buffer->tid = static_cast<int>(buffers.size()) + 1;
+        QThread *qthread = QThread::currentThread();
+        buffer->name = qthread != nullptr && !qthread->objectName().isEmpty()
+                           ? qthread->objectName()
+                           : QString("thread-%1").arg(buffer->tid);
+        buffers.push_back(buffer);
+        bufferOfThread.insert(thread, buffer);
+    }
+    localGeneration = current;
+    localBuffer = buffer;
+    return buffer;
+}
+
+/***********************************************************
+ * 函数名称: nowNs
+ * 函数功能: 获取追踪时钟的当前时间
+ * 参数说明: 无
+ * 返回值: 自进程启动以来的纳秒数
+ * 备注: 使用单调时钟，所有线程共用同一时间基准
+ ***********************************************************/
+qint64 traceLogger::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - traceEpoch)
+        .count();
+}
+
+/***********************************************************
+ * 函数名称: record
+ * 函数功能: 记录一个完整事件
+ * 参数说明:
+ *   name       - 事件名称，必须是字符串字面量
+ *   beginNs    - 开始时间(nowNs 时间基准)
+ *   durationNs - 持续时间(纳秒)
+ *   frame      - 帧号，-1 表示与具体帧无关
+ * 返回值: 无
+ * 备注: 只写本线程在本记录器中的缓冲区，缓冲区满时丢弃
+ ***********************************************************/
+void traceLogger::record(const char *name, qint64 beginNs, qint64 durationNs, qint64 frame)
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+
+    traceThreadBuffer *buffer = currentBuffer();
+    if (buffer == nullptr)
+    {
+        return;
+    }
+    const int index = buffer->count.load(std::memory_order_relaxed);
+    if (index >= TRACE_BUFFER_CAPACITY)
+    {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    traceEvent &event = buffer->events[index];
+    event.name = name;
+    event.beginNs = beginNs;
+    event.durationNs = durationNs;
+    event.frame = frame;
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+/***********************************************************
+ * 函数名称: writeChromeTrace
+ * 函数功能: 输出 Chrome trace-event JSON
+ * 参数说明:
+ *   fileName - 输出文件路径
+ * 返回值: 写出成功返回 true
+ * 备注: 事件以 "X"(完整事件)类型输出，时间单位为微秒；只包含本记录器的事件
+ ***********************************************************/
+bool traceLogger::writeChromeTrace(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    QByteArray chunk;
+    chunk.reserve(1 << 20);
+    chunk.append("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+
+    QMutexLocker locker(&mutex);
+    for (const traceThreadBuffer *buffer : buffers)
+    {
+        const int count = buffer->count.load(std::memory_order_acquire);
+        if (count == 0)
+        {
+            continue;
+        }
+
+        // 线程名称元数据事件
+        chunk.append(first ? "" : ",\n");
+        first = false;
+        chunk.append(QString("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%1,\"tid\":%2,\"args\":{\"name\":\"")
+                         .arg(pid)
+                         .arg(buffer->tid)
+                         .toUtf8());
+        chunk.append(escapeJson(buffer->name.toUtf8()));
+        chunk.append("\"}}");
+
+        for (int i = 0; i < count; ++i)
+        {
+            const traceEvent &event = buffer->events[i];
+            chunk.append(",\n{\"name\":\"");
+            chunk.append(event.name);
+            chunk.append("\",\"cat\":\"pipeline\",\"ph\":\"X\",\"pid\":");
+            chunk.append(QByteArray::number(pid));
+            chunk.append(",\"tid\":");
+            chunk.append(QByteArray::number(buffer->tid));
+            chunk.append(",\"ts\":");
+            chunk.append(QByteArray::number(event.beginNs / 1000.0, 'f', 3));
+            chunk.append(",\"dur\":");
+            chunk.append(QByteArray::number(event.durationNs / 1000.0, 'f', 3));
+            if (event.frame >= 0)
+            {
+                chunk.append(",\"args\":{\"frame\":");
+                chunk.append(QByteArray::number(event.frame));
+                chunk.append("}");
+            }
+            chunk.append("}");
+
+            if (chunk.size() > (1 << 20))
+            {
+                file.write(chunk);
+                chunk.clear();
+            }
+        }
+
+        const quint64 dropped = buffer->dropped.load(std::memory_order_relaxed);
+        if (dropped > 0)
+        {
+            chunk.append(QString(",\n{\"name\":\"dropped_events\",\"ph\":\"C\",\"pid\":%1,\"tid\":%2,\"ts\":0,\"args\":{\"dropped\":%3}}")
+                             .arg(pid)
+                             .arg(buffer->tid)
+                             .arg(dropped)
+                             .toUtf8());
+        }
+    }
+
+    chunk.append("\n]}\n");
+    file.write(chunk);
+    return file.error() == QFileDevice::NoError;
+}
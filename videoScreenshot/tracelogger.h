@@ -0,0 +1,93 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: tracelogger.h
+ *
+ * 模块描述:
+ *   该模块定义了时间线追踪记录器。每个导出线程拥有自己的记录器，开启后
+ *   参与该导出的每个线程把带帧号的作用域事件写入记录器内各自的无锁缓冲区，
+ *   导出结束后输出为 Chrome trace-event JSON，可直接在 Perfetto 或
+ *   chrome://tracing 中查看各线程的停顿情况。多个导出同时进行时互不影响，
+ *   输出文件只包含本次导出的事件。
+ *   记录器经统计对象传给各追踪点，未开启时每个追踪点只有一次指针判断。
+ *
+ * 主要功能:
+ *   1. 开始/停止一次追踪
+ *   2. 按线程记录作用域事件(名称、起止时间、帧号)
+ *   3. 输出 Chrome trace-event JSON，输出后释放各线程缓冲区
+ *
+ * 函数列表:
+ *   1. traceLogger               - 构造函数
+ *   2. ~traceLogger              - 析构函数，释放缓冲区
+ *   3. start                     - 清空上次的事件并开始记录
+ *   4. stop                      - 停止记录
+ *   5. isEnabled                 - 查询是否正在记录
+ *   6. nowNs                     - 获取追踪时钟的当前时间
+ *   7. record                    - 记录一个完整事件
+ *   8. clear                     - 释放所有线程的缓冲区
+ *   9. writeChromeTrace          - 输出 Chrome trace-event JSON
+ *   10. currentBuffer            - 获取当前线程在本记录器中的缓冲区
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 全局开关和全局缓冲区登记改为每个导出拥有的记录器，多个导出线程
+ *       同时追踪时不再互相清空、关闭或混入对方的事件
+ *     * 缓冲区归记录器所有，开始下一次追踪和输出后释放，已退出线程的缓冲区不再常驻
+ *     * 删除未使用的 setThreadName 和 TRACE_SCOPE
+ ***********************************************************/
+
+#ifndef TRACELOGGER_H
+#define TRACELOGGER_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <vector>
+
+struct traceThreadBuffer;
+
+class traceLogger
+{
+public:
+    traceLogger();
+    ~traceLogger();
+
+    void start();                         // 清空上次的事件并开始记录
+    void stop();                          // 停止记录，已记录的事件保留到输出
+    bool isEnabled() const { return enabledFlag.load(std::memory_order_relaxed); } // 查询是否正在记录
+    void record(const char *name, qint64 beginNs, qint64 durationNs,
+                qint64 frame = -1);       // 记录一个完整事件
+    void clear();                         // 释放所有线程的缓冲区
+    bool writeChromeTrace(const QString &fileName) const; // 输出 Chrome trace-event JSON
+
+    static qint64 nowNs();                // 获取追踪时钟的当前时间(纳秒)
+
+private:
+    traceThreadBuffer *currentBuffer();   // 获取当前线程在本记录器中的缓冲区
+
+    std::atomic<bool> enabledFlag;        // 是否正在记录
+    std::atomic<quint64> generation;      // 本次追踪的全局唯一编号，线程缓存据此判断是否失效
+    mutable QMutex mutex;                 // 保护缓冲区登记，仅在线程首次记录和输出时使用
+    std::vector<traceThreadBuffer *> buffers;            // 本次追踪各线程的缓冲区
+    QHash<Qt::HANDLE, traceThreadBuffer *> bufferOfThread; // 线程到缓冲区
+
+    traceLogger(const traceLogger &) = delete;
+    traceLogger &operator=(const traceLogger &) = delete;
+};
+
+#endif // TRACELOGGER_H
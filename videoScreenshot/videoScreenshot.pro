@@ -28,12 +28,22 @@ SOURCES += \
         main.cpp \
         mainwindow.cpp \
     exportsettings.cpp \
-    exportthread.cpp
+    gridview.cpp \
+    rangeslider.cpp \
+    startuptrace.cpp \
+    statspanel.cpp \
+    watchdaemon.cpp
 
 HEADERS += \
         mainwindow.h \
     exportsettings.h \
-    exportthread.h
+    gridview.h \
+    rangeslider.h \
+    startuptrace.h \
+    statspanel.h \
+    watchdaemon.h
+
+include(exportcore.pri)
 
 FORMS += \
         mainwindow.ui \
@@ -0,0 +1,640 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: watchdaemon.cpp
+ *
+ * 模块描述:
+ *   该模块实现了监视目录的守护进程。
+ *
+ * 主要功能:
+ *   1. 递归监视目录，发现新视频文件
+ *   2. 等待文件停止增长后入队
+ *   3. 固定大小的导出线程池，队列和待稳定文件数均有上限
+ *   4. 追加写入处理日志，重启时据此跳过已完成的文件
+ *
+ * 函数列表:
+ *   1. watchDaemon               - 构造函数
+ *   2. ~watchDaemon              - 析构函数，等待导出线程结束
+ *   3. start                     - 读取日志、建立监视并扫描已有文件
+ *   4. onInotifyReadable         - 读取 inotify 事件
+ *   5. onDirectoryChanged        - 处理 QFileSystemWatcher 目录变化
+ *   6. checkPending              - 检查待稳定文件
+ *   7. rescan                    - 全量扫描监视目录
+ *   8. onWorkerFinished          - 导出线程结束
+ *   9. addWatch                  - 监视目录及其子目录
+ *   10. scanDirectory            - 扫描目录中的视频文件
+ *   11. notePath                 - 记录一个可能的新文件
+ *   12. dispatch                 - 把队列中的文件分配给空闲线程
+ *   13. startWorker              - 为一个文件启动导出线程
+ *   14. loadJournal              - 读取处理日志
+ *   15. appendJournal            - 追加一条处理日志
+ *   16. fileKey                  - 计算文件标识
+ *   17. exportNameFor            - 生成文件的导出名称
+ *   18. applySavedSettings       - 将保存的导出设置应用到导出线程
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 支持为导出线程指定跨数据集近重复索引
+ *     * 应用多样性导出帧数和时间预算设置
+ *     * 支持为导出线程指定 YOLO 预标注
+ *     * 支持为导出线程指定切片导出和多分辨率输出版本
+ *     * 视频旁的 .ranges 任务文件指定该视频的导出时间段
+ *     * 应用 HDR 色调映射方式设置
+ *     * 退出时取消正在进行的导出；导出失败或被取消的文件记为 failed，重启后重新处理
+ *     * 应用帧分析过滤设置
+ *     * 应用逐帧元数据清单设置
+ *     * 随机种子按字符串读取为 64 位无符号数，不再截断
+ *     * 失败的文件不再记入已完成标识，按路径记录失败时的文件标识，
+ *       大小或修改时间变化(被重写)后重新入队
+ ***********************************************************/
+
+#include "watchdaemon.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QSettings>
+#include <QSocketNotifier>
+#include "exportthread.h"
+#include "timerange.h"
+
+#ifdef Q_OS_LINUX
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// 稳定性检查周期(毫秒)
+static const int STABLE_CHECK_INTERVAL_MS = 500;
+
+/***********************************************************
+ * 函数名称: watchDaemon
+ * 函数功能: 守护进程的构造函数
+ * 参数说明:
+ *   settings - 守护进程参数
+ *   parent   - 父对象指针
+ * 返回值: 无
+ * 备注: 监视在 start() 中建立
+ ***********************************************************/
+watchDaemon::watchDaemon(const options &settings, QObject *parent) : QObject(parent),
+                                                                     config(settings),
+                                                                     inotifyFd(-1),
+                                                                     notifier(nullptr),
+                                                                     fallbackWatcher(nullptr)
+{
+    config.workers = qMax(1, config.workers);
+    config.maxQueue = qMax(1, config.maxQueue);
+    config.maxPending = qMax(1, config.maxPending);
+    for (QString &extension : config.extensions)
+    {
+        extension = extension.trimmed().toLower();
+    }
+    config.extensions.removeAll(QString());
+    connect(&stableTimer, &QTimer::timeout, this, &watchDaemon::checkPending);
+    connect(&rescanTimer, &QTimer::timeout, this, &watchDaemon::rescan);
+}
+
+/***********************************************************
+ * 函数名称: ~watchDaemon
+ * 函数功能: 守护进程的析构函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 先取消全部正在导出的线程再逐个等待，未完成的文件不写完成日志，重启后重新处理
+ ***********************************************************/
+watchDaemon::~watchDaemon()
+{
+    for (auto it = running.begin(); it != running.end(); ++it)
+    {
+        it.key()->cancel();
+    }
+    for (auto it = running.begin(); it != running.end(); ++it)
+    {
+        it.key()->wait();
+        delete it.key();
+    }
+#ifdef Q_OS_LINUX
+    if (inotifyFd >= 0)
+    {
+        ::close(inotifyFd);
+    }
+#endif
+}
+
+/***********************************************************
+ * 函数名称: start
+ * 函数功能: 读取日志、建立监视并扫描已有文件
+ * 参数说明: 无
+ * 返回值: 成功返回 true
+ * 备注: 启动时的全量扫描同时完成崩溃恢复: 日志中没有完成记录的文件会重新入队
+ ***********************************************************/
+bool watchDaemon::start()
+{
+    clock.start();
+    if (!loadJournal())
+    {
+        return false;
+    }
+
+#ifdef Q_OS_LINUX
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd >= 0)
+    {
+        notifier = new QSocketNotifier(inotifyFd, QSocketNotifier::Read, this);
+        connect(notifier, &QSocketNotifier::activated, this, &watchDaemon::onInotifyReadable);
+    }
+#endif
+    if (inotifyFd < 0)
+    {
+        fallbackWatcher = new QFileSystemWatcher(this);
+        connect(fallbackWatcher, &QFileSystemWatcher::directoryChanged, this, &watchDaemon::onDirectoryChanged);
+    }
+
+    for (const QString &directory : config.directories)
+    {
+        if (!QFileInfo(directory).isDir())
+        {
+            qDebug() << "Watch directory not found:" << directory;
+            return false;
+        }
+        addWatch(QDir(directory).absolutePath());
+    }
+
+    stableTimer.start(STABLE_CHECK_INTERVAL_MS);
+    if (config.rescanSeconds > 0)
+    {
+        rescanTimer.start(config.rescanSeconds * 1000);
+    }
+    rescan();
+    qDebug() << "监视目录:" << config.directories << "导出线程:" << config.workers
+             << "已完成文件:" << doneKeys.size();
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: onInotifyReadable
+ * 函数功能: 读取 inotify 事件
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 新建子目录立即加入监视并扫描(目录创建和其中文件写入之间存在竞争)；
+ *       事件队列溢出时退回全量扫描
+ ***********************************************************/
+void watchDaemon::onInotifyReadable()
+{
+#ifdef Q_OS_LINUX
+    alignas(struct inotify_event) char buffer[16384];
+    while (true)
+    {
+        const ssize_t length = ::read(inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0)
+        {
+            break;
+        }
+        for (char *cursor = buffer; cursor < buffer + length;)
+        {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(cursor);
+            cursor += sizeof(struct inotify_event) + event->len;
+
+            if ((event->mask & IN_Q_OVERFLOW) != 0)
+            {
+                rescan();
+                continue;
+            }
+            if ((event->mask & IN_IGNORED) != 0)
+            {
+                watchDirs.remove(event->wd);
+                continue;
+            }
+            const QString directory = watchDirs.value(event->wd);
+            if (directory.isEmpty() || event->len == 0)
+            {
+                continue;
+            }
+            const QString path = directory + '/' + QString::fromLocal8Bit(event->name);
+            if ((event->mask & IN_ISDIR) != 0)
+            {
+                addWatch(path);
+                scanDirectory(path);
+            }
+            else
+            {
+                notePath(path);
+            }
+        }
+    }
+#endif
+}
+
+/***********************************************************
+ * 函数名称: onDirectoryChanged
+ * 函数功能: 处理 QFileSystemWatcher 目录变化
+ * 参数说明:
+ *   path - 发生变化的目录
+ * 返回值: 无
+ * 备注: 该信号不带文件名，只能重新扫描该目录
+ ***********************************************************/
+void watchDaemon::onDirectoryChanged(const QString &path)
+{
+    addWatch(path);
+    scanDirectory(path);
+}
+
+/***********************************************************
+ * 函数名称: checkPending
+ * 函数功能: 检查待稳定文件
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 大小和修改时间在 stableMs 内没有变化视为写入完成；
+ *       队列已满时文件留在待稳定列表，腾出空位后再入队
+ ***********************************************************/
+void watchDaemon::checkPending()
+{
+    const qint64 now = clock.elapsed();
+    for (auto it = pending.begin(); it != pending.end();)
+    {
+        const QFileInfo info(it.key());
+        if (!info.exists())
+        {
+            it = pending.erase(it);
+            continue;
+        }
+
+        const qint64 modifiedMs = info.lastModified().toMSecsSinceEpoch();
+        if (info.size() != it.value().size || modifiedMs != it.value().modifiedMs)
+        {
+            it.value().size = info.size();
+            it.value().modifiedMs = modifiedMs;
+            it.value().unchangedSince = now;
+            ++it;
+            continue;
+        }
+        if (now - it.value().unchangedSince < config.stableMs || ready.size() >= config.maxQueue)
+        {
+            ++it;
+            continue;
+        }
+
+        const QString key = fileKey(info);
+        if (!doneKeys.contains(key) && failedKeys.value(it.key()) != key && !queuedPaths.contains(it.key()))
+        {
+            ready.enqueue(qMakePair(it.key(), key));
+            queuedPaths.insert(it.key());
+        }
+        it = pending.erase(it);
+    }
+    dispatch();
+}
+
+/***********************************************************
+ * 函数名称: rescan
+ * 函数功能: 全量扫描监视目录
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 用于启动恢复、inotify 溢出和网络存储(远端写入不产生本地事件)
+ ***********************************************************/
+void watchDaemon::rescan()
+{
+    for (const QString &directory : config.directories)
+    {
+        scanDirectory(QDir(directory).absolutePath());
+    }
+}
+
+/***********************************************************
+ * 函数名称: onWorkerFinished
+ * 函数功能: 导出线程结束
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 写入完成日志后释放线程并分配下一个文件；失败或被取消的文件记为 failed，
+ *       按路径记录失败时的文件标识(含大小和修改时间)，文件未变时本次运行内不再重试，
+ *       被重写后重新入队，重启后也会重新处理
+ ***********************************************************/
+void watchDaemon::onWorkerFinished()
+{
+    exportThread *worker = static_cast<exportThread *>(sender());
+    auto it = running.find(worker);
+    if (it == running.end())
+    {
+        return;
+    }
+
+    const runningFile finished = it.value();
+    running.erase(it);
+    const exportThread::State state = worker->state();
+    const bool succeeded = state == exportThread::STATE_FINISHED;
+    appendJournal(succeeded ? "done" : "failed", finished.key, finished.path);
+    if (succeeded)
+    {
+        doneKeys.insert(finished.key);
+        failedKeys.remove(finished.path);
+    }
+    else
+    {
+        failedKeys.insert(finished.path, finished.key);
+    }
+    queuedPaths.remove(finished.path);
+    worker->deleteLater();
+    qDebug() << (succeeded ? "处理完成:" : "处理失败:") << finished.path << exportThread::stateName(state);
+    dispatch();
+}
+
+/***********************************************************
+ * 函数名称: addWatch
+ * 函数功能: 监视目录及其子目录
+ * 参数说明:
+ *   directory - 目录
+ * 返回值: 无
+ * 备注: 已监视的目录 inotify 会返回相同的监视号，重复添加无副作用
+ ***********************************************************/
+void watchDaemon::addWatch(const QString &directory)
+{
+    QStringList directories(directory);
+    QDirIterator it(directory, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        directories << it.next();
+    }
+
+    for (const QString &path : directories)
+    {
+#ifdef Q_OS_LINUX
+        if (inotifyFd >= 0)
+        {
+            const int wd = inotify_add_watch(inotifyFd, QFile::encodeName(path).constData(),
+                                             IN_CREATE | IN_CLOSE_WRITE | IN_MOVED_TO);
+            if (wd >= 0)
+            {
+                watchDirs.insert(wd, path);
+            }
+            continue;
+        }
+#endif
+        if (fallbackWatcher != nullptr && !fallbackWatcher->directories().contains(path))
+        {
+            fallbackWatcher->addPath(path);
+        }
+    }
+}
+
+/***********************************************************
+ * 函数名称: scanDirectory
+ * 函数功能: 扫描目录中的视频文件
+ * 参数说明:
+ *   directory - 目录，递归扫描
+ * 返回值: 无
+ * 备注: 无
+ ***********************************************************/
+void watchDaemon::scanDirectory(const QString &directory)
+{
+    QDirIterator it(directory, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        notePath(it.next());
+    }
+}
+
+/***********************************************************
+ * 函数名称: notePath
+ * 函数功能: 记录一个可能的新文件
+ * 参数说明:
+ *   path - 文件路径
+ * 返回值: 无
+ * 备注: 只接受指定后缀的文件；已入队、已完成、失败后未被重写或待稳定列表已满时忽略，
+ *       被忽略的文件会在下一次全量扫描时重新发现
+ ***********************************************************/
+void watchDaemon::notePath(const QString &path)
+{
+    const QFileInfo info(path);
+    if (!config.extensions.contains(info.suffix().toLower()) || queuedPaths.contains(path) ||
+        pending.contains(path) || pending.size() >= config.maxPending)
+    {
+        return;
+    }
+    if (!info.isFile())
+    {
+        return;
+    }
+    const QString key = fileKey(info);
+    if (doneKeys.contains(key) || failedKeys.value(path) == key)
+    {
+        return;
+    }
+
+    pendingFile file;
+    file.size = info.size();
+    file.modifiedMs = info.lastModified().toMSecsSinceEpoch();
+    file.unchangedSince = clock.elapsed();
+    pending.insert(path, file);
+}
+
+/***********************************************************
+ * 函数名称: dispatch
+ * 函数功能: 把队列中的文件分配给空闲线程
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 同时运行的导出线程数不超过 workers
+ ***********************************************************/
+void watchDaemon::dispatch()
+{
+    while (running.size() < config.workers && !ready.isEmpty())
+    {
+        const QPair<QString, QString> next = ready.dequeue();
+        startWorker(next.first, next.second);
+    }
+}
+
+/***********************************************************
+ * 函数名称: startWorker
+ * 函数功能: 为一个文件启动导出线程
+ * 参数说明:
+ *   path - 文件路径
+ *   key  - 文件标识
+ * 返回值: 无
+ * 备注: 每个文件使用新的导出线程对象，参数取自保存的导出设置；
+ *       视频旁有 "<视频文件名>.ranges" 任务文件时只导出其中的时间段
+ ***********************************************************/
+void watchDaemon::startWorker(const QString &path, const QString &key)
+{
+    exportThread *worker = new exportThread();
+    applySavedSettings(worker);
+    worker->setVideoFile(path);
+    worker->setExportName(exportNameFor(path));
+
+    // 任务文件: 视频旁同名的 .ranges 文件，每行一个导出时间段
+    const QString rangesFile = path + ".ranges";
+    if (QFile::exists(rangesFile))
+    {
+        QVector<timeRange> ranges;
+        QString error;
+        if (loadTimeRanges(rangesFile, ranges, &error))
+        {
+            worker->setTimeRanges(ranges);
+        }
+        else
+        {
+            qDebug() << "Read ranges file failed:" << error;
+        }
+    }
+    connect(worker, &QThread::finished, this, &watchDaemon::onWorkerFinished);
+
+    runningFile file;
+    file.path = path;
+    file.key = key;
+    running.insert(worker, file);
+    appendJournal("started", key, path);
+    qDebug() << "开始处理:" << path;
+    worker->start();
+}
+
+/***********************************************************
+ * 函数名称: loadJournal
+ * 函数功能: 读取处理日志
+ * 参数说明: 无
+ * 返回值: 日志可以打开时返回 true
+ * 备注: 日志每行为 "时间\t状态\t标识\t路径"，只有 done 记录决定是否跳过，
+ *       started 和 failed 记录仅供审计；读取后保持以追加方式打开
+ ***********************************************************/
+bool watchDaemon::loadJournal()
+{
+    journal.setFileName(config.journalFile);
+    if (journal.open(QIODevice::ReadOnly))
+    {
+        while (!journal.atEnd())
+        {
+            const QList<QByteArray> fields = journal.readLine().trimmed().split('\t');
+            if (fields.size() >= 3 && fields[1] == "done")
+            {
+                doneKeys.insert(QString::fromLatin1(fields[2]));
+            }
+        }
+        journal.close();
+    }
+
+    QDir().mkpath(QFileInfo(config.journalFile).absolutePath());
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        qDebug() << "Cannot open journal:" << config.journalFile << journal.errorString();
+        return false;
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: appendJournal
+ * 函数功能: 追加一条处理日志
+ * 参数说明:
+ *   state - 状态(started/done)
+ *   key   - 文件标识
+ *   path  - 文件路径
+ * 返回值: 无
+ * 备注: 每条记录立即落盘，进程被杀时最多丢失正在处理的文件
+ ***********************************************************/
+void watchDaemon::appendJournal(const QString &state, const QString &key, const QString &path)
+{
+    journal.write(QString("%1\t%2\t%3\t%4\n")
+                      .arg(QDateTime::currentDateTime().toString(Qt::ISODate))
+                      .arg(state)
+                      .arg(key)
+                      .arg(path)
+                      .toUtf8());
+    journal.flush();
+}
+
+/***********************************************************
+ * 函数名称: fileKey
+ * 函数功能: 计算文件标识
+ * 参数说明:
+ *   info - 文件信息
+ * 返回值: 16 位十六进制字符串
+ * 备注: 由路径、大小和修改时间共同决定，同名文件被替换后会重新处理；
+ *       每个已完成文件在内存中只占一个短字符串
+ ***********************************************************/
+QString watchDaemon::fileKey(const QFileInfo &info)
+{
+    const QByteArray identity = QString("%1|%2|%3")
+                                    .arg(info.absoluteFilePath())
+                                    .arg(info.size())
+                                    .arg(info.lastModified().toMSecsSinceEpoch())
+                                    .toUtf8();
+    return QString::fromLatin1(QCryptographicHash::hash(identity, QCryptographicHash::Sha1).toHex().left(16));
+}
+
+/***********************************************************
+ * 函数名称: exportNameFor
+ * 函数功能: 生成文件的导出名称
+ * 参数说明:
+ *   path - 文件路径
+ * 返回值: 导出名称
+ * 备注: 取相对监视目录的路径去掉后缀并把分隔符换成下划线，
+ *       不同相机目录下的同名文件不会互相覆盖
+ ***********************************************************/
+QString watchDaemon::exportNameFor(const QString &path) const
+{
+    const QFileInfo info(path);
+    QString relative = info.completeBaseName();
+    for (const QString &directory : config.directories)
+    {
+        const QString root = QDir(directory).absolutePath();
+        if (path.startsWith(root + '/'))
+        {
+            relative = QDir(root).relativeFilePath(info.absolutePath() + '/' + info.completeBaseName());
+            break;
+        }
+    }
+    return relative.replace('/', '_');
+}
+
+/***********************************************************
+ * 函数名称: applySavedSettings
+ * 函数功能: 将保存的导出设置应用到导出线程
+ * 参数说明:
+ *   worker - 导出线程
+ * 返回值: 无
+ * 备注: 键名和默认值与导出设置界面一致，界面上修改并保存后新入队的文件即生效；
+ *       近重复索引取自守护进程参数，所有导出线程共用同一索引文件
+ ***********************************************************/
+void watchDaemon::applySavedSettings(exportThread *worker) const
+{
+    QSettings settings("VideoScreenshot", "ExportSettings");
+    worker->setExportPath(config.exportPath.isEmpty()
+                              ? settings.value("exportPath", QDir::homePath() + "/Pictures/Screenshots").toString()
+                              : config.exportPath);
+    worker->setExportMode(settings.value("exportMode", 0).toInt());
+    worker->setInterval(qMax(1, settings.value("interval", 30).toInt()));
+    worker->setRandomCount(settings.value("randomCount", 10).toInt());
+    worker->setDiversityCount(settings.value("diversityCount", settings.value("orthogonalCount", 10)).toInt());
+    worker->setTimeBudget(settings.value("timeBudgetSec", 0).toInt());
+    worker->setKeyframeGap(settings.value("keyframeGapMs", 0).toInt());
+    worker->setRandomSeed(settings.value("randomSeed", 0).toString().toULongLong());
+    worker->setTraceEnabled(settings.value("traceEnabled", false).toBool());
+    worker->setDecoder(settings.value("decoderBackend", QString()).toString(),
+                       settings.value("decoderThreads", 0).toInt(),
+                       static_cast<frameSourceOptions::ThreadType>(
+                           settings.value("decoderThreadType", frameSourceOptions::THREAD_AUTO).toInt()));
+    worker->setDedupIndex(config.dedupIndex, config.dedupDistance);
+    worker->setAnnotation(config.annotation);
+    worker->setTiling(config.tileSize, config.tileOverlap, config.tileMinStdDev);
+    worker->setRenditions(config.renditions);
+    worker->setToneMap(frameView::toneMapFromName(settings.value("toneMap", "hable").toString()));
+    filterChain::options filterSettings;
+    filterSettings.minSharpness = settings.value("filterMinSharpness", 0.0).toDouble();
+    filterSettings.minSceneChange = settings.value("filterMinSceneChange", 0.0).toDouble();
+    filterSettings.minMotion = settings.value("filterMinMotion", 0.0).toDouble();
+    worker->setFrameFilters(filterSettings);
+    worker->setManifest(settings.value("manifestEnabled", true).toBool(), settings.value("manifestCsv", false).toBool());
+}
@@ -0,0 +1,169 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: watchdaemon.h
+ *
+ * 模块描述:
+ *   该模块定义了监视目录的守护进程。Linux 下用 inotify 监视目录树，
+ *   其他平台用 QFileSystemWatcher；网络存储上看不到远端写入事件，
+ *   另有周期性全量扫描兜底。文件大小和修改时间稳定一段时间后进入队列，
+ *   由固定数量的导出线程按保存的导出设置处理。
+ *   已完成的文件记入日志，重启后不会重复处理。
+ *
+ * 主要功能:
+ *   1. 递归监视目录，发现新视频文件
+ *   2. 等待文件停止增长后入队
+ *   3. 固定大小的导出线程池，队列和待稳定文件数均有上限
+ *   4. 追加写入处理日志，重启时据此跳过已完成的文件
+ *
+ * 函数列表:
+ *   1. watchDaemon               - 构造函数
+ *   2. ~watchDaemon              - 析构函数，等待导出线程结束
+ *   3. start                     - 读取日志、建立监视并扫描已有文件
+ *   4. onInotifyReadable         - 读取 inotify 事件
+ *   5. onDirectoryChanged        - 处理 QFileSystemWatcher 目录变化
+ *   6. checkPending              - 检查待稳定文件
+ *   7. rescan                    - 全量扫描监视目录
+ *   8. onWorkerFinished          - 导出线程结束
+ *   9. addWatch                  - 监视目录及其子目录
+ *   10. scanDirectory            - 扫描目录中的视频文件
+ *   11. notePath                 - 记录一个可能的新文件
+ *   12. dispatch                 - 把队列中的文件分配给空闲线程
+ *   13. startWorker              - 为一个文件启动导出线程
+ *   14. loadJournal              - 读取处理日志
+ *   15. appendJournal            - 追加一条处理日志
+ *   16. fileKey                  - 计算文件标识
+ *   17. exportNameFor            - 生成文件的导出名称
+ *   18. applySavedSettings       - 将保存的导出设置应用到导出线程
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 支持为导出线程指定跨数据集近重复索引
+ *     * 支持为导出线程指定 YOLO 预标注
+ *     * 支持为导出线程指定切片导出和多分辨率输出版本
+ *     * 视频旁的 .ranges 任务文件指定该视频的导出时间段
+ *     * 失败的文件按路径记录失败时的大小和修改时间，文件被重写后重新处理
+ ***********************************************************/
+
+#ifndef WATCHDAEMON_H
+#define WATCHDAEMON_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QQueue>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+#include "yoloannotator.h"
+#include "renditionset.h"
+
+class QFileInfo;
+class QFileSystemWatcher;
+class QSocketNotifier;
+class exportThread;
+
+class watchDaemon : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 守护进程参数
+    struct options
+    {
+        QStringList directories; // 监视目录
+        QStringList extensions;  // 视频文件后缀(小写，不含点)
+        QString exportPath;      // 导出根目录，为空时使用保存的导出设置
+        QString journalFile;     // 处理日志路径
+        int workers;             // 导出线程数
+        int stableMs;            // 大小和修改时间保持不变多久视为写入完成(毫秒)
+        int rescanSeconds;       // 全量扫描周期(秒)，0 为不扫描
+        int maxQueue;            // 等待导出的文件数上限
+        int maxPending;          // 等待稳定的文件数上限
+        QString dedupIndex;      // 近重复索引文件，为空表示不去重
+        int dedupDistance;       // 视为近重复的最大汉明距离
+        yoloAnnotator::options annotation; // YOLO 预标注参数，模型为空表示不标注
+        int tileSize;            // 切片边长(像素)，0 为导出整帧
+        int tileOverlap;         // 相邻切片重叠(像素)
+        double tileMinStdDev;    // 亮度标准差低于此值的切片不导出，0 为全部导出
+        QVector<renditionSet::rendition> renditions; // 多分辨率输出版本，为空表示只导出原图
+
+        options() : extensions(QStringList() << "mp4" << "mkv" << "avi" << "mov" << "ts" << "m4v" << "y4m"),
+                    workers(2), stableMs(2000), rescanSeconds(60), maxQueue(1000), maxPending(4000),
+                    dedupDistance(6), tileSize(0), tileOverlap(128), tileMinStdDev(0) {}
+    };
+
+    explicit watchDaemon(const options &config, QObject *parent = nullptr);
+    ~watchDaemon();
+
+    bool start(); // 读取日志、建立监视并扫描已有文件
+
+private slots:
+    void onInotifyReadable();                     // 读取 inotify 事件
+    void onDirectoryChanged(const QString &path); // 处理 QFileSystemWatcher 目录变化
+    void checkPending();                          // 检查待稳定文件
+    void rescan();                                // 全量扫描监视目录
+    void onWorkerFinished();                      // 导出线程结束
+
+private:
+    // 等待稳定的文件
+    struct pendingFile
+    {
+        qint64 size;           // 上次检查时的大小
+        qint64 modifiedMs;     // 上次检查时的修改时间
+        qint64 unchangedSince; // 大小和修改时间开始保持不变的时刻(守护进程时钟，毫秒)
+    };
+
+    // 正在导出的文件
+    struct runningFile
+    {
+        QString path; // 文件路径
+        QString key;  // 文件标识
+    };
+
+    void addWatch(const QString &directory);      // 监视目录及其子目录
+    void scanDirectory(const QString &directory); // 扫描目录中的视频文件
+    void notePath(const QString &path);           // 记录一个可能的新文件
+    void dispatch();                              // 把队列中的文件分配给空闲线程
+    void startWorker(const QString &path, const QString &key); // 为一个文件启动导出线程
+    bool loadJournal();                           // 读取处理日志
+    void appendJournal(const QString &state, const QString &key,
+                       const QString &path);      // 追加一条处理日志
+    QString exportNameFor(const QString &path) const; // 生成文件的导出名称
+    void applySavedSettings(exportThread *worker) const; // 将保存的导出设置应用到导出线程
+
+    static QString fileKey(const QFileInfo &info); // 计算文件标识
+
+    options config;                            // 守护进程参数
+    QHash<QString, pendingFile> pending;       // 等待稳定的文件
+    QQueue<QPair<QString, QString>> ready;     // 等待导出的文件(路径, 标识)
+    QSet<QString> queuedPaths;                 // 已入队或正在导出的文件路径
+    QSet<QString> doneKeys;                    // 已完成文件的标识
+    QHash<QString, QString> failedKeys;        // 本次运行中失败的文件: 路径 -> 失败时的文件标识
+    QHash<exportThread *, runningFile> running; // 正在导出的线程
+    QFile journal;                             // 处理日志
+    QElapsedTimer clock;                       // 守护进程时钟
+    QTimer stableTimer;                        // 稳定性检查定时器
+    QTimer rescanTimer;                        // 全量扫描定时器
+    int inotifyFd;                             // inotify 描述符，-1 表示未使用
+    QSocketNotifier *notifier;                 // inotify 可读通知
+    QHash<int, QString> watchDirs;             // inotify 监视号到目录的映射
+    QFileSystemWatcher *fallbackWatcher;       // 非 Linux 平台的目录监视器
+};
+
+#endif // WATCHDAEMON_H
@@ -0,0 +1,101 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: y4msource.h
+ *
+ * 模块描述:
+ *   该模块定义了免解码的原始帧输入源，读取 Y4M 或无头 YUV 数据。
+ *   普通文件整体内存映射，返回的帧视图直接指向映射区，不做拷贝；
+ *   标准输入("-")无法映射，使用一块复用的帧缓冲区逐帧读取。
+ *
+ * 主要功能:
+ *   1. 解析 Y4M 文件头和帧头
+ *   2. 按指定格式读取无头 YUV 数据
+ *   3. 以零拷贝帧视图逐帧输出
+ *
+ * 函数列表:
+ *   1. y4mSource                 - 构造函数
+ *   2. ~y4mSource                - 析构函数，解除映射并关闭文件
+ *   3. isRawInput                - 判断路径是否为原始帧输入
+ *   4. setRawFormat              - 设置无头 YUV 数据的格式
+ *   5. open                      - 打开输入
+ *   6. close                     - 关闭输入
+ *   7. readFrame                 - 读取下一帧
+ *   8. parseHeader               - 解析 Y4M 文件头
+ *   9. readLine                  - 读取一行(文件头/帧头)
+ *   10. readExact                - 从标准输入读取指定字节数
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ *   - 版本 1.1 (2026-10-18) - LiuJiaLe
+ *     * 实现帧源接口，读取耗时计入解复用阶段
+ ***********************************************************/
+
+#ifndef Y4MSOURCE_H
+#define Y4MSOURCE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include "framesource.h"
+#include "frameview.h"
+
+class y4mSource : public frameSource
+{
+public:
+    y4mSource();
+    ~y4mSource();
+
+    static bool isRawInput(const QString &path); // 判断路径是否为原始帧输入
+
+    void setRawFormat(int rawWidth, int rawHeight, frameView::PixelFormat pixelFormat,
+                      int rateNum, int rateDen); // 设置无头 YUV 数据的格式
+    bool open(const QString &path) override;     // 打开输入，"-" 表示标准输入
+    void close() override;                       // 关闭输入
+    bool readFrame(frameView &frame) override;   // 读取下一帧，视图在下一次调用前有效
+
+    int width() const override { return frameWidth; }                                // 帧宽度
+    int height() const override { return frameHeight; }                              // 帧高度
+    frameView::PixelFormat pixelFormat() const { return format; }                    // 像素格式
+    double frameRate() const override { return static_cast<double>(fpsNum) / fpsDen; } // 帧率
+    qint64 frameCount() const override { return totalFrames; }                       // 总帧数，未知时为 -1
+    bool isMapped() const { return mapped != nullptr; }                              // 是否为内存映射读取
+    QString errorString() const override { return error; }                           // 错误描述
+    QString backendName() const override { return "raw"; }                           // 后端名称
+
+private:
+    bool parseHeader(const QByteArray &line); // 解析 Y4M 文件头
+    bool readLine(QByteArray &line);          // 读取一行(文件头/帧头)
+    bool readExact(char *data, qint64 size);  // 从标准输入读取指定字节数
+
+    QFile file;             // 输入文件或标准输入
+    uchar *mapped;          // 内存映射起始地址
+    qint64 mappedSize;      // 映射长度
+    qint64 offset;          // 映射区当前读取位置
+    bool isY4M;             // 是否为 Y4M 封装
+    int frameWidth;         // 帧宽度
+    int frameHeight;        // 帧高度
+    frameView::PixelFormat format; // 像素格式
+    int fpsNum;             // 帧率分子
+    int fpsDen;             // 帧率分母
+    qint64 frameBytes;      // 每帧像素数据字节数
+    qint64 nextIndex;       // 下一帧序号
+    qint64 totalFrames;     // 总帧数，未知时为 -1
+    QByteArray frameBuffer; // 标准输入模式下复用的帧缓冲区
+    QString error;          // 错误描述
+};
+
+#endif // Y4MSOURCE_H
@@ -0,0 +1,778 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: yoloannotator.cpp
+ *
+ * 模块描述:
+ *   该模块实现了 YOLO 预标注器。所有推理线程共用一个 ONNX Runtime 会话
+ *   (Run 可并发调用)，每个线程持有自己的输入张量缓冲区并反复使用。
+ *   letterbox 在一遍扫描中完成双线性缩放、灰边填充、BGRA 到 RGB 的
+ *   通道重排、归一化和 HWC 到 CHW 的转置，直接写入批张量。
+ *
+ * 主要功能:
+ *   1. 加载模型并启动推理线程池
+ *   2. 提交已导出的图像，队列满时阻塞
+ *   3. 一遍完成缩放、填充、通道重排和归一化(letterbox)
+ *   4. 批量推理、置信度过滤、按类别 NMS，写出标注文件
+ *
+ * 函数列表:
+ *   1. yoloAnnotator             - 构造函数
+ *   2. ~yoloAnnotator            - 析构函数
+ *   3. isAvailable               - 是否编译了 ONNX Runtime 支持
+ *   4. start                     - 加载模型并启动推理线程
+ *   5. submit                    - 提交一张已导出的图像
+ *   6. finish                    - 处理完队列中的图像并停止线程
+ *   7. workerLoop                - 推理线程主循环
+ *   8. takeBatch                 - 从队列取出一批图像
+ *   9. letterbox                 - 将图像写入输入张量的一个批次位置
+ *   10. runBatch                 - 对一批图像推理并写出标注
+ *   11. decodeDetections         - 解析一张图像的模型输出
+ *   12. nonMaxSuppression        - 按类别做非极大值抑制
+ *   13. writeLabels              - 写出 YOLO 格式标注文件
+ *   14. boxOverlap               - 计算两个检测框的 IoU
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#include "yoloannotator.h"
+#include "pipelinestats.h"
+#include "tracelogger.h"
+#include <QBuffer>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#ifdef HAVE_ONNXRUNTIME
+#include <onnxruntime_cxx_api.h>
+#include <string>
+
+// ONNX Runtime 会话及输入输出名称
+struct yoloAnnotator::ortState
+{
+    Ort::Env env;
+    Ort::Session session;
+    std::string inputName;
+    std::string outputName;
+
+    ortState(const ORTCHAR_T *modelPath, const Ort::SessionOptions &sessionOptions)
+        : env(ORT_LOGGING_LEVEL_WARNING, "videoScreenshot"),
+          session(env, modelPath, sessionOptions) {}
+};
+#else
+struct yoloAnnotator::ortState
+{
+};
+#endif
+
+namespace
+{
+    const int DEFAULT_INPUT_SIZE = 640;      // 模型输入尺寸为动态时使用的边长
+    const int BATCH_WAIT_MS = 20;            // 不满一批时等待后续图像的最长时间
+    const int MAX_CANDIDATES = 30000;        // 进入 NMS 的候选框上限
+    const int MAX_DETECTIONS = 300;          // 每张图像保留的目标框上限
+    const float PAD_VALUE = 114.0f / 255.0f; // letterbox 灰边的归一化值
+    const float INV_255 = 1.0f / 255.0f;
+}
+
+// 推理线程，只负责调用预标注器的主循环
+class annotatorWorker : public QThread
+{
+public:
+    explicit annotatorWorker(yoloAnnotator *owner) : annotator(owner) {}
+
+protected:
+    void run() override { annotator->workerLoop(); }
+
+private:
+    yoloAnnotator *annotator;
+};
+
+/***********************************************************
+ * 函数名称: yoloAnnotator
+ * 函数功能: YOLO 预标注器的构造函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 使用前需调用 start()
+ ***********************************************************/
+yoloAnnotator::yoloAnnotator() : stats(nullptr),
+                                 ort(nullptr),
+                                 inputSize(DEFAULT_INPUT_SIZE),
+                                 batchLimit(1),
+                                 fixedBatch(false),
+                                 queuedBytes(0),
+                                 stopping(false),
+                                 submitterWaiting(false),
+                                 annotated(0),
+                                 boxes(0)
+{
+}
+
+/***********************************************************
+ * 函数名称: ~yoloAnnotator
+ * 函数功能: YOLO 预标注器的析构函数
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 未调用 finish() 时先处理完队列再退出
+ ***********************************************************/
+yoloAnnotator::~yoloAnnotator()
+{
+    finish();
+}
+
+/***********************************************************
+ * 函数名称: isAvailable
+ * 函数功能: 是否编译了 ONNX Runtime 支持
+ * 参数说明: 无
+ * 返回值: 以 CONFIG+=onnxruntime 编译时返回 true
+ * 备注: 无
+ ***********************************************************/
+bool yoloAnnotator::isAvailable()
+{
+#ifdef HAVE_ONNXRUNTIME
+    return true;
+#else
+    return false;
+#endif
+}
+
+/***********************************************************
+ * 函数名称: start
+ * 函数功能: 加载模型并启动推理线程
+ * 参数说明:
+ *   settings - 预标注参数
+ *   pipeline - 阶段统计对象，可为空
+ *   error    - 失败时返回错误描述，可为空
+ * 返回值: 成功返回 true
+ * 备注: 模型输入须为 [N,3,H,W] 的正方形；N、H、W 为动态时分别按
+ *       批大小参数和 640 处理，N 固定时以模型为准
+ ***********************************************************/
+bool yoloAnnotator::start(const options &settings, pipelineStats *pipeline, QString *error)
+{
+    finish();
+    config = settings;
+    stats = pipeline;
+    queuedBytes = 0;
+    stopping = false;
+    submitterWaiting = false;
+    annotated = 0;
+    boxes = 0;
+
+#ifdef HAVE_ONNXRUNTIME
+    try
+    {
+        Ort::SessionOptions sessionOptions;
+        sessionOptions.SetIntraOpNumThreads(qMax(1, config.intraThreads));
+        sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+#ifdef _WIN32
+        const std::wstring modelPath = config.modelPath.toStdWString();
+#else
+        const std::string modelPath = QFile::encodeName(config.modelPath).toStdString();
+#endif
+        ort = new ortState(modelPath.c_str(), sessionOptions);
+
+        Ort::AllocatorWithDefaultOptions allocator;
+        ort->inputName = ort->session.GetInputNameAllocated(0, allocator).get();
+        ort->outputName = ort->session.GetOutputNameAllocated(0, allocator).get();
+        const std::vector<int64_t> shape = ort->session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        if (shape.size() != 4 || (shape[1] > 0 && shape[1] != 3) ||
+            (shape[2] > 0 && shape[3] > 0 && shape[2] != shape[3]))
+        {
+            if (error)
+            {
+                *error = QStringLiteral("模型输入应为 [N,3,S,S] 的正方形图像");
+            }
+            delete ort;
+            ort = nullptr;
+            return false;
+        }
+        inputSize = shape[2] > 0 ? static_cast<int>(shape[2]) : (shape[3] > 0 ? static_cast<int>(shape[3]) : DEFAULT_INPUT_SIZE);
+        fixedBatch = shape[0] > 0;
+        batchLimit = fixedBatch ? static_cast<int>(shape[0]) : qMax(1, config.batchSize);
+    }
+    catch (const Ort::Exception &e)
+    {
+        if (error)
+        {
+            *error = QString::fromUtf8(e.what());
+        }
+        delete ort;
+        ort = nullptr;
+        return false;
+    }
+#else
+    if (error)
+    {
+        *error = QStringLiteral("未编译 ONNX Runtime 支持，请以 qmake \"CONFIG+=onnxruntime\" 重新编译");
+    }
+    return false;
+#endif
+
+    const int threadCount = qMax(1, config.workers);
+    for (int i = 0; i < threadCount; ++i)
+    {
+        QThread *worker = new annotatorWorker(this);
+        workers.append(worker);
+        worker->start();
+    }
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: submit
+ * 函数功能: 提交一张已导出的图像
+ * 参数说明:
+ *   imageFile - 已写出的图像文件路径，标注写到同名 .txt
+ *   image     - 已转换的图像，可为空
+ *   encoded   - 已编码的图像数据，image 为空时在推理线程中解码
+ * 返回值: 无
+ * 备注: 队列超过 2 倍批大小 x 线程数，或占用内存超过上限时阻塞，
+ *       形成背压；队列为空时总是接受，单张超大图像不会卡死
+ ***********************************************************/
+void yoloAnnotator::submit(const QString &imageFile, const QImage &image, const QByteArray &encoded)
+{
+    if (workers.isEmpty())
+    {
+        return;
+    }
+
+    job item;
+    const QFileInfo info(imageFile);
+    item.labelFile = info.dir().filePath(info.completeBaseName() + QStringLiteral(".txt"));
+    if (!image.isNull())
+    {
+        item.image = image;
+        item.bytes = static_cast<qint64>(image.bytesPerLine()) * image.height();
+    }
+    else
+    {
+        item.encoded = encoded;
+        item.bytes = encoded.size();
+    }
+
+    QMutexLocker locker(&mutex);
+    const int maxJobs = 2 * batchLimit * workers.size();
+    while (!queue.isEmpty() &&
+           (queue.size() >= maxJobs || queuedBytes + item.bytes > config.maxPendingBytes))
+    {
+        submitterWaiting = true;
+        notEmpty.wakeAll();
+        notFull.wait(&mutex);
+    }
+    submitterWaiting = false;
+    queue.enqueue(item);
+    queuedBytes += item.bytes;
+    if (stats)
+    {
+        stats->setQueueDepth(pipelineStats::STAGE_INFER, queue.size());
+    }
+    notEmpty.wakeOne();
+}
+
+/***********************************************************
+ * 函数名称: finish
+ * 函数功能: 处理完队列中的图像并停止线程
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 阻塞到所有已提交图像的标注写出为止，可重复调用
+ ***********************************************************/
+void yoloAnnotator::finish()
+{
+    {
+        QMutexLocker locker(&mutex);
+        stopping = true;
+        notEmpty.wakeAll();
+    }
+    for (QThread *worker : workers)
+    {
+        worker->wait();
+        delete worker;
+    }
+    workers.clear();
+    delete ort;
+    ort = nullptr;
+}
+
+/***********************************************************
+ * 函数名称: workerLoop
+ * 函数功能: 推理线程主循环
+ * 参数说明: 无
+ * 返回值: 无
+ * 备注: 输入张量缓冲区在批之间复用
+ ***********************************************************/
+void yoloAnnotator::workerLoop()
+{
+    QVector<job> batch;
+    QVector<float> tensor;
+    while (takeBatch(batch))
+    {
+        runBatch(batch, tensor);
+    }
+}
+
+/***********************************************************
+ * 函数名称: takeBatch
+ * 函数功能: 从队列取出一批图像
+ * 参数说明:
+ *   batch - 返回取出的图像
+ * 返回值: 已停止且队列为空时返回 false
+ * 备注: 不满一批时最多再等 20 毫秒凑批；已停止或提交方被背压
+ *       阻塞时不再等待，取走现有的图像
+ ***********************************************************/
+bool yoloAnnotator::takeBatch(QVector<job> &batch)
+{
+    batch.clear();
+    QMutexLocker locker(&mutex);
+    while (batch.isEmpty())
+    {
+        while (queue.isEmpty() && !stopping)
+        {
+            notEmpty.wait(&mutex);
+        }
+        if (queue.isEmpty())
+        {
+            return false;
+        }
+
+        QElapsedTimer waited;
+        waited.start();
+        while (queue.size() < batchLimit && !stopping && !submitterWaiting)
+        {
+            const qint64 remaining = BATCH_WAIT_MS - waited.elapsed();
+            if (remaining <= 0 || !notEmpty.wait(&mutex, static_cast<unsigned long>(remaining)))
+            {
+                break;
+            }
+        }
+
+        // 等待期间其他线程可能已取走图像，此时重新等待
+        while (!queue.isEmpty() && batch.size() < batchLimit)
+        {
+            const job item = queue.dequeue();
+            queuedBytes -= item.bytes;
+            batch.append(item);
+        }
+    }
+    if (stats)
+    {
+        stats->setQueueDepth(pipelineStats::STAGE_INFER, queue.size());
+    }
+    notFull.wakeAll();
+    return true;
+}
+
+/***********************************************************
+ * 函数名称: letterbox
+ * 函数功能: 将图像写入输入张量的一个批次位置
+ * 参数说明:
+ *   image  - RGB32/ARGB32 格式的图像
+ *   tensor - 该图像在批张量中的起始位置，3 x S x S 个浮点数
+ *   scale  - 返回缩放比例
+ *   padX   - 返回左侧灰边宽度
+ *   padY   - 返回上方灰边高度
+ * 返回值: 无
+ * 备注: 等比缩放到 S x S 内并居中，缩放、填充、RGB 重排、除以 255
+ *       和 CHW 转置在一遍中完成，每个输出元素只写一次。列方向的
+ *       采样位置和权重预先算好，按行复用
+ ***********************************************************/
+void yoloAnnotator::letterbox(const QImage &image, float *tensor, float &scale, int &padX, int &padY) const
+{
+    const int width = image.width();
+    const int height = image.height();
+    scale = qMin(static_cast<float>(inputSize) / width, static_cast<float>(inputSize) / height);
+    const int scaledWidth = qBound(1, qRound(width * scale), inputSize);
+    const int scaledHeight = qBound(1, qRound(height * scale), inputSize);
+    padX = (inputSize - scaledWidth) / 2;
+    padY = (inputSize - scaledHeight) / 2;
+
+    std::vector<int> left(scaledWidth);
+    std::vector<int> right(scaledWidth);
+    std::vector<float> weight(scaledWidth);
+    for (int x = 0; x < scaledWidth; ++x)
+    {
+        const float source = qBound(0.0f, (x + 0.5f) / scale - 0.5f, static_cast<float>(width - 1));
+        left[x] = static_cast<int>(source);
+        right[x] = qMin(left[x] + 1, width - 1);
+        weight[x] = source - left[x];
+    }
+
+    const qint64 plane = static_cast<qint64>(inputSize) * inputSize;
+    float *red = tensor;
+    float *green = tensor + plane;
+    float *blue = tensor + 2 * plane;
+    for (int y = 0; y < inputSize; ++y)
+    {
+        const qint64 rowOffset = static_cast<qint64>(y) * inputSize;
+        float *outRed = red + rowOffset;
+        float *outGreen = green + rowOffset;
+        float *outBlue = blue + rowOffset;
+        const int row = y - padY;
+        if (row < 0 || row >= scaledHeight)
+        {
+            std::fill(outRed, outRed + inputSize, PAD_VALUE);
+            std::fill(outGreen, outGreen + inputSize, PAD_VALUE);
+            std::fill(outBlue, outBlue + inputSize, PAD_VALUE);
+            continue;
+        }
+
+        const float sourceY = qBound(0.0f, (row + 0.5f) / scale - 0.5f, static_cast<float>(height - 1));
+        const int top = static_cast<int>(sourceY);
+        const int bottom = qMin(top + 1, height - 1);
+        const float wy = sourceY - top;
+        const QRgb *upper = reinterpret_cast<const QRgb *>(image.constScanLine(top));
+        const QRgb *lower = reinterpret_cast<const QRgb *>(image.constScanLine(bottom));
+
+        std::fill(outRed, outRed + padX, PAD_VALUE);
+        std::fill(outGreen, outGreen + padX, PAD_VALUE);
+        std::fill(outBlue, outBlue + padX, PAD_VALUE);
+        for (int x = 0; x < scaledWidth; ++x)
+        {
+            const QRgb a = upper[left[x]];
+            const QRgb b = upper[right[x]];
+            const QRgb c = lower[left[x]];
+            const QRgb d = lower[right[x]];
+            const float wx = weight[x];
+            const float w00 = (1.0f - wx) * (1.0f - wy) * INV_255;
+            const float w01 = wx * (1.0f - wy) * INV_255;
+            const float w10 = (1.0f - wx) * wy * INV_255;
+            const float w11 = wx * wy * INV_255;
+            outRed[padX + x] = qRed(a) * w00 + qRed(b) * w01 + qRed(c) * w10 + qRed(d) * w11;
+            outGreen[padX + x] = qGreen(a) * w00 + qGreen(b) * w01 + qGreen(c) * w10 + qGreen(d) * w11;
+            outBlue[padX + x] = qBlue(a) * w00 + qBlue(b) * w01 + qBlue(c) * w10 + qBlue(d) * w11;
+        }
+        const int tail = padX + scaledWidth;
+        std::fill(outRed + tail, outRed + inputSize, PAD_VALUE);
+        std::fill(outGreen + tail, outGreen + inputSize, PAD_VALUE);
+        std::fill(outBlue + tail, outBlue + inputSize, PAD_VALUE);
+    }
+}
+
+/***********************************************************
+ * 函数名称: runBatch
+ * 函数功能: 对一批图像推理并写出标注
+ * 参数说明:
+ *   batch  - 一批图像，处理后清空其中的图像数据
+ *   tensor - 本线程复用的输入张量缓冲区
+ * 返回值: 无
+ * 备注: 只有编码数据的图像按模型输入尺寸缩小解码；模型批大小固定
+ *       时不足一批的位置补零。批耗时平摊到每张图像计入推理阶段
+ ***********************************************************/
+void yoloAnnotator::runBatch(QVector<job> &batch, QVector<float> &tensor)
+{
+#ifdef HAVE_ONNXRUNTIME
+    QElapsedTimer timer;
+    timer.start();
+    traceLogger *tracer = stats != nullptr ? stats->activeTracer() : nullptr;
+    const qint64 traceBeginNs = tracer != nullptr ? traceLogger::nowNs() : -1;
+
+    const int count = batch.size();
+    const int rows = fixedBatch ? batchLimit : count;
+    const qint64 plane = 3LL * inputSize * inputSize;
+    if (tensor.size() < rows * plane)
+    {
+        tensor.resize(static_cast<int>(rows * plane));
+    }
+
+    QVector<float> scales(count, 1.0f);
+    QVector<int> padXs(count, 0);
+    QVector<int> padYs(count, 0);
+    QVector<QSize> sizes(count);
+    for (int i = 0; i < count; ++i)
+    {
+        float *slot = tensor.data() + i * plane;
+        QImage image = batch[i].image;
+        if (image.isNull())
+        {
+            QBuffer buffer(&batch[i].encoded);
+            QImageReader reader(&buffer);
+            const QSize original = reader.size();
+            if (original.isValid() && qMax(original.width(), original.height()) > inputSize)
+            {
+                reader.setScaledSize(original.scaled(inputSize, inputSize, Qt::KeepAspectRatio));
+            }
+            image = reader.read();
+        }
+        if (image.isNull())
+        {
+            qDebug() << "Annotate skipped, image unreadable:" << batch[i].labelFile;
+            std::fill(slot, slot + plane, 0.0f);
+            continue;
+        }
+        if (image.format() != QImage::Format_RGB32 && image.format() != QImage::Format_ARGB32)
+        {
+            image = image.convertToFormat(QImage::Format_RGB32);
+        }
+        sizes[i] = image.size();
+        letterbox(image, slot, scales[i], padXs[i], padYs[i]);
+    }
+    std::fill(tensor.data() + count * plane, tensor.data() + rows * plane, 0.0f);
+
+    try
+    {
+        const Ort::MemoryInfo memory = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        const int64_t shape[4] = {rows, 3, inputSize, inputSize};
+        Ort::Value input = Ort::Value::CreateTensor<float>(memory, tensor.data(), static_cast<size_t>(rows * plane), shape, 4);
+        const char *inputNames[] = {ort->inputName.c_str()};
+        const char *outputNames[] = {ort->outputName.c_str()};
+        std::vector<Ort::Value> outputs = ort->session.Run(Ort::RunOptions{nullptr}, inputNames, &input, 1, outputNames, 1);
+
+        const std::vector<int64_t> outputShape = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+        if (outputShape.size() != 3 || outputShape[0] < count)
+        {
+            qDebug() << "Unsupported YOLO output rank:" << static_cast<int>(outputShape.size());
+        }
+        else
+        {
+            // YOLOv8/YOLO11 输出为 [B, 4+类别数, 锚点数]，锚点数远大于类别数；
+            // 部分导出工具会转置为 [B, 锚点数, 4+类别数]
+            const bool transposed = outputShape[1] > outputShape[2];
+            const qint64 values = transposed ? outputShape[2] : outputShape[1];
+            const qint64 anchors = transposed ? outputShape[1] : outputShape[2];
+            const float *output = outputs[0].GetTensorData<float>();
+            for (int i = 0; i < count && values > 4; ++i)
+            {
+                if (sizes[i].isEmpty())
+                {
+                    continue;
+                }
+                QVector<detection> candidates = decodeDetections(output + i * values * anchors, values, anchors, transposed,
+                                                                 scales[i], padXs[i], padYs[i],
+                                                                 sizes[i].width(), sizes[i].height());
+                const QVector<detection> kept = nonMaxSuppression(candidates);
+                if (writeLabels(batch[i].labelFile, kept, sizes[i].width(), sizes[i].height()))
+                {
+                    annotated.fetch_add(1);
+                    boxes.fetch_add(kept.size());
+                }
+            }
+        }
+    }
+    catch (const Ort::Exception &e)
+    {
+        qDebug() << "YOLO inference failed:" << e.what();
+    }
+
+    const qint64 elapsed = timer.nsecsElapsed();
+    if (stats)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            stats->recordLatency(pipelineStats::STAGE_INFER, elapsed / count);
+        }
+    }
+    if (tracer != nullptr)
+    {
+        tracer->record("infer", traceBeginNs, traceLogger::nowNs() - traceBeginNs, -1);
+    }
+#else
+    Q_UNUSED(tensor);
+#endif
+    batch.clear();
+}
+
+/***********************************************************
+ * 函数名称: decodeDetections
+ * 函数功能: 解析一张图像的模型输出
+ * 参数说明:
+ *   output      - 该图像的输出数据
+ *   values      - 每个锚点的数值个数，4 个框坐标加各类别分数
+ *   anchors     - 锚点数
+ *   transposed  - 输出是否为 [锚点数, 4+类别数] 布局
+ *   scale       - letterbox 缩放比例
+ *   padX        - letterbox 左侧灰边宽度
+ *   padY        - letterbox 上方灰边高度
+ *   imageWidth  - 图像宽度
+ *   imageHeight - 图像高度
+ * 返回值: 置信度不低于阈值的候选框，坐标为图像像素
+ * 备注: 先按内存顺序扫描各类别分数求出每个锚点的最高分，再只对
+ *       过阈值的锚点读取框坐标，[4+类别数, 锚点数] 布局下全程顺序访问
+ ***********************************************************/
+QVector<yoloAnnotator::detection> yoloAnnotator::decodeDetections(const float *output, qint64 values, qint64 anchors,
+                                                                  bool transposed, float scale, int padX, int padY,
+                                                                  int imageWidth, int imageHeight) const
+{
+    std::vector<float> bestScore(static_cast<size_t>(anchors), 0.0f);
+    std::vector<int> bestClass(static_cast<size_t>(anchors), -1);
+    if (transposed)
+    {
+        for (qint64 a = 0; a < anchors; ++a)
+        {
+            const float *scores = output + a * values + 4;
+            for (qint64 c = 0; c < values - 4; ++c)
+            {
+                if (scores[c] > bestScore[a])
+                {
+                    bestScore[a] = scores[c];
+                    bestClass[a] = static_cast<int>(c);
+                }
+            }
+        }
+    }
+    else
+    {
+        for (qint64 c = 0; c < values - 4; ++c)
+        {
+            const float *scores = output + (4 + c) * anchors;
+            for (qint64 a = 0; a < anchors; ++a)
+            {
+                if (scores[a] > bestScore[a])
+                {
+                    bestScore[a] = scores[a];
+                    bestClass[a] = static_cast<int>(c);
+                }
+            }
+        }
+    }
+
+    QVector<detection> candidates;
+    for (qint64 a = 0; a < anchors; ++a)
+    {
+        if (bestClass[a] < 0 || bestScore[a] < config.confidence)
+        {
+            continue;
+        }
+        const qint64 step = transposed ? 1 : anchors;
+        const float *box = transposed ? output + a * values : output + a;
+        const float cx = (box[0] - padX) / scale;
+        const float cy = (box[step] - padY) / scale;
+        const float halfWidth = box[2 * step] / scale / 2.0f;
+        const float halfHeight = box[3 * step] / scale / 2.0f;
+
+        detection item;
+        item.classId = bestClass[a];
+        item.score = bestScore[a];
+        item.x1 = qBound(0.0f, cx - halfWidth, static_cast<float>(imageWidth));
+        item.y1 = qBound(0.0f, cy - halfHeight, static_cast<float>(imageHeight));
+        item.x2 = qBound(0.0f, cx + halfWidth, static_cast<float>(imageWidth));
+        item.y2 = qBound(0.0f, cy + halfHeight, static_cast<float>(imageHeight));
+        if (item.x2 > item.x1 && item.y2 > item.y1)
+        {
+            candidates.append(item);
+        }
+    }
+    return candidates;
+}
+
+/***********************************************************
+ * 函数名称: boxOverlap
+ * 函数功能: 计算两个检测框的 IoU
+ * 参数说明:
+ *   x1, y1, x2, y2 - 第一个框
+ *   u1, v1, u2, v2 - 第二个框
+ * 返回值: 交并比
+ * 备注: 无
+ ***********************************************************/
+static inline float boxOverlap(float x1, float y1, float x2, float y2,
+                               float u1, float v1, float u2, float v2)
+{
+    const float width = qMin(x2, u2) - qMax(x1, u1);
+    const float height = qMin(y2, v2) - qMax(y1, v1);
+    if (width <= 0.0f || height <= 0.0f)
+    {
+        return 0.0f;
+    }
+    const float intersection = width * height;
+    return intersection / ((x2 - x1) * (y2 - y1) + (u2 - u1) * (v2 - v1) - intersection);
+}
+
+/***********************************************************
+ * 函数名称: nonMaxSuppression
+ * 函数功能: 按类别做非极大值抑制
+ * 参数说明:
+ *   candidates - 候选框，会被按分数排序
+ * 返回值: 保留的目标框，按分数降序
+ * 备注: 只抑制同类别的框；候选最多取分数最高的 30000 个，
+ *       结果最多 300 个
+ ***********************************************************/
+QVector<yoloAnnotator::detection> yoloAnnotator::nonMaxSuppression(QVector<detection> &candidates) const
+{
+    std::sort(candidates.begin(), candidates.end(), [](const detection &a, const detection &b)
+              { return a.score > b.score; });
+    if (candidates.size() > MAX_CANDIDATES)
+    {
+        candidates.resize(MAX_CANDIDATES);
+    }
+
+    QVector<detection> kept;
+    for (const detection &item : candidates)
+    {
+        bool suppressed = false;
+        for (const detection &other : kept)
+        {
+            if (other.classId == item.classId &&
+                boxOverlap(item.x1, item.y1, item.x2, item.y2, other.x1, other.y1, other.x2, other.y2) > config.iou)
+            {
+                suppressed = true;
+                break;
+            }
+        }
+        if (!suppressed)
+        {
+            kept.append(item);
+            if (kept.size() >= MAX_DETECTIONS)
+            {
+                break;
+            }
+        }
+    }
+    return kept;
+}
+
+/***********************************************************
+ * 函数名称: writeLabels
+ * 函数功能: 写出 YOLO 格式标注文件
+ * 参数说明:
+ *   labelFile   - 标注文件路径
+ *   detections  - 目标框，坐标为图像像素
+ *   imageWidth  - 图像宽度
+ *   imageHeight - 图像高度
+ * 返回值: 写出成功返回 true
+ * 备注: 每行 "类别 中心x 中心y 宽 高"，坐标按图像尺寸归一化到 [0,1]，
+ *       保留 6 位小数。没有目标时写出空文件，表示已标注且为负样本
+ ***********************************************************/
+bool yoloAnnotator::writeLabels(const QString &labelFile, const QVector<detection> &detections,
+                                int imageWidth, int imageHeight) const
+{
+    QByteArray text;
+    text.reserve(detections.size() * 48);
+    for (const detection &item : detections)
+    {
+        text += QByteArray::number(item.classId);
+        text += ' ';
+        text += QByteArray::number((item.x1 + item.x2) / 2.0f / imageWidth, 'f', 6);
+        text += ' ';
+        text += QByteArray::number((item.y1 + item.y2) / 2.0f / imageHeight, 'f', 6);
+        text += ' ';
+        text += QByteArray::number((item.x2 - item.x1) / imageWidth, 'f', 6);
+        text += ' ';
+        text += QByteArray::number((item.y2 - item.y1) / imageHeight, 'f', 6);
+        text += '\n';
+    }
+
+    QFile file(labelFile);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(text) != text.size())
+    {
+        qDebug() << "Failed to write labels:" << labelFile << file.errorString();
+        return false;
+    }
+    return true;
+}
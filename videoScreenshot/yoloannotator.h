@@ -0,0 +1,154 @@
+/************************************************************
+ * Copyright 2025 LiuJiaLe
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * 文件: yoloannotator.h
+ *
+ * 模块描述:
+ *   该模块定义了 YOLO 预标注器: 用 ONNX Runtime 在 CPU 上运行用户提供的
+ *   YOLO 检测模型(YOLOv8/YOLO11 导出的 ONNX)，为导出的每张图像在同目录
+ *   写出 YOLO 格式的 .txt 标注。推理在独立的线程池中按批进行，输入队列
+ *   按帧数和字节数限长，队列满时提交方阻塞，慢模型会拖慢导出而不会
+ *   堆积内存。需以 CONFIG+=onnxruntime 编译，否则启动时报错。
+ *
+ * 主要功能:
+ *   1. 加载模型并启动推理线程池
+ *   2. 提交已导出的图像，队列满时阻塞
+ *   3. 一遍完成缩放、填充、通道重排和归一化(letterbox)
+ *   4. 批量推理、置信度过滤、按类别 NMS，写出标注文件
+ *
+ * 函数列表:
+ *   1. yoloAnnotator             - 构造函数
+ *   2. ~yoloAnnotator            - 析构函数
+ *   3. isAvailable               - 是否编译了 ONNX Runtime 支持
+ *   4. start                     - 加载模型并启动推理线程
+ *   5. submit                    - 提交一张已导出的图像
+ *   6. finish                    - 处理完队列中的图像并停止线程
+ *   7. workerLoop                - 推理线程主循环
+ *   8. takeBatch                 - 从队列取出一批图像
+ *   9. letterbox                 - 将图像写入输入张量的一个批次位置
+ *   10. runBatch                 - 对一批图像推理并写出标注
+ *   11. decodeDetections         - 解析一张图像的模型输出
+ *   12. nonMaxSuppression        - 按类别做非极大值抑制
+ *   13. writeLabels              - 写出 YOLO 格式标注文件
+ *
+ * 版本历史:
+ *   - 版本 1.0 (2026-10-18) - LiuJiaLe
+ *     * 初始版本创建
+ ***********************************************************/
+
+#ifndef YOLOANNOTATOR_H
+#define YOLOANNOTATOR_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+#include <atomic>
+
+class pipelineStats;
+
+class yoloAnnotator
+{
+public:
+    // 预标注参数
+    struct options
+    {
+        QString modelPath;       // ONNX 模型文件，为空表示不标注
+        int batchSize;           // 每批图像数，模型批大小固定时以模型为准
+        int workers;             // 推理线程数
+        int intraThreads;        // 每个推理线程内 ONNX Runtime 使用的线程数
+        float confidence;        // 置信度阈值
+        float iou;               // NMS 的 IoU 阈值
+        qint64 maxPendingBytes;  // 等待推理的图像占用内存上限(字节)
+
+        options() : batchSize(8), workers(1), intraThreads(2), confidence(0.25f), iou(0.45f),
+                    maxPendingBytes(256LL * 1024 * 1024) {}
+    };
+
+    yoloAnnotator();
+    ~yoloAnnotator();
+
+    static bool isAvailable(); // 是否编译了 ONNX Runtime 支持
+
+    bool start(const options &settings, pipelineStats *pipeline,
+               QString *error = nullptr);                 // 加载模型并启动推理线程
+    void submit(const QString &imageFile, const QImage &image,
+                const QByteArray &encoded);               // 提交一张已导出的图像，队列满时阻塞
+    void finish();                                        // 处理完队列中的图像并停止线程
+
+    qint64 annotatedCount() const { return annotated.load(); } // 已写出标注的图像数
+    qint64 boxCount() const { return boxes.load(); }           // 已写出的目标框数
+
+private:
+    friend class annotatorWorker;
+    struct ortState;
+
+    // 等待推理的一张图像
+    struct job
+    {
+        QString labelFile;  // 标注文件路径
+        QImage image;       // 已转换的图像，为空时从 encoded 解码
+        QByteArray encoded; // 已编码的图像数据
+        qint64 bytes;       // 计入队列上限的字节数
+    };
+
+    // 一个检测结果，坐标为原图像素
+    struct detection
+    {
+        int classId;
+        float score;
+        float x1;
+        float y1;
+        float x2;
+        float y2;
+    };
+
+    void workerLoop();                            // 推理线程主循环
+    bool takeBatch(QVector<job> &batch);          // 从队列取出一批图像，停止且队列为空时返回 false
+    void letterbox(const QImage &image, float *tensor, float &scale,
+                   int &padX, int &padY) const;   // 将图像写入输入张量的一个批次位置
+    void runBatch(QVector<job> &batch, QVector<float> &tensor); // 对一批图像推理并写出标注
+    QVector<detection> decodeDetections(const float *output, qint64 rows, qint64 anchors,
+                                        bool transposed, float scale, int padX, int padY,
+                                        int imageWidth, int imageHeight) const; // 解析一张图像的模型输出
+    QVector<detection> nonMaxSuppression(QVector<detection> &candidates) const; // 按类别做非极大值抑制
+    bool writeLabels(const QString &labelFile, const QVector<detection> &detections,
+                     int imageWidth, int imageHeight) const;  // 写出 YOLO 格式标注文件
+
+    options config;              // 预标注参数
+    pipelineStats *stats;        // 阶段统计对象，可为空
+    ortState *ort;               // ONNX Runtime 会话，未编译支持时为空
+    int inputSize;               // 模型输入边长
+    int batchLimit;              // 实际批大小
+    bool fixedBatch;             // 模型批大小是否固定，固定时不足一批补零
+
+    QMutex mutex;                // 保护队列
+    QWaitCondition notEmpty;     // 队列非空或停止
+    QWaitCondition notFull;      // 队列有空位
+    QQueue<job> queue;           // 等待推理的图像
+    qint64 queuedBytes;          // 队列中图像占用的字节数
+    bool stopping;               // 是否已请求停止
+    bool submitterWaiting;       // 提交方是否因队列满而阻塞
+    QVector<QThread *> workers;  // 推理线程
+
+    std::atomic<qint64> annotated; // 已写出标注的图像数
+    std::atomic<qint64> boxes;     // 已写出的目标框数
+};
+
+#endif // YOLOANNOTATOR_H